@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+#include "BenchData.h"
+
+#include "GameObject.h"
+#include "C_Animator.h"
+#include "C_Mesh.h"
+
+#include "R_Mesh.h"
+#include "R_Animation.h"
+#include "ResourceBase.h"
+
+namespace Benchmark
+{
+	namespace Animation
+	{
+		void ChannelSampling(State& state)
+		{
+			const uint channelCount = 50;
+
+			LCG random(9);
+			ResourceBase base(ResourceType::ANIMATION, "Benchmark.fbx", "Animation", 1);
+			R_Animation* animation = Data::CreateAnimation(channelCount, state.size, &base, random);
+
+			GameObject* gameObject = new GameObject(nullptr, "Animator");
+			C_Animator* animator = (C_Animator*)gameObject->CreateComponent(Component::Type::Animator);
+
+			//Same sampling done by C_Animator::UpdateChannelsTransform for every channel
+			float time = 0.0f;
+			while (state.Next())
+			{
+				float currentKey = time * animation->ticksPerSecond;
+				std::map<std::string, Channel>::const_iterator it;
+				for (it = animation->channels.begin(); it != animation->channels.end(); ++it)
+				{
+					DoNotOptimize(animator->GetChannelPosition(it->second, currentKey, float3::zero));
+					DoNotOptimize(animator->GetChannelRotation(it->second, currentKey, Quat::identity));
+					DoNotOptimize(animator->GetChannelScale(it->second, currentKey, float3::one));
+				}
+
+				time += 1.0f / 60.0f;
+				if (time * animation->ticksPerSecond > animation->duration)
+					time = 0.0f;
+			}
+			state.SetItemsPerIteration(channelCount);
+
+			RELEASE(gameObject);
+			RELEASE(animation);
+		}
+
+		void DeformAnimMesh(State& state)
+		{
+			const uint boneCount = 32;
+
+			LCG random(10);
+			ResourceBase base(ResourceType::MESH, "Benchmark.fbx", "Mesh", 1);
+			R_Mesh* mesh = Data::CreateMesh(state.size, boneCount, &base, random);
+
+			//Same layout as an imported model: the root bone hangs from an armature node, sibling of the mesh
+			GameObject* root = new GameObject(nullptr, "Root");
+			GameObject* character = new GameObject(root, "Character");
+			GameObject* meshObject = new GameObject(character, "Mesh");
+			GameObject* armature = new GameObject(character, "Armature");
+
+			std::vector<GameObject*> bones;
+			for (uint b = 0; b < boneCount; ++b)
+			{
+				GameObject* parent = b == 0 ? armature : bones[(b - 1) / 4];
+				bones.push_back(new GameObject(parent, Data::BoneName(b).c_str(), Data::RandomPosition(random, 1.0f)));
+			}
+			root->OnUpdateTransform();
+
+			//The mesh is not listed in module resources: the handle only borrows it, and it is deleted once the handle is released
+			C_Mesh* cMesh = (C_Mesh*)meshObject->CreateComponent(Component::Type::Mesh);
+			cMesh->SetResource(mesh);
+			cMesh->rootBone = bones[0];
+
+			//Same calls done by C_Animator::UpdateMeshAnimation every frame
+			while (state.Next())
+			{
+				cMesh->StartBoneDeformation();
+				cMesh->DeformAnimMesh();
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE(cMesh->animMesh);
+			RELEASE(root);
+			RELEASE(mesh);
+		}
+	}
+}
+
+void Benchmark::RegisterAnimationBenchmarks()
+{
+	Register("Animator/ChannelSampling", Animation::ChannelSampling, { 10, 100, 1000 });
+	Register("C_Mesh/DeformAnimMesh", Animation::DeformAnimMesh, { 1000, 10000, 50000 });
+}
@@ -0,0 +1,177 @@
+#include "Benchmark.h"
+
+#include "Engine.h"
+#include "M_FileSystem.h"
+#include "PathNode.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace Benchmark
+{
+	namespace FileSystem
+	{
+		//Project with a tree of 'count' files outside Assets, so it is never imported: 100 files per folder (half of them
+		//.meta files), 10 folders per parent folder
+		std::string CreateTreeProject(uint count)
+		{
+			namespace fs = std::filesystem;
+			std::string project = GetScratchDir() + "/TreeProject_" + std::to_string(count);
+			fs::path tree = fs::path(project) / "Tree";
+
+			std::error_code error;
+			if (fs::exists(tree / "Complete", error))
+				return project;
+
+			const uint filesPerFolder = 100;
+			uint folderCount = (count + filesPerFolder - 1) / filesPerFolder;
+			for (uint f = 0; f < folderCount; ++f)
+			{
+				fs::path folder = tree / ("a" + std::to_string(f / 100)) / ("b" + std::to_string(f / 10 % 10)) / ("c" + std::to_string(f % 10));
+				fs::create_directories(folder, error);
+				for (uint i = 0; i < filesPerFolder / 2; ++i)
+				{
+					std::ofstream(folder / ("Mesh" + std::to_string(i) + ".fbx"));
+					std::ofstream(folder / ("Mesh" + std::to_string(i) + ".fbx.meta"));
+				}
+			}
+			std::ofstream(tree / "Complete");
+			return project;
+		}
+
+		//Counts the files in the tree, as the callers of GetAllFiles walk it
+		uint CountFiles(const PathNode& node)
+		{
+			uint ret = node.isFile ? 1 : 0;
+			for (uint i = 0; i < node.children.size(); ++i)
+				ret += CountFiles(node.children[i]);
+			return ret;
+		}
+
+		//Same scan as the asset explorer refresh and the startup asset registration: .meta files ignored
+		//'cold' lists every directory again, otherwise only the directories are checked for changes
+		void ScanTree(State& state, bool cold)
+		{
+			std::string project = CreateTreeProject(state.size);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				std::vector<std::string> ignoreExtensions(1, "meta");
+				uint fileCount = 0;
+				while (state.Next())
+				{
+					if (cold)
+					{
+						state.PauseTiming();
+						Engine->fileSystem->ClearScan();
+						state.ResumeTiming();
+					}
+					PathNode tree = Engine->fileSystem->GetAllFiles("Tree", nullptr, &ignoreExtensions);
+					fileCount = CountFiles(tree);
+				}
+
+				if (fileCount != state.size / 2)
+					LOG("[error] Scanned %u files, %u expected", fileCount, state.size / 2);
+				state.SetItemsPerIteration(state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void GetAllFiles(State& state)
+		{
+			ScanTree(state, false);
+		}
+
+		void GetAllFilesCold(State& state)
+		{
+			ScanTree(state, true);
+		}
+
+		//External asset of 'size' MB, as imported from outside the project
+		std::string CreateLargeFile(uint size)
+		{
+			std::string file = GetScratchDir() + "/Large_" + std::to_string(size) + ".bin";
+			std::error_code error;
+			if (std::filesystem::file_size(file, error) == (uint64)size << 20)
+				return file;
+
+			std::vector<char> block(1 << 20);
+			for (uint i = 0; i < block.size(); ++i)
+				block[i] = (char)(i * 2654435761u >> 24);
+
+			std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+			for (uint i = 0; i < size; ++i)
+				stream.write(block.data(), block.size());
+			return file;
+		}
+
+		void DuplicateFile(State& state)
+		{
+			std::string file = CreateLargeFile(state.size);
+			while (state.Next())
+			{
+				if (Engine->fileSystem->DuplicateFile(file.c_str(), TEMP_PATH "Duplicate.bin") == false)
+					LOG("[error] Could not duplicate %s", file.c_str());
+			}
+			Engine->fileSystem->Remove(TEMP_PATH "Duplicate.bin");
+			state.SetItemsPerIteration((uint64)state.size << 20);
+		}
+
+		//Reference: the stream copy DuplicateFile used before, in place
+		void DuplicateFileStream(State& state)
+		{
+			std::string file = CreateLargeFile(state.size);
+			while (state.Next())
+			{
+				std::ifstream src(file, std::ios::binary);
+				std::ofstream dst(TEMP_PATH "Duplicate.bin", std::ios::binary);
+				dst << src.rdbuf();
+			}
+			Engine->fileSystem->Remove(TEMP_PATH "Duplicate.bin");
+			state.SetItemsPerIteration((uint64)state.size << 20);
+		}
+
+		//Replaces a library sized file of 'size' bytes, with and without flushing it to the disk
+		void SaveFile(State& state, bool sync)
+		{
+			std::vector<char> buffer(state.size, 'T');
+			bool syncWrites = Engine->fileSystem->IsSyncingWrites();
+			Engine->fileSystem->SetSyncWrites(sync);
+
+			while (state.Next())
+			{
+				if (Engine->fileSystem->Save(TEMP_PATH "Save.bin", buffer.data(), state.size) != state.size)
+					LOG("[error] Could not save %s", TEMP_PATH "Save.bin");
+			}
+			Engine->fileSystem->FinishWrites();
+
+			Engine->fileSystem->SetSyncWrites(syncWrites);
+			Engine->fileSystem->Remove(TEMP_PATH "Save.bin");
+			state.SetItemsPerIteration(state.size);
+		}
+
+		void Save(State& state)
+		{
+			SaveFile(state, false);
+		}
+
+		void SaveSync(State& state)
+		{
+			SaveFile(state, true);
+		}
+	}
+}
+
+void Benchmark::RegisterFileSystemBenchmarks()
+{
+	Register("FileSystem/GetAllFiles", FileSystem::GetAllFiles, { 1000, 10000, 100000 });
+	Register("FileSystem/GetAllFilesCold", FileSystem::GetAllFilesCold, { 1000, 10000, 100000 });
+	Register("FileSystem/DuplicateFile", FileSystem::DuplicateFile, { 1, 16, 128 });
+	Register("FileSystem/DuplicateFileStream", FileSystem::DuplicateFileStream, { 1, 16, 128 });
+	Register("FileSystem/Save", FileSystem::Save, { 4096, 1 << 20 });
+	Register("FileSystem/SaveSync", FileSystem::SaveSync, { 4096, 1 << 20 });
+}
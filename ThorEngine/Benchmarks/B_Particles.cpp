@@ -0,0 +1,60 @@
+#include "Benchmark.h"
+
+#include "Engine.h"
+#include "M_Renderer3D.h"
+
+#include "GameObject.h"
+#include "C_ParticleSystem.h"
+
+#include "Emitter.h"
+#include "EmitterInstance.h"
+#include "ParticleModule.h"
+
+namespace Benchmark
+{
+	namespace Particles
+	{
+		void EmitterInstanceUpdate(State& state)
+		{
+			Emitter emitter;
+			emitter.maxParticleCount = state.size;
+
+			//Lifetime is long enough for all particles to stay alive during the whole case
+			ParticleLifetime* lifetime = new ParticleLifetime();
+			lifetime->initialLifetime1 = lifetime->initialLifetime2 = 1e9f;
+
+			emitter.modules.push_back(new EmitterBase());
+			emitter.modules.push_back(lifetime);
+			emitter.modules.push_back(new ParticleVelocity());
+			emitter.modules.push_back(new ParticleColor());
+
+			GameObject* gameObject = new GameObject(nullptr, "Particle System");
+			C_ParticleSystem* component = (C_ParticleSystem*)gameObject->CreateComponent(Component::Type::ParticleSystem);
+
+			EmitterInstance instance;
+			instance.Init(&emitter, component);
+			for (uint i = 0; i < state.size; ++i)
+				instance.SpawnParticle();
+
+			while (state.Next())
+			{
+				instance.Update(1.0f / 60.0f);
+
+				//Particles are queued in the renderer every update, flushing them is not measured
+				state.PauseTiming();
+				Engine->renderer3D->DrawAllParticles();
+				state.ResumeTiming();
+			}
+			state.SetItemsPerIteration(state.size);
+
+			for (uint i = 0; i < emitter.modules.size(); ++i)
+				RELEASE(emitter.modules[i]);
+			RELEASE(gameObject);
+		}
+	}
+}
+
+void Benchmark::RegisterParticleBenchmarks()
+{
+	Register("EmitterInstance/Update", Particles::EmitterInstanceUpdate, { 1000, 10000, 100000 });
+}
@@ -0,0 +1,1035 @@
+#include "Benchmark.h"
+#include "BenchData.h"
+
+#include "Engine.h"
+#include "M_Resources.h"
+#include "Config.h"
+#include "JSONStream.h"
+#include "GameObject.h"
+#include "SceneGenerator.h"
+#include "M_FileSystem.h"
+#include "MemoryTracker.h"
+#include "Compression.h"
+#include "IOService.h"
+
+#include "I_Meshes.h"
+#include "I_Animations.h"
+#include "I_Scenes.h"
+
+#include "R_Mesh.h"
+#include "R_Animation.h"
+#include "R_Scene.h"
+#include "R_Model.h"
+#include "ResourceBase.h"
+#include "C_Mesh.h"
+
+#include <filesystem>
+#include <fstream>
+#include <deque>
+#include <thread>
+#include <atomic>
+
+namespace Benchmark
+{
+	namespace Resources
+	{
+		//Same content as a generated stress scene with 'count' GameObjects
+		void GenerateScene(uint count, R_Scene* scene)
+		{
+			SceneGenerator::Settings settings;
+			settings.objectCount = count;
+			settings.meshCount = settings.materialCount = 0;
+
+			SceneGenerator::Stats stats;
+			SceneGenerator::Generate(settings, scene, stats);
+		}
+
+		//Serialized scene with 'count' game objects, as saved by Importer::Scenes: binary or json
+		uint CreateSceneBuffer(uint count, char** buffer, bool json = false)
+		{
+			R_Scene scene;
+			GenerateScene(count, &scene);
+
+			uint size = json ? Importer::Scenes::SaveJSON(&scene, buffer) : Importer::Scenes::Save(&scene, buffer);
+			RELEASE(scene.root);
+			return size;
+		}
+
+		void ConfigParse(State& state)
+		{
+			char* buffer = nullptr;
+			uint size = CreateSceneBuffer(state.size, &buffer, true);
+
+			while (state.Next())
+			{
+				Config config(buffer);
+				DoNotOptimize(config.GetArray("GameObjects").GetSize());
+			}
+			state.SetItemsPerIteration(size);
+
+			RELEASE_ARRAY(buffer);
+		}
+
+		void ConfigSerialize(State& state)
+		{
+			char* buffer = nullptr;
+			CreateSceneBuffer(state.size, &buffer, true);
+			Config config(buffer);
+			RELEASE_ARRAY(buffer);
+
+			uint size = 0;
+			while (state.Next())
+			{
+				size = config.Serialize(&buffer);
+				DoNotOptimize(buffer);
+				RELEASE_ARRAY(buffer);
+			}
+			state.SetItemsPerIteration(size);
+		}
+
+		//Attributes of a json scene, the ones Importer::Scenes read from its Config tree before scenes were streamed
+		template <typename Key>
+		struct SceneKeys
+		{
+			Key gameObjects, uid, parentUID, name, active, isStatic, openInHierarchy, translation, rotation, scale;
+			Key components, componentType, hasResource, ID;
+		};
+
+		template <typename Key>
+		uint64 ReadSceneConfig(const Config& file, const SceneKeys<Key>& keys)
+		{
+			uint64 ret = 0;
+			Config_Array gameObjects = file.GetArray(keys.gameObjects);
+			for (uint i = 0; i < gameObjects.GetSize(); ++i)
+			{
+				Config node = gameObjects.GetNode(i);
+				ret += (uint64)node.GetNumber(keys.uid) + (uint64)node.GetNumber(keys.parentUID) + node.GetString(keys.name).size();
+				ret += node.GetBool(keys.active) + node.GetBool(keys.isStatic) + node.GetBool(keys.openInHierarchy, false);
+				ret += (uint64)(node.GetArray(keys.translation).GetFloat3(0).x + node.GetArray(keys.rotation).GetQuat(0).w + node.GetArray(keys.scale).GetFloat3(0).y);
+
+				Config_Array components = node.GetArray(keys.components);
+				for (uint c = 0; c < components.GetSize(); ++c)
+				{
+					Config comp = components.GetNode(c);
+					ret += (uint64)comp.GetNumber(keys.componentType) + comp.GetBool(keys.hasResource) + (uint64)comp.GetNumber(keys.ID);
+				}
+			}
+			return ret;
+		}
+
+		template <typename Key>
+		void ReadScene(State& state, const SceneKeys<Key>& keys)
+		{
+			char* buffer = nullptr;
+			CreateSceneBuffer(state.size, &buffer, true);
+			Config config(buffer);
+			RELEASE_ARRAY(buffer);
+
+			while (state.Next())
+				DoNotOptimize(ReadSceneConfig(config, keys));
+			state.SetItemsPerIteration(state.size);
+		}
+
+		//Looks every attribute up by name, comparing it with each attribute of the object
+		void ConfigRead(State& state)
+		{
+			const SceneKeys<const char*> keys = { "GameObjects", "UID", "ParentUID", "Name", "Active", "Static", "OpenInHierarchy",
+				"Translation", "Rotation", "Scale", "Components", "ComponentType", "HasResource", "ID" };
+			ReadScene(state, keys);
+		}
+
+		//Same lookups with precomputed keys: each one finds its attribute in the slot it was last found at
+		void ConfigReadKeys(State& state)
+		{
+			static const SceneKeys<ConfigKey> keys = { "GameObjects", "UID", "ParentUID", "Name", "Active", "Static", "OpenInHierarchy",
+				"Translation", "Rotation", "Scale", "Components", "ComponentType", "HasResource", "ID" };
+			ReadScene(state, keys);
+		}
+
+		//Every token of the same text Config/Parse reads, without building a tree
+		void JSONParse(State& state)
+		{
+			char* buffer = nullptr;
+			uint size = CreateSceneBuffer(state.size, &buffer, true);
+
+			while (state.Next())
+			{
+				JSONReader reader(buffer, size);
+				uint tokens = 0;
+				while (reader.Next() != JSONReader::Token::END && reader.HasError() == false)
+					++tokens;
+				DoNotOptimize(tokens);
+			}
+			state.SetItemsPerIteration(size);
+
+			RELEASE_ARRAY(buffer);
+		}
+
+		//parson's own serializer on the tree Config/Serialize writes: it measures the text before writing it
+		void JSONSerializeParson(State& state)
+		{
+			char* buffer = nullptr;
+			CreateSceneBuffer(state.size, &buffer, true);
+			JSON_Value* root = json_parse_string(buffer);
+			RELEASE_ARRAY(buffer);
+
+			uint size = 0;
+			while (state.Next())
+			{
+				size = (uint)json_serialization_size_pretty(root);
+				buffer = new char[size];
+				json_serialize_to_buffer_pretty(root, buffer, size);
+				DoNotOptimize(buffer);
+				RELEASE_ARRAY(buffer);
+			}
+			state.SetItemsPerIteration(size);
+
+			json_value_free(root);
+		}
+
+		void LoadScene(State& state, bool json)
+		{
+			char* buffer = nullptr;
+			uint size = CreateSceneBuffer(state.size, &buffer, json);
+
+			R_Scene scene;
+			RELEASE(scene.root);
+
+			while (state.Next())
+			{
+				Importer::Scenes::Load(buffer, size, &scene);
+
+				state.PauseTiming();
+				RELEASE(scene.root);
+				state.ResumeTiming();
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE_ARRAY(buffer);
+		}
+
+		void ScenesLoad(State& state)
+		{
+			LoadScene(state, false);
+		}
+
+		void ScenesLoadJSON(State& state)
+		{
+			LoadScene(state, true);
+		}
+
+		void SaveScene(State& state, bool json)
+		{
+			R_Scene scene;
+			GenerateScene(state.size, &scene);
+
+			while (state.Next())
+			{
+				char* buffer = nullptr;
+				if (json)
+					Importer::Scenes::SaveJSON(&scene, &buffer);
+				else
+					Importer::Scenes::Save(&scene, &buffer);
+				DoNotOptimize(buffer);
+				RELEASE_ARRAY(buffer);
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE(scene.root);
+		}
+
+		void ScenesSave(State& state)
+		{
+			SaveScene(state, false);
+		}
+
+		void ScenesSaveJSON(State& state)
+		{
+			SaveScene(state, true);
+		}
+
+		void MeshesLoad(State& state)
+		{
+			LCG random(6);
+			ResourceBase base(ResourceType::MESH, "Benchmark.fbx", "Mesh", 1);
+			R_Mesh* source = Data::CreateMesh(state.size, 32, &base, random);
+
+			char* buffer = nullptr;
+			Importer::Meshes::Save(source, &buffer);
+			RELEASE(source);
+
+			while (state.Next())
+			{
+				R_Mesh* mesh = new R_Mesh();
+				mesh->baseData = &base;
+				Importer::Meshes::Load(buffer, mesh);
+
+				state.PauseTiming();
+				RELEASE(mesh);
+				state.ResumeTiming();
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE_ARRAY(buffer);
+		}
+
+		void AnimationsLoad(State& state)
+		{
+			const uint channelCount = 50;
+
+			LCG random(7);
+			ResourceBase base(ResourceType::ANIMATION, "Benchmark.fbx", "Animation", 1);
+			R_Animation* source = Data::CreateAnimation(channelCount, state.size, &base, random);
+
+			char* buffer = nullptr;
+			Importer::Animations::Save(source, &buffer);
+			RELEASE(source);
+
+			while (state.Next())
+			{
+				R_Animation* animation = new R_Animation();
+				animation->baseData = &base;
+				Importer::Animations::Load(buffer, animation);
+
+				state.PauseTiming();
+				RELEASE(animation);
+				state.ResumeTiming();
+			}
+			state.SetItemsPerIteration(channelCount * state.size);
+
+			RELEASE_ARRAY(buffer);
+		}
+
+		//Model library file with 'count' nodes, as saved by Importer::Models: binary or json
+		uint CreateModelBuffer(uint count, char** buffer, bool json = false)
+		{
+			//Node hierarchy of an imported model, parents listed before their children
+			LCG random(8);
+			R_Model model;
+			for (uint i = 0; i < count; ++i)
+			{
+				uint parentID = i > 0 ? random.Int(0, i - 1) + 1 : 0;
+				model.nodes.push_back(ModelNode(i + 1, ("Node_" + std::to_string(i)).c_str(), Data::RandomPosition(random, 10.0f), float3::one, Quat::identity, parentID));
+				model.nodes.back().meshID = random.Int(0, 63);
+				model.nodes.back().materialID = random.Int(0, 15);
+			}
+			return (uint)(json ? Importer::Models::SaveJSON(&model, buffer) : Importer::Models::Save(&model, buffer));
+		}
+
+		//Instantiates the model hierarchy, as M_SceneManager::LoadModel does with a loaded model
+		void LoadModel(State& state, bool json)
+		{
+			char* buffer = nullptr;
+			uint size = CreateModelBuffer(state.size, &buffer, json);
+
+			while (state.Next())
+			{
+				R_Model model;
+				Importer::Models::Load(buffer, size, &model);
+
+				state.PauseTiming();
+				RELEASE(model.root);
+				state.ResumeTiming();
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE_ARRAY(buffer);
+		}
+
+		void ModelsLoad(State& state)
+		{
+			LoadModel(state, false);
+		}
+
+		void ModelsLoadJSON(State& state)
+		{
+			LoadModel(state, true);
+		}
+
+		//Library file content of a resource type, as saved by its importer. 'size' scales the content like in the load cases
+		uint CreateLibraryBuffer(ResourceType type, uint size, char** buffer)
+		{
+			LCG random(8);
+			ResourceBase base(type, "Benchmark.fbx", "Resource", 1);
+			uint ret = 0;
+			switch (type)
+			{
+				case ResourceType::MESH:
+				{
+					R_Mesh* mesh = Data::CreateMesh(size, 32, &base, random);
+					ret = (uint)Importer::Meshes::Save(mesh, buffer);
+					RELEASE(mesh);
+					break;
+				}
+				case ResourceType::ANIMATION:
+				{
+					R_Animation* animation = Data::CreateAnimation(50, size, &base, random);
+					ret = (uint)Importer::Animations::Save(animation, buffer);
+					RELEASE(animation);
+					break;
+				}
+				case ResourceType::MODEL: ret = CreateModelBuffer(size, buffer); break;
+				case ResourceType::SCENE: ret = CreateSceneBuffer(size, buffer); break;
+				default: break;
+			}
+			return ret;
+		}
+
+		//Decode throughput, in bytes of library file per second, and compression ratio of a library file
+		void RunDecompress(State& state, ResourceType type)
+		{
+			char* buffer = nullptr;
+			uint size = CreateLibraryBuffer(type, state.size, &buffer);
+
+			char* blob = nullptr;
+			uint64 blobSize = Compression::CompressBlob(buffer, size, &blob);
+			if (blobSize == 0)
+			{
+				LOG("[error] Compression benchmark: library file does not compress");
+				RELEASE_ARRAY(buffer);
+				return;
+			}
+
+			char* destination = new char[size];
+			if (Compression::DecompressBlob(blob, blobSize, destination) == false || memcmp(destination, buffer, size) != 0)
+				LOG("[error] Compression benchmark: decoded library file does not match the original");
+
+			while (state.Next())
+			{
+				Compression::DecompressBlob(blob, blobSize, destination);
+				DoNotOptimize(destination[0]);
+			}
+			state.SetItemsPerIteration(size);
+			state.SetRatio((double)size / blobSize);
+
+			RELEASE_ARRAY(destination);
+			RELEASE_ARRAY(blob);
+			RELEASE_ARRAY(buffer);
+		}
+
+		void DecompressMeshes(State& state)		{ RunDecompress(state, ResourceType::MESH); }
+		void DecompressAnimations(State& state)	{ RunDecompress(state, ResourceType::ANIMATION); }
+		void DecompressModels(State& state)		{ RunDecompress(state, ResourceType::MODEL); }
+		void DecompressScenes(State& state)		{ RunDecompress(state, ResourceType::SCENE); }
+
+		//Generated project with 'count' scene assets, shared by the resource database cases
+		std::string GetAssetsProject(uint count, std::vector<std::string>* paths)
+		{
+			std::string project = GetScratchDir() + "/Assets_" + std::to_string(count);
+			Data::CreateAssetsProject(project.c_str(), count, 100, paths);
+			return project;
+		}
+
+		void FindResourceBase(State& state)
+		{
+			//The lookup runs over a generated project with 'size' assets
+			std::vector<std::string> paths;
+			std::string project = GetAssetsProject(state.size, &paths);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				LCG random(8);
+				std::vector<std::string> queries;
+				for (uint i = 0; i < 256; ++i)
+					queries.push_back(paths[random.Int(0, paths.size() - 1)]);
+
+				uint index = 0;
+				while (state.Next())
+				{
+					DoNotOptimize(Engine->moduleResources->FindResourceBase(queries[index++ % queries.size()].c_str()));
+				}
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void Startup(State& state)
+		{
+			std::string project = GetAssetsProject(state.size, nullptr);
+
+			//The first start imports the generated folders, only starts with every .meta in place are measured
+			StopEngine();
+			StartEngine(project.c_str());
+
+			while (state.Next())
+			{
+				state.PauseTiming();
+				StopEngine();
+				state.ResumeTiming();
+
+				StartEngine(project.c_str());
+			}
+			state.SetItemsPerIteration(state.size);
+
+			StopEngine();
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		//Project settings with 'threads' import threads (0 for every core), read by the next start
+		void SetImportThreads(const char* projectDir, uint threads)
+		{
+			std::ofstream(std::filesystem::path(projectDir) / "Engine" / "Settings.JSON") << "{ \"EditorState\": { \"Resources\": { \"Import Threads\": " << threads << " } } }";
+		}
+
+		void RunImportStartup(State& state, uint threads)
+		{
+			//Every start imports all assets, as in a fresh checkout without .meta files
+			std::string project = GetScratchDir() + "/Import_" + std::to_string(state.size);
+			Data::CreateAssetsProject(project.c_str(), state.size, 100);
+
+			StopEngine();
+			while (state.Next())
+			{
+				state.PauseTiming();
+				StopEngine();
+				Data::RemoveImportedData(project.c_str());
+				SetImportThreads(project.c_str(), threads);
+				state.ResumeTiming();
+
+				StartEngine(project.c_str());
+			}
+			state.SetItemsPerIteration(state.size);
+
+			StopEngine();
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void ImportStartup(State& state)
+		{
+			RunImportStartup(state, 0);
+		}
+
+		void ImportStartupSerial(State& state)
+		{
+			RunImportStartup(state, 1);
+		}
+
+		//Scene asset of a generated project filled with 'count' GameObjects, modified and saved every iteration
+		void RunSaveScene(State& state, bool background)
+		{
+			std::string project = GetAssetsProject(1, nullptr);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				ResourceHandle<R_Scene> hScene((1ull << 40));
+				GenerateScene(state.size, hScene.Get());
+
+				while (state.Next())
+				{
+					//Only the main thread time is measured: it is the hitch seen by the editor
+					if (background)
+					{
+						hScene.Get()->SetDirty();
+						resources->SaveChangedResources();
+					}
+					else
+						resources->SaveResource(hScene.Get());
+
+					state.PauseTiming();
+					Engine->fileSystem->FinishWrites();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(state.size);
+				hScene.Free();
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void SaveChanged(State& state)
+		{
+			RunSaveScene(state, true);
+		}
+
+		void SaveSync(State& state)
+		{
+			RunSaveScene(state, false);
+		}
+
+		//Generated project with 'count' meshes of 4096 vertices, shared by the resource loading cases
+		std::string GetMeshProject(uint count, std::vector<uint64>* meshIDs)
+		{
+			std::string project = GetScratchDir() + "/Meshes_" + std::to_string(count);
+			Data::CreateMeshProject(project.c_str(), count, 4096, meshIDs);
+			return project;
+		}
+
+		void LoadSync(State& state)
+		{
+			std::vector<uint64> meshIDs;
+			std::string project = GetMeshProject(state.size, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				std::vector<Resource*> loaded;
+				while (state.Next())
+				{
+					for (uint i = 0; i < meshIDs.size(); ++i)
+						loaded.push_back(resources->RequestResource(meshIDs[i]));
+
+					state.PauseTiming();
+					for (uint i = 0; i < loaded.size(); ++i)
+						resources->ReleaseResource(loaded[i]);
+					loaded.clear();
+					resources->ClearCache();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		//Loads a few large meshes per iteration, from a mapping of their library file or from a read copy
+		//The peak reported is heap memory: read buffers plus the mesh arrays. Mapped pages belong to the page cache
+		void LoadLargeMeshes(State& state, bool mapped)
+		{
+			const uint meshCount = 4;
+			std::vector<uint64> meshIDs;
+			std::string project = GetScratchDir() + "/LargeMeshes_" + std::to_string(state.size);
+			Data::CreateMeshProject(project.c_str(), meshCount, state.size, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				resources->mapLibraryFiles = mapped;
+
+				MemoryTracker::Tag meshTag = MemoryTracker::GetResourceTag(ResourceType::MESH);
+				std::vector<Resource*> loaded;
+				while (state.Next())
+				{
+					state.PauseTiming();
+					uint64 meshBytes = MemoryTracker::GetStats(meshTag).liveBytes;
+					MemoryTracker::ResetPeaks();
+					state.ResumeTiming();
+
+					for (uint i = 0; i < meshIDs.size(); ++i)
+						loaded.push_back(resources->RequestResource(meshIDs[i]));
+
+					state.PauseTiming();
+					state.SetPeakBytes(MemoryTracker::GetStats(MemoryTracker::Tag::IMPORTER).peakBytes + MemoryTracker::GetStats(meshTag).liveBytes - meshBytes);
+					for (uint i = 0; i < loaded.size(); ++i)
+						resources->ReleaseResource(loaded[i]);
+					loaded.clear();
+					resources->ClearCache();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration((uint64)meshCount * state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void LoadLargeMeshesMapped(State& state)
+		{
+			LoadLargeMeshes(state, true);
+		}
+
+		void LoadLargeMeshesRead(State& state)
+		{
+			LoadLargeMeshes(state, false);
+		}
+
+		//Loads 'size' small meshes per iteration, from loose library files or from a cooked library pack
+		void LoadSmallMeshes(State& state, bool packed)
+		{
+			std::vector<uint64> meshIDs;
+			std::string project = GetScratchDir() + (packed ? "/PackedMeshes_" : "/LooseMeshes_") + std::to_string(state.size);
+			Data::CreateMeshProject(project.c_str(), state.size, 256, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				if (packed && Engine->fileSystem->HasLibraryPack() == false && resources->CookLibrary() == false)
+					LOG("[error] Could not cook the library of %s", project.c_str());
+
+				std::vector<Resource*> loaded;
+				while (state.Next())
+				{
+					for (uint i = 0; i < meshIDs.size(); ++i)
+						loaded.push_back(resources->RequestResource(meshIDs[i]));
+
+					state.PauseTiming();
+					for (uint i = 0; i < loaded.size(); ++i)
+						resources->ReleaseResource(loaded[i]);
+					loaded.clear();
+					resources->ClearCache();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void LoadLoose(State& state)
+		{
+			LoadSmallMeshes(state, false);
+		}
+
+		void LoadPacked(State& state)
+		{
+			LoadSmallMeshes(state, true);
+		}
+
+		void LoadAsync(State& state)
+		{
+			std::vector<uint64> meshIDs;
+			std::string project = GetMeshProject(state.size, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				while (state.Next())
+				{
+					for (uint i = 0; i < meshIDs.size(); ++i)
+						resources->RequestResourceAsync(meshIDs[i]);
+					resources->FinishAsyncLoads();
+
+					state.PauseTiming();
+					for (uint i = 0; i < meshIDs.size(); ++i)
+						resources->ReleaseAsyncRequest(meshIDs[i]);
+					resources->ClearCache();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void LoadCached(State& state)
+		{
+			//Same as LoadSync, released meshes stay in the cache between iterations
+			std::vector<uint64> meshIDs;
+			std::string project = GetMeshProject(state.size, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				std::vector<Resource*> loaded;
+				while (state.Next())
+				{
+					for (uint i = 0; i < meshIDs.size(); ++i)
+						loaded.push_back(resources->RequestResource(meshIDs[i]));
+
+					state.PauseTiming();
+					for (uint i = 0; i < loaded.size(); ++i)
+						resources->ReleaseResource(loaded[i]);
+					loaded.clear();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		//Loads every mesh used by the GameObjects of a loaded scene, as the first frame rendering it would
+		void GetSceneMeshes(GameObject* gameObject)
+		{
+			if (C_Mesh* mesh = gameObject->GetComponent<C_Mesh>())
+				DoNotOptimize(mesh->rMeshHandle.Get());
+
+			for (uint i = 0; i < gameObject->childs.size(); ++i)
+				GetSceneMeshes(gameObject->childs[i]);
+		}
+
+		//Scene with 4 GameObjects per mesh of a generated mesh project, loaded with all its meshes every iteration
+		void RunLoadScene(State& state, bool prefetch)
+		{
+			std::vector<uint64> meshIDs;
+			std::string project = GetMeshProject(state.size, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+				resources->prefetchDependencies = prefetch;
+
+				const char* scenePath = "Assets/Generated/Meshes.scene";
+				const ResourceBase* sceneBase = resources->FindResourceBase(scenePath);
+				uint64 sceneID = sceneBase ? sceneBase->ID : 0;
+				if (sceneID == 0)
+				{
+					SceneGenerator::Settings settings;
+					settings.objectCount = state.size * 4;
+					settings.meshCount = state.size;
+					settings.materialCount = 0;
+					sceneID = SceneGenerator::GenerateAsset(settings, scenePath, nullptr);
+				}
+
+				while (state.Next())
+				{
+					R_Scene* scene = (R_Scene*)resources->RequestResource(sceneID);
+					GetSceneMeshes(scene->root);
+
+					state.PauseTiming();
+					resources->ReleaseResource(scene);
+					resources->FinishAsyncLoads();
+					resources->Update();
+					resources->ClearCache();
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(state.size);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		void LoadScenePrefetch(State& state)
+		{
+			RunLoadScene(state, true);
+		}
+
+		void LoadSceneSerial(State& state)
+		{
+			RunLoadScene(state, false);
+		}
+
+		//Worker threads resolve and free handles to the meshes of a generated project while the main thread requests, releases,
+		//evicts and updates them. Run it on a ThreadSanitizer build to check the handles and the registry
+		void ConcurrentAcquire(State& state)
+		{
+			const uint workerCount = 4;
+			const uint operationsPerWorker = 10000;
+
+			std::vector<uint64> meshIDs;
+			std::string project = GetMeshProject(state.size, &meshIDs);
+
+			StopEngine();
+			if (StartEngine(project.c_str()))
+			{
+				M_Resources* resources = Engine->moduleResources;
+
+				//Handles resolved by several workers at once: only one instance is kept per handle
+				std::vector<ResourceHandle<R_Mesh>> shared(meshIDs.begin(), meshIDs.end());
+				uint round = 0;
+
+				while (state.Next())
+				{
+					std::atomic<uint> running(workerCount);
+					std::vector<std::thread> workers;
+					for (uint w = 0; w < workerCount; ++w)
+					{
+						workers.push_back(std::thread([&, w]()
+						{
+							LCG random(round * workerCount + w + 1);
+							for (uint i = 0; i < operationsPerWorker; ++i)
+							{
+								uint index = random.Int() % meshIDs.size();
+								ResourceHandle<R_Mesh> handle(meshIDs[index]);
+								if (const R_Mesh* mesh = handle.Get())
+									DoNotOptimize(mesh->GetCPUMemory());
+
+								ResourceHandle<R_Mesh> copy(handle);
+
+								//Shared handles keep their meshes loaded until the round ends: only a quarter of them is used
+								if (index % 4 == 0)
+								{
+									if (const R_Mesh* mesh = shared[index].Get())
+										DoNotOptimize(mesh->GetID());
+								}
+
+								//Gives the other threads a chance to run in between, even on a single core
+								if (i % 64 == 0)
+									std::this_thread::yield();
+							}
+							running--;
+						}));
+					}
+
+					//Main thread side: a moving window of half the meshes stays loaded, so workers take the last instance of some
+					//meshes and race with the loads, releases, deferred releases and evictions
+					std::deque<Resource*> loaded;
+					for (uint step = 0; running.load() > 0; ++step)
+					{
+						loaded.push_back(resources->RequestResource(meshIDs[step % meshIDs.size()]));
+						if (loaded.size() > meshIDs.size() / 2)
+						{
+							resources->ReleaseResource(loaded.front());
+							loaded.pop_front();
+						}
+
+						resources->Update();
+						if (step % 8 == 0)
+							resources->ClearCache();
+					}
+
+					for (uint i = 0; i < loaded.size(); ++i)
+						resources->ReleaseResource(loaded[i]);
+
+					for (uint w = 0; w < workerCount; ++w)
+						workers[w].join();
+
+					state.PauseTiming();
+					for (uint i = 0; i < shared.size(); ++i)
+						shared[i].Free();
+					resources->Update();
+					resources->ClearCache();
+
+					//Every instance is released: nothing can stay loaded
+					for (uint i = 0; i < meshIDs.size(); ++i)
+					{
+						if (resources->GetLoadState(meshIDs[i]) == ResourceLoadState::READY)
+							LOG("[error] Concurrent acquire: mesh %llu still loaded after every instance was released", meshIDs[i]);
+					}
+					round++;
+					state.ResumeTiming();
+				}
+				state.SetItemsPerIteration(workerCount * operationsPerWorker);
+			}
+			StopEngine();
+
+			StartEngine(GetDefaultProjectDir().c_str());
+		}
+
+		//'count' library sized files of 16KB, read by the I/O benchmarks
+		std::string CreateReadFiles(uint count, std::vector<std::string>& paths)
+		{
+			std::string directory = GetScratchDir() + "/IOFiles_" + std::to_string(count);
+			std::filesystem::create_directories(directory);
+
+			std::vector<char> content(16 * 1024);
+			for (uint i = 0; i < content.size(); ++i)
+				content[i] = (char)(i * 31);
+
+			for (uint i = 0; i < count; ++i)
+			{
+				paths.push_back(directory + "/" + std::to_string(i));
+				if (std::filesystem::exists(paths.back()) == false)
+					std::ofstream(paths.back(), std::ios::binary).write(content.data(), content.size());
+			}
+			return directory;
+		}
+
+		//Reads 'size' files per iteration through a standalone service, submitted as a single batch
+		void ReadBatch(State& state, bool useRing)
+		{
+			std::vector<std::string> paths;
+			CreateReadFiles(state.size, paths);
+
+			IOService io(2, [](IORequest& request) { request.realPath = request.file; return false; },
+				[](const IORequest&) { return false; }, useRing);
+			if (useRing && io.IsUsingRing() == false)
+				LOG("[Warning] io_uring is not available: reads run with blocking calls");
+
+			std::atomic<uint64> readBytes{ 0 };
+			std::vector<IORequest*> batch;
+			while (state.Next())
+			{
+				for (uint i = 0; i < paths.size(); ++i)
+				{
+					IORequest* request = new IORequest();
+					request->file = paths[i];
+					request->completeOnMainThread = false;
+					request->onComplete = [&io, &readBytes](IORequest& read)
+					{
+						readBytes += read.size;
+						io.ReleaseBuffer(read.buffer, read.capacity);
+					};
+					batch.push_back(request);
+				}
+				io.Submit(batch);
+				batch.clear();
+				io.Wait();
+			}
+
+			if (readBytes == 0)
+				LOG("[error] I/O read batch: no file was read");
+			state.SetItemsPerIteration(state.size);
+		}
+
+		void IOReadBatch(State& state)
+		{
+			ReadBatch(state, true);
+		}
+
+		void IOReadBatchThreads(State& state)
+		{
+			ReadBatch(state, false);
+		}
+
+		//Same files read one after the other in the calling thread
+		void IOReadSync(State& state)
+		{
+			std::vector<std::string> paths;
+			CreateReadFiles(state.size, paths);
+
+			uint64 readBytes = 0;
+			std::vector<char> buffer;
+			while (state.Next())
+			{
+				for (uint i = 0; i < paths.size(); ++i)
+				{
+					std::ifstream file(paths[i], std::ios::binary | std::ios::ate);
+					buffer.resize((size_t)file.tellg());
+					file.seekg(0);
+					file.read(buffer.data(), buffer.size());
+					readBytes += buffer.size();
+				}
+			}
+
+			DoNotOptimize(readBytes);
+			state.SetItemsPerIteration(state.size);
+		}
+	}
+}
+
+void Benchmark::RegisterResourceBenchmarks()
+{
+	Register("Config/Parse", Resources::ConfigParse, { 100, 1000, 10000 });
+	Register("Config/Serialize", Resources::ConfigSerialize, { 100, 1000, 10000 });
+	Register("Config/Read", Resources::ConfigRead, { 100, 1000, 10000 });
+	Register("Config/ReadKeys", Resources::ConfigReadKeys, { 100, 1000, 10000 });
+	Register("JSON/Parse", Resources::JSONParse, { 100, 1000, 10000 });
+	Register("JSON/SerializeParson", Resources::JSONSerializeParson, { 100, 1000, 10000 });
+	Register("Importer/ScenesLoad", Resources::ScenesLoad, { 100, 1000, 10000 });
+	Register("Importer/ScenesLoadJSON", Resources::ScenesLoadJSON, { 100, 1000, 10000 });
+	Register("Importer/ScenesSave", Resources::ScenesSave, { 100, 1000, 10000 });
+	Register("Importer/ScenesSaveJSON", Resources::ScenesSaveJSON, { 100, 1000, 10000 });
+	Register("Importer/ModelsLoad", Resources::ModelsLoad, { 100, 1000, 10000 });
+	Register("Importer/ModelsLoadJSON", Resources::ModelsLoadJSON, { 100, 1000, 10000 });
+	Register("Importer/MeshesLoad", Resources::MeshesLoad, { 1000, 10000, 100000 });
+	Register("Importer/AnimationsLoad", Resources::AnimationsLoad, { 10, 100, 1000 });
+	Register("Compression/Meshes", Resources::DecompressMeshes, { 1000, 10000, 100000 });
+	Register("Compression/Animations", Resources::DecompressAnimations, { 10, 100, 1000 });
+	Register("Compression/Models", Resources::DecompressModels, { 100, 1000, 10000 });
+	Register("Compression/Scenes", Resources::DecompressScenes, { 100, 1000, 10000 });
+	Register("Resources/FindResourceBase", Resources::FindResourceBase, { 1000, 10000, 50000 });
+	Register("Resources/Startup", Resources::Startup, { 1000, 10000, 50000 });
+	Register("Resources/ImportStartup", Resources::ImportStartup, { 1000, 10000 });
+	Register("Resources/ImportStartupSerial", Resources::ImportStartupSerial, { 1000, 10000 });
+	Register("Resources/SaveChanged", Resources::SaveChanged, { 1000, 10000 });
+	Register("Resources/SaveSync", Resources::SaveSync, { 1000, 10000 });
+	Register("Resources/LoadSync", Resources::LoadSync, { 16, 64, 256 });
+	Register("Resources/LoadAsync", Resources::LoadAsync, { 16, 64, 256 });
+	Register("Resources/LoadLoose", Resources::LoadLoose, { 256, 1024, 4096 });
+	Register("Resources/LoadPacked", Resources::LoadPacked, { 256, 1024, 4096 });
+	Register("Resources/LoadLargeMeshesMapped", Resources::LoadLargeMeshesMapped, { 65536, 262144, 1048576 });
+	Register("Resources/LoadLargeMeshesRead", Resources::LoadLargeMeshesRead, { 65536, 262144, 1048576 });
+	Register("Resources/LoadCached", Resources::LoadCached, { 16, 64, 256 });
+	Register("Resources/LoadScenePrefetch", Resources::LoadScenePrefetch, { 16, 64, 256 });
+	Register("Resources/LoadSceneSerial", Resources::LoadSceneSerial, { 16, 64, 256 });
+	Register("Resources/ConcurrentAcquire", Resources::ConcurrentAcquire, { 16, 64 });
+	Register("IO/ReadBatch", Resources::IOReadBatch, { 64, 256, 1024 });
+	Register("IO/ReadBatchThreads", Resources::IOReadBatchThreads, { 64, 256, 1024 });
+	Register("IO/ReadSync", Resources::IOReadSync, { 64, 256, 1024 });
+}
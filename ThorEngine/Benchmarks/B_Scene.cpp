@@ -0,0 +1,104 @@
+#include "Benchmark.h"
+#include "BenchData.h"
+
+#include "GameObject.h"
+#include "Quadtree.h"
+
+#include "MathGeoLib/src/Geometry/Frustum.h"
+
+namespace Benchmark
+{
+	namespace Scene
+	{
+		//Same bounds used by M_SceneManager
+		const AABB quadtreeBox(vec(-80, -30, -80), vec(80, 30, 80));
+
+		GameObject* CreateStaticObjects(uint count, LCG& random)
+		{
+			GameObject* root = new GameObject(nullptr, "Root");
+			for (uint i = 0; i < count; ++i)
+			{
+				float3 position(random.Float(-78.0f, 78.0f), random.Float(-28.0f, 28.0f), random.Float(-78.0f, 78.0f));
+				new GameObject(root, "Static", position);
+			}
+			root->OnUpdateTransform();
+			return root;
+		}
+
+		void QuadtreeInsert(State& state)
+		{
+			LCG random(1);
+			GameObject* root = CreateStaticObjects(state.size, random);
+
+			while (state.Next())
+			{
+				Quadtree quadtree(quadtreeBox);
+				for (uint i = 0; i < root->childs.size(); ++i)
+					quadtree.AddGameObject(root->childs[i]);
+				DoNotOptimize(quadtree);
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE(root);
+		}
+
+		void QuadtreeQueryFrustum(State& state)
+		{
+			LCG random(2);
+			GameObject* root = CreateStaticObjects(state.size, random);
+
+			Quadtree quadtree(quadtreeBox);
+			for (uint i = 0; i < root->childs.size(); ++i)
+				quadtree.AddGameObject(root->childs[i]);
+
+			//Camera orbiting the scene, same setup as C_Camera
+			const uint frustumCount = 64;
+			std::vector<Frustum> frustums(frustumCount);
+			for (uint i = 0; i < frustumCount; ++i)
+			{
+				float angle = 6.28f * i / frustumCount;
+				float3 position(cos(angle) * 60.0f, 10.0f, sin(angle) * 60.0f);
+
+				frustums[i].SetKind(FrustumSpaceGL, FrustumRightHanded);
+				frustums[i].SetViewPlaneDistances(0.1f, 100.0f);
+				frustums[i].SetPerspective(1.0f, 1.0f);
+				float3 front = (-position).Normalized();
+				float3 up = front.Cross(float3::unitY).Cross(front).Normalized();
+				frustums[i].SetFrame(position, front, up);
+			}
+
+			std::vector<const GameObject*> candidates;
+			uint index = 0;
+			while (state.Next())
+			{
+				candidates.clear();
+				quadtree.CollectCandidates(candidates, frustums[index++ % frustumCount]);
+				DoNotOptimize(candidates.data());
+			}
+
+			RELEASE(root);
+		}
+
+		void OnUpdateTransform(State& state)
+		{
+			LCG random(3);
+			GameObject* root = new GameObject(nullptr, "Root");
+			Data::CreateHierarchy(root, state.size, 4, random);
+
+			while (state.Next())
+			{
+				root->OnUpdateTransform();
+			}
+			state.SetItemsPerIteration(state.size);
+
+			RELEASE(root);
+		}
+	}
+}
+
+void Benchmark::RegisterSceneBenchmarks()
+{
+	Register("Quadtree/Insert", Scene::QuadtreeInsert, { 1000, 10000, 50000 });
+	Register("Quadtree/QueryFrustum", Scene::QuadtreeQueryFrustum, { 1000, 10000, 50000 });
+	Register("GameObject/OnUpdateTransform", Scene::OnUpdateTransform, { 1000, 10000, 100000 });
+}
@@ -0,0 +1,221 @@
+#include "BenchData.h"
+
+#include "GameObject.h"
+#include "R_Mesh.h"
+#include "R_Animation.h"
+#include "ResourceBase.h"
+#include "I_Meshes.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+std::string Benchmark::Data::BoneName(uint index)
+{
+	return std::string("Bone_") + std::to_string(index);
+}
+
+float3 Benchmark::Data::RandomPosition(LCG& random, float extent)
+{
+	return float3(random.Float(-extent, extent), random.Float(-extent, extent), random.Float(-extent, extent));
+}
+
+R_Mesh* Benchmark::Data::CreateMesh(uint vertexCount, uint boneCount, ResourceBase* base, LCG& random)
+{
+	R_Mesh* mesh = new R_Mesh();
+	mesh->baseData = base;
+
+	mesh->buffersSize[R_Mesh::b_vertices] = vertexCount;
+	mesh->buffersSize[R_Mesh::b_normals] = vertexCount;
+	mesh->buffersSize[R_Mesh::b_tex_coords] = vertexCount;
+	mesh->buffersSize[R_Mesh::b_indices] = vertexCount * 3;
+
+	mesh->vertices = new float[vertexCount * 3];
+	mesh->normals = new float[vertexCount * 3];
+	mesh->tex_coords = new float[vertexCount * 2];
+	mesh->indices = new uint[vertexCount * 3];
+
+	for (uint v = 0; v < vertexCount; ++v)
+	{
+		float3 position = RandomPosition(random, 10.0f);
+		float3 normal = position.Normalized();
+		memcpy(&mesh->vertices[v * 3], position.ptr(), sizeof(float) * 3);
+		memcpy(&mesh->normals[v * 3], normal.ptr(), sizeof(float) * 3);
+		mesh->tex_coords[v * 2] = random.Float();
+		mesh->tex_coords[v * 2 + 1] = random.Float();
+	}
+
+	for (uint i = 0; i < vertexCount * 3; ++i)
+		mesh->indices[i] = random.Int(0, vertexCount - 1);
+
+	if (boneCount > 0)
+	{
+		mesh->buffersSize[R_Mesh::b_bone_IDs] = mesh->buffersSize[R_Mesh::b_bone_weights] = vertexCount * 4;
+		mesh->boneIDs = new int[vertexCount * 4];
+		mesh->boneWeights = new float[vertexCount * 4];
+
+		for (uint v = 0; v < vertexCount; ++v)
+		{
+			for (uint w = 0; w < 4; ++w)
+			{
+				mesh->boneIDs[v * 4 + w] = random.Int(0, boneCount - 1);
+				mesh->boneWeights[v * 4 + w] = 0.25f;
+			}
+		}
+
+		mesh->boneTransforms.resize(boneCount);
+		for (uint b = 0; b < boneCount; ++b)
+		{
+			mesh->boneMapping[BoneName(b)] = b;
+			mesh->boneOffsets.push_back(float4x4::Translate(RandomPosition(random, 1.0f)).ToFloat4x4());
+		}
+	}
+
+	mesh->CreateAABB();
+	return mesh;
+}
+
+R_Animation* Benchmark::Data::CreateAnimation(uint channelCount, uint keyCount, ResourceBase* base, LCG& random)
+{
+	R_Animation* animation = new R_Animation();
+	animation->baseData = base;
+	animation->ticksPerSecond = 30.0f;
+	animation->duration = (float)keyCount;
+
+	for (uint c = 0; c < channelCount; ++c)
+	{
+		Channel& channel = animation->channels[BoneName(c)];
+		channel.name = BoneName(c);
+
+		for (uint k = 0; k < keyCount; ++k)
+		{
+			channel.positionKeys[k] = RandomPosition(random, 1.0f);
+			channel.rotationKeys[k] = Quat::RotateAxisAngle(float3::unitY, random.Float(0.0f, 6.28f));
+			channel.scaleKeys[k] = float3::one;
+		}
+	}
+	return animation;
+}
+
+void Benchmark::Data::CreateHierarchy(GameObject* root, uint count, uint fanOut, LCG& random)
+{
+	std::vector<GameObject*> parents;
+	parents.push_back(root);
+
+	uint parentIndex = 0;
+	for (uint i = 0; i < count; ++i)
+	{
+		GameObject* parent = parents[parentIndex];
+		if (parent->childs.size() >= fanOut)
+			parent = parents[++parentIndex];
+
+		std::string name = std::string("GameObject_") + std::to_string(i);
+		Quat rotation = Quat::RotateAxisAngle(float3::unitY, random.Float(0.0f, 6.28f));
+		parents.push_back(new GameObject(parent, name.c_str(), RandomPosition(random, 2.0f), rotation, float3::one));
+	}
+}
+
+void Benchmark::Data::CreateAssetsProject(const char* projectDir, uint assetCount, uint assetsPerFolder, std::vector<std::string>* assetPaths)
+{
+	namespace fs = std::filesystem;
+	std::error_code error;
+
+	fs::path generated = fs::path(projectDir) / "Assets" / "Generated";
+	bool exists = fs::exists(generated, error);
+	fs::create_directories(generated, error);
+
+	for (uint i = 0; i < assetCount; ++i)
+	{
+		std::string folder = std::string("Folder_") + std::to_string(i / assetsPerFolder);
+		std::string name = std::string("Asset_") + std::to_string(i);
+		std::string path = std::string("Assets/Generated/") + folder + "/" + name + ".scene";
+
+		if (assetPaths != nullptr)
+			assetPaths->push_back(path);
+
+		//Generated projects are kept in the scratch directory between runs
+		if (exists)
+			continue;
+
+		if (i % assetsPerFolder == 0)
+			fs::create_directories(generated / folder, error);
+
+		//IDs above 32 bits never collide with the ones generated by M_Resources
+		uint64 ID = (1ull << 40) + i;
+		std::ofstream(fs::path(projectDir) / path) << "{ \"GameObjects\": [ ] }";
+		std::ofstream(fs::path(projectDir) / (path + ".meta")) << "{ \"ID\": " << ID << ", \"Name\": \"" << name
+			<< "\", \"Type\": " << (int)ResourceType::SCENE << ", \"Library file\": \"" << SCENES_PATH << ID << "\", \"Contained Resources\": [ ] }";
+	}
+}
+
+void Benchmark::Data::CreateMeshProject(const char* projectDir, uint meshCount, uint vertexCount, std::vector<uint64>* meshIDs)
+{
+	namespace fs = std::filesystem;
+	std::error_code error;
+
+	fs::path model = fs::path(projectDir) / "Assets" / "Generated" / "Meshes.fbx";
+	bool exists = fs::exists(model, error);
+	fs::create_directories(model.parent_path(), error);
+	fs::create_directories(fs::path(projectDir) / MESHES_PATH, error);
+	fs::create_directories(fs::path(projectDir) / MODELS_PATH, error);
+
+	//IDs above 32 bits never collide with the ones generated by M_Resources
+	uint64 modelID = 1ull << 41;
+	std::ofstream meta;
+	if (exists == false)
+	{
+		std::ofstream(model) << "Generated";
+		//The model is never loaded, its library file only has to exist so the asset is not imported again
+		std::ofstream(fs::path(projectDir) / (MODELS_PATH + std::to_string(modelID))) << "Generated";
+		meta.open(model.string() + ".meta");
+		meta << "{ \"ID\": " << modelID << ", \"Name\": \"Meshes\", \"Type\": " << (int)ResourceType::MODEL
+			<< ", \"Library file\": \"" << MODELS_PATH << modelID << "\", \"Contained Resources\": [ ";
+	}
+
+	LCG random(9);
+	for (uint i = 0; i < meshCount; ++i)
+	{
+		uint64 ID = modelID + 1 + i;
+		if (meshIDs != nullptr)
+			meshIDs->push_back(ID);
+
+		//Generated projects are kept in the scratch directory between runs
+		if (exists)
+			continue;
+
+		std::string name = std::string("Mesh_") + std::to_string(i);
+		meta << (i > 0 ? ", " : "") << "{ \"ID\": " << ID << ", \"Name\": \"" << name << "\", \"Type\": " << (int)ResourceType::MESH
+			<< ", \"Library file\": \"" << MESHES_PATH << ID << "\" }";
+
+		ResourceBase base(ResourceType::MESH, "Assets/Generated/Meshes.fbx", name.c_str(), ID);
+		R_Mesh* mesh = CreateMesh(vertexCount, 32, &base, random);
+
+		char* buffer = nullptr;
+		uint size = Importer::Meshes::Save(mesh, &buffer);
+		std::ofstream(fs::path(projectDir) / (MESHES_PATH + std::to_string(ID)), std::ios::binary).write(buffer, size);
+
+		RELEASE_ARRAY(buffer);
+		RELEASE(mesh);
+	}
+
+	if (exists == false)
+		meta << " ] }";
+}
+
+void Benchmark::Data::RemoveImportedData(const char* projectDir)
+{
+	namespace fs = std::filesystem;
+	std::error_code error;
+
+	std::vector<fs::path> metaFiles;
+	for (fs::recursive_directory_iterator it(fs::path(projectDir) / "Assets", error), end; it != end; it.increment(error))
+	{
+		if (it->path().extension() == ".meta")
+			metaFiles.push_back(it->path());
+	}
+
+	for (uint i = 0; i < metaFiles.size(); ++i)
+		fs::remove(metaFiles[i], error);
+	fs::remove(fs::path(projectDir) / "Assets.meta", error);
+	fs::remove_all(fs::path(projectDir) / "Library", error);
+}
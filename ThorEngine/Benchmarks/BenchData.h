@@ -0,0 +1,49 @@
+#ifndef __BENCH_DATA_H__
+#define __BENCH_DATA_H__
+
+#include "Globals.h"
+#include "MathGeoLib/src/Algorithm/Random/LCG.h"
+#include "MathGeoLib/src/Math/float3.h"
+
+#include <string>
+#include <vector>
+
+class GameObject;
+class R_Mesh;
+class R_Animation;
+struct ResourceBase;
+
+//Deterministic synthetic data used by the benchmark cases
+namespace Benchmark
+{
+	namespace Data
+	{
+		std::string BoneName(uint index);
+
+		//Mesh with 'vertexCount' vertices (and as many triangles), skinned with 4 weights per vertex
+		//to 'boneCount' bones named by BoneName. 'base' is used as the resource base data
+		R_Mesh* CreateMesh(uint vertexCount, uint boneCount, ResourceBase* base, LCG& random);
+
+		//Animation with one channel per bone (BoneName) and 'keyCount' keys per channel and key type
+		R_Animation* CreateAnimation(uint channelCount, uint keyCount, ResourceBase* base, LCG& random);
+
+		//Creates 'count' game objects under 'root', 'fanOut' children per node, breadth first
+		void CreateHierarchy(GameObject* root, uint count, uint fanOut, LCG& random);
+
+		float3 RandomPosition(LCG& random, float extent);
+
+		//Writes 'assetCount' scene assets with their .meta files into 'projectDir'/Assets/Generated,
+		//'assetsPerFolder' per sub folder. Assets are loaded from their .meta without importing.
+		//Fills 'assetPaths' with the assets path relative to the project, if not null
+		void CreateAssetsProject(const char* projectDir, uint assetCount, uint assetsPerFolder, std::vector<std::string>* assetPaths = nullptr);
+
+		//Writes a model asset containing 'meshCount' meshes of 'vertexCount' vertices into 'projectDir'/Assets/Generated,
+		//with its .meta and the meshes library files already in place. Fills 'meshIDs', if not null
+		void CreateMeshProject(const char* projectDir, uint meshCount, uint vertexCount, std::vector<uint64>* meshIDs = nullptr);
+
+		//Removes every .meta in 'projectDir'/Assets and the Library, so the next start imports all assets again
+		void RemoveImportedData(const char* projectDir);
+	}
+}
+
+#endif //__BENCH_DATA_H__
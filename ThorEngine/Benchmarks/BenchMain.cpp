@@ -0,0 +1,129 @@
+#include "Benchmark.h"
+#include "Engine.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <filesystem>
+
+TEngine* Engine = nullptr;
+
+void PrintUsage()
+{
+	printf("Usage: ThorBenchmarks [options]\n");
+	printf("  --list                 List all benchmark cases and their sizes\n");
+	printf("  --filter <text>        Only run the cases whose name contains <text>\n");
+	printf("  --sizes <a,b,...>      Override the sizes of every case\n");
+	printf("  --samples <n>          Timed samples per case and size (default 15)\n");
+	printf("  --min-time <ms>        Minimum duration of each sample (default 20)\n");
+	printf("  --quick                Same as --samples 5 --min-time 5\n");
+	printf("  --out <file>           Save the results as JSON\n");
+	printf("  --baseline <file>      Compare against a results file saved with --out\n");
+	printf("  --threshold <percent>  Regression threshold for --baseline (default 10)\n");
+}
+
+std::vector<uint> ParseSizes(const char* text)
+{
+	std::vector<uint> sizes;
+	while (*text != '\0')
+	{
+		char* end = nullptr;
+		uint size = (uint)strtoul(text, &end, 10);
+		if (end == text)
+			break;
+
+		sizes.push_back(size);
+		text = *end == ',' ? end + 1 : end;
+	}
+	return sizes;
+}
+
+int main(int argc, char** argv)
+{
+	Benchmark::Options options;
+	std::string outFile;
+	std::string baselineFile;
+	bool list = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--list") == 0)
+			list = true;
+		else if (strcmp(arg, "--quick") == 0)
+		{
+			options.samples = 5;
+			options.minSampleMs = 5.0;
+		}
+		else if (value == nullptr || strcmp(arg, "--help") == 0)
+		{
+			PrintUsage();
+			return strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else
+		{
+			if (strcmp(arg, "--filter") == 0)
+				options.filter = value;
+			else if (strcmp(arg, "--sizes") == 0)
+				options.sizes = ParseSizes(value);
+			else if (strcmp(arg, "--samples") == 0)
+				options.samples = atoi(value) > 2 ? atoi(value) : 2;
+			else if (strcmp(arg, "--min-time") == 0)
+				options.minSampleMs = atof(value);
+			else if (strcmp(arg, "--out") == 0)
+				outFile = value;
+			else if (strcmp(arg, "--baseline") == 0)
+				baselineFile = value;
+			else if (strcmp(arg, "--threshold") == 0)
+				options.threshold = atof(value);
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+			++i;
+		}
+	}
+
+	Benchmark::RegisterSceneBenchmarks();
+	Benchmark::RegisterResourceBenchmarks();
+	Benchmark::RegisterAnimationBenchmarks();
+	Benchmark::RegisterParticleBenchmarks();
+	Benchmark::RegisterFileSystemBenchmarks();
+
+	if (list)
+	{
+		Benchmark::ListCases();
+		return EXIT_SUCCESS;
+	}
+
+	//Output paths are given relative to the launch directory, the engine changes it
+	std::error_code error;
+	std::string launchDir = std::filesystem::current_path(error).generic_string();
+	if (!outFile.empty() && std::filesystem::path(outFile).is_relative())
+		outFile = launchDir + "/" + outFile;
+	if (!baselineFile.empty() && std::filesystem::path(baselineFile).is_relative())
+		baselineFile = launchDir + "/" + baselineFile;
+
+	if (Benchmark::StartEngine(Benchmark::GetDefaultProjectDir().c_str()) == false)
+	{
+		printf("[error] Engine could not be initialized\n");
+		return EXIT_FAILURE;
+	}
+
+	std::vector<Benchmark::Result> results;
+	Benchmark::Run(options, results);
+	Benchmark::StopEngine();
+
+	Benchmark::PrintResults(results);
+
+	int ret = EXIT_SUCCESS;
+	if (!outFile.empty() && Benchmark::SaveResults(outFile.c_str(), options, results) == false)
+		ret = EXIT_FAILURE;
+
+	if (!baselineFile.empty() && Benchmark::CompareBaseline(baselineFile.c_str(), options, results) != 0)
+		ret = EXIT_FAILURE;
+
+	return ret;
+}
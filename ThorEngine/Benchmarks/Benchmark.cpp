@@ -0,0 +1,397 @@
+#include "Benchmark.h"
+
+#include "Engine.h"
+#include "Config.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <math.h>
+#include <sstream>
+
+namespace Benchmark
+{
+	struct Case
+	{
+		std::string name;
+		Function function = nullptr;
+		std::vector<uint> sizes;
+	};
+
+	std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	//Two-sided 95% Student's t values for 1 to 30 degrees of freedom
+	double GetTValue(uint degreesOfFreedom)
+	{
+		static const double table[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+										   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+										   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+		if (degreesOfFreedom == 0)
+			return 0.0;
+		return degreesOfFreedom <= 30 ? table[degreesOfFreedom - 1] : 1.96;
+	}
+
+	Result ComputeResult(const char* name, const State& state)
+	{
+		Result result;
+		result.name = name;
+		result.size = state.size;
+		result.iterations = state.GetIterationsPerSample();
+		result.items = state.GetItemsPerIteration();
+		result.peakBytes = state.GetPeakBytes();
+		result.ratio = state.GetRatio();
+
+		std::vector<double> samples = state.GetSamples();
+		result.samples = samples.size();
+		if (samples.empty())
+			return result;
+
+		std::sort(samples.begin(), samples.end());
+		uint count = samples.size();
+
+		double sum = 0.0;
+		for (uint i = 0; i < count; ++i)
+			sum += samples[i];
+		result.mean = sum / count;
+
+		double squares = 0.0;
+		for (uint i = 0; i < count; ++i)
+			squares += (samples[i] - result.mean) * (samples[i] - result.mean);
+		result.stdDev = count > 1 ? sqrt(squares / (count - 1)) : 0.0;
+
+		result.median = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) * 0.5;
+		result.min = samples.front();
+		result.max = samples.back();
+		result.ci95 = GetTValue(count - 1) * result.stdDev / sqrt((double)count);
+
+		return result;
+	}
+
+	std::string FormatTime(double ns)
+	{
+		char buffer[32];
+		if (ns < 1e3)
+			snprintf(buffer, 32, "%.1f ns", ns);
+		else if (ns < 1e6)
+			snprintf(buffer, 32, "%.2f us", ns / 1e3);
+		else if (ns < 1e9)
+			snprintf(buffer, 32, "%.2f ms", ns / 1e6);
+		else
+			snprintf(buffer, 32, "%.2f s", ns / 1e9);
+		return buffer;
+	}
+
+	std::string FormatBytes(uint64 bytes)
+	{
+		if (bytes == 0)
+			return "-";
+
+		char buffer[32];
+		if (bytes < 1024 * 1024)
+			snprintf(buffer, 32, "%.1f KB", bytes / 1024.0);
+		else
+			snprintf(buffer, 32, "%.1f MB", bytes / (1024.0 * 1024.0));
+		return buffer;
+	}
+
+	std::string FormatRatio(double ratio)
+	{
+		if (ratio <= 0.0)
+			return "-";
+
+		char buffer[32];
+		snprintf(buffer, 32, "%.2fx", ratio);
+		return buffer;
+	}
+
+	bool LoadFile(const char* file, std::string& content)
+	{
+		std::ifstream stream(file, std::ios::binary);
+		if (!stream.is_open())
+			return false;
+
+		std::stringstream buffer;
+		buffer << stream.rdbuf();
+		content = buffer.str();
+		return true;
+	}
+}
+
+// State ------------------------------------------------------------
+Benchmark::State::State(uint size, uint samples, double minSampleMs) : size(size), samplesWanted(samples), minSampleMs(minSampleMs)
+{
+	//First call to Next() starts the timer, so the setup code before the loop is not measured
+	iteration = iterationsPerSample;
+}
+
+bool Benchmark::State::NextSample()
+{
+	double elapsedMs = timer.ReadMs() - pausedMs;
+
+	if (started == false)
+	{
+		started = true;
+	}
+	else if (calibrating)
+	{
+		if (elapsedMs >= minSampleMs || iterationsPerSample >= (1ull << 40))
+		{
+			//The last calibration sample is discarded, it acts as warm-up
+			calibrating = false;
+		}
+		else
+		{
+			//Grow towards the wanted sample time, at least x2 and at most x10 at a time
+			double factor = elapsedMs > 0.0 ? minSampleMs * 1.2 / elapsedMs : 10.0;
+			factor = factor < 2.0 ? 2.0 : (factor > 10.0 ? 10.0 : factor);
+			iterationsPerSample = (uint64)(iterationsPerSample * factor);
+		}
+	}
+	else
+	{
+		samples.push_back(elapsedMs * 1e6 / iterationsPerSample);
+		if (samples.size() >= samplesWanted)
+			return false;
+	}
+
+	iteration = 1;
+	pausedMs = 0.0;
+	timer.Start();
+	return true;
+}
+
+void Benchmark::State::PauseTiming()
+{
+	pauseTimer.Start();
+}
+
+void Benchmark::State::ResumeTiming()
+{
+	pausedMs += pauseTimer.ReadMs();
+}
+
+// Cases ------------------------------------------------------------
+void Benchmark::Register(const char* name, Function function, const std::vector<uint>& sizes)
+{
+	Case newCase;
+	newCase.name = name;
+	newCase.function = function;
+	newCase.sizes = sizes;
+	GetCases().push_back(newCase);
+}
+
+void Benchmark::ListCases()
+{
+	const std::vector<Case>& cases = GetCases();
+	for (uint i = 0; i < cases.size(); ++i)
+	{
+		printf("%s [", cases[i].name.c_str());
+		for (uint s = 0; s < cases[i].sizes.size(); ++s)
+			printf(s == 0 ? "%u" : ", %u", cases[i].sizes[s]);
+		printf("]\n");
+	}
+}
+
+void Benchmark::Run(const Options& options, std::vector<Result>& results)
+{
+	const std::vector<Case>& cases = GetCases();
+	for (uint i = 0; i < cases.size(); ++i)
+	{
+		if (!options.filter.empty() && cases[i].name.find(options.filter) == std::string::npos)
+			continue;
+
+		const std::vector<uint>& sizes = options.sizes.empty() ? cases[i].sizes : options.sizes;
+		for (uint s = 0; s < sizes.size(); ++s)
+		{
+			printf("Running %s/%u...\n", cases[i].name.c_str(), sizes[s]);
+			fflush(stdout);
+
+			State state(sizes[s], options.samples, options.minSampleMs);
+			cases[i].function(state);
+
+			if (state.GetSamples().empty())
+			{
+				printf("[warning] %s/%u did not produce any sample\n", cases[i].name.c_str(), sizes[s]);
+				continue;
+			}
+			results.push_back(ComputeResult(cases[i].name.c_str(), state));
+		}
+	}
+}
+
+// Reports ----------------------------------------------------------
+void Benchmark::PrintResults(const std::vector<Result>& results)
+{
+	printf("\n%-40s %10s %12s %9s %12s %12s %14s %12s %8s\n", "Benchmark", "Size", "Mean", "+-95%", "Median", "Min", "Items/s", "Peak Mem", "Ratio");
+	for (uint i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+		double relativeCI = result.mean > 0.0 ? 100.0 * result.ci95 / result.mean : 0.0;
+		double itemsPerSecond = result.mean > 0.0 ? result.items * 1e9 / result.mean : 0.0;
+
+		printf("%-40s %10u %12s %8.2f%% %12s %12s %14.4g %12s %8s\n", result.name.c_str(), result.size, FormatTime(result.mean).c_str(),
+			relativeCI, FormatTime(result.median).c_str(), FormatTime(result.min).c_str(), itemsPerSecond, FormatBytes(result.peakBytes).c_str(),
+			FormatRatio(result.ratio).c_str());
+	}
+}
+
+bool Benchmark::SaveResults(const char* file, const Options& options, const std::vector<Result>& results)
+{
+	Config config;
+	config.SetString("Unit", "ns");
+	config.SetNumber("Samples", options.samples);
+	config.SetNumber("Min Sample Ms", options.minSampleMs);
+
+	Config_Array resultsArray = config.SetArray("Results");
+	for (uint i = 0; i < results.size(); ++i)
+	{
+		Config node = resultsArray.AddNode();
+		node.SetString("Name", results[i].name.c_str());
+		node.SetNumber("Size", results[i].size);
+		node.SetNumber("Samples", results[i].samples);
+		node.SetNumber("Iterations", (double)results[i].iterations);
+		node.SetNumber("Items", (double)results[i].items);
+		node.SetNumber("Mean", results[i].mean);
+		node.SetNumber("Median", results[i].median);
+		node.SetNumber("Std Dev", results[i].stdDev);
+		node.SetNumber("Min", results[i].min);
+		node.SetNumber("Max", results[i].max);
+		node.SetNumber("CI95", results[i].ci95);
+		if (results[i].peakBytes > 0)
+			node.SetNumber("Peak Bytes", (double)results[i].peakBytes);
+		if (results[i].ratio > 0.0)
+			node.SetNumber("Ratio", results[i].ratio);
+	}
+
+	char* buffer = nullptr;
+	uint size = config.Serialize(&buffer);
+
+	bool ret = false;
+	FILE* output = fopen(file, "wb");
+	if (output != nullptr)
+	{
+		//Serialized size includes the null terminator
+		ret = fwrite(buffer, 1, size - 1, output) == size - 1;
+		fclose(output);
+	}
+	RELEASE_ARRAY(buffer);
+
+	if (ret == false)
+		printf("[error] Could not write benchmark results to '%s'\n", file);
+	return ret;
+}
+
+int Benchmark::CompareBaseline(const char* file, const Options& options, const std::vector<Result>& results)
+{
+	std::string content;
+	if (LoadFile(file, content) == false)
+	{
+		printf("[error] Could not open baseline '%s'\n", file);
+		return -1;
+	}
+
+	Config baseline(content.c_str());
+	if (baseline.NodeExists() == false)
+	{
+		printf("[error] Baseline '%s' is not a valid results file\n", file);
+		return -1;
+	}
+
+	Config_Array baseResults = baseline.GetArray("Results");
+	int regressions = 0;
+
+	printf("\nComparison against '%s' (threshold %.1f%%)\n", file, options.threshold);
+	printf("%-40s %10s %12s %12s %9s\n", "Benchmark", "Size", "Baseline", "Current", "Change");
+	for (uint i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+
+		uint b = 0;
+		for (; b < baseResults.GetSize(); ++b)
+		{
+			Config node = baseResults.GetNode(b);
+			if (node.GetString("Name") == result.name && (uint)node.GetNumber("Size") == result.size)
+				break;
+		}
+
+		if (b == baseResults.GetSize())
+		{
+			printf("%-40s %10u %12s %12s %9s\n", result.name.c_str(), result.size, "-", FormatTime(result.mean).c_str(), "new");
+			continue;
+		}
+
+		Config node = baseResults.GetNode(b);
+		double baseMean = node.GetNumber("Mean");
+		double baseCI = node.GetNumber("CI95");
+		double change = baseMean > 0.0 ? 100.0 * (result.mean - baseMean) / baseMean : 0.0;
+
+		//Only flag changes over the threshold that are also statistically significant
+		bool regression = change > options.threshold && (result.mean - result.ci95) > (baseMean + baseCI);
+		if (regression)
+			++regressions;
+
+		printf("%-40s %10u %12s %12s %+8.2f%%%s\n", result.name.c_str(), result.size, FormatTime(baseMean).c_str(),
+			FormatTime(result.mean).c_str(), change, regression ? "  REGRESSION" : "");
+	}
+
+	printf("%d regression(s) found\n", regressions);
+	return regressions;
+}
+
+// Engine -----------------------------------------------------------
+bool Benchmark::StartEngine(const char* projectDir)
+{
+	namespace fs = std::filesystem;
+	std::error_code error;
+
+	fs::create_directories(fs::path(projectDir) / "Engine" / "Assets", error);
+	fs::create_directories(fs::path(projectDir) / "Assets", error);
+
+	fs::path settings = fs::path(projectDir) / "Engine" / "DefaultSettings.JSON";
+	if (fs::exists(settings, error) == false)
+	{
+		std::ofstream stream(settings);
+		stream << "{ \"EditorState\": { } }";
+	}
+
+	fs::current_path(projectDir, error);
+	if (error)
+	{
+		printf("[error] Could not open project '%s': %s\n", projectDir, error.message().c_str());
+		return false;
+	}
+
+	Engine = new TEngine();
+	return Engine->Init();
+}
+
+void Benchmark::StopEngine()
+{
+	if (Engine != nullptr)
+	{
+		Engine->CleanUp();
+		RELEASE(Engine);
+	}
+}
+
+const std::string& Benchmark::GetScratchDir()
+{
+	static std::string scratchDir;
+	if (scratchDir.empty())
+	{
+		std::error_code error;
+		std::filesystem::path path = std::filesystem::temp_directory_path(error) / "ThorBenchmarks";
+		std::filesystem::create_directories(path, error);
+		scratchDir = path.generic_string();
+	}
+	return scratchDir;
+}
+
+std::string Benchmark::GetDefaultProjectDir()
+{
+	return GetScratchDir() + "/Project";
+}
@@ -0,0 +1,153 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include "Globals.h"
+#include "PerfTimer.h"
+
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Microbenchmark framework for the headless engine core
+//Each case is run once per size: the measured loop is first calibrated until a sample
+//lasts at least 'minSampleMs', then timed for 'samples' samples of that many iterations.
+//Results are reported per iteration with a 95% confidence interval.
+namespace Benchmark
+{
+	class State
+	{
+	public:
+		State(uint size, uint samples, double minSampleMs);
+
+		//Measured loop: while (state.Next()) { ... }
+		inline bool Next()
+		{
+			if (++iteration <= iterationsPerSample)
+				return true;
+			return NextSample();
+		}
+
+		//Excludes per-iteration setup / cleanup from the measure. Adds timer overhead,
+		//only use it for cases where a single iteration takes several microseconds
+		void PauseTiming();
+		void ResumeTiming();
+
+		//Number of items processed per iteration, used to report throughput
+		void SetItemsPerIteration(uint64 items) { itemsPerIteration = items; }
+
+		//Memory peak reached by an iteration, reported next to the times. The highest value set is kept
+		void SetPeakBytes(uint64 bytes) { if (bytes > peakBytes) peakBytes = bytes; }
+
+		//Size ratio reported by the case, such as a compression ratio
+		void SetRatio(double value) { ratio = value; }
+
+		const std::vector<double>& GetSamples() const { return samples; }
+		uint64 GetIterationsPerSample() const { return iterationsPerSample; }
+		uint64 GetItemsPerIteration() const { return itemsPerIteration; }
+		uint64 GetPeakBytes() const { return peakBytes; }
+		double GetRatio() const { return ratio; }
+
+	private:
+		bool NextSample();
+
+	public:
+		const uint size;
+
+	private:
+		const uint samplesWanted;
+		const double minSampleMs;
+
+		bool started = false;
+		bool calibrating = true;
+		uint64 iteration = 0;
+		uint64 iterationsPerSample = 1;
+		uint64 itemsPerIteration = 1;
+		uint64 peakBytes = 0;
+		double ratio = 0.0;
+
+		PerfTimer timer;
+		PerfTimer pauseTimer;
+		double pausedMs = 0.0;
+
+		std::vector<double> samples; //Nanoseconds per iteration
+	};
+
+	typedef void (*Function)(State& state);
+
+	struct Result
+	{
+		std::string name;
+		uint size = 0;
+		uint samples = 0;
+		uint64 iterations = 0;
+		uint64 items = 1;
+		uint64 peakBytes = 0;	//0 if the case does not report it
+		double ratio = 0.0;		//0 if the case does not report it
+
+		//All times in nanoseconds per iteration
+		double mean = 0.0;
+		double median = 0.0;
+		double stdDev = 0.0;
+		double min = 0.0;
+		double max = 0.0;
+		double ci95 = 0.0;	//Half width of the 95% confidence interval of the mean
+	};
+
+	struct Options
+	{
+		std::string filter;
+		std::vector<uint> sizes;	//Overrides the default sizes of every case when not empty
+		uint samples = 15;
+		double minSampleMs = 20.0;
+		double threshold = 10.0;	//Regression threshold, in percent
+	};
+
+	//Registers a new benchmark case that will run once for each of 'sizes'
+	void Register(const char* name, Function function, const std::vector<uint>& sizes);
+
+	void ListCases();
+	void Run(const Options& options, std::vector<Result>& results);
+
+	void PrintResults(const std::vector<Result>& results);
+	bool SaveResults(const char* file, const Options& options, const std::vector<Result>& results);
+
+	//Compares the results against a previous run saved with SaveResults
+	//Returns the amount of regressions: cases slower than 'threshold' percent where both
+	//confidence intervals do not overlap
+	int CompareBaseline(const char* file, const Options& options, const std::vector<Result>& results);
+
+	//Creates the global Engine on 'projectDir', which becomes the working directory
+	bool StartEngine(const char* projectDir);
+	void StopEngine();
+
+	//Directory where benchmarks can generate their projects and temporary files
+	const std::string& GetScratchDir();
+
+	//Empty project the engine runs on while benchmarking
+	std::string GetDefaultProjectDir();
+
+	//Prevents the compiler from optimizing away a computed value
+	template<typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#ifdef _MSC_VER
+		static volatile const void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	//Case registration, one function per benchmark file
+	void RegisterSceneBenchmarks();
+	void RegisterResourceBenchmarks();
+	void RegisterAnimationBenchmarks();
+	void RegisterParticleBenchmarks();
+	void RegisterFileSystemBenchmarks();
+}
+
+#endif //__BENCHMARK_H__
@@ -0,0 +1,213 @@
+#include "AssetDatabase.h"
+
+#include <string.h>
+
+#define ASSET_DATABASE_MAGIC "ThorADB"
+#define ASSET_DATABASE_VERSION 2
+
+namespace
+{
+	//Sequential writes and bounds checked reads over a database buffer
+	struct Writer
+	{
+		char* cursor;
+
+		void Bytes(const void* data, uint size) { memcpy(cursor, data, size); cursor += size; }
+		template <typename T> void Value(T value) { Bytes(&value, sizeof(T)); }
+		void String(const std::string& string) { Value<uint>(string.size()); Bytes(string.data(), string.size()); }
+	};
+
+	struct Reader
+	{
+		const char* cursor;
+		const char* end;
+		bool valid = true;
+
+		bool Bytes(void* data, uint size)
+		{
+			if (valid == false || (uint)(end - cursor) < size)
+				return valid = false;
+			memcpy(data, cursor, size);
+			cursor += size;
+			return true;
+		}
+		template <typename T> T Value() { T value = T(); Bytes(&value, sizeof(T)); return value; }
+		std::string String()
+		{
+			uint size = Value<uint>();
+			if (valid == false || (uint)(end - cursor) < size)
+			{
+				valid = false;
+				return std::string();
+			}
+			std::string string(cursor, size);
+			cursor += size;
+			return string;
+		}
+	};
+
+	uint GetBaseSize(const ResourceBase& base)
+	{
+		return sizeof(uint64) + sizeof(int) + sizeof(uint) * 3 + base.name.size() + base.libraryFile.size()
+			+ sizeof(uint64) + base.containedResources.size() * sizeof(uint64)
+			+ sizeof(uint) + base.dependencies.size() * sizeof(uint64);
+	}
+
+	void WriteBase(Writer& writer, const ResourceBase& base)
+	{
+		writer.Value<uint64>(base.ID);
+		writer.Value<int>((int)base.type);
+		writer.String(base.name);
+		writer.String(base.libraryFile);
+		writer.Value<uint64>(base.contentHash);
+		writer.Value<uint>(base.containedResources.size());
+		writer.Bytes(base.containedResources.data(), base.containedResources.size() * sizeof(uint64));
+		writer.Value<uint>(base.dependencies.size());
+		writer.Bytes(base.dependencies.data(), base.dependencies.size() * sizeof(uint64));
+	}
+
+	void ReadIDs(Reader& reader, std::vector<uint64>& IDs)
+	{
+		uint count = reader.Value<uint>();
+		if (reader.valid && count <= (uint)(reader.end - reader.cursor) / sizeof(uint64))
+		{
+			IDs.resize(count);
+			reader.Bytes(IDs.data(), count * sizeof(uint64));
+		}
+		else
+		{
+			reader.valid = false;
+		}
+	}
+
+	void ReadBase(Reader& reader, const std::string& assetsFile, ResourceBase& base)
+	{
+		base.ID = reader.Value<uint64>();
+		base.type = (ResourceType)reader.Value<int>();
+		base.name = reader.String();
+		base.assetsFile = assetsFile;
+		base.libraryFile = reader.String();
+		base.contentHash = reader.Value<uint64>();
+
+		ReadIDs(reader, base.containedResources);
+		ReadIDs(reader, base.dependencies);
+	}
+}
+
+bool AssetDatabase::Load(const char* buffer, uint size)
+{
+	Reader reader = { buffer, buffer + size };
+
+	char magic[sizeof(ASSET_DATABASE_MAGIC)];
+	reader.Bytes(magic, sizeof(magic));
+	if (reader.valid == false || memcmp(magic, ASSET_DATABASE_MAGIC, sizeof(magic)) != 0 || reader.Value<uint>() != ASSET_DATABASE_VERSION)
+		return false;
+
+	std::unordered_map<std::string, Record> loaded;
+	uint count = reader.Value<uint>();
+	loaded.reserve(count);
+
+	for (uint i = 0; i < count && reader.valid; ++i)
+	{
+		std::string assetsFile = reader.String();
+		Record& record = loaded[assetsFile];
+
+		record.assetDate = reader.Value<uint64>();
+		record.importerVersion = reader.Value<uint>();
+		record.importSettings = reader.Value<uint64>();
+		record.metaDate = reader.Value<uint64>();
+		ReadBase(reader, assetsFile, record.base);
+
+		uint containedCount = reader.Value<uint>();
+		for (uint c = 0; c < containedCount && reader.valid; ++c)
+		{
+			record.contained.push_back(ResourceBase());
+			ReadBase(reader, assetsFile, record.contained.back());
+		}
+	}
+
+	if (reader.valid == false || reader.cursor != reader.end)
+		return false;
+
+	records.swap(loaded);
+	dirty = false;
+	return true;
+}
+
+uint AssetDatabase::Save(char** buffer) const
+{
+	uint size = sizeof(ASSET_DATABASE_MAGIC) + sizeof(uint) * 2;
+	for (std::unordered_map<std::string, Record>::const_iterator it = records.begin(); it != records.end(); ++it)
+	{
+		size += sizeof(uint) + it->first.size() + sizeof(uint64) * 3 + sizeof(uint) * 2;
+		size += GetBaseSize(it->second.base);
+		for (uint i = 0; i < it->second.contained.size(); ++i)
+			size += GetBaseSize(it->second.contained[i]);
+	}
+
+	*buffer = new char[size];
+	Writer writer = { *buffer };
+
+	writer.Bytes(ASSET_DATABASE_MAGIC, sizeof(ASSET_DATABASE_MAGIC));
+	writer.Value<uint>(ASSET_DATABASE_VERSION);
+	writer.Value<uint>(records.size());
+
+	for (std::unordered_map<std::string, Record>::const_iterator it = records.begin(); it != records.end(); ++it)
+	{
+		const Record& record = it->second;
+		writer.String(it->first);
+		writer.Value<uint64>(record.assetDate);
+		writer.Value<uint>(record.importerVersion);
+		writer.Value<uint64>(record.importSettings);
+		writer.Value<uint64>(record.metaDate);
+		WriteBase(writer, record.base);
+
+		writer.Value<uint>(record.contained.size());
+		for (uint i = 0; i < record.contained.size(); ++i)
+			WriteBase(writer, record.contained[i]);
+	}
+
+	return size;
+}
+
+const AssetDatabase::Record* AssetDatabase::Find(const std::string& assetsFile, uint64 metaDate)
+{
+	std::unordered_map<std::string, Record>::iterator it = records.find(assetsFile);
+	if (it == records.end() || it->second.metaDate != metaDate)
+		return nullptr;
+
+	it->second.visited = true;
+	return &it->second;
+}
+
+const AssetDatabase::Record& AssetDatabase::Set(const std::string& assetsFile, const Record& record)
+{
+	Record& stored = records[assetsFile];
+	stored = record;
+	stored.visited = true;
+	dirty = true;
+	return stored;
+}
+
+void AssetDatabase::Remove(const std::string& assetsFile)
+{
+	if (records.erase(assetsFile) > 0)
+		dirty = true;
+}
+
+void AssetDatabase::RemoveUnvisited()
+{
+	for (std::unordered_map<std::string, Record>::iterator it = records.begin(); it != records.end(); )
+	{
+		if (it->second.visited == false)
+		{
+			it = records.erase(it);
+			dirty = true;
+		}
+		else
+		{
+			it->second.visited = false;
+			++it;
+		}
+	}
+}
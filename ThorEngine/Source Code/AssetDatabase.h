@@ -0,0 +1,55 @@
+#ifndef __ASSET_DATABASE_H__
+#define __ASSET_DATABASE_H__
+
+#include "Globals.h"
+#include "ResourceBase.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+//Binary copy of the .meta files of every asset, saved in Library
+//Startup registers the assets from it with a single read: a .meta file is only parsed again when its
+//modification date differs from the recorded one. The .meta files stay as the source of truth for version control
+class AssetDatabase
+{
+public:
+	struct Record
+	{
+		ResourceBase base;
+		std::vector<ResourceBase> contained;	//Empty for folders: their children are assets themselves
+
+		uint64 assetDate = 0;		//"Date" in the .meta: asset modification date when it was imported
+		uint importerVersion = 0;
+		uint64 importSettings = 0;
+		uint64 metaDate = 0;		//.meta file modification date
+
+		bool visited = false;
+	};
+
+	//Returns false if the buffer is not a valid database. Nothing is loaded in that case
+	bool Load(const char* buffer, uint size);
+
+	//Returns the size of the buffer file (0 if any errors)
+	//Warning: buffer memory needs to be released after the function call
+	uint Save(char** buffer) const;
+
+	//Returns the record of 'assetsFile' if its .meta file has not changed since it was recorded, and marks it as visited
+	const Record* Find(const std::string& assetsFile, uint64 metaDate);
+
+	const Record& Set(const std::string& assetsFile, const Record& record);
+	void Remove(const std::string& assetsFile);
+
+	//Drops the records of the assets not found since the database was loaded
+	void RemoveUnvisited();
+
+	inline uint GetSize() const { return records.size(); }
+	inline bool IsDirty() const { return dirty; }
+	inline void ClearDirty() { dirty = false; }
+
+private:
+	std::unordered_map<std::string, Record> records;
+	bool dirty = false;
+};
+
+#endif //__ASSET_DATABASE_H__
@@ -227,9 +227,9 @@ void C_Animator::UpdateChannelsTransform(const R_Animation* settings, const R_An
 	}
 }
 
-float3 C_Animator::GetChannelPosition(const Channel& channel, float currentKey, float3 default) const
+float3 C_Animator::GetChannelPosition(const Channel& channel, float currentKey, float3 defaultValue) const
 {
-	float3 position = default;
+	float3 position = defaultValue;
 	
 	if (channel.HasPosKey())
 	{
@@ -253,9 +253,9 @@ float3 C_Animator::GetChannelPosition(const Channel& channel, float currentKey,
 	return position;
 }
 
-Quat C_Animator::GetChannelRotation(const Channel& channel, float currentKey, Quat default) const
+Quat C_Animator::GetChannelRotation(const Channel& channel, float currentKey, Quat defaultValue) const
 {
-	Quat rotation = default;
+	Quat rotation = defaultValue;
 
 	if (channel.HasRotKey())
 	{
@@ -278,9 +278,9 @@ Quat C_Animator::GetChannelRotation(const Channel& channel, float currentKey, Qu
 	return rotation;
 }
 
-float3 C_Animator::GetChannelScale(const Channel& channel, float currentKey, float3 default) const
+float3 C_Animator::GetChannelScale(const Channel& channel, float currentKey, float3 defaultValue) const
 {
-	float3 scale = default;
+	float3 scale = defaultValue;
 
 	if (channel.HasScaleKey())
 	{
@@ -33,12 +33,14 @@ public:
 	uint64 GetResourceID() const;
 	static inline Type GetType() { return Type::Animator; };
 
+	//Channel sampling at a given key. Returns 'defaultValue' if the channel has no keys
+	float3 GetChannelPosition(const Channel& channel, float currentKey, float3 defaultValue) const;
+	Quat GetChannelRotation(const Channel& channel, float currentKey, Quat defaultValue) const;
+	float3 GetChannelScale(const Channel& channel, float currentKey, float3 defaultValue) const;
+
 private:
 
 	void UpdateChannelsTransform(const R_Animation* settings, const R_Animation* blend, float blendRatio);
-	float3 GetChannelPosition(const Channel& channel, float currentKey, float3 default) const;
-	Quat GetChannelRotation(const Channel& channel, float currentKey, Quat default) const;
-	float3 GetChannelScale(const Channel& channel, float currentKey, float3 default) const;
 
 	void UpdateMeshAnimation(GameObject* gameObject);
 
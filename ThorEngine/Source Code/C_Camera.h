@@ -3,8 +3,8 @@
 
 #include "Component.h"
 
-#include "MathGeoLib\src\MathBuildConfig.h"
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathBuildConfig.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 class GameObject;
 
 class C_Camera : public Component
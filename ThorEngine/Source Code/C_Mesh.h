@@ -3,7 +3,7 @@
 
 #include "Globals.h"
 #include "Component.h"
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 
 #include <map>
 #include <string>
@@ -3,6 +3,7 @@
 
 #include "Globals.h"
 #include "ResourceHandle.h"
+#include "MemoryTracker.h"
 
 //TODO: move into .cpp?
 #include "MathGeoLib/src/Math/float4x4.h"
@@ -12,6 +13,8 @@ class Resource;
 
 class Component
 {
+	MEMORY_TAG(MemoryTracker::Tag::COMPONENTS)
+
 public:
 	enum Type
 	{
@@ -0,0 +1,286 @@
+#include "Compression.h"
+
+#include <string.h>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Compression
+{
+	typedef unsigned char byte;
+
+	static const uint MIN_MATCH = 4;
+	static const uint LAST_LITERALS = 5;	//The block always ends with at least 5 literals
+	static const uint MATCH_FIND_LIMIT = 12;	//Last match starts at least 12 bytes before the end
+	static const uint MAX_OFFSET = 65535;
+	static const uint HASH_BITS = 14;
+
+	static const char blobMagic[8] = { 'T', 'H', 'O', 'R', 'L', 'Z', 'B', '1' };
+	static const uint64 blobHeaderSize = sizeof(blobMagic) + sizeof(uint64);
+
+	//Unaligned little endian reads
+	inline uint Read32(const byte* data) { uint value; memcpy(&value, data, sizeof(value)); return value; }
+	inline uint64 Read64(const byte* data) { uint64 value; memcpy(&value, data, sizeof(value)); return value; }
+
+	inline uint HashSequence(uint sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+	inline uint CountTrailingZeros(uint64 value)
+	{
+#if defined(_MSC_VER) && defined(_WIN64)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return (uint)index;
+#elif defined(_MSC_VER)
+		//32 bit builds only scan 32 bits at a time
+		unsigned long index;
+		if (_BitScanForward(&index, (unsigned long)value))
+			return (uint)index;
+		_BitScanForward(&index, (unsigned long)(value >> 32));
+		return (uint)index + 32;
+#else
+		return (uint)__builtin_ctzll(value);
+#endif
+	}
+
+	//Length of the match between 'a' and 'b', without reading from 'limit' on
+	inline uint64 MatchLength(const byte* a, const byte* b, const byte* limit)
+	{
+		const byte* start = a;
+		while (a + sizeof(uint64) <= limit)
+		{
+			uint64 difference = Read64(a) ^ Read64(b);
+			if (difference != 0)
+				return a - start + (CountTrailingZeros(difference) >> 3);
+			a += sizeof(uint64);
+			b += sizeof(uint64);
+		}
+		while (a < limit && *a == *b)
+		{
+			++a;
+			++b;
+		}
+		return a - start;
+	}
+
+	//Lengths of 15 or more continue in extra bytes, 255 each until a smaller one
+	inline byte* WriteLength(byte* cursor, uint64 length)
+	{
+		for (; length >= 255; length -= 255)
+			*cursor++ = 255;
+		*cursor++ = (byte)length;
+		return cursor;
+	}
+
+	inline bool ReadLength(const byte** cursor, const byte* end, uint64& length)
+	{
+		byte value = 255;
+		while (value == 255)
+		{
+			if (*cursor >= end)
+				return false;
+			value = *(*cursor)++;
+			length += value;
+		}
+		return true;
+	}
+
+	//Token, literals and, unless it is the last sequence, match offset and length
+	inline byte* WriteSequence(byte* cursor, const byte* end, const byte* literals, uint64 literalCount, uint64 offset, uint64 matchLength, bool last)
+	{
+		uint64 needed = 1 + literalCount + literalCount / 255 + 1 + (last ? 0 : 2 + matchLength / 255 + 1);
+		if (needed > (uint64)(end - cursor))
+			return nullptr;
+
+		byte* token = cursor++;
+		*token = (byte)((literalCount < 15 ? literalCount : 15) << 4);
+		if (literalCount >= 15)
+			cursor = WriteLength(cursor, literalCount - 15);
+
+		memcpy(cursor, literals, literalCount);
+		cursor += literalCount;
+		if (last)
+			return cursor;
+
+		*cursor++ = (byte)(offset & 0xFF);
+		*cursor++ = (byte)(offset >> 8);
+
+		matchLength -= MIN_MATCH;
+		*token |= (byte)(matchLength < 15 ? matchLength : 15);
+		if (matchLength >= 15)
+			cursor = WriteLength(cursor, matchLength - 15);
+		return cursor;
+	}
+}
+
+uint64 Compression::Compress(const char* source, uint64 size, char* destination, uint64 capacity)
+{
+	const byte* input = (const byte*)source;
+	const byte* inputEnd = input + size;
+	byte* output = (byte*)destination;
+	byte* outputEnd = output + capacity;
+
+	const byte* anchor = input;
+	if (size > MATCH_FIND_LIMIT)
+	{
+		const byte* matchFindLimit = inputEnd - MATCH_FIND_LIMIT;
+		const byte* matchLimit = inputEnd - LAST_LITERALS;
+
+		//Last position seen for each hashed sequence, relative to 'input'. Blocks over 4GB are not needed
+		std::vector<uint> table((size_t)1 << HASH_BITS, 0);
+
+		const byte* cursor = input + 1;
+		while (cursor <= matchFindLimit)
+		{
+			uint sequence = Read32(cursor);
+			uint& entry = table[HashSequence(sequence)];
+			const byte* candidate = input + entry;
+			entry = (uint)(cursor - input);
+
+			if (cursor - candidate > MAX_OFFSET || Read32(candidate) != sequence)
+			{
+				//Data that does not compress is skipped faster the longer it goes on
+				cursor += 1 + ((cursor - anchor) >> 6);
+				continue;
+			}
+
+			//Matches are extended backwards over the pending literals
+			while (cursor > anchor && candidate > input && cursor[-1] == candidate[-1])
+			{
+				--cursor;
+				--candidate;
+			}
+
+			uint64 length = MIN_MATCH + MatchLength(cursor + MIN_MATCH, candidate + MIN_MATCH, matchLimit);
+			output = WriteSequence(output, outputEnd, anchor, cursor - anchor, cursor - candidate, length, false);
+			if (output == nullptr)
+				return 0;
+
+			cursor += length;
+			anchor = cursor;
+
+			//Position inside the match, helps with repeating records
+			if (cursor <= matchFindLimit)
+				table[HashSequence(Read32(cursor - 2))] = (uint)(cursor - 2 - input);
+		}
+	}
+
+	output = WriteSequence(output, outputEnd, anchor, inputEnd - anchor, 0, 0, true);
+	return output != nullptr ? output - (byte*)destination : 0;
+}
+
+bool Compression::Decompress(const char* source, uint64 size, char* destination, uint64 rawSize)
+{
+	const byte* input = (const byte*)source;
+	const byte* inputEnd = input + size;
+	byte* output = (byte*)destination;
+	byte* outputEnd = output + rawSize;
+
+	while (input < inputEnd)
+	{
+		byte token = *input++;
+
+		uint64 literalCount = token >> 4;
+		if (literalCount == 15 && ReadLength(&input, inputEnd, literalCount) == false)
+			return false;
+		if (literalCount > (uint64)(inputEnd - input) || literalCount > (uint64)(outputEnd - output))
+			return false;
+
+		//Short runs are copied as a whole chunk when there is room: the extra bytes are overwritten next
+		if (literalCount <= 16 && inputEnd - input >= 16 && outputEnd - output >= 16)
+			memcpy(output, input, 16);
+		else
+			memcpy(output, input, literalCount);
+		input += literalCount;
+		output += literalCount;
+
+		//The last sequence only has literals
+		if (input == inputEnd)
+			break;
+
+		if (inputEnd - input < 2)
+			return false;
+		uint64 offset = input[0] | ((uint64)input[1] << 8);
+		input += 2;
+		if (offset == 0 || offset > (uint64)(output - (byte*)destination))
+			return false;
+
+		uint64 length = token & 15;
+		if (length == 15 && ReadLength(&input, inputEnd, length) == false)
+			return false;
+		length += MIN_MATCH;
+		if (length > (uint64)(outputEnd - output))
+			return false;
+
+		//Matches can overlap the bytes they write: they are copied in chunks no longer than the offset
+		const byte* match = output - offset;
+		byte* matchEnd = output + length;
+		if (offset >= sizeof(uint64) && (uint64)(outputEnd - output) >= length + sizeof(uint64))
+		{
+			for (; output < matchEnd; output += sizeof(uint64), match += sizeof(uint64))
+				memcpy(output, match, sizeof(uint64));
+			output = matchEnd;
+		}
+		else if (offset >= length)
+		{
+			memcpy(output, match, length);
+			output = matchEnd;
+		}
+		else if (offset >= sizeof(uint64))
+		{
+			for (; output + sizeof(uint64) <= matchEnd; output += sizeof(uint64), match += sizeof(uint64))
+				memcpy(output, match, sizeof(uint64));
+			while (output < matchEnd)
+				*output++ = *match++;
+		}
+		else
+		{
+			while (output < matchEnd)
+				*output++ = *match++;
+		}
+	}
+
+	return output == outputEnd;
+}
+
+uint64 Compression::CompressBlob(const char* data, uint64 size, char** blob)
+{
+	*blob = nullptr;
+	uint64 capacity = blobHeaderSize + CompressBound(size);
+	char* buffer = new char[capacity];
+
+	memcpy(buffer, blobMagic, sizeof(blobMagic));
+	memcpy(buffer + sizeof(blobMagic), &size, sizeof(uint64));
+
+	uint64 compressedSize = Compress(data, size, buffer + blobHeaderSize, capacity - blobHeaderSize);
+	if (compressedSize == 0 || blobHeaderSize + compressedSize >= size)
+	{
+		RELEASE_ARRAY(buffer);
+		return 0;
+	}
+
+	*blob = buffer;
+	return blobHeaderSize + compressedSize;
+}
+
+bool Compression::IsBlob(const char* data, uint64 size)
+{
+	return size >= blobHeaderSize && memcmp(data, blobMagic, sizeof(blobMagic)) == 0;
+}
+
+uint64 Compression::GetBlobRawSize(const char* blob, uint64 size)
+{
+	if (IsBlob(blob, size) == false)
+		return 0;
+
+	uint64 rawSize = 0;
+	memcpy(&rawSize, blob + sizeof(blobMagic), sizeof(uint64));
+	return rawSize;
+}
+
+bool Compression::DecompressBlob(const char* blob, uint64 size, char* destination)
+{
+	uint64 rawSize = GetBlobRawSize(blob, size);
+	return rawSize > 0 && Decompress(blob + blobHeaderSize, size - blobHeaderSize, destination, rawSize);
+}
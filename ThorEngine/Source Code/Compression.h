@@ -0,0 +1,37 @@
+#ifndef __COMPRESSION_H__
+#define __COMPRESSION_H__
+
+#include "Globals.h"
+
+//Fast lossless compression of library files (LZ4 block format: byte aligned literals and matches, 64KB window)
+//Decoding only copies bytes, it runs close to memory speed. Compression is greedy with a single hash probe
+namespace Compression
+{
+	//Raw blocks, without any header ------------------------------------
+
+	//Worst case size of a compressed block: data that does not compress grows slightly
+	inline uint64 CompressBound(uint64 size) { return size + size / 255 + 16; }
+
+	//Returns the compressed size, 0 if it does not fit in 'capacity'
+	uint64 Compress(const char* source, uint64 size, char* destination, uint64 capacity);
+
+	//Decodes a whole block into 'destination', which has to be exactly 'rawSize' bytes
+	//Returns false if the block is damaged: it never reads or writes out of the given ranges
+	bool Decompress(const char* source, uint64 size, char* destination, uint64 rawSize);
+
+	//Blobs: a header with the raw size followed by a block ---------------
+	//Saved library files start with the header when compressed. No library file format starts like it
+
+	//Returns the blob size, 0 (and no buffer) if compressing does not make the data smaller
+	//Warning: buffer memory needs to be released after the function call
+	uint64 CompressBlob(const char* data, uint64 size, char** blob);
+
+	bool IsBlob(const char* data, uint64 size);
+	//Size of the data once decompressed, 0 if 'blob' is not a blob
+	uint64 GetBlobRawSize(const char* blob, uint64 size);
+
+	//Decodes the blob into 'destination', which has to hold GetBlobRawSize bytes
+	bool DecompressBlob(const char* blob, uint64 size, char* destination);
+}
+
+#endif //__COMPRESSION_H__
@@ -1,4 +1,47 @@
 #include "Config.h"
+#include "JSONStream.h"
+
+#include <string.h>
+
+namespace
+{
+	void WriteValue(JSONWriter& writer, const JSON_Value* value);
+
+	void WriteObject(JSONWriter& writer, const JSON_Object* object)
+	{
+		writer.BeginObject();
+		size_t count = json_object_get_count(object);
+		for (size_t i = 0; i < count; ++i)
+		{
+			writer.Key(json_object_get_name(object, i));
+			WriteValue(writer, json_object_get_value_at(object, i));
+		}
+		writer.EndObject();
+	}
+
+	void WriteValue(JSONWriter& writer, const JSON_Value* value)
+	{
+		switch (json_value_get_type(value))
+		{
+			case JSONObject:
+				WriteObject(writer, json_value_get_object(value));
+				break;
+			case JSONArray:
+			{
+				const JSON_Array* array = json_value_get_array(value);
+				writer.BeginArray();
+				for (size_t i = 0; i < json_array_get_count(array); ++i)
+					WriteValue(writer, json_array_get_value(array, i));
+				writer.EndArray();
+				break;
+			}
+			case JSONString:	writer.String(json_value_get_string(value)); break;
+			case JSONNumber:	writer.Number(json_value_get_number(value)); break;
+			case JSONBoolean:	writer.Bool(json_value_get_boolean(value) != 0); break;
+			default:			writer.Null(); break;
+		}
+	}
+}
 
 //Contructor used for data append
 Config::Config()
@@ -28,12 +71,15 @@ Config::~Config()
 }
 
 //Fills a buffer, returns its size
+//The tree is written in a single pass: parson walks it twice, to measure the text and to write it
 uint Config::Serialize(char** buffer)
 {
-	size_t size = json_serialization_size_pretty(root_value);
-	*buffer = new char[size];
-	json_serialize_to_buffer_pretty(root_value, *buffer, size);
-	return size;
+	JSONWriter writer;
+	if (root_value)
+		WriteValue(writer, root_value);
+	else
+		WriteObject(writer, node);
+	return (uint)writer.Finish(buffer);
 }
 
 bool Config::NodeExists()
@@ -42,6 +88,11 @@ bool Config::NodeExists()
 	return root_value != nullptr;
 }
 
+bool Config::HasAttribute(const char* name) const
+{
+	return json_object_has_value(node, name) != 0;
+}
+
 void Config::Release()
 {
 	if (root_value)
@@ -78,31 +129,111 @@ Config Config::SetNode(const char* name)
 }
 
 //Get attributes --------------
-double Config::GetNumber(const char* name, double default) const
+double Config::GetNumber(const char* name, double defaultValue) const
 {
-	if (json_object_has_value_of_type(node, name, JSONNumber))
-		return json_object_get_number(node, name);
-	return default;
+	return ToNumber(Find(name), defaultValue);
 }
 
-std::string Config::GetString(const char* name, const char* default) const
+std::string Config::GetString(const char* name, const char* defaultValue) const
 {
-	if (json_object_has_value_of_type(node, name, JSONString))
-		return json_object_get_string(node, name);
-	return default;
+	return ToString(Find(name), defaultValue);
 }
 
-bool Config::GetBool(const char* name, bool default) const
+bool Config::GetBool(const char* name, bool defaultValue) const
 {
-	if (json_object_has_value_of_type(node, name, JSONBoolean))
-		return json_object_get_boolean(node, name);
-	return default;
+	return ToBool(Find(name), defaultValue);
 }
 
 Config_Array Config::GetArray(const char* name) const
 {
-	if (json_object_has_value_of_type(node, name, JSONArray))
-		return Config_Array(json_object_get_array(node, name));
+	return ToArray(Find(name), name);
+}
+
+Config Config::GetNode(const char* name) const
+{
+	return Config(json_value_get_object(Find(name)));
+}
+
+bool Config::HasAttribute(const ConfigKey& key) const
+{
+	return Find(key) != nullptr;
+}
+
+double Config::GetNumber(const ConfigKey& key, double defaultValue) const
+{
+	return ToNumber(Find(key), defaultValue);
+}
+
+std::string Config::GetString(const ConfigKey& key, const char* defaultValue) const
+{
+	return ToString(Find(key), defaultValue);
+}
+
+bool Config::GetBool(const ConfigKey& key, bool defaultValue) const
+{
+	return ToBool(Find(key), defaultValue);
+}
+
+Config_Array Config::GetArray(const ConfigKey& key) const
+{
+	return ToArray(Find(key), key.name);
+}
+
+Config Config::GetNode(const ConfigKey& key) const
+{
+	return Config(json_value_get_object(Find(key)));
+}
+//Endof Get attributes---------
+
+JSON_Value* Config::Find(const char* name) const
+{
+	return json_object_get_value(node, name);
+}
+
+JSON_Value* Config::Find(const ConfigKey& key) const
+{
+	uint count = (uint)json_object_get_count(node);
+	uint slot = key.slot.load(std::memory_order_relaxed);
+
+	//Names are compared up to the key length: a match also needs the name to end there
+	if (slot < count)
+	{
+		const char* name = json_object_get_name(node, slot);
+		if (strncmp(name, key.name, key.length) == 0 && name[key.length] == '\0')
+			return json_object_get_value_at(node, slot);
+	}
+
+	for (uint i = 0; i < count; ++i)
+	{
+		const char* name = json_object_get_name(node, i);
+		if (name[0] == key.name[0] && strncmp(name, key.name, key.length) == 0 && name[key.length] == '\0')
+		{
+			key.slot.store(i, std::memory_order_relaxed);
+			return json_object_get_value_at(node, i);
+		}
+	}
+	return nullptr;
+}
+
+double Config::ToNumber(const JSON_Value* value, double defaultValue)
+{
+	return json_value_get_type(value) == JSONNumber ? json_value_get_number(value) : defaultValue;
+}
+
+std::string Config::ToString(const JSON_Value* value, const char* defaultValue)
+{
+	return json_value_get_type(value) == JSONString ? json_value_get_string(value) : defaultValue;
+}
+
+bool Config::ToBool(const JSON_Value* value, bool defaultValue)
+{
+	return json_value_get_type(value) == JSONBoolean ? json_value_get_boolean(value) != 0 : defaultValue;
+}
+
+Config_Array Config::ToArray(const JSON_Value* value, const char* name)
+{
+	if (json_value_get_type(value) == JSONArray)
+		return Config_Array(json_value_get_array(value));
 	else
 	{
 		//Careful, if this else is entered we cause a memory leak, but at least
@@ -112,12 +243,6 @@ Config_Array Config::GetArray(const char* name) const
 	}
 }
 
-Config Config::GetNode(const char* name) const
-{
-	return Config(json_object_get_object(node, name));
-}
-//Endof Get attributes---------
-
 Config_Array::Config_Array()
 {
 	arr = json_value_get_array(json_value_init_array());
@@ -182,32 +307,32 @@ Config Config_Array::AddNode()
 //Endof append attributes-------
 
 //Get attributes ---------------
-double Config_Array::GetNumber(uint index, double default) const
+double Config_Array::GetNumber(uint index, double defaultValue) const
 {
 	if (index < size)
 		return json_array_get_number(arr, index);
 	else
 	{
 		LOG("[Warning] JSON Array: Index out of size");
-		return 0;
+		return defaultValue;
 	}
 }
 
-const char* Config_Array::GetString(uint index, const char* default) const
+const char* Config_Array::GetString(uint index, const char* defaultValue) const
 {
 	if (index < size)
 		return json_array_get_string(arr, index);
 	else
 	{
 		LOG("[Warning] JSON Array: Index out of size");
-		return default;
+		return defaultValue;
 	}
 }
 
-float3 Config_Array::GetFloat3(uint index, float3 default) const
+float3 Config_Array::GetFloat3(uint index, float3 defaultValue) const
 {
 	index *= 3;
-	float3 ret = default;
+	float3 ret = defaultValue;
 
 	ret.x = GetNumber(index + 0, ret.x);
 	ret.y = GetNumber(index + 1, ret.y);
@@ -216,10 +341,10 @@ float3 Config_Array::GetFloat3(uint index, float3 default) const
 	return ret;
 }
 
-float4 Config_Array::GetFloat4(uint index, float4 default) const
+float4 Config_Array::GetFloat4(uint index, float4 defaultValue) const
 {
 	index *= 4;
-	float4 ret = default;
+	float4 ret = defaultValue;
 
 	ret.x = GetNumber(index + 0, ret.x);
 	ret.y = GetNumber(index + 1, ret.y);
@@ -229,10 +354,10 @@ float4 Config_Array::GetFloat4(uint index, float4 default) const
 	return ret;
 }
 
-Quat Config_Array::GetQuat(uint index, Quat  default) const
+Quat Config_Array::GetQuat(uint index, Quat  defaultValue) const
 {
 	index *= 4;
-	Quat ret = default;
+	Quat ret = defaultValue;
 
 	ret.x = GetNumber(index + 0, ret.x);
 	ret.y = GetNumber(index + 1, ret.y);
@@ -242,14 +367,14 @@ Quat Config_Array::GetQuat(uint index, Quat  default) const
 	return ret;
 }
 
-bool Config_Array::GetBool(uint index, bool default) const
+bool Config_Array::GetBool(uint index, bool defaultValue) const
 {
 	if (index < size)
 		return json_array_get_boolean(arr, index);
 	else
 	{
 		LOG("[Warning] JSON Array: Index out of size");
-		return default;
+		return defaultValue;
 	}
 }
 
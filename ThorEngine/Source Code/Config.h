@@ -1,11 +1,12 @@
 #ifndef __CONFIG_H__
 #define __CONFIG_H__
 
-#include "parson\parson.h"
+#include "parson/parson.h"
 #include <string>
 #include "Globals.h"
 #include <vector>
-#include "MathGeoLib\src\MathGeoLib.h"
+#include <atomic>
+#include "MathGeoLib/src/MathGeoLib.h"
 
 //http://kgabis.github.io/parson/
 
@@ -18,6 +19,29 @@ typedef struct json_value_t  JSON_Value;
 struct json_array_t;
 typedef struct json_array_t  JSON_Array;
 
+//Attribute name with its length, computed at compile time. Keys read often are declared once as static constants
+//Objects saved by the same code list their attributes in the same order: a key remembers the slot it was last found
+//at, so reading objects of a known schema takes a single name comparison per attribute instead of a scan
+class ConfigKey
+{
+public:
+	constexpr ConfigKey(const char* name) : name(name), length(Length(name)) {}
+
+	static constexpr uint Length(const char* name)
+	{
+		uint ret = 0;
+		while (name[ret] != '\0') ++ret;
+		return ret;
+	}
+
+public:
+	const char* name;
+	uint length;
+
+	//Shared by every thread reading with the key: a stale slot only costs a scan
+	mutable std::atomic<uint> slot{ 0 };
+};
+
 class Config_Array;
 class Config
 {
@@ -38,6 +62,7 @@ public:
 
 	uint Serialize(char** buffer);	//Returns a filled buffer
 	bool NodeExists();
+	bool HasAttribute(const char* name) const;
 	void Release();
 
 	//Append attributes -----------
@@ -49,13 +74,32 @@ public:
 	//Endof append attributes------
 
 	//Get attributes --------------
-	double GetNumber(const char* name, double default = 0) const;
-	std::string GetString(const char* name, const char* default = "") const;
-	bool GetBool(const char* name, bool default = true) const;
+	double GetNumber(const char* name, double defaultValue = 0) const;
+	std::string GetString(const char* name, const char* defaultValue = "") const;
+	bool GetBool(const char* name, bool defaultValue = true) const;
 	Config_Array GetArray(const char* name) const;
 	Config GetNode(const char* name) const;
+
+	//Same lookups with a precomputed key
+	bool HasAttribute(const ConfigKey& key) const;
+	double GetNumber(const ConfigKey& key, double defaultValue = 0) const;
+	std::string GetString(const ConfigKey& key, const char* defaultValue = "") const;
+	bool GetBool(const ConfigKey& key, bool defaultValue = true) const;
+	Config_Array GetArray(const ConfigKey& key) const;
+	Config GetNode(const ConfigKey& key) const;
 	//Endof Get attributes---------
 	
+private:
+	//Value of an attribute, nullptr if the node does not have it
+	JSON_Value* Find(const char* name) const;
+	JSON_Value* Find(const ConfigKey& key) const;
+
+	//Shared by both lookups: values of another type are taken as missing
+	static double ToNumber(const JSON_Value* value, double defaultValue);
+	static std::string ToString(const JSON_Value* value, const char* defaultValue);
+	static bool ToBool(const JSON_Value* value, bool defaultValue);
+	static Config_Array ToArray(const JSON_Value* value, const char* name);
+
 private:
 	JSON_Value* root_value = nullptr; //Only used for file root
 	JSON_Object* node = nullptr;
@@ -80,12 +124,12 @@ public:
 	//Endof append attributes-------
 
 	//Get attributes ---------------
-	double GetNumber(uint index, double default = 0) const;
-	const char* GetString(uint index, const char* default = "") const;
-	bool GetBool(uint index, bool default = true) const;
-	float3 GetFloat3(uint index, float3 default = float3::zero) const; //Index is based on float3 not on single data!
-	float4 GetFloat4(uint index, float4 default = float4::zero) const; //Index is based on float4 not on single data!
-	Quat GetQuat(uint index, Quat  default = Quat::identity) const;
+	double GetNumber(uint index, double defaultValue = 0) const;
+	const char* GetString(uint index, const char* defaultValue = "") const;
+	bool GetBool(uint index, bool defaultValue = true) const;
+	float3 GetFloat3(uint index, float3 defaultValue = float3::zero) const; //Index is based on float3 not on single data!
+	float4 GetFloat4(uint index, float4 defaultValue = float4::zero) const; //Index is based on float4 not on single data!
+	Quat GetQuat(uint index, Quat  defaultValue = Quat::identity) const;
 	void FillVectorNumber(std::vector<double>& vector) const;
 	void FillVectorString(std::vector<char*>& vector) const;
 	void FillVectorBoool(std::vector<bool>& vector) const;
@@ -0,0 +1,276 @@
+#include "DirectoryScanner.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	//Type and modification date in seconds, as PhysFS reports them
+	bool StatPath(const std::string& path, bool& isDirectory, uint64& modTime)
+	{
+#ifdef _WIN32
+		struct _stat64 pathStat;
+		if (_stat64(path.c_str(), &pathStat) != 0)
+			return false;
+		isDirectory = (pathStat.st_mode & _S_IFDIR) != 0;
+#else
+		struct stat pathStat;
+		if (stat(path.c_str(), &pathStat) != 0)
+			return false;
+		isDirectory = S_ISDIR(pathStat.st_mode);
+#endif
+		modTime = (uint64)pathStat.st_mtime;
+		return true;
+	}
+
+	//Directory modification date with the finest resolution available: seconds would miss the changes made right after a scan
+	uint64 GetDirectoryDate(const std::string& path)
+	{
+#ifdef _WIN32
+		std::error_code error;
+		if (fs::is_directory(path, error) == false)
+			return 0;
+		uint64 date = (uint64)fs::last_write_time(path, error).time_since_epoch().count();
+		return error ? 0 : (date != 0 ? date : 1);
+#else
+		struct stat pathStat;
+		if (stat(path.c_str(), &pathStat) != 0 || S_ISDIR(pathStat.st_mode) == false)
+			return 0;
+		uint64 date = (uint64)pathStat.st_mtim.tv_sec * 1000000000ull + (uint64)pathStat.st_mtim.tv_nsec;
+		return date != 0 ? date : 1;
+#endif
+	}
+
+	inline bool CompareNames(const DirectoryScanner::Entry& a, const DirectoryScanner::Entry& b)
+	{
+		return a.name < b.name;
+	}
+}
+
+DirectoryScanner::DirectoryScanner(const std::vector<std::string>& searchPaths) : searchPaths(searchPaths)
+{
+}
+
+DirectoryScanner::~DirectoryScanner()
+{
+	RELEASE(threads);
+}
+
+bool DirectoryScanner::Scan(const char* directory, bool recursive)
+{
+	std::lock_guard<std::mutex> scanLock(scanMutex);
+	std::string path = Normalize(directory);
+
+	if (recursive)
+	{
+		//Listing mostly waits for the disk: more threads than cores still help when the listings are not cached
+		if (threads == nullptr)
+			threads = new ThreadPool(4);
+
+		threads->Submit([this, path]() { ScanDirectory(path, true); });
+		threads->Wait();
+	}
+	else
+	{
+		ScanDirectory(path, false);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return listings.find(path) != listings.end();
+}
+
+std::shared_ptr<const std::vector<DirectoryScanner::Entry>> DirectoryScanner::GetEntries(const char* directory) const
+{
+	std::string path = Normalize(directory);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	std::map<std::string, Listing>::const_iterator it = listings.find(path);
+	return it != listings.end() ? it->second.entries : nullptr;
+}
+
+bool DirectoryScanner::GetModTime(const char* file, uint64& modTime) const
+{
+	std::string path = Normalize(file);
+	size_t separator = path.find_last_of('/');
+	std::string directory = separator != std::string::npos ? path.substr(0, separator) : "";
+
+	Entry key;
+	key.name = separator != std::string::npos ? path.substr(separator + 1) : path;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	std::map<std::string, Listing>::const_iterator it = listings.find(directory);
+	if (it == listings.end() || it->second.valid == false)
+		return false;
+
+	const std::vector<Entry>& entries = *it->second.entries;
+	std::vector<Entry>::const_iterator entry = std::lower_bound(entries.begin(), entries.end(), key, CompareNames);
+	modTime = (entry != entries.end() && entry->name == key.name) ? entry->modTime : (uint64)-1;
+	return true;
+}
+
+void DirectoryScanner::Invalidate(const char* path)
+{
+	std::string normalized = Normalize(path);
+	size_t separator = normalized.find_last_of('/');
+	std::string directory = separator != std::string::npos ? normalized.substr(0, separator) : "";
+
+	std::lock_guard<std::mutex> lock(mutex);
+	invalidations++;
+
+	std::map<std::string, Listing>::iterator it = listings.find(directory);
+	if (it != listings.end())
+		it->second.valid = false;
+
+	it = listings.find(normalized);
+	if (it != listings.end())
+		it->second.valid = false;
+}
+
+void DirectoryScanner::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	listings.clear();
+}
+
+std::string DirectoryScanner::Normalize(const char* path)
+{
+	std::string ret = path != nullptr ? path : "";
+	std::replace(ret.begin(), ret.end(), '\\', '/');
+	while (ret.empty() == false && ret.back() == '/')
+		ret.pop_back();
+	if (ret == ".")
+		ret.clear();
+	return ret;
+}
+
+void DirectoryScanner::ScanDirectory(const std::string& directory, bool recursive)
+{
+	std::vector<uint64> dates;
+	bool exists = GetDirectoryDates(directory, dates);
+
+	std::vector<std::string> subdirectories;
+	bool current = false;
+	uint64 startInvalidations = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::map<std::string, Listing>::iterator it = listings.find(directory);
+		if (exists == false)
+		{
+			EraseSubtree(directory);
+			return;
+		}
+
+		current = it != listings.end() && it->second.valid && it->second.searchPathDates == dates;
+		if (current && recursive)
+		{
+			const std::vector<Entry>& entries = *it->second.entries;
+			for (uint i = 0; i < entries.size(); ++i)
+			{
+				if (entries[i].isDirectory)
+					subdirectories.push_back(directory.empty() ? entries[i].name : directory + "/" + entries[i].name);
+			}
+		}
+		startInvalidations = invalidations;
+	}
+
+	if (current == false)
+	{
+		std::shared_ptr<std::vector<Entry>> entries = std::make_shared<std::vector<Entry>>();
+		ReadDirectory(directory, dates, *entries);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		Listing& listing = listings[directory];
+
+		//Subdirectories gone since the last listing take their own listings with them
+		if (listing.entries != nullptr)
+		{
+			const std::vector<Entry>& previous = *listing.entries;
+			for (uint i = 0; i < previous.size(); ++i)
+			{
+				if (previous[i].isDirectory == false)
+					continue;
+				std::vector<Entry>::const_iterator entry = std::lower_bound(entries->begin(), entries->end(), previous[i], CompareNames);
+				if (entry == entries->end() || entry->name != previous[i].name || entry->isDirectory == false)
+					EraseSubtree(directory.empty() ? previous[i].name : directory + "/" + previous[i].name);
+			}
+		}
+
+		for (uint i = 0; recursive && i < entries->size(); ++i)
+		{
+			if ((*entries)[i].isDirectory)
+				subdirectories.push_back(directory.empty() ? (*entries)[i].name : directory + "/" + (*entries)[i].name);
+		}
+
+		listing.entries = entries;
+		listing.searchPathDates = dates;
+		//A path invalidated while reading may have been written after it was listed
+		listing.valid = invalidations == startInvalidations;
+	}
+
+	for (uint i = 0; i < subdirectories.size(); ++i)
+	{
+		std::string subdirectory = subdirectories[i];
+		threads->Submit([this, subdirectory]() { ScanDirectory(subdirectory, true); });
+	}
+}
+
+void DirectoryScanner::ReadDirectory(const std::string& directory, const std::vector<uint64>& dates, std::vector<Entry>& entries) const
+{
+	std::error_code error;
+	for (uint i = 0; i < searchPaths.size(); ++i)
+	{
+		if (dates[i] == 0)
+			continue;
+
+		std::string realDirectory = GetRealPath(i, directory);
+		for (fs::directory_iterator it(realDirectory, error), end; !error && it != end; it.increment(error))
+		{
+			Entry entry;
+			entry.name = it->path().filename().generic_string();
+			if (StatPath(realDirectory + "/" + entry.name, entry.isDirectory, entry.modTime))
+				entries.push_back(std::move(entry));
+		}
+		error.clear();
+	}
+
+	//Names found in several search paths keep the first one
+	std::stable_sort(entries.begin(), entries.end(), CompareNames);
+	entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.name == b.name; }), entries.end());
+}
+
+bool DirectoryScanner::GetDirectoryDates(const std::string& directory, std::vector<uint64>& dates) const
+{
+	bool ret = false;
+	dates.resize(searchPaths.size());
+	for (uint i = 0; i < searchPaths.size(); ++i)
+	{
+		dates[i] = GetDirectoryDate(GetRealPath(i, directory));
+		ret |= dates[i] != 0;
+	}
+	return ret;
+}
+
+void DirectoryScanner::EraseSubtree(const std::string& directory)
+{
+	if (directory.empty())
+	{
+		listings.clear();
+		return;
+	}
+
+	listings.erase(directory);
+	std::string prefix = directory + "/";
+	std::map<std::string, Listing>::iterator it = listings.lower_bound(prefix);
+	while (it != listings.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+		it = listings.erase(it);
+}
+
+std::string DirectoryScanner::GetRealPath(uint searchPath, const std::string& path) const
+{
+	return path.empty() ? searchPaths[searchPath] : searchPaths[searchPath] + "/" + path;
+}
@@ -0,0 +1,84 @@
+#ifndef __DIRECTORY_SCANNER_H__
+#define __DIRECTORY_SCANNER_H__
+
+#include "Globals.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+
+class ThreadPool;
+
+//Snapshot of the directory listings under a set of search paths, merged the same way as PhysFS: an entry found in
+//several search paths is taken from the first one
+//Subtrees are listed in parallel. Scanning again only stats the directories: a listing is read again when its directory
+//was modified (an entry added, removed or renamed) or invalidated. Changing a file does not modify its directory: writers
+//invalidate the path so the snapshot keeps its modification date
+class DirectoryScanner
+{
+public:
+	struct Entry
+	{
+		std::string name;
+		bool isDirectory = false;
+		uint64 modTime = 0;		//Seconds since epoch, like PHYSFS_getLastModTime
+	};
+
+	//'searchPaths' are real directories, in search order. Virtual paths are relative to all of them
+	DirectoryScanner(const std::vector<std::string>& searchPaths);
+	~DirectoryScanner();
+
+	//Brings the listing of 'directory', and of every directory under it if 'recursive', up to date
+	//Returns false if 'directory' is not a directory in any search path
+	bool Scan(const char* directory, bool recursive = true);
+
+	//Entries of a scanned directory, sorted by name. nullptr if the directory is not in the snapshot
+	//Listings are never modified: a later scan replaces them, the returned one stays valid
+	std::shared_ptr<const std::vector<Entry>> GetEntries(const char* directory) const;
+
+	//Modification date of a file in a scanned directory. Returns false if the directory is not in the snapshot or has
+	//been invalidated since: the caller has to read it from disk. 'modTime' is (uint64)-1 for missing files
+	bool GetModTime(const char* file, uint64& modTime) const;
+
+	//The directory containing 'path' is listed again in the next scan, and 'path' itself if it is a directory
+	//Safe to call from any thread
+	void Invalidate(const char* path);
+	void Clear();
+
+	//Virtual path without trailing separators, with '/' as separator
+	static std::string Normalize(const char* path);
+
+private:
+	struct Listing
+	{
+		std::shared_ptr<const std::vector<Entry>> entries;
+		std::vector<uint64> searchPathDates;	//Modification date of the directory in each search path, 0 if missing
+		bool valid = true;
+	};
+
+	//Lists 'directory' if it changed and, if 'recursive', queues its subdirectories. Runs in the scanning threads
+	void ScanDirectory(const std::string& directory, bool recursive);
+	void ReadDirectory(const std::string& directory, const std::vector<uint64>& dates, std::vector<Entry>& entries) const;
+
+	//Directory dates in each search path. Returns false if it is not a directory in any of them
+	bool GetDirectoryDates(const std::string& directory, std::vector<uint64>& dates) const;
+
+	//Removes the listings of 'directory' and everything under it. Called with 'mutex' locked
+	void EraseSubtree(const std::string& directory);
+
+	std::string GetRealPath(uint searchPath, const std::string& path) const;
+
+private:
+	std::vector<std::string> searchPaths;
+
+	mutable std::mutex mutex;
+	std::map<std::string, Listing> listings;	//By virtual path: subtrees are contiguous
+	uint64 invalidations = 0;	//Listings read while a path was invalidated are kept as invalid
+
+	std::mutex scanMutex;	//A single scan at a time
+	ThreadPool* threads = nullptr;
+};
+
+#endif //__DIRECTORY_SCANNER_H__
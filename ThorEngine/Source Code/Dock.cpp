@@ -1,8 +1,8 @@
 #include "Dock.h"
 
-#include "ImGui\imgui.h"
+#include "ImGui/imgui.h"
 #define IMGUI_DEFINE_MATH_OPERATORS
-#include "ImGui\imgui_internal.h"
+#include "ImGui/imgui_internal.h"
 
 #include "DWindow.h"
 #include "Engine.h"
@@ -25,7 +25,8 @@ void Emitter::SaveAsset(Config& config) const
 
 	for (uint i = 0; i < modules.size(); ++i)
 	{
-		modules[i]->SaveAsset(modulesArray.AddNode());
+		Config moduleNode = modulesArray.AddNode();
+		modules[i]->SaveAsset(moduleNode);
 	}
 }
 
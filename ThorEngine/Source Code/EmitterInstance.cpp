@@ -20,7 +20,7 @@ void EmitterInstance::Init(Emitter* emitterReference, C_ParticleSystem* componen
 	this->component = component;
 
 	particles.resize(emitterReference->maxParticleCount);
-	particleIndices = new unsigned int[emitterReference->maxParticleCount];
+	particleIndices.resize(emitterReference->maxParticleCount);
 	
 	for (uint i = 0; i < emitterReference->maxParticleCount; ++i)
 	{
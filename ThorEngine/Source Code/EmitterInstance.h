@@ -2,6 +2,9 @@
 #define __EMITTER_INSTANCE_H__
 
 #include "Particle.h"
+#include "MemoryTracker.h"
+
+#include <vector>
 
 class Emitter;
 class C_ParticleSystem;
@@ -29,8 +32,8 @@ public:
 
 	//Particle-related data
 	unsigned int activeParticles = 0;
-	unsigned int* particleIndices;		//Ha ha, nice trick learnt from unreal, this is pure fun.
-	std::vector<Particle> particles;
+	std::vector<unsigned int, MemoryTracker::Allocator<unsigned int, MemoryTracker::Tag::PARTICLES>> particleIndices;		//Ha ha, nice trick learnt from unreal, this is pure fun.
+	std::vector<Particle, MemoryTracker::Allocator<Particle, MemoryTracker::Tag::PARTICLES>> particles;
 
 	Emitter* emitterReference;			//A reference to the emitter resource
 	C_ParticleSystem* component;		//A reference to the particle system component
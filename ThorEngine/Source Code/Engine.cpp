@@ -7,8 +7,10 @@
 #include "M_SceneManager.h"
 #include "M_Renderer3D.h"
 #include "M_Camera3D.h"
-#include "M_Editor.h"
 #include "M_Resources.h"
+#ifndef THOR_HEADLESS
+#include "M_Editor.h"
+#endif
 
 #include "R_Scene.h"
 
@@ -19,6 +21,8 @@
 
 TEngine::TEngine()
 {
+	mainThread = std::this_thread::get_id();
+
 	fileSystem = new M_FileSystem();
 	window = new M_Window();
 	input = new M_Input();
@@ -29,7 +33,9 @@ TEngine::TEngine()
 	camera = new M_Camera3D();
 
 	moduleResources = new M_Resources();
+#ifndef THOR_HEADLESS
 	moduleEditor = new M_Editor();
+#endif
 
 	// Main Modules
 	AddModule(fileSystem);
@@ -42,7 +48,9 @@ TEngine::TEngine()
 	AddModule(moduleResources);
 
 	AddModule(renderer3D);
+#ifndef THOR_HEADLESS
 	AddModule(moduleEditor);
+#endif
 
 	title = TITLE;
 	organization = ORGANIZATION;
@@ -80,7 +88,10 @@ bool TEngine::Init()
 	for (uint i = 0; i < list_modules.size(); i++)
 	{
 		if (list_modules[i]->IsActive())
-			ret = list_modules[i]->Init(node.GetNode(list_modules[i]->name.c_str()));
+		{
+			Config moduleNode = node.GetNode(list_modules[i]->name.c_str());
+			ret = list_modules[i]->Init(moduleNode);
+		}
 	}
 
 	// After all Init calls we call Start() in all modules
@@ -105,9 +116,10 @@ bool TEngine::Init()
 // ---------------------------------------------
 void TEngine::PrepareUpdate()
 {
-	dt = frameTimer.ReadSec();
+	dt = fixedDt > 0.0f ? fixedDt : frameTimer.ReadSec();
 	frameTimer.Start();
 	Time::PreUpdate(dt);
+	FlushPendingLogs();
 }
 
 // ---------------------------------------------
@@ -115,10 +127,12 @@ void TEngine::FinishUpdate()
 {
 	Time::Update();
 	float frame_ms = frameTimer.Read();
+#ifndef THOR_HEADLESS
 	if (frame_ms > 0 && frame_ms < frame_ms_cap)
 	{
 		SDL_Delay(frame_ms_cap - frame_ms);
 	}
+#endif
 
 	frame_count++;
 	if (second_count.Read() >= 1000)
@@ -128,7 +142,9 @@ void TEngine::FinishUpdate()
 		frame_count = 0;
 	}
 
+#ifndef THOR_HEADLESS
 	Engine->moduleEditor->UpdateFPSData(last_FPS, frameTimer.Read());
+#endif
 }
 
 // Call PreUpdate, Update and PostUpdate on all modules
@@ -137,20 +153,29 @@ update_status TEngine::Update()
 	update_status ret = UPDATE_CONTINUE;
 	PrepareUpdate();
 	
+	if (profileModules)
+		moduleTimes.assign(list_modules.size() * UPDATE_STEP_COUNT, 0.0);
+
 	BROFILER_CATEGORY("Engine PreUpdate", Profiler::Color::Yellow)
 	for (uint i = 0; i < list_modules.size() && ret == UPDATE_CONTINUE; i++)
 	{
+		if (profileModules) moduleTimer.Start();
 		ret = list_modules[i]->PreUpdate();
+		if (profileModules) moduleTimes[i * UPDATE_STEP_COUNT + PRE_UPDATE] = moduleTimer.ReadMs();
 	}
 	BROFILER_CATEGORY("Engine Update", Profiler::Color::Purple)
 	for (uint i = 0; i < list_modules.size() && ret == UPDATE_CONTINUE; i++)
 	{
+		if (profileModules) moduleTimer.Start();
 		ret = list_modules[i]->Update();
+		if (profileModules) moduleTimes[i * UPDATE_STEP_COUNT + UPDATE] = moduleTimer.ReadMs();
 	}
 	BROFILER_CATEGORY("Engine PostUpdate", Profiler::Color::Green)
 	for (uint i = 0; i < list_modules.size() && ret == UPDATE_CONTINUE; i++)
 	{
+		if (profileModules) moduleTimer.Start();
 		ret = list_modules[i]->PostUpdate();
+		if (profileModules) moduleTimes[i * UPDATE_STEP_COUNT + POST_UPDATE] = moduleTimer.ReadMs();
 	}
 
 	FinishUpdate();
@@ -169,15 +194,61 @@ bool TEngine::CleanUp()
 	return ret;
 }
 
+void TEngine::SetFixedDeltaTime(float fixedDt)
+{
+	this->fixedDt = fixedDt > 0.0f ? fixedDt : 0.0f;
+	Time::fixedStep = this->fixedDt > 0.0f;
+}
+
+uint TEngine::GetModuleCount() const
+{
+	return list_modules.size();
+}
+
+const Module* TEngine::GetModule(uint index) const
+{
+	return index < list_modules.size() ? list_modules[index] : nullptr;
+}
+
+double TEngine::GetModuleTime(uint index, UpdateStep step) const
+{
+	uint timeIndex = index * UPDATE_STEP_COUNT + step;
+	return timeIndex < moduleTimes.size() ? moduleTimes[timeIndex] : 0.0;
+}
+
 void TEngine::RequestBrowser(char* path)
 {
+#ifdef _WIN32
 	ShellExecuteA(0, "Open", path, 0, "", 3);
+#endif
 }
 
 
 void TEngine::Log(const char* input)
 {
+#ifdef THOR_HEADLESS
+	fprintf(stderr, "%s\n", input);
+#else
+	if (IsMainThread() == false)
+	{
+		std::lock_guard<std::mutex> lock(logMutex);
+		pendingLogs.push_back(input);
+		return;
+	}
 	moduleEditor->Log(input);
+#endif
+}
+
+void TEngine::FlushPendingLogs()
+{
+	std::vector<std::string> logs;
+	{
+		std::lock_guard<std::mutex> lock(logMutex);
+		logs.swap(pendingLogs);
+	}
+
+	for (uint i = 0; i < logs.size(); ++i)
+		Log(logs[i].c_str());
 }
 
 const char* TEngine::GetTitleName() const
@@ -231,7 +302,8 @@ void TEngine::SaveSettingsNow(const char* full_path)
 
 	for (uint i = 0; i < list_modules.size(); i++)
 	{
-		list_modules[i]->SaveConfig(node.SetNode(list_modules[i]->name.c_str()));
+		Config moduleNode = node.SetNode(list_modules[i]->name.c_str());
+		list_modules[i]->SaveConfig(moduleNode);
 	}
 
 	char* buffer = nullptr;
@@ -254,7 +326,8 @@ void TEngine::LoadSettingsNow(const char* full_path)
 		{
 			for (uint i = 0; i < list_modules.size(); i++)
 			{
-				list_modules[i]->LoadConfig(root.GetNode(list_modules[i]->name.c_str()));
+				Config moduleNode = root.GetNode(list_modules[i]->name.c_str());
+				list_modules[i]->LoadConfig(moduleNode);
 			}
 		}
 	}
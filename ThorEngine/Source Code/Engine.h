@@ -5,6 +5,8 @@
 #include "PerfTimer.h"
 #include <string>
 #include <vector>
+#include <thread>
+#include <mutex>
 
 class Module;
 
@@ -44,6 +46,11 @@ private:
 
 	Timer		frameTimer;
 	float		dt;
+	float		fixedDt = 0.0f;
+
+	//Module update profiling
+	PerfTimer			moduleTimer;
+	std::vector<double>	moduleTimes;
 
 	//FPS
 	Timer		second_count;
@@ -51,10 +58,27 @@ private:
 	int			last_FPS;
 
 	std::vector<Module*> list_modules;
+
+	//Messages logged from other threads, shown at the start of the next frame
+	std::thread::id mainThread;
+	std::mutex logMutex;
+	std::vector<std::string> pendingLogs;
 	
 	std::string title;
 	std::string organization;
 
+public:
+	enum UpdateStep
+	{
+		PRE_UPDATE,
+		UPDATE,
+		POST_UPDATE,
+		UPDATE_STEP_COUNT
+	};
+
+	//Measure the time every module spends in each update step
+	bool profileModules = false;
+
 public:
 
 	TEngine();
@@ -66,7 +90,9 @@ public:
 	bool CleanUp();
 
 	void RequestBrowser(char* path);
+	//Safe from any thread. Messages from other threads reach the editor console on the next frame
 	void Log(const char* input);
+	inline bool IsMainThread() const { return std::this_thread::get_id() == mainThread; }
 
 	const char* GetTitleName() const;
 	const char* GetOrganizationName() const;
@@ -76,11 +102,20 @@ public:
 
 	void OnRemoveGameObject(GameObject* gameObject);
 
+	//Every frame advances 'fixedDt' seconds instead of the real elapsed time. 0 goes back to real time
+	void SetFixedDeltaTime(float fixedDt);
+
+	uint GetModuleCount() const;
+	const Module* GetModule(uint index) const;
+	//Time (ms) spent by a module in an update step during the last frame, measured while 'profileModules' is set
+	double GetModuleTime(uint index, UpdateStep step) const;
+
 private:
 
 	void AddModule(Module* mod);
 	void PrepareUpdate();
 	void FinishUpdate();
+	void FlushPendingLogs();
 
 	void SaveSettingsNow(const char*);
 	void LoadSettingsNow(const char*);
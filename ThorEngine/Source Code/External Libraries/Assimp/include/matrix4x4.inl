@@ -412,12 +412,12 @@ inline aiVector3D aiMatrix4x4t<TReal>::GetEuler() const
 
 	if (a3 > static_cast<TReal>(0.998)) { // singularity at north pole
 		euler.z = std::atan2(-b1,b2);
-		euler.y = -(static_cast<TReal>(PI)/static_cast<TReal>(2));
+		euler.y = -(static_cast<TReal>(AI_MATH_PI)/static_cast<TReal>(2));
 		euler.x = static_cast<TReal>(0);
 	}
 	else if (a3 < static_cast<TReal>(-0.998)) { // singularity at south pole
 		euler.z = std::atan2(-b1,b2);
-		euler.y = (static_cast<TReal>(PI)/static_cast<TReal>(2));
+		euler.y = (static_cast<TReal>(AI_MATH_PI)/static_cast<TReal>(2));
 		euler.x = static_cast<TReal>(0);
 	}
 	else
@@ -16,7 +16,9 @@ limitations under the License. */
 /** @file Clock.h
 @brief The Clock class. Supplies timing facilities. */
 
+#ifdef _WIN32
 #define WIN32
+#endif
 
 #ifdef WIN32
 #define Polygon Polygon_unused
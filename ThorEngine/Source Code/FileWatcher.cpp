@@ -0,0 +1,380 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
+
+namespace fs = std::filesystem;
+
+FileWatcher::~FileWatcher()
+{
+	Stop();
+}
+
+bool FileWatcher::Start(const char* directory, bool forcePolling)
+{
+	Stop();
+
+	std::error_code error;
+	this->directory = directory;
+	absoluteRoot = fs::absolute(directory, error).string();
+	if (error || fs::is_directory(absoluteRoot, error) == false)
+	{
+		LOG("[error] Could not watch '%s': directory not found", directory);
+		return false;
+	}
+
+	stopping = false;
+	polling = true;
+
+#ifdef __linux__
+	if (forcePolling == false)
+	{
+		inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyFd >= 0)
+			polling = false;
+		else
+			LOG("[Warning] inotify not available, polling '%s' for changes", directory);
+	}
+#endif
+
+	thread = polling ? std::thread(&FileWatcher::PollingLoop, this) : std::thread(&FileWatcher::InotifyLoop, this);
+	return true;
+}
+
+void FileWatcher::Stop()
+{
+	if (thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(stopMutex);
+			stopping = true;
+		}
+		stopSignal.notify_all();
+		thread.join();
+	}
+
+#ifdef __linux__
+	if (inotifyFd >= 0)
+		close(inotifyFd);
+#endif
+	inotifyFd = -1;
+	watchPaths.clear();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	pending.clear();
+}
+
+void FileWatcher::CollectEvents(std::vector<Event>& events)
+{
+	uint64 now = NowMs();
+	std::vector<Pending> ready;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (std::map<std::string, Pending>::iterator it = pending.begin(); it != pending.end(); )
+		{
+			if (now - it->second.lastMs >= debounceMs)
+			{
+				ready.push_back(it->second);
+				it = pending.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	//Parents are created before their content: sorting by the first change keeps that order
+	std::stable_sort(ready.begin(), ready.end(), [](const Pending& a, const Pending& b) { return a.firstMs < b.firstMs; });
+	for (uint i = 0; i < ready.size(); ++i)
+		events.push_back(ready[i].event);
+}
+
+void FileWatcher::AddEvent(EventType type, const std::string& path, bool isDirectory, const std::string& oldPath)
+{
+	uint64 now = NowMs();
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (type == EventType::RENAMED)
+	{
+		//Changes to the old path are replaced by the rename. A file created and renamed before being reported is just created
+		std::map<std::string, Pending>::iterator oldIt = pending.find(oldPath);
+		bool oldIsNew = oldIt != pending.end() && oldIt->second.event.type == EventType::CREATED;
+		if (oldIt != pending.end())
+			pending.erase(oldIt);
+
+		if (oldIsNew)
+			type = EventType::CREATED;
+	}
+
+	std::map<std::string, Pending>::iterator it = pending.find(path);
+	if (it == pending.end())
+	{
+		Pending& entry = pending[path];
+		entry.event.type = type;
+		entry.event.path = path;
+		entry.event.oldPath = type == EventType::RENAMED ? oldPath : "";
+		entry.event.isDirectory = isDirectory;
+		entry.firstMs = entry.lastMs = now;
+		return;
+	}
+
+	Event& event = it->second.event;
+	it->second.lastMs = now;
+	event.isDirectory = isDirectory;
+
+	switch (type)
+	{
+		case EventType::CREATED:
+		{
+			//Deleted and created again: the content changed
+			if (event.type == EventType::DELETED)
+				event.type = EventType::MODIFIED;
+			break;
+		}
+		case EventType::MODIFIED:
+		{
+			//Created or renamed files keep their event, the content is read when it is processed
+			if (event.type == EventType::DELETED)
+				event.type = EventType::MODIFIED;
+			break;
+		}
+		case EventType::DELETED:
+		{
+			if (event.type == EventType::CREATED)
+			{
+				pending.erase(it);
+			}
+			else
+			{
+				//The file renamed here is gone: its old path still needs to be removed
+				if (event.type == EventType::RENAMED && pending.find(event.oldPath) == pending.end())
+				{
+					Pending& oldEntry = pending[event.oldPath];
+					oldEntry.event.type = EventType::DELETED;
+					oldEntry.event.path = event.oldPath;
+					oldEntry.event.isDirectory = isDirectory;
+					oldEntry.firstMs = it->second.firstMs;
+					oldEntry.lastMs = now;
+				}
+				event.type = EventType::DELETED;
+				event.oldPath.clear();
+			}
+			break;
+		}
+		case EventType::RENAMED:
+		{
+			event.type = EventType::RENAMED;
+			event.oldPath = oldPath;
+			break;
+		}
+	}
+}
+
+uint64 FileWatcher::NowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef __linux__
+void FileWatcher::InotifyLoop()
+{
+	AddWatches("");
+
+	pollfd descriptor = { inotifyFd, POLLIN, 0 };
+	while (stopping == false)
+	{
+		//Short timeout: the loop checks 'stopping'
+		if (poll(&descriptor, 1, 100) > 0)
+			ReadInotifyEvents();
+	}
+}
+
+bool FileWatcher::AddWatches(const std::string& relativePath)
+{
+	const uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+	std::string absolutePath = relativePath.empty() ? absoluteRoot : absoluteRoot + "/" + relativePath;
+	int watch = inotify_add_watch(inotifyFd, absolutePath.c_str(), mask);
+	if (watch < 0)
+	{
+		LOG("[Warning] Could not watch directory '%s'", absolutePath.c_str());
+		return false;
+	}
+	watchPaths[watch] = relativePath;
+
+	//Subdirectories. Files created before the watch existed are found by the scan of the directory creation event
+	std::error_code error;
+	for (fs::directory_iterator it(absolutePath, error), end; it != end; it.increment(error))
+	{
+		std::string childPath = relativePath.empty() ? it->path().filename().string() : relativePath + "/" + it->path().filename().string();
+		if (it->is_directory(error))
+			AddWatches(childPath);
+	}
+	return true;
+}
+
+void FileWatcher::ReadInotifyEvents()
+{
+	alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+
+	//Renames within the tree come as a "moved from" and a "moved to" event sharing a cookie
+	std::map<uint32_t, std::pair<std::string, bool>> movedFrom;
+
+	while (true)
+	{
+		ssize_t size = read(inotifyFd, buffer, sizeof(buffer));
+		if (size <= 0)
+			break;
+
+		for (char* cursor = buffer; cursor < buffer + size; )
+		{
+			const inotify_event* event = (const inotify_event*)cursor;
+			cursor += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				LOG("[Warning] Too many file changes at once, '%s' will be scanned again", directory.c_str());
+				AddEvent(EventType::MODIFIED, directory, true);
+				continue;
+			}
+
+			if (event->mask & IN_IGNORED)
+			{
+				watchPaths.erase(event->wd);
+				continue;
+			}
+
+			std::unordered_map<int, std::string>::iterator watchIt = watchPaths.find(event->wd);
+			if (watchIt == watchPaths.end() || event->len == 0)
+				continue;
+
+			std::string relativePath = watchIt->second.empty() ? event->name : watchIt->second + "/" + event->name;
+			std::string path = directory + "/" + relativePath;
+			bool isDirectory = (event->mask & IN_ISDIR) != 0;
+
+			if (event->mask & IN_MOVED_FROM)
+			{
+				movedFrom[event->cookie] = std::make_pair(relativePath, isDirectory);
+			}
+			else if (event->mask & IN_MOVED_TO)
+			{
+				std::map<uint32_t, std::pair<std::string, bool>>::iterator fromIt = movedFrom.find(event->cookie);
+				if (fromIt != movedFrom.end())
+				{
+					//Watches inside a renamed directory keep working: only their paths change
+					if (isDirectory)
+					{
+						std::string oldPrefix = fromIt->second.first;
+						for (std::unordered_map<int, std::string>::iterator it = watchPaths.begin(); it != watchPaths.end(); ++it)
+						{
+							if (it->second == oldPrefix || it->second.compare(0, oldPrefix.size() + 1, oldPrefix + "/") == 0)
+								it->second = relativePath + it->second.substr(oldPrefix.size());
+						}
+					}
+					AddEvent(EventType::RENAMED, path, isDirectory, directory + "/" + fromIt->second.first);
+					movedFrom.erase(fromIt);
+				}
+				else
+				{
+					if (isDirectory)
+						AddWatches(relativePath);
+					AddEvent(EventType::CREATED, path, isDirectory);
+				}
+			}
+			else if (event->mask & IN_CREATE)
+			{
+				if (isDirectory)
+					AddWatches(relativePath);
+				AddEvent(EventType::CREATED, path, isDirectory);
+			}
+			else if (event->mask & IN_DELETE)
+			{
+				AddEvent(EventType::DELETED, path, isDirectory);
+			}
+			else if (isDirectory == false) //Modified, written or touched
+			{
+				AddEvent(EventType::MODIFIED, path, false);
+			}
+		}
+	}
+
+	//Moved out of the tree
+	for (std::map<uint32_t, std::pair<std::string, bool>>::iterator it = movedFrom.begin(); it != movedFrom.end(); ++it)
+		AddEvent(EventType::DELETED, directory + "/" + it->second.first, it->second.second);
+}
+#else
+void FileWatcher::InotifyLoop()
+{
+}
+
+bool FileWatcher::AddWatches(const std::string& relativePath)
+{
+	return false;
+}
+
+void FileWatcher::ReadInotifyEvents()
+{
+}
+#endif
+
+void FileWatcher::PollingLoop()
+{
+	std::unordered_map<std::string, FileState> snapshot;
+	TakeSnapshot(snapshot);
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(stopMutex);
+			stopSignal.wait_for(lock, std::chrono::milliseconds(pollIntervalMs), [this] { return stopping.load(); });
+			if (stopping)
+				return;
+		}
+
+		std::unordered_map<std::string, FileState> current;
+		TakeSnapshot(current);
+
+		for (std::unordered_map<std::string, FileState>::iterator it = current.begin(); it != current.end(); ++it)
+		{
+			std::unordered_map<std::string, FileState>::iterator previous = snapshot.find(it->first);
+			if (previous == snapshot.end())
+				AddEvent(EventType::CREATED, it->first, it->second.isDirectory);
+			else if (it->second.isDirectory == false && (previous->second.modTime != it->second.modTime || previous->second.size != it->second.size))
+				AddEvent(EventType::MODIFIED, it->first, false);
+		}
+		for (std::unordered_map<std::string, FileState>::iterator it = snapshot.begin(); it != snapshot.end(); ++it)
+		{
+			if (current.find(it->first) == current.end())
+				AddEvent(EventType::DELETED, it->first, it->second.isDirectory);
+		}
+
+		snapshot.swap(current);
+	}
+}
+
+void FileWatcher::TakeSnapshot(std::unordered_map<std::string, FileState>& snapshot) const
+{
+	std::error_code error;
+	for (fs::recursive_directory_iterator it(absoluteRoot, error), end; it != end; it.increment(error))
+	{
+		FileState state;
+		state.isDirectory = it->is_directory(error);
+		if (state.isDirectory == false)
+		{
+			state.size = it->file_size(error);
+			state.modTime = it->last_write_time(error).time_since_epoch().count();
+		}
+
+		std::string relativePath = it->path().lexically_relative(absoluteRoot).generic_string();
+		snapshot[directory + "/" + relativePath] = state;
+	}
+}
@@ -0,0 +1,97 @@
+#ifndef __FILE_WATCHER_H__
+#define __FILE_WATCHER_H__
+
+#include "Globals.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+//Reports the changes made to the files in a directory tree
+//Linux uses inotify, other platforms (or if inotify fails) compare periodic snapshots of the tree
+//Changes are detected in a background thread. Every path gets a single event, sent once the path had no activity
+//during the debounce time: a file written in several steps is reported once
+class FileWatcher
+{
+public:
+	enum class EventType
+	{
+		CREATED,
+		MODIFIED,	//Directories get it if their changes could not be tracked and they need a full rescan
+		DELETED,
+		RENAMED,	//From 'oldPath'. Only inotify reports them, polling sees a deletion and a creation
+	};
+
+	struct Event
+	{
+		EventType type = EventType::MODIFIED;
+		std::string path;
+		std::string oldPath;
+		bool isDirectory = false;
+	};
+
+	~FileWatcher();
+
+	//Paths in the events start with 'directory', as given
+	bool Start(const char* directory, bool forcePolling = false);
+	void Stop();
+
+	//Moves to 'events' the changes that have been quiet for the debounce time, oldest first
+	void CollectEvents(std::vector<Event>& events);
+
+	inline bool IsPolling() const { return polling; }
+
+public:
+	uint debounceMs = 250;
+	uint pollIntervalMs = 1000;
+
+private:
+	struct Pending
+	{
+		Event event;
+		uint64 firstMs = 0;
+		uint64 lastMs = 0;
+	};
+
+	struct FileState
+	{
+		uint64 modTime = 0;
+		uint64 size = 0;
+		bool isDirectory = false;
+	};
+
+	void InotifyLoop();
+	bool AddWatches(const std::string& relativePath);
+	void ReadInotifyEvents();
+
+	void PollingLoop();
+	void TakeSnapshot(std::unordered_map<std::string, FileState>& snapshot) const;
+
+	//Merges the change with the pending one for the same path
+	void AddEvent(EventType type, const std::string& path, bool isDirectory, const std::string& oldPath = "");
+
+	static uint64 NowMs();
+
+private:
+	std::string directory;		//As given, prefix of every reported path
+	std::string absoluteRoot;
+
+	std::thread thread;
+	std::atomic<bool> stopping = { false };
+	std::mutex stopMutex;
+	std::condition_variable stopSignal;
+	bool polling = false;
+
+	int inotifyFd = -1;
+	std::unordered_map<int, std::string> watchPaths;	//inotify watch descriptor to path relative to the root
+
+	std::mutex mutex;
+	std::map<std::string, Pending> pending;
+};
+
+#endif //__FILE_WATCHER_H__
@@ -10,6 +10,8 @@
 #include "C_Camera.h"
 #include "C_Animator.h"
 #include "C_Billboard.h"
+
+#include <algorithm>
 #include "C_ParticleSystem.h"
 
 GameObject::GameObject() : TreeNode(GAMEOBJECT)
@@ -227,6 +229,18 @@ void GameObject::CollectChilds(std::vector<const GameObject*>& vector) const
 		childs[i]->CollectChilds(vector);
 }
 
+void GameObject::CollectResources(std::vector<uint64>& resources) const
+{
+	for (uint i = 0; i < components.size(); ++i)
+	{
+		if (components[i]->HasResource() && components[i]->GetResourceID() != 0)
+			resources.push_back(components[i]->GetResourceID());
+	}
+
+	for (uint i = 0; i < childs.size(); i++)
+		childs[i]->CollectResources(resources);
+}
+
 GameObject* GameObject::FindChildByName(const char* name) const
 {
 	std::vector<GameObject*>::const_iterator it;
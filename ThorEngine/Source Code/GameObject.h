@@ -11,12 +11,15 @@
 
 #include <vector>
 #include "Component.h"
+#include "MemoryTracker.h"
 
 class C_Transform;
 class Config;
 
 class GameObject : public TreeNode
 {
+	MEMORY_TAG(MemoryTracker::Tag::GAMEOBJECTS)
+
 public:
 	GameObject();
 	GameObject(GameObject* parent,  const char* name = "No name", const float3& translation = float3::zero, const Quat& rotation = Quat::identity, const float3& scale = float3::one);
@@ -40,6 +43,8 @@ public:
 
 	void CollectChilds(std::vector<GameObject*>& vector);
 	void CollectChilds(std::vector<const GameObject*>& vector) const;
+	//Resources used by the components of the GameObject and all its childs
+	void CollectResources(std::vector<uint64>& resources) const;
 	GameObject* FindChildByName(const char* name) const;
 	GameObject* GetChild(uint index) const;
 
@@ -4,7 +4,7 @@
 #include "Globals.h"
 #include "OpenGL.h"
 #include "Color.h"
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 
 class Gizmos
 {
@@ -1,7 +1,9 @@
 #ifndef __GLOBALS_H__
 #define __GLOBALS_H__
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <stdio.h>
 
 #define LIBRARY_PATH "Library/"
@@ -15,8 +17,11 @@
 #define PARTICLES_PATH "Library/ParticleSystems/"
 #define SHADERS_PATH "Library/Shaders/"
 #define SCENES_PATH "Library/Scenes/"
+#define ASSET_DATABASE_FILE "Library/AssetDatabase"
+#define LIBRARY_PACK_FILE "Library/Library.pack"
+#define TEMP_PATH "Library/Temp/"
 
-#define LOG(format, ...) log(__FILE__, __LINE__, format, __VA_ARGS__)
+#define LOG(format, ...) log(__FILE__, __LINE__, format, ##__VA_ARGS__)
 
 void log(const char file[], int line, const char* format, ...);
 
@@ -27,7 +32,7 @@ void log(const char file[], int line, const char* format, ...);
 #define HAVE_M_PI
 
 typedef unsigned int uint;
-typedef unsigned __int64 uint64;
+typedef unsigned long long uint64;
 
 enum update_status
 {
@@ -0,0 +1,102 @@
+#include "Hash.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+namespace Hash
+{
+	static const uint64 PRIME_1 = 11400714785074694791ull;
+	static const uint64 PRIME_2 = 14029467366897019727ull;
+	static const uint64 PRIME_3 = 1609587929392839161ull;
+	static const uint64 PRIME_4 = 9650029242287828579ull;
+	static const uint64 PRIME_5 = 2870177450012600261ull;
+
+	inline uint64 RotateLeft(uint64 value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+	//Unaligned little endian reads
+	inline uint64 Read64(const unsigned char* data) { uint64 value; memcpy(&value, data, sizeof(value)); return value; }
+	inline uint64 Read32(const unsigned char* data) { unsigned int value; memcpy(&value, data, sizeof(value)); return value; }
+
+	inline uint64 Round(uint64 accumulator, uint64 input)
+	{
+		accumulator += input * PRIME_2;
+		accumulator = RotateLeft(accumulator, 31);
+		return accumulator * PRIME_1;
+	}
+
+	inline uint64 MergeRound(uint64 accumulator, uint64 value)
+	{
+		accumulator ^= Round(0, value);
+		return accumulator * PRIME_1 + PRIME_4;
+	}
+}
+
+uint64 Hash::Compute(const void* data, uint64 size, uint64 seed)
+{
+	const unsigned char* cursor = (const unsigned char*)data;
+	const unsigned char* end = cursor + size;
+	uint64 hash;
+
+	if (size >= 32)
+	{
+		//Four independent lanes over 32 byte stripes
+		uint64 v1 = seed + PRIME_1 + PRIME_2;
+		uint64 v2 = seed + PRIME_2;
+		uint64 v3 = seed;
+		uint64 v4 = seed - PRIME_1;
+
+		const unsigned char* limit = end - 32;
+		do
+		{
+			v1 = Round(v1, Read64(cursor)); cursor += 8;
+			v2 = Round(v2, Read64(cursor)); cursor += 8;
+			v3 = Round(v3, Read64(cursor)); cursor += 8;
+			v4 = Round(v4, Read64(cursor)); cursor += 8;
+		} while (cursor <= limit);
+
+		hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+		hash = MergeRound(hash, v1);
+		hash = MergeRound(hash, v2);
+		hash = MergeRound(hash, v3);
+		hash = MergeRound(hash, v4);
+	}
+	else
+	{
+		hash = seed + PRIME_5;
+	}
+
+	hash += size;
+
+	for (; cursor + 8 <= end; cursor += 8)
+		hash = RotateLeft(hash ^ Round(0, Read64(cursor)), 27) * PRIME_1 + PRIME_4;
+
+	if (cursor + 4 <= end)
+	{
+		hash = RotateLeft(hash ^ (Read32(cursor) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+		cursor += 4;
+	}
+
+	for (; cursor < end; ++cursor)
+		hash = RotateLeft(hash ^ (*cursor * PRIME_5), 11) * PRIME_1;
+
+	//Final avalanche
+	hash ^= hash >> 33;
+	hash *= PRIME_2;
+	hash ^= hash >> 29;
+	hash *= PRIME_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+std::string Hash::ToString(uint64 hash)
+{
+	char string[17];
+	snprintf(string, 17, "%016llx", (unsigned long long)hash);
+	return string;
+}
+
+uint64 Hash::FromString(const char* string)
+{
+	return strtoull(string, nullptr, 16);
+}
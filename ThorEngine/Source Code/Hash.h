@@ -0,0 +1,22 @@
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include "Globals.h"
+
+#include <string>
+
+//Fast non-cryptographic hashing, used to detect content changes (xxHash64)
+namespace Hash
+{
+	uint64 Compute(const void* data, uint64 size, uint64 seed = 0);
+	inline uint64 Compute(const std::string& text, uint64 seed = 0) { return Compute(text.data(), text.size(), seed); }
+
+	//Order dependent: Combine(a, b) != Combine(b, a)
+	inline uint64 Combine(uint64 hash, uint64 value) { return Compute(&value, sizeof(value), hash); }
+
+	//Hashes are saved as hexadecimal strings: JSON numbers cannot hold 64 bits
+	std::string ToString(uint64 hash);
+	uint64 FromString(const char* string);
+}
+
+#endif //__HASH_H__
@@ -0,0 +1,547 @@
+#include "IOService.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace
+{
+	const uint minBufferSize = 4096;
+	const uint maxPooledBufferSize = 16 * 1024 * 1024;
+	const uint64 maxPooledBytes = 64 * 1024 * 1024;
+
+#ifdef __linux__
+	//io_uring instance used by a single thread: submission and completion rings shared with the kernel
+	class Ring
+	{
+	public:
+		~Ring() { Close(); }
+
+		bool Init(uint entries)
+		{
+			io_uring_params params;
+			memset(&params, 0, sizeof(params));
+			fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+			if (fd < 0)
+				return false;
+
+			sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMap)
+				sqSize = cqSize = sqSize > cqSize ? sqSize : cqSize;
+
+			sqRing = Map(sqSize, IORING_OFF_SQ_RING);
+			cqRing = singleMap ? sqRing : Map(cqSize, IORING_OFF_CQ_RING);
+			sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+			sqes = (io_uring_sqe*)Map(sqesSize, IORING_OFF_SQES);
+			if (sqRing == nullptr || cqRing == nullptr || sqes == nullptr)
+			{
+				Close();
+				return false;
+			}
+
+			sqTail = (unsigned*)((char*)sqRing + params.sq_off.tail);
+			sqMask = *(unsigned*)((char*)sqRing + params.sq_off.ring_mask);
+			sqArray = (unsigned*)((char*)sqRing + params.sq_off.array);
+			cqHead = (unsigned*)((char*)cqRing + params.cq_off.head);
+			cqTail = (unsigned*)((char*)cqRing + params.cq_off.tail);
+			cqMask = *(unsigned*)((char*)cqRing + params.cq_off.ring_mask);
+			cqes = (io_uring_cqe*)((char*)cqRing + params.cq_off.cqes);
+			return true;
+		}
+
+		void Close()
+		{
+			if (sqes != nullptr) munmap(sqes, sqesSize);
+			if (cqRing != nullptr && cqRing != sqRing) munmap(cqRing, cqSize);
+			if (sqRing != nullptr) munmap(sqRing, sqSize);
+			if (fd >= 0) close(fd);
+			sqes = nullptr;
+			sqRing = cqRing = nullptr;
+			fd = -1;
+		}
+
+		inline bool IsOpen() const { return fd >= 0; }
+
+		//Only the owner thread writes the submission tail: it is published with a release store
+		void QueueRead(int file, iovec* vector, uint64 userData)
+		{
+			unsigned tail = *sqTail;
+			unsigned index = tail & sqMask;
+
+			io_uring_sqe& sqe = sqes[index];
+			memset(&sqe, 0, sizeof(sqe));
+			sqe.opcode = IORING_OP_READV;
+			sqe.fd = file;
+			sqe.addr = (uint64)vector;
+			sqe.len = 1;
+			sqe.off = 0;
+			sqe.user_data = userData;
+
+			sqArray[index] = index;
+			__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+		}
+
+		//Submits 'count' queued reads and calls 'onCompleted(userData, result)' for each of them
+		//Returns false if the ring failed: reads not reported yet may not have run
+		template <typename Function>
+		bool Run(uint count, Function onCompleted)
+		{
+			uint toSubmit = count;
+			uint reaped = 0;
+			while (reaped < count)
+			{
+				int ret = (int)syscall(__NR_io_uring_enter, fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+				if (ret < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					return false;
+				}
+				toSubmit -= (uint)ret < toSubmit ? (uint)ret : toSubmit;
+
+				unsigned head = *cqHead;
+				unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+				for (; head != tail; ++head, ++reaped)
+				{
+					const io_uring_cqe& cqe = cqes[head & cqMask];
+					onCompleted(cqe.user_data, cqe.res);
+				}
+				__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+			}
+			return true;
+		}
+
+	private:
+		void* Map(size_t size, off_t offset)
+		{
+			void* ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+			return ret != MAP_FAILED ? ret : nullptr;
+		}
+
+	private:
+		int fd = -1;
+
+		void* sqRing = nullptr;
+		void* cqRing = nullptr;
+		size_t sqSize = 0;
+		size_t cqSize = 0;
+		io_uring_sqe* sqes = nullptr;
+		size_t sqesSize = 0;
+
+		unsigned* sqTail = nullptr;
+		unsigned sqMask = 0;
+		unsigned* sqArray = nullptr;
+		unsigned* cqHead = nullptr;
+		unsigned* cqTail = nullptr;
+		unsigned cqMask = 0;
+		io_uring_cqe* cqes = nullptr;
+	};
+#endif
+}
+
+IOService::IOService(uint threadCount, ReadResolver resolver, Writer writer, bool useRing) : resolver(resolver), writer(writer)
+{
+#ifdef __linux__
+	//Kernels without io_uring (or sandboxes blocking it) fail to create the ring
+	Ring probe;
+	ringReads = useRing && probe.Init(batchSize);
+#endif
+
+	for (uint i = 0; i < (threadCount > 0 ? threadCount : 1); ++i)
+		threads.push_back(std::thread(&IOService::WorkerLoop, this));
+}
+
+IOService::~IOService()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	requestQueued.notify_all();
+
+	for (uint i = 0; i < threads.size(); ++i)
+		threads[i].join();
+
+	for (uint i = 0; i < completions.size(); ++i)
+	{
+		RELEASE_ARRAY(completions[i]->buffer);
+		RELEASE(completions[i]);
+	}
+
+	for (uint i = 0; i < 32; ++i)
+	{
+		for (uint b = 0; b < freeBuffers[i].size(); ++b)
+			RELEASE_ARRAY(freeBuffers[i][b]);
+	}
+}
+
+void IOService::Submit(IORequest* request)
+{
+	Submit(std::vector<IORequest*>(1, request));
+}
+
+void IOService::Submit(const std::vector<IORequest*>& batch)
+{
+	if (batch.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (uint i = 0; i < batch.size(); ++i)
+		{
+			if (batch[i]->type == IORequest::Type::WRITE)
+			{
+				writes.push_back(batch[i]);
+				pendingWrites[batch[i]->file]++;
+			}
+			else
+				reads[(int)batch[i]->priority].push_back(batch[i]);
+		}
+	}
+	requestQueued.notify_all();
+}
+
+void IOService::Promote(const IORequest* request, IOPriority priority)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (int p = (int)priority + 1; p < (int)IOPriority::COUNT; ++p)
+	{
+		//Only compared: 'request' may have finished and been deleted already
+		std::deque<IORequest*>::iterator it = std::find(reads[p].begin(), reads[p].end(), request);
+		if (it != reads[p].end())
+		{
+			IORequest* promoted = *it;
+			reads[p].erase(it);
+			promoted->priority = priority;
+			reads[(int)priority].push_back(promoted);
+			return;
+		}
+	}
+}
+
+void IOService::RunCompletions()
+{
+	std::vector<IORequest*> finished;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (completions.empty())
+			return;
+		finished.swap(completions);
+	}
+
+	for (uint i = 0; i < finished.size(); ++i)
+	{
+		if (finished[i]->onComplete)
+			finished[i]->onComplete(*finished[i]);
+		RELEASE(finished[i]);
+	}
+}
+
+void IOService::Wait()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		requestFinished.wait(lock, [this]
+		{
+			for (uint p = 0; p < (uint)IOPriority::COUNT; ++p)
+			{
+				if (reads[p].empty() == false)
+					return false;
+			}
+			return writes.empty() && runningRequests == 0;
+		});
+	}
+	RunCompletions();
+}
+
+void IOService::WaitWrites(const char* file) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (pendingWrites.empty())
+		return;
+
+	requestFinished.wait(lock, [this, file] { return pendingWrites.find(file) == pendingWrites.end(); });
+}
+
+char* IOService::AcquireBuffer(uint size, uint& capacity)
+{
+	if (size > maxPooledBufferSize)
+	{
+		capacity = size;
+		return new char[size];
+	}
+
+	uint sizeClass = GetSizeClass(size);
+	capacity = minBufferSize << sizeClass;
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		if (freeBuffers[sizeClass].empty() == false)
+		{
+			char* ret = freeBuffers[sizeClass].back();
+			freeBuffers[sizeClass].pop_back();
+			pooledBytes -= capacity;
+			return ret;
+		}
+	}
+	return new char[capacity];
+}
+
+void IOService::ReleaseBuffer(char* buffer, uint capacity)
+{
+	if (buffer == nullptr)
+		return;
+
+	//Buffers not taken from the pool are just deleted
+	if (capacity >= minBufferSize && capacity <= maxPooledBufferSize && (capacity & (capacity - 1)) == 0)
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		if (pooledBytes + capacity <= maxPooledBytes)
+		{
+			freeBuffers[GetSizeClass(capacity)].push_back(buffer);
+			pooledBytes += capacity;
+			return;
+		}
+	}
+	RELEASE_ARRAY(buffer);
+}
+
+void IOService::WorkerLoop()
+{
+	void* ring = nullptr;
+#ifdef __linux__
+	Ring threadRing;
+	if (ringReads && threadRing.Init(batchSize))
+		ring = &threadRing;
+#endif
+
+	std::vector<IORequest*> requests;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (TakeRequests(requests) == false)
+			{
+				//Reads waiting for a write are finished by the thread running it
+				if (stopping && runningRequests == 0)
+					return;
+				requestQueued.wait(lock);
+			}
+			runningRequests += requests.size();
+		}
+
+		if (requests[0]->type == IORequest::Type::WRITE)
+		{
+			IORequest* request = requests[0];
+			request->succeeded = writer(*request);
+			RELEASE_ARRAY(request->buffer);
+			Finish(request);
+		}
+		else
+		{
+			RunReads(requests, ring);
+		}
+		requests.clear();
+	}
+}
+
+bool IOService::TakeRequests(std::vector<IORequest*>& requests)
+{
+	//Writes go one at a time, so writes of the same file keep their order
+	if (writing == false && writes.empty() == false)
+	{
+		requests.push_back(writes.front());
+		writes.pop_front();
+		writing = true;
+		return true;
+	}
+
+	for (uint p = 0; p < (uint)IOPriority::COUNT && requests.size() < batchSize; ++p)
+	{
+		std::deque<IORequest*>& queue = reads[p];
+		for (std::deque<IORequest*>::iterator it = queue.begin(); it != queue.end() && requests.size() < batchSize; )
+		{
+			//A read of a file being written waits for it
+			if (pendingWrites.empty() == false && pendingWrites.find((*it)->file) != pendingWrites.end())
+			{
+				++it;
+				continue;
+			}
+			requests.push_back(*it);
+			it = queue.erase(it);
+		}
+	}
+	return requests.empty() == false;
+}
+
+void IOService::RunReads(std::vector<IORequest*>& requests, void* ring)
+{
+#ifdef __linux__
+	Ring* uring = (Ring*)ring;
+	std::vector<int> files(requests.size(), -1);
+	std::vector<iovec> vectors(requests.size());
+	uint queued = 0;
+#endif
+
+	for (uint i = 0; i < requests.size(); ++i)
+	{
+		IORequest& request = *requests[i];
+		if (resolver(request))
+			continue;
+		if (request.realPath.empty())
+		{
+			request.succeeded = false;
+			continue;
+		}
+
+#ifdef __linux__
+		if (uring != nullptr)
+		{
+			struct stat fileStat;
+			int file = open(request.realPath.c_str(), O_RDONLY | O_CLOEXEC);
+			if (file >= 0 && fstat(file, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && (uint64)fileStat.st_size < 0xFFFFFFFFull)
+			{
+				request.size = (uint)fileStat.st_size;
+				request.buffer = AcquireBuffer(request.size + 1, request.capacity);
+				request.buffer[request.size] = '\0';
+				request.succeeded = true;
+				if (request.size > 0)
+				{
+					files[i] = file;
+					vectors[i].iov_base = request.buffer;
+					vectors[i].iov_len = request.size;
+					uring->QueueRead(file, &vectors[i], i);
+					++queued;
+					continue;
+				}
+			}
+			if (file >= 0)
+				close(file);
+		}
+#endif
+		if (request.buffer == nullptr)
+			request.succeeded = ReadFile(request);
+	}
+
+#ifdef __linux__
+	if (queued > 0)
+	{
+		bool ringFailed = uring->Run(queued, [&](uint64 index, int result)
+		{
+			IORequest& request = *requests[index];
+			//Short reads are finished with blocking calls
+			uint64 done = result > 0 ? (uint64)result : 0;
+			while (result >= 0 && done < request.size)
+			{
+				ssize_t read = pread(files[index], request.buffer + done, request.size - done, (off_t)done);
+				if (read <= 0)
+					break;
+				done += (uint64)read;
+			}
+			request.succeeded = done == request.size;
+			close(files[index]);
+			files[index] = -1;
+		}) == false;
+
+		//Without a working ring, reads not completed yet are issued again without it
+		//Their buffers are not reused: the kernel may still be writing into them
+		if (ringFailed)
+		{
+			uring->Close();
+			for (uint i = 0; i < requests.size(); ++i)
+			{
+				if (files[i] < 0)
+					continue;
+				close(files[i]);
+				requests[i]->buffer = nullptr;
+				requests[i]->succeeded = ReadFile(*requests[i]);
+			}
+		}
+	}
+#endif
+
+	for (uint i = 0; i < requests.size(); ++i)
+	{
+		if (requests[i]->succeeded == false)
+		{
+			ReleaseBuffer(requests[i]->buffer, requests[i]->capacity);
+			requests[i]->buffer = nullptr;
+			requests[i]->size = requests[i]->capacity = 0;
+		}
+		Finish(requests[i]);
+	}
+}
+
+bool IOService::ReadFile(IORequest& request)
+{
+	FILE* file = fopen(request.realPath.c_str(), "rb");
+	if (file == nullptr)
+		return false;
+
+	bool ret = false;
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		long size = ftell(file);
+		if (size >= 0 && fseek(file, 0, SEEK_SET) == 0)
+		{
+			request.size = (uint)size;
+			request.buffer = AcquireBuffer(request.size + 1, request.capacity);
+			request.buffer[request.size] = '\0';
+			ret = fread(request.buffer, 1, request.size, file) == request.size;
+		}
+	}
+	fclose(file);
+	return ret;
+}
+
+void IOService::Finish(IORequest* request)
+{
+	//Callbacks run before the request counts as finished: Wait also waits for them
+	bool mainThread = request->completeOnMainThread;
+	if (mainThread == false && request->onComplete)
+		request->onComplete(*request);
+
+	bool wrote = request->type == IORequest::Type::WRITE;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (wrote)
+		{
+			std::unordered_map<std::string, uint>::iterator it = pendingWrites.find(request->file);
+			if (--it->second == 0)
+				pendingWrites.erase(it);
+			writing = false;
+		}
+		runningRequests--;
+
+		if (mainThread)
+			completions.push_back(request);
+	}
+
+	if (mainThread == false)
+		RELEASE(request);
+
+	requestFinished.notify_all();
+	//Writes unblock the next write and the reads of their file
+	if (wrote)
+		requestQueued.notify_all();
+}
+
+uint IOService::GetSizeClass(uint size)
+{
+	uint sizeClass = 0;
+	while ((minBufferSize << sizeClass) < size)
+		++sizeClass;
+	return sizeClass;
+}
@@ -0,0 +1,135 @@
+#ifndef __IO_SERVICE_H__
+#define __IO_SERVICE_H__
+
+#include "Globals.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//Higher priorities are served first. Requests of the same priority run in submission order
+enum class IOPriority
+{
+	HIGH,		//Content needed right now: a load the main thread waits for
+	NORMAL,
+	PREFETCH,	//Background reads that may not be used soon
+	COUNT
+};
+
+struct IORequest
+{
+	enum class Type
+	{
+		READ,
+		WRITE,
+	};
+
+	Type type = Type::READ;
+	IOPriority priority = IOPriority::NORMAL;
+	std::string file;
+
+	//Reads: filled by the service with a null terminated buffer of the pool, 'capacity' bytes long. Release it
+	//with IOService::ReleaseBuffer (or RELEASE_ARRAY: it is then not reused)
+	//Writes: content to write, allocated with new[]. The service takes ownership
+	char* buffer = nullptr;
+	uint size = 0;
+	uint capacity = 0;
+
+	//Set by the service's read resolver: path on disk, empty if the resolver already read the file
+	std::string realPath;
+
+	bool succeeded = false;
+
+	//Called once the request finished, in the main thread (IOService::RunCompletions) or, without 'completeOnMainThread',
+	//in the I/O thread as soon as it finishes. The request is deleted afterwards
+	std::function<void(IORequest&)> onComplete;
+	bool completeOnMainThread = true;
+};
+
+//Runs file reads and writes in a pool of I/O threads
+//Each thread takes a batch of queued reads and issues them together: with io_uring on Linux, when the kernel
+//supports it, or one after the other elsewhere. Writes run one at a time in submission order, and reads of a
+//file wait until its queued writes have finished
+class IOService
+{
+public:
+	//Runs in the I/O threads before a read. Fills 'realPath', or reads the file itself and returns true
+	typedef std::function<bool(IORequest&)> ReadResolver;
+	//Runs a write in the I/O threads, returns the result
+	typedef std::function<bool(const IORequest&)> Writer;
+
+	//'useRing' false issues every read with blocking calls
+	IOService(uint threadCount, ReadResolver resolver, Writer writer, bool useRing = true);
+	//Queued requests are finished. Main thread completions are dropped
+	~IOService();
+
+	//The service owns the requests until they complete
+	void Submit(IORequest* request);
+	void Submit(const std::vector<IORequest*>& batch);
+
+	//Moves a request still queued to a higher priority. Nothing happens if it already started
+	void Promote(const IORequest* request, IOPriority priority);
+
+	//Runs the main thread completions of the finished requests
+	void RunCompletions();
+
+	//Blocks until every submitted request has finished and runs the main thread completions
+	void Wait();
+	//Blocks while 'file' has queued or running writes
+	void WaitWrites(const char* file) const;
+
+	//Recycled read buffers: sizes are rounded up to a power of two, at least 4KB
+	char* AcquireBuffer(uint size, uint& capacity);
+	void ReleaseBuffer(char* buffer, uint capacity);
+
+	inline bool IsUsingRing() const { return ringReads; }
+
+private:
+	void WorkerLoop();
+
+	//Takes the next writes or batch of reads. Called with 'mutex' locked
+	bool TakeRequests(std::vector<IORequest*>& requests);
+
+	void RunReads(std::vector<IORequest*>& reads, void* ring);
+	bool ReadFile(IORequest& request);
+	void Finish(IORequest* request);
+
+	static uint GetSizeClass(uint size);
+
+public:
+	//Reads issued together by a thread
+	static const uint batchSize = 32;
+
+private:
+	ReadResolver resolver;
+	Writer writer;
+	bool ringReads = false;
+
+	std::vector<std::thread> threads;
+	bool stopping = false;
+
+	mutable std::mutex mutex;
+	std::condition_variable requestQueued;
+	mutable std::condition_variable requestFinished;
+
+	std::deque<IORequest*> reads[(int)IOPriority::COUNT];
+	std::deque<IORequest*> writes;
+	bool writing = false;
+	uint runningRequests = 0;
+
+	//Queued and running writes by file
+	std::unordered_map<std::string, uint> pendingWrites;
+	//Finished requests waiting for RunCompletions, in completion order
+	std::vector<IORequest*> completions;
+
+	std::mutex poolMutex;
+	std::vector<char*> freeBuffers[32];		//By size class
+	uint64 pooledBytes = 0;
+};
+
+#endif //__IO_SERVICE_H__
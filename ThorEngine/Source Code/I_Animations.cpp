@@ -118,7 +118,7 @@ void Importer::Animations::Load(const char* buffer, R_Animation* rAnimation)
 	{
 		Channel newChannel;
 		Private::LoadChannel(newChannel, &cursor);
-		rAnimation->channels[newChannel.name.c_str()] = newChannel;
+		rAnimation->channels[newChannel.name] = std::move(newChannel);
 	}
 }
 
@@ -218,13 +218,9 @@ void Importer::Animations::Private::LoadChannel(Channel& channel, const char** c
 
 	if (nameSize > 0)
 	{
-		char* string = new char[nameSize + 1];
 		bytes = sizeof(char) * nameSize;
-		memcpy(string, *cursor, bytes);
+		channel.name.assign(*cursor, bytes);
 		*cursor += bytes;
-		string[nameSize] = '\0';
-		channel.name = string;
-		RELEASE_ARRAY(string);
 	}
 
 	//Ranges
@@ -249,7 +245,8 @@ void Importer::Animations::Private::LoadChannelKeys(std::map<double, float3>& ma
 		memcpy(&data, *cursor, sizeof(float) * 3);
 		*cursor += sizeof(float) * 3;
 
-		map[time] = float3(data);
+		//Keys are saved in order, each one goes at the end of the map
+		map.emplace_hint(map.end(), time, float3(data));
 	}
 }
 
@@ -264,6 +261,6 @@ void Importer::Animations::Private::LoadChannelKeys(std::map<double, Quat>& map,
 		memcpy(&data, *cursor, sizeof(float) * 4);
 		*cursor += sizeof(float) * 4;
 
-		map[time] = Quat(data);
+		map.emplace_hint(map.end(), time, Quat(data));
 	}
 }
\ No newline at end of file
@@ -10,12 +10,21 @@
 #include "Assimp/include/material.h"
 #include "Assimp/include/texture.h"
 
+#ifdef THOR_HEADLESS
+#include "OpenGL.h"
+#else
 #pragma comment( lib, "Devil/libx86/DevIL.lib" )
-#include "Devil\include\ilu.h"
+#include "Devil/include/ilu.h"
 #pragma comment( lib, "Devil/libx86/ILU.lib" )
-#include "Devil\include\ilut.h"
+#include "Devil/include/ilut.h"
 #pragma comment( lib, "Devil/libx86/ILUT.lib" )
 
+#include <mutex>
+
+//DevIL keeps the bound image as global state: image calls from different threads cannot overlap
+static std::mutex devilMutex;
+#endif
+
 
 /*
 R_Texture* M_Materials::ImportPrefabImage(char* buffer, uint64 ID, const char* source_file, uint sizeX, uint sizeY)
@@ -74,6 +83,11 @@ R_Material* Importer::Materials::Create()
 //TODO: Find texture in hard drive, duplicate it and import it next to the scene
 void Importer::Materials::Import(const aiMaterial* material, R_Material* rMaterial)
 {
+#ifdef THOR_HEADLESS
+	(void)material;
+	(void)rMaterial;
+	LOG("[error] Material import is not available in headless builds");
+#else
 	uint numTextures = material->GetTextureCount(aiTextureType_DIFFUSE);
 	std::string texture_fileName = "", texture_extension = "";
 	std::string texture_file;
@@ -96,7 +110,9 @@ void Importer::Materials::Import(const aiMaterial* material, R_Material* rMateri
 
 	if (texture_file != "" && texture_file != ("."))
 	{
-		if (uint64 textureID = Engine->moduleResources->ImportFileFromAssets(texture_path.c_str()))
+		//Textures in assets are imported before any model: only missing ones are imported here
+		const ResourceBase* textureBase = Engine->moduleResources->FindResourceBase(texture_path.c_str(), nullptr, ResourceType::TEXTURE);
+		if (uint64 textureID = textureBase ? textureBase->ID : Engine->moduleResources->ImportFileFromAssets(texture_path.c_str()))
 		{
 			rMaterial->hTexture.Set(textureID);
 		}
@@ -107,6 +123,7 @@ void Importer::Materials::Import(const aiMaterial* material, R_Material* rMateri
 	aiString matName;
 	material->Get(AI_MATKEY_NAME, matName);
 	rMaterial->baseData->name = matName.C_Str();
+#endif
 }
 
 //Process R_Material data into a buffer ready to save
@@ -153,6 +170,39 @@ void Importer::Materials::Load(const char* buffer, uint size, R_Material* rMater
 	rMaterial->color = Color(color[0], color[1], color[2], color[3]);
 }
 
+#ifdef THOR_HEADLESS
+//Headless builds do not link DevIL: textures cannot be decoded, but they keep a (null) GL name
+void Importer::Textures::Init()
+{
+}
+
+R_Texture* Importer::Textures::Create()
+{
+	return new R_Texture();
+}
+
+bool Importer::Textures::Import(const char* /*buffer*/, uint /*size*/, R_Texture* /*rTexture*/)
+{
+	LOG("[error] Texture import is not available in headless builds");
+	return false;
+}
+
+uint64 Importer::Textures::Save(const R_Texture* /*rTexture*/, char** /*buffer*/)
+{
+	return 0;
+}
+
+uint64 Importer::Textures::Convert(const char* /*fileBuffer*/, uint /*fileSize*/, char** /*buffer*/)
+{
+	LOG("[error] Texture import is not available in headless builds");
+	return 0;
+}
+
+void Importer::Textures::Load(const char* /*buffer*/, uint /*size*/, R_Texture* texture)
+{
+	glGenTextures(1, &texture->buffer);
+}
+#else
 void Importer::Textures::Init()
 {
 	ilInit();
@@ -197,14 +247,35 @@ uint64 Importer::Textures::Save(const R_Texture* rTexture, char** buffer)
 	return saveBufferSize;
 }
 
+uint64 Importer::Textures::Convert(const char* fileBuffer, uint fileSize, char** buffer)
+{
+	std::lock_guard<std::mutex> lock(devilMutex);
+
+	ILuint ImageName;
+	ilGenImages(1, &ImageName);
+	ilBindImage(ImageName);
+
+	uint64 size = 0;
+	if (Import(fileBuffer, fileSize, nullptr))
+		size = Save(nullptr, buffer);
+
+	ilDeleteImages(1, &ImageName);
+	return size;
+}
+
 void Importer::Textures::Load(const char* buffer, uint size, R_Texture* texture)
 {
+	std::lock_guard<std::mutex> lock(devilMutex);
+
 	ILuint ImageName;
 	ilGenImages(1, &ImageName);
 	ilBindImage(ImageName);
 
 	ilLoadL(IL_TYPE_UNKNOWN, (const void*)buffer, size);
 	texture->buffer = ilutGLBindTexImage();
+	texture->width = ilGetInteger(IL_IMAGE_WIDTH);
+	texture->height = ilGetInteger(IL_IMAGE_HEIGHT);
 
 	ilDeleteImages(1, &ImageName);
 }
+#endif
@@ -45,6 +45,12 @@ namespace Importer
 		//Import due to DevIL memory management
 		uint64 Save(const R_Texture* rTexture, char** buffer);
 
+		//Decodes an image file and encodes it as the DDS file saved in library. Import + Save in one call
+		//Can be called from any thread: DevIL calls are serialized
+		//Returns the size of the buffer file (0 if any errors)
+		//Warning: buffer memory needs to be released after the function call
+		uint64 Convert(const char* fileBuffer, uint fileSize, char** buffer);
+
 		//Process buffer data into a ready-to-use R_Mesh.
 		//Returns nullptr if any errors occured during the process.
 		void Load(const char* buffer, uint size, R_Texture* texture);
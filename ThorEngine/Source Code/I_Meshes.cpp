@@ -1,6 +1,7 @@
 #include "I_Meshes.h"
 
 #include "R_Mesh.h"
+#include "MappedFile.h"
 
 #include "Assimp/include/mesh.h"
 
@@ -233,70 +234,101 @@ void Importer::Meshes::Private::SaveBones(const R_Mesh* rMesh, char** cursor)
 void Importer::Meshes::Load(const char* buffer, R_Mesh* mesh)
 {
 	const char* cursor = buffer;
+	Private::LoadArrays(&cursor, mesh, true);
 
+	//GPU buffers are created by M_Resources once loaded: this may run on a loading thread
+	mesh->CreateAABB();
+}
+
+void Importer::Meshes::Load(MappedFile* file, R_Mesh* mesh)
+{
+	mesh->mappedFile = file;
+	const char* cursor = file->GetData();
+
+	//The header is copied first to check the arrays fit in the file: reading past the view crashes
+	uint64 headerSize = sizeof(mesh->buffersSize) + sizeof(uint);
+	bool truncated = file->GetSize() < headerSize;
+	if (truncated == false)
+	{
+		memcpy(mesh->buffersSize, cursor, sizeof(mesh->buffersSize));
+		truncated = file->GetSize() < headerSize + Private::CalcArraysSize(mesh);
+	}
+
+	if (truncated == true)
+	{
+		LOG("[error] Mesh library file of '%s' is truncated", mesh->GetName());
+		for (uint i = 0; i < R_Mesh::max_buffer_type; ++i)
+			mesh->buffersSize[i] = 0;
+	}
+	else
+		Private::LoadArrays(&cursor, mesh, false);
+
+	mesh->CreateAABB();
+}
+
+template <typename T>
+T* Importer::Meshes::Private::ReadArray(const char** cursor, uint count, bool copy)
+{
+	T* ret = nullptr;
+	if (copy)
+	{
+		ret = new T[count];
+		memcpy(ret, *cursor, sizeof(T) * count);
+	}
+	else
+	{
+		//Library arrays follow a header of uints and are never misaligned
+		ret = (T*)*cursor;
+	}
+	*cursor += sizeof(T) * count;
+	return ret;
+}
+
+void Importer::Meshes::Private::LoadArrays(const char** cursor, R_Mesh* mesh, bool copy)
+{
 	uint bytes = sizeof(mesh->buffersSize);
-	memcpy(mesh->buffersSize, cursor, bytes);
-	cursor += bytes;
+	memcpy(mesh->buffersSize, *cursor, bytes);
+	*cursor += bytes;
 
 	bytes = sizeof(uint);
 	uint bonesSize = 0;
-	memcpy(&bonesSize, cursor, bytes);
-	cursor += bytes;
+	memcpy(&bonesSize, *cursor, bytes);
+	*cursor += bytes;
 	
 	mesh->boneTransforms.resize(bonesSize);
 	mesh->boneOffsets.resize(bonesSize);
 
-	//Code breaks here due to huge ranges value
-	bytes = sizeof(uint) * mesh->buffersSize[R_Mesh::b_indices];
-	mesh->indices = new uint[mesh->buffersSize[R_Mesh::b_indices]];
-	memcpy(mesh->indices, cursor, bytes);
-	cursor += bytes;
-
-	bytes = sizeof(float) * mesh->buffersSize[R_Mesh::b_vertices] * 3;
-	mesh->vertices = new float[mesh->buffersSize[R_Mesh::b_vertices] * 3];
-	memcpy(mesh->vertices, cursor, bytes);
-	cursor += bytes;
+	mesh->indices = ReadArray<uint>(cursor, mesh->buffersSize[R_Mesh::b_indices], copy);
+	mesh->vertices = ReadArray<float>(cursor, mesh->buffersSize[R_Mesh::b_vertices] * 3, copy);
 
 	if (mesh->buffersSize[R_Mesh::b_normals] > 0)
-	{
-		bytes = sizeof(float) * mesh->buffersSize[R_Mesh::b_normals] * 3;
-		mesh->normals = new float[mesh->buffersSize[R_Mesh::b_normals] * 3];
-		memcpy(mesh->normals, cursor, bytes);
-		cursor += bytes;
-	}
+		mesh->normals = ReadArray<float>(cursor, mesh->buffersSize[R_Mesh::b_normals] * 3, copy);
 
 	if (mesh->buffersSize[R_Mesh::b_tex_coords] > 0)
-	{
-		bytes = sizeof(float) * mesh->buffersSize[R_Mesh::b_tex_coords] * 2;
-		mesh->tex_coords = new float[mesh->buffersSize[R_Mesh::b_tex_coords] * 2];
-		memcpy(mesh->tex_coords, cursor, bytes);
-		cursor += bytes;
-	}
+		mesh->tex_coords = ReadArray<float>(cursor, mesh->buffersSize[R_Mesh::b_tex_coords] * 2, copy);
 
-	Private::LoadBones(&cursor, mesh);
+	LoadBones(cursor, mesh, copy);
+}
 
-	mesh->CreateAABB();
-	mesh->LoadOnMemory();	//TODO: Do we need to load buffers here?
+uint64 Importer::Meshes::Private::CalcArraysSize(const R_Mesh* rMesh)
+{
+	uint64 ret = sizeof(uint) * (uint64)rMesh->buffersSize[R_Mesh::b_indices];
+	ret += sizeof(float) * (uint64)rMesh->buffersSize[R_Mesh::b_vertices] * 3;
+	ret += sizeof(float) * (uint64)rMesh->buffersSize[R_Mesh::b_normals] * 3;
+	ret += sizeof(float) * (uint64)rMesh->buffersSize[R_Mesh::b_tex_coords] * 2;
+	ret += sizeof(int) * (uint64)rMesh->buffersSize[R_Mesh::b_bone_IDs];
+	ret += sizeof(float) * (uint64)rMesh->buffersSize[R_Mesh::b_bone_weights];
+	return ret;
 }
 
-void Importer::Meshes::Private::LoadBones(const char** cursor, R_Mesh* rMesh)
+void Importer::Meshes::Private::LoadBones(const char** cursor, R_Mesh* rMesh, bool copy)
 {
 	uint bytes = 0;
 	if (rMesh->buffersSize[R_Mesh::b_bone_IDs] > 0)
-	{
-		bytes = sizeof(int) * rMesh->buffersSize[R_Mesh::b_bone_IDs];
-		rMesh->boneIDs = new int[rMesh->buffersSize[R_Mesh::b_bone_IDs]];
-		memcpy(rMesh->boneIDs, *cursor, bytes);
-		*cursor += bytes;
-	}
+		rMesh->boneIDs = ReadArray<int>(cursor, rMesh->buffersSize[R_Mesh::b_bone_IDs], copy);
 
 	if (rMesh->buffersSize[R_Mesh::b_bone_weights] > 0)
-	{
-		bytes = sizeof(float) * rMesh->buffersSize[R_Mesh::b_bone_weights];
-		rMesh->boneWeights = new float[rMesh->buffersSize[R_Mesh::b_bone_weights]];
-		memcpy(rMesh->boneWeights, *cursor, bytes);
-		*cursor += bytes;
-	}
+		rMesh->boneWeights = ReadArray<float>(cursor, rMesh->buffersSize[R_Mesh::b_bone_weights], copy);
 
 	float matrix[16];
 	for (uint i = 0; i < rMesh->boneOffsets.size(); ++i)
@@ -6,6 +6,7 @@
 
 class C_Mesh;
 class R_Mesh;
+class MappedFile;
 
 struct aiMesh;
 
@@ -29,6 +30,9 @@ namespace Importer
 		//Returns nullptr if any errors occured during the process.
 		void Load(const char* buffer, R_Mesh* mesh);
 
+		//Same as above, but the mesh arrays point into the mapped library file instead of being copied
+		//The mesh takes ownership of 'file', the view lives as long as the resource
+		void Load(MappedFile* file, R_Mesh* mesh);
 
 		namespace Private
 		{
@@ -36,7 +40,15 @@ namespace Importer
 
 			void SaveBones(const R_Mesh* rMesh, char** cursor);
 
-			void LoadBones(const char** cursor, R_Mesh* rMesh);
+			//Reads the vertex and bone arrays. Without 'copy' they point into the buffer
+			void LoadArrays(const char** cursor, R_Mesh* rMesh, bool copy);
+			void LoadBones(const char** cursor, R_Mesh* rMesh, bool copy);
+
+			//Bytes taken by the arrays of a mesh, following its header
+			uint64 CalcArraysSize(const R_Mesh* rMesh);
+
+			template <typename T>
+			T* ReadArray(const char** cursor, uint count, bool copy);
 		}
 	}
 }
@@ -12,20 +12,28 @@
 #include "C_Transform.h"
 #include "C_Camera.h"
 #include "C_Animator.h"
-#include "C_ParticleSystem.h"
 
 #include "Resource.h"
+#include "ResourceHandle.h"
 #include "R_Model.h"
 #include "R_Scene.h"
 
-#include "Config.h"
+#include "JSONStream.h"
 
 #include "Assimp/include/cimport.h"
 #include "Assimp/include/scene.h"
 #include "Assimp/include/postprocess.h"
+#ifndef THOR_HEADLESS
 #pragma comment (lib, "Assimp/libx86/assimp.lib")
+#endif
 
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
+
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <string.h>
 
 //TODO: kind of a dirty method to have a private variable in the namespace
 namespace Importer { namespace Models { LCG randomID; } }
@@ -37,7 +45,23 @@ R_Model* Importer::Models::Create()
 
 const aiScene* Importer::Models::ProcessAssimpScene(const char* buffer, uint size)
 {
+#ifdef THOR_HEADLESS
+	(void)buffer;
+	(void)size;
+	LOG("[error] Model import is not available in headless builds");
+	return nullptr;
+#else
 	return aiImportFileFromMemory(buffer, size, aiProcessPreset_TargetRealtime_MaxQuality, nullptr);
+#endif
+}
+
+void Importer::Models::ReleaseAssimpScene(const aiScene* scene)
+{
+#ifdef THOR_HEADLESS
+	(void)scene;
+#else
+	aiReleaseImport(scene);
+#endif
 }
 
 void Importer::Models::Import(const aiScene* scene, R_Model* model)
@@ -115,86 +139,540 @@ void Importer::Models::LinkModelResources(R_Model* model, const std::vector<uint
 	}
 }
 
+namespace
+{
+	//Binary models: header, one fixed size record per node and the string table with the node names
+	//Nodes are stored parents first, so a record only refers to previous ones
+	const char modelMagic[4] = { 'T', 'M', 'D', 'L' };
+	const uint modelVersion = 1;
+	const uint noParentNode = UINT_MAX;	//Model root
+
+	struct ModelHeader
+	{
+		char magic[4];
+		uint version;
+		uint nodeCount;
+		uint stringTableSize;
+	};
+
+	struct ModelNodeRecord
+	{
+		uint parent;	//Index of the parent record, noParentNode for the root
+		uint name;		//Offset in the string table
+		uint64 meshID;
+		uint64 materialID;
+		float transform[16];
+	};
+
+	static_assert(sizeof(ModelHeader) == 16 && sizeof(ModelNodeRecord) == 88, "Model format changed");
+}
+
 uint64 Importer::Models::Save(const R_Model* model, char** buffer)
 {
-	Config file;
-	Config_Array nodesArray = file.SetArray("Nodes");
-	
+	std::vector<ModelNodeRecord> records(model->nodes.size());
+	std::string strings;
+
+	//Node IDs are only used to link the nodes: records link them by index
+	std::unordered_map<uint, uint> indices;
+	indices.reserve(model->nodes.size());
+
 	for (uint i = 0; i < model->nodes.size(); ++i)
 	{
-		Private::SaveModelNode(nodesArray.AddNode(), model->nodes[i]);
+		const ModelNode& node = model->nodes[i];
+		ModelNodeRecord& record = records[i];
+
+		std::unordered_map<uint, uint>::iterator parent = indices.find(node.parentID);
+		record.parent = parent != indices.end() ? parent->second : noParentNode;
+		record.name = (uint)strings.size();
+		record.meshID = node.meshID > 0 ? (uint64)node.meshID : 0;
+		record.materialID = node.materialID > 0 ? (uint64)node.materialID : 0;
+		memcpy(record.transform, node.transform.ptr(), sizeof(record.transform));
+
+		strings.append(node.name).push_back('\0');
+		indices[node.ID] = i;
 	}
 
-	uint size = file.Serialize(buffer);
+	ModelHeader header;
+	memcpy(header.magic, modelMagic, sizeof(modelMagic));
+	header.version = modelVersion;
+	header.nodeCount = (uint)records.size();
+	header.stringTableSize = (uint)strings.size();
+
+	uint64 size = sizeof(ModelHeader) + records.size() * sizeof(ModelNodeRecord) + strings.size();
+	*buffer = new char[size];
+	char* cursor = *buffer;
+	memcpy(cursor, &header, sizeof(header));
+	cursor += sizeof(header);
+	if (records.empty() == false)
+		memcpy(cursor, records.data(), records.size() * sizeof(ModelNodeRecord));
+	cursor += records.size() * sizeof(ModelNodeRecord);
+	if (strings.empty() == false)
+		memcpy(cursor, strings.data(), strings.size());
+
 	return size;
 }
 
-void Importer::Models::Private::SaveModelNode(Config& config, const ModelNode& node)
+uint64 Importer::Models::SaveJSON(const R_Model* model, char** buffer)
 {
-	config.SetNumber("Node ID", node.ID);
-	config.SetString("Name", node.name.c_str());
+	JSONWriter writer(model->nodes.size() * 512 + 64);
+	writer.BeginObject();
+	writer.Key("Nodes");
+	writer.BeginArray();
 
-	config.SetNumber("Parent Node ID", node.parentID);
+	for (uint i = 0; i < model->nodes.size(); ++i)
+	{
+		writer.BeginObject();
+		Private::SaveModelNode(writer, model->nodes[i]);
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+	writer.EndObject();
+	return writer.Finish(buffer);
+}
+
+bool Importer::Models::IsBinary(const char* buffer, uint size)
+{
+	return buffer != nullptr && size >= sizeof(ModelHeader) && memcmp(buffer, modelMagic, sizeof(modelMagic)) == 0;
+}
 
-	Config_Array transformArray = config.SetArray("Transform");
+void Importer::Models::Private::SaveModelNode(JSONWriter& writer, const ModelNode& node)
+{
+	writer.Key("Node ID");
+	writer.UInt64(node.ID);
+	writer.Key("Name");
+	writer.String(node.name.c_str(), (uint)node.name.size());
+
+	writer.Key("Parent Node ID");
+	writer.UInt64(node.parentID);
+
+	writer.Key("Transform");
+	writer.BeginArray();
 	for (uint i = 0u; i < 16u; ++i)
 	{
-		transformArray.AddNumber(node.transform.ptr()[i]);
+		writer.Number(node.transform.ptr()[i]);
 	}
+	writer.EndArray();
 
-	config.SetNumber("Mesh ID", node.meshID);
-	config.SetNumber("Material ID", node.materialID);
+	writer.Key("Mesh ID");
+	writer.UInt64(node.meshID);
+	writer.Key("Material ID");
+	writer.UInt64(node.materialID);
 }
 
-void Importer::Models::Load(const char* buffer, R_Model* model)
+void Importer::Models::Load(const char* buffer, uint size, R_Model* model)
 {
-	Config file(buffer);
-	Config_Array nodesArray = file.GetArray("Nodes");
+	if (IsBinary(buffer, size))
+		Private::LoadBinary(buffer, size, model);
+	else
+		Private::LoadJSON(buffer, size, model);
+}
 
-	//We create an empty GameObject that will hold all the model data and will be removed later
-	std::map<uint64, GameObject*> createdGameObjects;
+void Importer::Models::Private::LoadBinary(const char* buffer, uint size, R_Model* model)
+{
+	ModelHeader header;
+	memcpy(&header, buffer, sizeof(header));
+
+	uint64 stringsOffset = sizeof(ModelHeader) + (uint64)header.nodeCount * sizeof(ModelNodeRecord);
+	const char* strings = buffer + stringsOffset;
+	if (header.version > modelVersion || stringsOffset + header.stringTableSize > size ||
+		(header.stringTableSize > 0 && strings[header.stringTableSize - 1] != '\0'))
+	{
+		LOG("[error] Model file is damaged or from a newer version");
+		return;
+	}
 
-	for (uint i = 0u; i < nodesArray.GetSize(); ++i)
+	std::vector<GameObject*> gameObjects(header.nodeCount, nullptr);
+	for (uint i = 0; i < header.nodeCount; ++i)
 	{
-		Config modelNode = nodesArray.GetNode(i);
+		ModelNodeRecord record;
+		memcpy(&record, buffer + sizeof(ModelHeader) + i * sizeof(ModelNodeRecord), sizeof(record));
 
-		//Finding the proper parent for the new GameObject
-		GameObject* parent = nullptr;
-		std::map<uint64, GameObject*>::iterator it = createdGameObjects.find(modelNode.GetNumber("Parent Node ID"));
-		if (it != createdGameObjects.end())
-			parent = it->second;
+		GameObject* parent = record.parent < i ? gameObjects[record.parent] : nullptr;
+		const char* name = record.name < header.stringTableSize ? strings + record.name : "No name";
 
-		//Gathering all transform data
 		float4x4 transform;
-		Config_Array transformArray = modelNode.GetArray("Transform");
-		for (uint i = 0u; i < 16; ++i)
-		{
-			transform.ptr()[i] = transformArray.GetNumber(i);
-		}
+		memcpy(transform.ptr(), record.transform, sizeof(record.transform));
 
-		GameObject* newGameObject = new GameObject(parent, transform, modelNode.GetString("Name").c_str());
-		newGameObject->uid = randomID.Int(); //Warning: Do not confuse with Node IDs. Node IDs are ONLY for internal node relationships	
-		createdGameObjects[modelNode.GetNumber("Node ID")] = newGameObject; //Here we store Node ID as we only use it for building parentships
+		GameObject* newGameObject = new GameObject(parent, transform, name);
+		newGameObject->uid = randomID.Int();
+		gameObjects[i] = newGameObject;
 		if (!parent) model->root = newGameObject;
 
-		//Adding mesh component and assignint its resource (if any)
-		uint64 meshID = 0;
-		if ((meshID = modelNode.GetNumber("Mesh ID")) != 0)
+		if (record.meshID != 0)
 		{
 			C_Mesh* meshComponent = (C_Mesh*)newGameObject->CreateComponent(Component::Type::Mesh);
-			meshComponent->SetResource(meshID);
+			meshComponent->SetResource(record.meshID);
 		}
 
-		//Adding material component and assignint its resource (if any)
-		uint64 materialID = 0;
-		if ((materialID = modelNode.GetNumber("Material ID")) != 0)
+		if (record.materialID != 0)
 		{
 			C_Material* materialComponent = (C_Material*)newGameObject->CreateComponent(Component::Type::Material);
-			materialComponent->SetResource(materialID);
+			materialComponent->SetResource(record.materialID);
 		}
 	}
 }
 
+void Importer::Models::Private::LoadJSON(const char* buffer, uint size, R_Model* model)
+{
+	//Nodes are read straight from the text: no json tree is built for the file
+	JSONReader reader(buffer, size);
+	std::map<uint64, GameObject*> createdGameObjects;
+	std::string name;
+
+	if (reader.Next() == JSONReader::Token::OBJECT_BEGIN)
+	{
+		while (reader.NextKey())
+		{
+			if (reader.Is("Nodes") == false || reader.Next() != JSONReader::Token::ARRAY_BEGIN)
+			{
+				reader.SkipValue();
+				continue;
+			}
+
+			while (reader.NextElement())
+			{
+				if (reader.GetToken() != JSONReader::Token::OBJECT_BEGIN)
+				{
+					reader.SkipValue();
+					continue;
+				}
+
+				uint64 nodeID = 0, parentID = 0, meshID = 0, materialID = 0;
+				float4x4 transform;
+				transform.Set(float4x4::zero);
+				name.clear();
+
+				while (reader.NextKey())
+				{
+					if (reader.Is("Node ID"))				nodeID = reader.ReadUInt64();
+					else if (reader.Is("Parent Node ID"))	parentID = reader.ReadUInt64();
+					else if (reader.Is("Name"))				reader.ReadString(name);
+					else if (reader.Is("Transform"))		reader.ReadNumbers(transform.ptr(), 16);
+					else if (reader.Is("Mesh ID"))			meshID = reader.ReadUInt64();
+					else if (reader.Is("Material ID"))		materialID = reader.ReadUInt64();
+					else									reader.SkipValue();
+				}
+
+				//Finding the proper parent for the new GameObject
+				GameObject* parent = nullptr;
+				std::map<uint64, GameObject*>::iterator it = createdGameObjects.find(parentID);
+				if (it != createdGameObjects.end())
+					parent = it->second;
+
+				GameObject* newGameObject = new GameObject(parent, transform, name.c_str());
+				newGameObject->uid = randomID.Int(); //Warning: Do not confuse with Node IDs. Node IDs are ONLY for internal node relationships
+				createdGameObjects[nodeID] = newGameObject; //Here we store Node ID as we only use it for building parentships
+				if (!parent) model->root = newGameObject;
+
+				//Adding mesh and material components and assigning their resources (if any)
+				if (meshID != 0)
+				{
+					C_Mesh* meshComponent = (C_Mesh*)newGameObject->CreateComponent(Component::Type::Mesh);
+					meshComponent->SetResource(meshID);
+				}
+
+				if (materialID != 0)
+				{
+					C_Material* materialComponent = (C_Material*)newGameObject->CreateComponent(Component::Type::Material);
+					materialComponent->SetResource(materialID);
+				}
+			}
+		}
+	}
+
+	if (reader.HasError())
+		LOG("[error] Model file is damaged: json error at byte %llu", reader.GetOffset());
+}
+
+namespace
+{
+	//Binary scenes: header, IDs of the resources used, GameObject records, string table and one block of records per
+	//component type. GameObjects are stored parents first, so a record only refers to previous ones
+	const char sceneMagic[4] = { 'T', 'S', 'C', 'N' };
+	const uint sceneVersion = 1;
+	const uint noParent = UINT_MAX;	//Children of the scene root
+
+	struct SceneHeader
+	{
+		char magic[4];
+		uint version;
+		uint gameObjectCount;
+		uint resourceCount;
+		uint stringTableSize;
+		uint blockCount;
+	};
+
+	enum GameObjectFlags
+	{
+		ACTIVE = 1 << 0,
+		STATIC = 1 << 1,
+		SELECTED = 1 << 2,
+		OPEN_IN_HIERARCHY = 1 << 3,
+	};
+
+	struct GameObjectRecord
+	{
+		uint64 uid;
+		uint parent;	//Index of the parent record, noParent for the children of the root
+		uint name;		//Offset in the string table
+		float position[3];
+		float rotation[4];
+		float scale[3];
+		uint flags;
+		uint padding;
+	};
+
+	struct BlockHeader
+	{
+		uint type;
+		uint count;
+		uint recordSize;	//Records can grow in later versions: readers skip what they do not know
+		uint padding;
+	};
+
+	//Common part of every component record
+	struct ComponentRecord
+	{
+		uint gameObject;	//Index of the GameObject record
+		uint hasResource;
+		uint64 resourceID;
+	};
+
+	struct CameraRecord
+	{
+		ComponentRecord base;
+		float fov;		//Vertical, in degrees
+		float nearPlane;
+		float farPlane;
+		float padding;
+	};
+
+	struct AnimatorRecord
+	{
+		ComponentRecord base;
+		uint playing;
+		uint currentAnimation;
+	};
+
+	static_assert(sizeof(SceneHeader) == 24 && sizeof(GameObjectRecord) == 64 && sizeof(BlockHeader) == 16, "Scene format changed");
+
+	uint GetRecordSize(Component::Type type)
+	{
+		switch (type)
+		{
+			case Component::Camera:		return sizeof(CameraRecord);
+			case Component::Animator:	return sizeof(AnimatorRecord);
+			default:					return sizeof(ComponentRecord);
+		}
+	}
+
+	inline uint64 AlignTo8(uint64 offset) { return (offset + 7) & ~(uint64)7; }
+
+	//Gathers the records of a scene, from its GameObjects or from a JSON scene, and writes them in the binary format
+	class SceneWriter
+	{
+	public:
+		//'parent' is the index of a GameObject added before, or noParent
+		uint AddGameObject(uint64 uid, uint parent, const char* name, const float3& position, const Quat& rotation, const float3& scale, uint flags)
+		{
+			GameObjectRecord record;
+			memset(&record, 0, sizeof(record));
+			record.uid = uid;
+			record.parent = parent;
+			record.name = (uint)strings.size();
+			memcpy(record.position, position.ptr(), sizeof(record.position));
+			memcpy(record.rotation, rotation.ptr(), sizeof(record.rotation));
+			memcpy(record.scale, scale.ptr(), sizeof(record.scale));
+			record.flags = flags;
+
+			strings.append(name).push_back('\0');
+			gameObjects.push_back(record);
+			return (uint)gameObjects.size() - 1;
+		}
+
+		//'record' is GetRecordSize(type) bytes long and starts with a ComponentRecord
+		void AddComponent(Component::Type type, const ComponentRecord* record)
+		{
+			if (type <= Component::Transform || type >= Component::Unknown)
+				return;
+
+			std::vector<char>& block = blocks[type];
+			block.insert(block.end(), (const char*)record, (const char*)record + GetRecordSize(type));
+			if (record->hasResource)
+				resources.push_back(record->resourceID);
+		}
+
+		uint64 Write(char** buffer)
+		{
+			std::sort(resources.begin(), resources.end());
+			resources.erase(std::unique(resources.begin(), resources.end()), resources.end());
+
+			SceneHeader header;
+			memcpy(header.magic, sceneMagic, sizeof(sceneMagic));
+			header.version = sceneVersion;
+			header.gameObjectCount = (uint)gameObjects.size();
+			header.resourceCount = (uint)resources.size();
+			header.stringTableSize = (uint)strings.size();
+			header.blockCount = 0;
+
+			uint64 size = sizeof(SceneHeader) + resources.size() * sizeof(uint64) + gameObjects.size() * sizeof(GameObjectRecord);
+			size = AlignTo8(size + strings.size());
+			for (uint i = 0; i < Component::Unknown; ++i)
+			{
+				if (blocks[i].empty()) continue;
+				size += sizeof(BlockHeader) + blocks[i].size();
+				header.blockCount++;
+			}
+
+			char* cursor = *buffer = new char[size];
+			memset(cursor, 0, size);
+			cursor = Append(cursor, &header, sizeof(header));
+			cursor = Append(cursor, resources.data(), resources.size() * sizeof(uint64));
+			cursor = Append(cursor, gameObjects.data(), gameObjects.size() * sizeof(GameObjectRecord));
+			cursor = Append(cursor, strings.data(), strings.size());
+			cursor = *buffer + AlignTo8(cursor - *buffer);
+
+			for (uint i = 0; i < Component::Unknown; ++i)
+			{
+				if (blocks[i].empty()) continue;
+				BlockHeader block = { i, (uint)(blocks[i].size() / GetRecordSize((Component::Type)i)), GetRecordSize((Component::Type)i), 0 };
+				cursor = Append(cursor, &block, sizeof(block));
+				cursor = Append(cursor, blocks[i].data(), blocks[i].size());
+			}
+			return size;
+		}
+
+	private:
+		static char* Append(char* cursor, const void* data, uint64 size)
+		{
+			if (size > 0)
+				memcpy(cursor, data, size);
+			return cursor + size;
+		}
+
+	private:
+		std::vector<GameObjectRecord> gameObjects;
+		std::string strings;
+		std::vector<char> blocks[Component::Unknown];
+		std::vector<uint64> resources;
+	};
+
+	//Sections of a binary scene, checked against the buffer size
+	struct SceneSections
+	{
+		SceneHeader header;
+		const char* resources = nullptr;
+		const char* gameObjects = nullptr;
+		const char* strings = nullptr;
+		const char* blocks = nullptr;
+		const char* end = nullptr;
+	};
+
+	bool ReadSections(const char* buffer, uint size, SceneSections& sections)
+	{
+		if (Importer::Scenes::IsBinary(buffer, size) == false)
+			return false;
+
+		memcpy(&sections.header, buffer, sizeof(SceneHeader));
+		const SceneHeader& header = sections.header;
+		if (header.version > sceneVersion)
+			return false;
+
+		uint64 offset = sizeof(SceneHeader);
+		sections.resources = buffer + offset;
+		offset += (uint64)header.resourceCount * sizeof(uint64);
+		sections.gameObjects = buffer + offset;
+		offset += (uint64)header.gameObjectCount * sizeof(GameObjectRecord);
+		sections.strings = buffer + offset;
+		offset += header.stringTableSize;
+		if (offset > size || (header.stringTableSize > 0 && sections.strings[header.stringTableSize - 1] != '\0'))
+			return false;
+
+		sections.blocks = buffer + (AlignTo8(offset) < size ? AlignTo8(offset) : size);
+		sections.end = buffer + size;
+		return true;
+	}
+
+	//Next component block, nullptr at the end. Returns false if the block does not fit in the buffer
+	bool ReadBlock(const char*& cursor, const char* end, BlockHeader& block)
+	{
+		if ((uint64)(end - cursor) < sizeof(BlockHeader))
+			return false;
+		memcpy(&block, cursor, sizeof(BlockHeader));
+		cursor += sizeof(BlockHeader);
+		return block.recordSize >= sizeof(ComponentRecord) && (uint64)block.count * block.recordSize <= (uint64)(end - cursor);
+	}
+
+	//Reads the components array of a json GameObject into records of the binary format
+	void ReadComponents(JSONReader& reader, std::vector<Component::Type>& types, std::vector<CameraRecord>& records)
+	{
+		if (reader.Next() != JSONReader::Token::ARRAY_BEGIN)
+		{
+			reader.SkipValue();
+			return;
+		}
+
+		while (reader.NextElement())
+		{
+			if (reader.GetToken() != JSONReader::Token::OBJECT_BEGIN)
+			{
+				reader.SkipValue();
+				continue;
+			}
+
+			int type = 0;
+			bool hasResource = true, playing = true;
+			uint64 resourceID = 0;
+			float fov = 0, nearPlane = 0, farPlane = 0;
+			uint currentAnimation = 0;
+
+			while (reader.NextKey())
+			{
+				if (reader.Is("ComponentType"))				type = (int)reader.ReadNumber();
+				else if (reader.Is("HasResource"))			hasResource = reader.ReadBool();
+				else if (reader.Is("ID"))					resourceID = reader.ReadUInt64();
+				else if (reader.Is("FOV"))					fov = (float)reader.ReadNumber();
+				else if (reader.Is("NearPlane"))			nearPlane = (float)reader.ReadNumber();
+				else if (reader.Is("FarPlane"))				farPlane = (float)reader.ReadNumber();
+				else if (reader.Is("Playing"))				playing = reader.ReadBool();
+				else if (reader.Is("Current Animation"))	currentAnimation = (uint)reader.ReadNumber();
+				else										reader.SkipValue();
+			}
+
+			//Large enough for any component record
+			CameraRecord record;
+			memset(&record, 0, sizeof(record));
+			record.base.hasResource = hasResource ? 1 : 0;
+			record.base.resourceID = hasResource ? resourceID : 0;
+
+			if (type == Component::Camera)
+			{
+				record.fov = fov;
+				record.nearPlane = nearPlane;
+				record.farPlane = farPlane;
+			}
+			else if (type == Component::Animator)
+			{
+				AnimatorRecord* animatorRecord = (AnimatorRecord*)&record;
+				animatorRecord->playing = playing ? 1 : 0;
+				animatorRecord->currentAnimation = currentAnimation;
+			}
+
+			types.push_back((Component::Type)type);
+			records.push_back(record);
+		}
+	}
+
+	void WriteNumbers(JSONWriter& writer, const float* values, uint count)
+	{
+		writer.BeginArray();
+		for (uint i = 0; i < count; ++i)
+			writer.Number(values[i]);
+		writer.EndArray();
+	}
+}
+
 R_Scene* Importer::Scenes::Create()
 {
 	return new R_Scene();
@@ -202,187 +680,382 @@ R_Scene* Importer::Scenes::Create()
 
 uint64 Importer::Scenes::Save(const R_Scene* scene, char** buffer)
 {
-	Config file;
-	Config_Array goArray = file.SetArray("GameObjects");
+	std::vector<const GameObject*> gameObjects;
+	scene->root->CollectChilds(gameObjects);
+	gameObjects.erase(gameObjects.begin());
 
+	SceneWriter writer;
+	std::unordered_map<const GameObject*, uint> indices;
+	indices.reserve(gameObjects.size());
+
+	for (uint i = 0; i < gameObjects.size(); ++i)
+	{
+		const GameObject* gameObject = gameObjects[i];
+		const C_Transform* transform = gameObject->GetComponent<C_Transform>();
+
+		std::unordered_map<const GameObject*, uint>::iterator parent = indices.find(gameObject->parent);
+		uint flags = (gameObject->active ? ACTIVE : 0) | (gameObject->isStatic ? STATIC : 0) |
+			(gameObject->IsSelected() ? SELECTED : 0) | (gameObject->hierarchyOpen ? OPEN_IN_HIERARCHY : 0);
+
+		uint index = writer.AddGameObject(gameObject->uid, parent != indices.end() ? parent->second : noParent, gameObject->name.c_str(),
+			transform->GetPosition(), transform->GetQuatRotation(), transform->GetScale(), flags);
+		indices[gameObject] = index;
+
+		const std::vector<Component*> components = gameObject->GetAllComponents();
+		for (uint c = 0; c < components.size(); ++c)
+		{
+			const Component* component = components[c];
+
+			//Large enough for any component record
+			CameraRecord record;
+			memset(&record, 0, sizeof(record));
+			record.base.gameObject = index;
+			record.base.hasResource = component->HasResource() ? 1 : 0;
+			record.base.resourceID = component->HasResource() ? component->GetResourceID() : 0;
+
+			if (component->GetType() == Component::Camera)
+			{
+				const C_Camera* camera = (const C_Camera*)component;
+				record.fov = camera->frustum.VerticalFov() * RADTODEG;
+				record.nearPlane = camera->frustum.NearPlaneDistance();
+				record.farPlane = camera->frustum.FarPlaneDistance();
+			}
+			else if (component->GetType() == Component::Animator)
+			{
+				const C_Animator* animator = (const C_Animator*)component;
+				AnimatorRecord* animatorRecord = (AnimatorRecord*)&record;
+				animatorRecord->playing = animator->playing ? 1 : 0;
+				animatorRecord->currentAnimation = animator->current_animation;
+			}
+			writer.AddComponent(component->GetType(), &record.base);
+		}
+	}
+
+	return writer.Write(buffer);
+}
+
+uint64 Importer::Scenes::SaveJSON(const R_Scene* scene, char** buffer)
+{
 	std::vector<const GameObject*> gameObjects;
 	scene->root->CollectChilds(gameObjects);
 	gameObjects.erase(gameObjects.begin());
 
+	//GameObjects are written as they are visited: no json tree is built for the scene
+	JSONWriter writer(gameObjects.size() * 1024 + 64);
+	writer.BeginObject();
+	writer.Key("GameObjects");
+	writer.BeginArray();
+
 	for (uint i = 0; i < gameObjects.size(); ++i)
 	{
-		Private::SaveGameObject(goArray.AddNode(), gameObjects[i]);
+		writer.BeginObject();
+		Private::SaveGameObject(writer, gameObjects[i]);
+		writer.EndObject();
 	}
 
-	uint size = file.Serialize(buffer);
-	return size;
+	writer.EndArray();
+	writer.EndObject();
+	return writer.Finish(buffer);
 }
 
-void Importer::Scenes::Private::SaveGameObject(Config& config, const GameObject* gameObject)
+uint64 Importer::Scenes::ConvertJSON(const char* buffer, uint size, char** binary)
 {
-	config.SetNumber("UID", gameObject->uid);
+	//The text is read in a single pass, each GameObject is added once its object ends
+	JSONReader reader(buffer, size);
+	SceneWriter writer;
+	std::unordered_map<uint64, uint> indices;
+
+	std::string name;
+	std::vector<Component::Type> types;
+	std::vector<CameraRecord> records;
+
+	if (reader.Next() == JSONReader::Token::OBJECT_BEGIN)
+	{
+		while (reader.NextKey())
+		{
+			if (reader.Is("GameObjects") == false || reader.Next() != JSONReader::Token::ARRAY_BEGIN)
+			{
+				reader.SkipValue();
+				continue;
+			}
+
+			while (reader.NextElement())
+			{
+				if (reader.GetToken() != JSONReader::Token::OBJECT_BEGIN)
+				{
+					reader.SkipValue();
+					continue;
+				}
+
+				uint64 uid = 0, parentUID = 0;
+				bool active = true, isStatic = true, selected = false, openInHierarchy = false;
+				float3 position = float3::zero, scale = float3::zero;
+				Quat rotation = Quat::identity;
+				name.clear();
+				types.clear();
+				records.clear();
+
+				while (reader.NextKey())
+				{
+					if (reader.Is("UID"))					uid = reader.ReadUInt64();
+					else if (reader.Is("ParentUID"))		parentUID = reader.ReadUInt64();
+					else if (reader.Is("Name"))				reader.ReadString(name);
+					else if (reader.Is("Active"))			active = reader.ReadBool();
+					else if (reader.Is("Static"))			isStatic = reader.ReadBool();
+					else if (reader.Is("Selected"))			selected = reader.ReadBool(false);
+					else if (reader.Is("OpenInHierarchy"))	openInHierarchy = reader.ReadBool(false);
+					else if (reader.Is("Translation"))		reader.ReadNumbers(position.ptr(), 3);
+					else if (reader.Is("Rotation"))			reader.ReadNumbers(rotation.ptr(), 4);
+					else if (reader.Is("Scale"))			reader.ReadNumbers(scale.ptr(), 3);
+					else if (reader.Is("Components"))		ReadComponents(reader, types, records);
+					else									reader.SkipValue();
+				}
 
-	config.SetNumber("ParentUID", gameObject->parent ? gameObject->parent->uid : 0);
-	config.SetString("Name", gameObject->name.c_str());
+				std::unordered_map<uint64, uint>::iterator parent = indices.find(parentUID);
+				uint flags = (active ? ACTIVE : 0) | (isStatic ? STATIC : 0) | (selected ? SELECTED : 0) | (openInHierarchy ? OPEN_IN_HIERARCHY : 0);
 
-	config.SetBool("Active", gameObject->active);
-	config.SetBool("Static", gameObject->isStatic);
-	config.SetBool("Selected", gameObject->IsSelected());
-	config.SetBool("OpenInHierarchy", gameObject->hierarchyOpen);
+				uint index = writer.AddGameObject(uid, parent != indices.end() ? parent->second : noParent, name.c_str(), position, rotation, scale, flags);
+				indices[uid] = index;
+
+				for (uint c = 0; c < records.size(); ++c)
+				{
+					records[c].base.gameObject = index;
+					writer.AddComponent(types[c], &records[c].base);
+				}
+			}
+		}
+	}
+
+	if (reader.HasError())
+		LOG("[error] Scene file is damaged: json error at byte %llu", reader.GetOffset());
+
+	return writer.Write(binary);
+}
+
+bool Importer::Scenes::IsBinary(const char* buffer, uint size)
+{
+	return buffer != nullptr && size >= sizeof(SceneHeader) && memcmp(buffer, sceneMagic, sizeof(sceneMagic)) == 0;
+}
+
+void Importer::Scenes::Private::SaveGameObject(JSONWriter& writer, const GameObject* gameObject)
+{
+	writer.Key("UID");
+	writer.UInt64(gameObject->uid);
+
+	writer.Key("ParentUID");
+	writer.UInt64(gameObject->parent ? gameObject->parent->uid : 0);
+	writer.Key("Name");
+	writer.String(gameObject->name.c_str(), (uint)gameObject->name.size());
+
+	writer.Key("Active");
+	writer.Bool(gameObject->active);
+	writer.Key("Static");
+	writer.Bool(gameObject->isStatic);
+	writer.Key("Selected");
+	writer.Bool(gameObject->IsSelected());
+	writer.Key("OpenInHierarchy");
+	writer.Bool(gameObject->hierarchyOpen);
 
 	const C_Transform* transform = gameObject->GetComponent<C_Transform>();
+	float3 position = transform->GetPosition();
+	Quat rotation = transform->GetQuatRotation();
+	float3 scale = transform->GetScale();
 
 	//Translation part
-	config.SetArray("Translation").AddFloat3(transform->GetPosition());
+	writer.Key("Translation");
+	WriteNumbers(writer, position.ptr(), 3);
 
 	//Rotation part
-	config.SetArray("Rotation").AddQuat(transform->GetQuatRotation());
+	writer.Key("Rotation");
+	WriteNumbers(writer, rotation.ptr(), 4);
 
 	//Scale part
-	config.SetArray("Scale").AddFloat3(transform->GetScale());
+	writer.Key("Scale");
+	WriteNumbers(writer, scale.ptr(), 3);
 
-	Config_Array compConfig = config.SetArray("Components");
+	writer.Key("Components");
+	writer.BeginArray();
 	const std::vector<Component*> components = gameObject->GetAllComponents();
 
 	for (uint i = 0; i < components.size(); i++)
 	{
-		SaveComponentBase(compConfig.AddNode(), components[i]);
+		writer.BeginObject();
+		SaveComponentBase(writer, components[i]);
+		writer.EndObject();
 	}
+	writer.EndArray();
 }
 
-void Importer::Scenes::Private::SaveComponentBase(Config& config, const Component* component)
+void Importer::Scenes::GetDependencies(const char* buffer, uint size, std::vector<uint64>& dependencies)
 {
-	config.SetNumber("ComponentType", (int)component->GetType());
-	Private::SaveComponent(config, component);
+	//json scenes are converted first: binary scenes list them in their header
+	char* binary = nullptr;
+	if (IsBinary(buffer, size) == false)
+	{
+		size = (uint)ConvertJSON(buffer, size, &binary);
+		buffer = binary;
+	}
+
+	SceneSections sections;
+	if (ReadSections(buffer, size, sections))
+	{
+		uint64 offset = dependencies.size();
+		dependencies.resize(offset + sections.header.resourceCount);
+		memcpy(dependencies.data() + offset, sections.resources, sections.header.resourceCount * sizeof(uint64));
+	}
+	RELEASE_ARRAY(binary);
+}
+
+void Importer::Scenes::Private::SaveComponentBase(JSONWriter& writer, const Component* component)
+{
+	writer.Key("ComponentType");
+	writer.Number((int)component->GetType());
+	Private::SaveComponent(writer, component);
 
-	config.SetBool("HasResource", component->HasResource());
+	writer.Key("HasResource");
+	writer.Bool(component->HasResource());
 	if (component->HasResource())
 	{
-		config.SetNumber("ID", component->GetResourceID());
+		writer.Key("ID");
+		writer.UInt64(component->GetResourceID());
 	}
 }
 
-void Importer::Scenes::Private::SaveComponent(Config& config, const Component* component)
+void Importer::Scenes::Private::SaveComponent(JSONWriter& writer, const Component* component)
 {
 	switch (component->GetType())
 	{
 		case(Component::Camera):
-			Private::SaveComponent(config, (C_Camera*)component);
+			Private::SaveComponent(writer, (C_Camera*)component);
 			break;
 		case(Component::Animator):
-			Private::SaveComponent(config, (C_Animator*)component);
+			Private::SaveComponent(writer, (C_Animator*)component);
+			break;
+		default:
 			break;
 	}
 }
 
-void Importer::Scenes::Private::SaveComponent(Config& config, const C_Camera* camera)
+void Importer::Scenes::Private::SaveComponent(JSONWriter& writer, const C_Camera* camera)
 {
-	config.SetNumber("FOV", camera->frustum.VerticalFov() * RADTODEG);
-	config.SetNumber("NearPlane", camera->frustum.NearPlaneDistance());
-	config.SetNumber("FarPlane", camera->frustum.FarPlaneDistance());
+	writer.Key("FOV");
+	writer.Number(camera->frustum.VerticalFov() * RADTODEG);
+	writer.Key("NearPlane");
+	writer.Number(camera->frustum.NearPlaneDistance());
+	writer.Key("FarPlane");
+	writer.Number(camera->frustum.FarPlaneDistance());
 }
 
-void Importer::Scenes::Private::SaveComponent(Config& config, const C_Animator* animator)
+void Importer::Scenes::Private::SaveComponent(JSONWriter& writer, const C_Animator* animator)
 {
-	config.SetBool("Playing", animator->playing);
-	config.SetNumber("Current Animation", animator->current_animation);
+	writer.Key("Playing");
+	writer.Bool(animator->playing);
+	writer.Key("Current Animation");
+	writer.Number(animator->current_animation);
 }
 
-//TODO: Do we need to fill this function ??
-void Importer::Scenes::Private::SaveComponent(Config& config, const C_ParticleSystem* component)
+void Importer::Scenes::Load(const char* buffer, uint size, R_Scene* scene)
 {
-
+	if (IsBinary(buffer, size))
+		Private::LoadBinary(buffer, size, scene);
+	else
+		Private::LoadJSON(buffer, size, scene);
 }
 
-void Importer::Scenes::Load(const char* buffer, R_Scene* scene)
+void Importer::Scenes::Private::LoadBinary(const char* buffer, uint size, R_Scene* scene)
 {
-	Config file(buffer);
 	scene->root = new GameObject();
-	std::map<uint64, GameObject*> createdGameObjects;
-	Config_Array gameObjects_array = file.GetArray("GameObjects");
 
-	for (uint i = 0; i < gameObjects_array.GetSize(); ++i)
+	SceneSections sections;
+	if (ReadSections(buffer, size, sections) == false)
 	{
-		//Single GameObject load
-		Config gameObject_node = gameObjects_array.GetNode(i);
+		LOG("[error] Scene file is damaged or from a newer version");
+		return;
+	}
+	const SceneHeader& header = sections.header;
 
-		float3 position = gameObject_node.GetArray("Translation").GetFloat3(0);
-		Quat rotation = gameObject_node.GetArray("Rotation").GetQuat(0);
-		float3 scale = gameObject_node.GetArray("Scale").GetFloat3(0);
+	//Every resource used by the components is requested first, so the files are read while the GameObjects are created
+	std::vector<ResourceHandle<Resource>> requestedResources;
+	requestedResources.reserve(header.resourceCount);
+	for (uint i = 0; i < header.resourceCount; ++i)
+	{
+		uint64 ID;
+		memcpy(&ID, sections.resources + i * sizeof(uint64), sizeof(uint64));
+		requestedResources.push_back(ResourceHandle<Resource>(ID));
+		requestedResources.back().LoadAsync();
+	}
 
-		//Parent setup
-		GameObject* parent = nullptr;
-		std::map<uint64, GameObject*>::iterator it = createdGameObjects.find(gameObject_node.GetNumber("ParentUID"));
-		if (it != createdGameObjects.end())
-			parent = it->second;
+	std::vector<GameObject*> gameObjects(header.gameObjectCount, nullptr);
+	for (uint i = 0; i < header.gameObjectCount; ++i)
+	{
+		GameObjectRecord record;
+		memcpy(&record, sections.gameObjects + i * sizeof(GameObjectRecord), sizeof(GameObjectRecord));
+
+		GameObject* parent = record.parent < i ? gameObjects[record.parent] : scene->root;
+		const char* name = record.name < header.stringTableSize ? sections.strings + record.name : "No name";
+
+		GameObject* gameObject = new GameObject(parent, name, float3(record.position), Quat(record.rotation), float3(record.scale));
+		gameObject->uid = record.uid;
+		gameObject->active = (record.flags & ACTIVE) != 0;
+		gameObject->isStatic = (record.flags & STATIC) != 0;
+		gameObject->beenSelected = gameObject->hierarchyOpen = (record.flags & OPEN_IN_HIERARCHY) != 0;
+		gameObjects[i] = gameObject;
+	}
 
-		GameObject* gameObject = new GameObject(parent ? parent : scene->root, gameObject_node.GetString("Name").c_str(), position, rotation, scale);
-		gameObject->uid = gameObject_node.GetNumber("UID");
-		createdGameObjects[gameObject->uid] = gameObject;
+	const char* cursor = sections.blocks;
+	for (uint b = 0; b < header.blockCount; ++b)
+	{
+		BlockHeader block;
+		if (ReadBlock(cursor, sections.end, block) == false)
+		{
+			LOG("[error] Scene file is damaged: some components could not be loaded");
+			break;
+		}
 
-		gameObject->active = gameObject_node.GetBool("Active");
-		gameObject->isStatic = gameObject_node.GetBool("Static");
-		
-		//if (gameObject_node.GetBool("Selected", false))
-		//	Engine->moduleEditor->AddSelect(gameObject);
+		Component::Type type = (Component::Type)block.type;
+		for (uint i = 0; i < block.count; ++i, cursor += block.recordSize)
+		{
+			//Large enough for any record this version knows: longer ones are cut, shorter ones filled with zeros
+			CameraRecord record;
+			memset(&record, 0, sizeof(record));
+			memcpy(&record, cursor, block.recordSize < sizeof(record) ? block.recordSize : sizeof(record));
 
-		gameObject->beenSelected = gameObject->hierarchyOpen = gameObject_node.GetBool("OpenInHierarchy", false);
+			if (record.base.gameObject >= header.gameObjectCount)
+				continue;
 
-		Config_Array components = gameObject_node.GetArray("Components");
+			Component* component = gameObjects[record.base.gameObject]->CreateComponent(type);
+			if (component == nullptr)
+				continue;
 
-		for (uint i = 0; i < components.GetSize(); i++)
-		{
-			Config comp = components.GetNode(i);
-			Component::Type type = (Component::Type)((int)comp.GetNumber("ComponentType"));
+			if (record.base.hasResource)
+				component->SetResource(record.base.resourceID);
 
-			if (Component* component = gameObject->CreateComponent(type))
+			if (type == Component::Camera)
 			{
-				if (comp.GetBool("HasResource") == true)
-				{
-					component->SetResource(comp.GetNumber("ID"));
-				}
-				Private::LoadComponent(comp, component);
+				C_Camera* camera = (C_Camera*)component;
+				camera->SetFOV(record.fov);
+				camera->SetNearPlane(record.nearPlane);
+				camera->SetFarPlane(record.farPlane);
+			}
+			else if (type == Component::Animator)
+			{
+				const AnimatorRecord* animatorRecord = (const AnimatorRecord*)&record;
+				C_Animator* animator = (C_Animator*)component;
+				animator->playing = animatorRecord->playing != 0;
+				animator->SetAnimation(animatorRecord->currentAnimation);
 			}
-
 		}
-
-		//Call OnUpdateTransform() to init all components according to the GameObject
-		gameObject->OnUpdateTransform();
-	}
-}
-
-void Importer::Scenes::Private::LoadComponent(Config& config, Component* component)
-{
-	switch (component->GetType())
-	{
-	case(Component::Camera):
-	{
-		Private::LoadComponent(config, (C_Camera*)component);
-		break;
-	}
-	case(Component::Animator):
-	{
-		Private::LoadComponent(config, (C_Animator*)component);
-		break;
-	}
 	}
-}
 
-void Importer::Scenes::Private::LoadComponent(Config& config, C_Camera* camera)
-{
-	camera->SetFOV(config.GetNumber("FOV"));
-	camera->SetNearPlane(config.GetNumber("NearPlane"));
-	camera->SetFarPlane(config.GetNumber("FarPlane"));
+	//Call OnUpdateTransform() to init all components according to the GameObject, once for the whole hierarchy
+	scene->root->OnUpdateTransform();
 }
 
-void Importer::Scenes::Private::LoadComponent(Config& config, C_Animator* animator)
+void Importer::Scenes::Private::LoadJSON(const char* buffer, uint size, R_Scene* scene)
 {
-	animator->playing = config.GetBool("Playing");
-	uint currentAnimation = config.GetNumber("Current Animation");
-	animator->SetAnimation(currentAnimation);
+	//Converted first: the binary loader requests the resources and builds the hierarchy in a single pass
+	char* binary = nullptr;
+	uint64 binarySize = ConvertJSON(buffer, size, &binary);
+	LoadBinary(binary, (uint)binarySize, scene);
+	RELEASE_ARRAY(binary);
 }
-
-void Importer::Scenes::Private::LoadComponent(Config& config, C_ParticleSystem* particleSystem)
-{
-
-}
\ No newline at end of file
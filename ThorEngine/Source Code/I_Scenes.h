@@ -3,6 +3,7 @@
 
 #include "Globals.h"
 #include <vector>
+#include <set>
 
 struct aiScene;
 struct aiNode;
@@ -14,14 +15,13 @@ class C_Material;
 class C_Animator;
 class C_Camera;
 class C_Transform;
-class C_ParticleSystem;
 class R_Model;
 class R_Scene;
 struct ModelNode;
 class Component;
 class GameObject;
 
-class Config;
+class JSONWriter;
 
 namespace Importer
 {
@@ -31,8 +31,9 @@ namespace Importer
 		R_Model* Create();
 
 		//Processes an already loaded FBX file and loads it into an assimp scene structure
-		//Warning: (TODO) do we need to release aiScene data later? (aiReleaseImport is not specificed in Assimp)
+		//Can be called from any thread. The scene needs to be released with ReleaseAssimpScene
 		const aiScene* ProcessAssimpScene(const char* buffer, uint size);
+		void ReleaseAssimpScene(const aiScene* scene);
 
 		//Processes an already loaded FBX file and generates all the hierarchy and components setup
 		//Warning: meshes, materials and lights need to be linked later, this function only loads the hierarchy
@@ -43,13 +44,19 @@ namespace Importer
 		//Here we update them to assign the correct resource IDs
 		void LinkModelResources(R_Model* model, const std::vector<uint64>& meshes, const std::vector<uint64>& materials);
 
-		//Save all model data (all contained nodes) into a buffer file saved as json
+		//Save all model data (all contained nodes) into a binary buffer: a flat table of nodes with their parent index,
+		//transform, mesh and material IDs, followed by a string table with the node names
 		//Returns the size of the buffer file (0 if any errors)
 		//Warning: buffer memory needs to be released after the function call
 		uint64 Save(const R_Model* model, char** buffer);
 
-		//Process an json model buffer and loads all the GameObject hierarchy
-		void Load(const char* buffer, R_Model* model);
+		//Same content saved as json, the format of older library files. Load accepts both formats
+		//Written in a single pass, without building a json tree
+		uint64 SaveJSON(const R_Model* model, char** buffer);
+		bool IsBinary(const char* buffer, uint size);
+
+		//Process a model buffer and loads all the GameObject hierarchy
+		void Load(const char* buffer, uint size, R_Model* model);
 
 		namespace Private
 		{
@@ -58,8 +65,13 @@ namespace Importer
 			//GameObjects that are meant to have a mesh, material or light, are added the component and given the id from the aiScene container.
 			void ImportNodeData(const aiScene* scene, const aiNode* node, R_Model* model, uint64 parentID);
 
+			//Binary models are instantiated in a single pass over the node table
+			void LoadBinary(const char* buffer, uint size, R_Model* model);
+			//json models are read with a pull parser, node by node
+			void LoadJSON(const char* buffer, uint size, R_Model* model);
+
 			//Save the info from a model node (name, id, transform, texture and material) into a file
-			void SaveModelNode(Config& config, const ModelNode& node);
+			void SaveModelNode(JSONWriter& writer, const ModelNode& node);
 		}
 
 	}
@@ -69,44 +81,50 @@ namespace Importer
 		//Creates an empty scene resource using default constructor
 		R_Scene* Create();
 
-		//Process a GameObject data with its hierarchy into a buffer file saved as json
+		//Process a GameObject data with its hierarchy into a binary buffer: a string table for the names, a fixed size
+		//record per GameObject with its parent index and a block of records per component type
 		//Returns the size of the buffer file (0 if any errors)
 		//Warning: buffer memory needs to be released after the function call
 		uint64 Save(const R_Scene* scene, char** buffer);
-			   
-		//Process an json scene buffer and loads all the GameObject hierarchy
-		void Load(const char* buffer, R_Scene* scene);
 
-		namespace Private
-		{
-			//Process a GameObject data with its hierarchy into a config file
-			//This function will be called recursively for every child in <gameObject>
-			void SaveGameObject(Config& config, const GameObject* gameObject);
+		//Same content saved as json, to read or diff scene assets. Load and GetDependencies accept both formats
+		//Written in a single pass, without building a json tree
+		uint64 SaveJSON(const R_Scene* scene, char** buffer);
 
-			//Process a Component base data into a config file
-			//This function will call specific functions for each component type
-			void SaveComponentBase(Config& config, const Component* component);
+		//Converts a json scene buffer into the binary format without creating its GameObjects
+		//The text is read with a pull parser: no json tree is built. Can be called from any thread
+		uint64 ConvertJSON(const char* buffer, uint size, char** binary);
+		bool IsBinary(const char* buffer, uint size);
 
-			//Select the specific component class to be saved and calls its according function
-			void SaveComponent(Config& config, const Component* component);
+		//Process a scene buffer and loads all the GameObject hierarchy
+		void Load(const char* buffer, uint size, R_Scene* scene);
 
-			//Process a Camera component data into a config file
-			void SaveComponent(Config& config, const C_Camera* component);
+		//Lists the resources used by the components of a scene buffer, without creating its GameObjects
+		//Can be called from any thread
+		void GetDependencies(const char* buffer, uint size, std::vector<uint64>& dependencies);
 
-			//Process an Animation component data into a config file
-			void SaveComponent(Config& config, const C_Animator* component);
+		namespace Private
+		{
+			//Binary scenes are read in a single pass over the records. Damaged files load what fits in the buffer
+			void LoadBinary(const char* buffer, uint size, R_Scene* scene);
+			//json scenes are converted to the binary format and loaded from it
+			void LoadJSON(const char* buffer, uint size, R_Scene* scene);
 
-			//Process a Particle System component data into a config file
-			void SaveComponent(Config& config, const C_ParticleSystem* component);
+			//Process a GameObject data with its hierarchy into a json writer
+			void SaveGameObject(JSONWriter& writer, const GameObject* gameObject);
 
-			//Loads the base for all components and calls the specific component load function
-			void LoadComponent(Config& config, Component* component);
+			//Process a Component base data into a json writer
+			//This function will call specific functions for each component type
+			void SaveComponentBase(JSONWriter& writer, const Component* component);
 
-			void LoadComponent(Config& config, C_Camera* camera);
+			//Select the specific component class to be saved and calls its according function
+			void SaveComponent(JSONWriter& writer, const Component* component);
 
-			void LoadComponent(Config& config, C_Animator* animation);
+			//Process a Camera component data into a json writer
+			void SaveComponent(JSONWriter& writer, const C_Camera* component);
 
-			void LoadComponent(Config& config, C_ParticleSystem* particleSystem);
+			//Process an Animation component data into a json writer
+			void SaveComponent(JSONWriter& writer, const C_Animator* component);
 		}
 	}
 }
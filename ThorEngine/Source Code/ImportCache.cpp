@@ -0,0 +1,145 @@
+#include "ImportCache.h"
+
+#include "Config.h"
+#include "Hash.h"
+#include "M_FileSystem.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+void ImportCache::SetDirectory(const char* directory)
+{
+	this->directory = directory;
+
+	if (IsEnabled())
+	{
+		std::error_code error;
+		fs::create_directories(this->directory, error);
+		if (error)
+		{
+			LOG("[Warning] Import cache disabled, could not create '%s': %s", directory, error.message().c_str());
+			this->directory.clear();
+		}
+	}
+}
+
+bool ImportCache::Fetch(uint64 key, uint64 ID, const std::vector<uint64>& containedIDs, std::vector<ResourceBase>& contained)
+{
+	if (!IsEnabled())
+		return false;
+
+	fs::path entryDir = fs::path(directory) / Hash::ToString(key);
+	std::ifstream stream(entryDir / "Entry.json", std::ios::binary);
+	if (!stream.is_open())
+		return false;
+
+	std::stringstream text;
+	text << stream.rdbuf();
+	Config entry(text.str().c_str());
+
+	if ((uint64)entry.GetNumber("ID") != ID)
+		return false;
+
+	std::vector<ResourceBase> bases;
+	Config_Array entryContained = entry.GetArray("Contained Resources");
+	for (uint i = 0; i < entryContained.GetSize(); ++i)
+	{
+		Config node = entryContained.GetNode(i);
+		ResourceBase base((ResourceType)(int)node.GetNumber("Type"), "", node.GetString("Name").c_str(), node.GetNumber("ID"));
+		base.libraryFile = node.GetString("Library file");
+		base.LoadDependencies(node);
+		bases.push_back(base);
+	}
+
+	//The project already knows the contained resources by other IDs: scenes and models reference those
+	if (!containedIDs.empty())
+	{
+		if (containedIDs.size() != bases.size())
+			return false;
+		for (uint i = 0; i < bases.size(); ++i)
+		{
+			if (std::find(containedIDs.begin(), containedIDs.end(), bases[i].ID) == containedIDs.end())
+				return false;
+		}
+	}
+
+	//Library files are stored by resource ID
+	bool copied = RestoreFile(entryDir / std::to_string(ID), entry.GetString("Library file"));
+	for (uint i = 0; i < bases.size() && copied; ++i)
+		copied = RestoreFile(entryDir / std::to_string(bases[i].ID), bases[i].libraryFile);
+
+	if (copied == false)
+	{
+		LOG("[Warning] Could not copy import cache entry %s", Hash::ToString(key).c_str());
+		return false;
+	}
+
+	contained.insert(contained.end(), bases.begin(), bases.end());
+	hits++;
+	return true;
+}
+
+void ImportCache::Store(uint64 key, const ResourceBase& base, const std::vector<const ResourceBase*>& contained)
+{
+	if (!IsEnabled())
+		return;
+
+	//Written aside and renamed: other projects may be reading the cache
+	fs::path entryDir = fs::path(directory) / Hash::ToString(key);
+	fs::path tempDir = entryDir.string() + ".tmp" + std::to_string(base.ID);
+
+	std::error_code error;
+	fs::remove_all(tempDir, error);
+	fs::create_directories(tempDir, error);
+
+	fs::copy_file(base.libraryFile, tempDir / std::to_string(base.ID), error);
+	for (uint i = 0; i < contained.size() && !error; ++i)
+		fs::copy_file(contained[i]->libraryFile, tempDir / std::to_string(contained[i]->ID), error);
+
+	if (!error)
+	{
+		Config entry;
+		base.Serialize(entry);
+		Config_Array entryContained = entry.SetArray("Contained Resources");
+		for (uint i = 0; i < contained.size(); ++i)
+		{
+			Config node = entryContained.AddNode();
+			contained[i]->Serialize(node);
+		}
+
+		char* buffer = nullptr;
+		uint size = entry.Serialize(&buffer);
+		std::ofstream(tempDir / "Entry.json", std::ios::binary).write(buffer, size);
+		RELEASE_ARRAY(buffer);
+
+		fs::remove_all(entryDir, error);
+		fs::rename(tempDir, entryDir, error);
+	}
+
+	if (error)
+	{
+		LOG("[Warning] Could not store import cache entry for '%s': %s", base.assetsFile.c_str(), error.message().c_str());
+		fs::remove_all(tempDir, error);
+		return;
+	}
+	stores++;
+}
+
+bool ImportCache::RestoreFile(const fs::path& cachedFile, const std::string& libraryFile) const
+{
+	//Copied aside and renamed: the previous library file may still be mapped
+	std::string tempFile = libraryFile + ".tmp";
+	std::error_code error;
+	if (M_FileSystem::CopyFileContent(cachedFile.string().c_str(), tempFile.c_str()))
+	{
+		fs::rename(tempFile, libraryFile, error);
+		if (!error)
+			return true;
+	}
+	fs::remove(tempFile, error);
+	return false;
+}
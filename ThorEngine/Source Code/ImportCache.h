@@ -0,0 +1,46 @@
+#ifndef __IMPORT_CACHE_H__
+#define __IMPORT_CACHE_H__
+
+#include "Globals.h"
+#include "ResourceBase.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <filesystem>
+
+//Library output of asset imports, shared by every project using the same cache directory
+//Entries are keyed by the import key (content hash, importer version and settings) and keep the IDs they were
+//imported with: an asset reuses an entry when its .meta carries the same IDs, as with the same asset in another
+//branch or a project sharing it
+class ImportCache
+{
+public:
+	//An empty directory disables the cache
+	void SetDirectory(const char* directory);
+	inline const std::string& GetDirectory() const { return directory; }
+	inline bool IsEnabled() const { return !directory.empty(); }
+
+	//Copies the library files of the entry into the project library and fills 'contained' with its contained resources
+	//Returns false if there is no entry for 'key' imported as 'ID' with the 'containedIDs' (empty accepts any)
+	//Can be called from any thread
+	bool Fetch(uint64 key, uint64 ID, const std::vector<uint64>& containedIDs, std::vector<ResourceBase>& contained);
+
+	//Stores the library files of an imported resource and its contained resources, replacing any entry for 'key'
+	void Store(uint64 key, const ResourceBase& base, const std::vector<const ResourceBase*>& contained);
+
+	inline uint GetHits() const { return hits; }
+	inline uint GetStores() const { return stores; }
+
+private:
+	//Replaces a library file with its cached copy
+	bool RestoreFile(const std::filesystem::path& cachedFile, const std::string& libraryFile) const;
+
+private:
+	std::string directory;
+
+	std::atomic<uint> hits = { 0 };
+	std::atomic<uint> stores = { 0 };
+};
+
+#endif //__IMPORT_CACHE_H__
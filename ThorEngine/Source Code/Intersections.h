@@ -1,7 +1,7 @@
 #ifndef __INTERSECTIONS_H__
 #define __INTERSECTIONS_H__
 
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 #include "PerfTimer.h"
 #include <vector>
 
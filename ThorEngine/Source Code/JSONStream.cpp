@@ -0,0 +1,614 @@
+#include "JSONStream.h"
+
+#include <charconv>
+#include <math.h>
+
+namespace
+{
+	inline bool IsWhitespace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+	inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+	int HexValue(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	//Reads the 4 hex digits of a \u sequence. Returns false if they are not valid
+	bool ReadCodeUnit(const char* text, const char* end, uint& codeUnit)
+	{
+		if (end - text < 4)
+			return false;
+
+		codeUnit = 0;
+		for (uint i = 0; i < 4; ++i)
+		{
+			int value = HexValue(text[i]);
+			if (value < 0)
+				return false;
+			codeUnit = (codeUnit << 4) | (uint)value;
+		}
+		return true;
+	}
+
+	void AppendUTF8(std::string& string, uint codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			string.push_back((char)codePoint);
+		}
+		else if (codePoint < 0x800)
+		{
+			string.push_back((char)(0xC0 | (codePoint >> 6)));
+			string.push_back((char)(0x80 | (codePoint & 0x3F)));
+		}
+		else if (codePoint < 0x10000)
+		{
+			string.push_back((char)(0xE0 | (codePoint >> 12)));
+			string.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+			string.push_back((char)(0x80 | (codePoint & 0x3F)));
+		}
+		else
+		{
+			string.push_back((char)(0xF0 | (codePoint >> 18)));
+			string.push_back((char)(0x80 | ((codePoint >> 12) & 0x3F)));
+			string.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+			string.push_back((char)(0x80 | (codePoint & 0x3F)));
+		}
+	}
+
+	//Doubles hold every integer up to 2^53 exactly
+	const double maxExactInteger = 9007199254740992.0;
+}
+
+JSONReader::JSONReader(const char* buffer, uint64 size) : buffer(buffer), cursor(buffer), end(buffer + size)
+{
+	containers.reserve(16);
+}
+
+JSONReader::Token JSONReader::Next()
+{
+	if (token == Token::ERROR)
+		return token;
+
+	SkipWhitespace();
+
+	if (containers.empty())
+	{
+		//The root value has been read: only whitespace (or the null terminator saved with the buffer) may follow
+		if (afterValue)
+		{
+			if (cursor != end && *cursor != '\0')
+				return Fail();
+			return token = Token::END;
+		}
+		return token = ReadValue();
+	}
+
+	if (afterKey)
+	{
+		afterKey = false;
+		return token = ReadValue();
+	}
+
+	if (cursor == end)
+		return Fail();
+
+	char close = containers.back() == '{' ? '}' : ']';
+	if (*cursor == close)
+	{
+		++cursor;
+		containers.pop_back();
+		afterValue = true;
+		return token = (close == '}' ? Token::OBJECT_END : Token::ARRAY_END);
+	}
+
+	if (afterValue)
+	{
+		if (*cursor != ',')
+			return Fail();
+		++cursor;
+		SkipWhitespace();
+	}
+
+	if (containers.back() == '[')
+		return token = ReadValue();
+
+	//Object member: "key" :
+	if (cursor == end || *cursor != '"' || ReadStringView() == false)
+		return Fail();
+
+	SkipWhitespace();
+	if (cursor == end || *cursor != ':')
+		return Fail();
+	++cursor;
+
+	afterKey = true;
+	afterValue = false;
+	return token = Token::KEY;
+}
+
+bool JSONReader::SkipValue()
+{
+	if (token == Token::KEY)
+		Next();
+
+	if (token == Token::OBJECT_BEGIN || token == Token::ARRAY_BEGIN)
+	{
+		uint depth = (uint)containers.size();
+		while (containers.size() >= depth && token != Token::ERROR)
+			Next();
+	}
+	return token != Token::ERROR && token != Token::END;
+}
+
+bool JSONReader::NextKey()
+{
+	return Next() == Token::KEY;
+}
+
+bool JSONReader::NextElement()
+{
+	Token next = Next();
+	return next != Token::ARRAY_END && next != Token::ERROR && next != Token::END;
+}
+
+double JSONReader::ReadNumber(double defaultValue)
+{
+	if (Next() == Token::NUMBER)
+		return GetNumber();
+	SkipValue();
+	return defaultValue;
+}
+
+uint64 JSONReader::ReadUInt64(uint64 defaultValue)
+{
+	if (Next() == Token::NUMBER)
+		return GetUInt64();
+	SkipValue();
+	return defaultValue;
+}
+
+bool JSONReader::ReadBool(bool defaultValue)
+{
+	if (Next() == Token::BOOL)
+		return boolean;
+	SkipValue();
+	return defaultValue;
+}
+
+void JSONReader::ReadString(std::string& string, const char* defaultValue)
+{
+	if (Next() == Token::STRING)
+	{
+		GetString(string);
+		return;
+	}
+	SkipValue();
+	string = defaultValue;
+}
+
+uint JSONReader::ReadNumbers(float* values, uint count)
+{
+	if (Next() != Token::ARRAY_BEGIN)
+	{
+		SkipValue();
+		return 0;
+	}
+
+	uint read = 0;
+	while (NextElement())
+	{
+		if (token == Token::NUMBER && read < count)
+			values[read++] = (float)GetNumber();
+		else
+			SkipValue();
+	}
+	return read;
+}
+
+void JSONReader::GetString(std::string& string) const
+{
+	if (escaped == false)
+	{
+		string.assign(view, length);
+		return;
+	}
+
+	string.clear();
+	string.reserve(length);
+
+	const char* text = view;
+	const char* textEnd = view + length;
+	while (text < textEnd)
+	{
+		if (*text != '\\')
+		{
+			string.push_back(*text++);
+			continue;
+		}
+
+		//Strings are checked while reading: an escape is never the last character
+		char sequence = text[1];
+		text += 2;
+		switch (sequence)
+		{
+			case 'b': string.push_back('\b'); break;
+			case 'f': string.push_back('\f'); break;
+			case 'n': string.push_back('\n'); break;
+			case 'r': string.push_back('\r'); break;
+			case 't': string.push_back('\t'); break;
+			case 'u':
+			{
+				uint codePoint = 0;
+				if (ReadCodeUnit(text, textEnd, codePoint) == false)
+					break;
+				text += 4;
+
+				//Characters out of the basic plane come as two code units
+				uint low = 0;
+				if (codePoint >= 0xD800 && codePoint < 0xDC00 && textEnd - text >= 6 && text[0] == '\\' && text[1] == 'u' &&
+					ReadCodeUnit(text + 2, textEnd, low) && low >= 0xDC00 && low < 0xE000)
+				{
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					text += 6;
+				}
+				AppendUTF8(string, codePoint);
+				break;
+			}
+			default: string.push_back(sequence); break;	//'"', '\\' and '/'
+		}
+	}
+}
+
+double JSONReader::GetNumber() const
+{
+	double value = 0;
+	std::from_chars(view, view + length, value);
+	return value;
+}
+
+uint64 JSONReader::GetUInt64() const
+{
+	uint64 value = 0;
+	std::from_chars_result result = std::from_chars(view, view + length, value);
+	if (result.ec == std::errc() && result.ptr == view + length)
+		return value;
+
+	//Fractions, exponents and negative numbers
+	double number = GetNumber();
+	return number > 0 ? (uint64)number : 0;
+}
+
+JSONReader::Token JSONReader::ReadValue()
+{
+	if (cursor == end)
+		return Fail();
+
+	afterValue = true;
+	switch (*cursor)
+	{
+		case '{':
+		case '[':
+		{
+			containers.push_back(*cursor);
+			++cursor;
+			afterValue = false;
+			return containers.back() == '{' ? Token::OBJECT_BEGIN : Token::ARRAY_BEGIN;
+		}
+		case '"':
+		{
+			return ReadStringView() ? Token::STRING : Fail();
+		}
+		case 't':
+		{
+			boolean = true;
+			return ReadLiteral("true", 4) ? Token::BOOL : Fail();
+		}
+		case 'f':
+		{
+			boolean = false;
+			return ReadLiteral("false", 5) ? Token::BOOL : Fail();
+		}
+		case 'n':
+		{
+			return ReadLiteral("null", 4) ? Token::NULL_VALUE : Fail();
+		}
+	}
+
+	//Number: the text is kept and only converted when asked for
+	const char* start = cursor;
+	if (*cursor == '-')
+		++cursor;
+
+	const char* digits = cursor;
+	while (cursor != end && IsDigit(*cursor)) ++cursor;
+	if (cursor == digits)
+		return Fail();
+
+	if (cursor != end && *cursor == '.')
+	{
+		++cursor;
+		while (cursor != end && IsDigit(*cursor)) ++cursor;
+	}
+	if (cursor != end && (*cursor == 'e' || *cursor == 'E'))
+	{
+		++cursor;
+		if (cursor != end && (*cursor == '+' || *cursor == '-'))
+			++cursor;
+		while (cursor != end && IsDigit(*cursor)) ++cursor;
+	}
+
+	view = start;
+	length = (uint)(cursor - start);
+	escaped = false;
+	return Token::NUMBER;
+}
+
+bool JSONReader::ReadStringView()
+{
+	//Skipping the opening quote
+	const char* start = ++cursor;
+	escaped = false;
+
+	while (cursor != end)
+	{
+		const char* quote = (const char*)memchr(cursor, '"', end - cursor);
+		if (quote == nullptr)
+			break;
+
+		//Escape sequences only matter when they hide a quote. The other ones are decoded by GetString
+		const char* backslash = (const char*)memchr(cursor, '\\', quote - cursor);
+		if (backslash == nullptr)
+		{
+			view = start;
+			length = (uint)(quote - start);
+			cursor = quote + 1;
+			return true;
+		}
+
+		escaped = true;
+		cursor = backslash + 2;
+	}
+
+	cursor = end;
+	return false;
+}
+
+bool JSONReader::ReadLiteral(const char* literal, uint size)
+{
+	if ((uint64)(end - cursor) < size || memcmp(cursor, literal, size) != 0)
+		return false;
+	cursor += size;
+	return true;
+}
+
+void JSONReader::SkipWhitespace()
+{
+	while (cursor != end && IsWhitespace(*cursor))
+		++cursor;
+}
+
+JSONReader::Token JSONReader::Fail()
+{
+	return token = Token::ERROR;
+}
+
+JSONWriter::JSONWriter(uint64 capacity)
+{
+	Grow(capacity > 0 ? capacity : 1);
+	hasElements.reserve(16);
+}
+
+JSONWriter::~JSONWriter()
+{
+	RELEASE_ARRAY(data);
+}
+
+void JSONWriter::BeginObject()
+{
+	BeginElement();
+	Append('{');
+	hasElements.push_back(false);
+}
+
+void JSONWriter::EndObject()
+{
+	EndContainer('}');
+}
+
+void JSONWriter::BeginArray()
+{
+	BeginElement();
+	Append('[');
+	hasElements.push_back(false);
+}
+
+void JSONWriter::EndArray()
+{
+	EndContainer(']');
+}
+
+void JSONWriter::Key(const char* name)
+{
+	BeginElement();
+	AppendString(name, strlen(name));
+	Append(": ", 2);
+	afterKey = true;
+}
+
+void JSONWriter::Number(double value)
+{
+	BeginElement();
+	Reserve(32);
+
+	//Json has no text for nan or infinity
+	if (isfinite(value) == false)
+	{
+		Append("null", 4);
+		return;
+	}
+
+	std::to_chars_result result;
+	if (value == floor(value) && fabs(value) < maxExactInteger)
+		result = std::to_chars(data + size, data + capacity, (long long)value);
+	else
+		result = std::to_chars(data + size, data + capacity, value);
+	size = result.ptr - data;
+}
+
+void JSONWriter::UInt64(uint64 value)
+{
+	BeginElement();
+	Reserve(24);
+	size = std::to_chars(data + size, data + capacity, (unsigned long long)value).ptr - data;
+}
+
+void JSONWriter::Bool(bool value)
+{
+	BeginElement();
+	if (value)
+		Append("true", 4);
+	else
+		Append("false", 5);
+}
+
+void JSONWriter::String(const char* value)
+{
+	String(value, (uint)strlen(value));
+}
+
+void JSONWriter::String(const char* value, uint length)
+{
+	BeginElement();
+	AppendString(value, length);
+}
+
+void JSONWriter::Null()
+{
+	BeginElement();
+	Append("null", 4);
+}
+
+uint64 JSONWriter::Finish(char** buffer)
+{
+	Append('\0');
+	*buffer = data;
+	uint64 ret = size;
+
+	data = nullptr;
+	size = capacity = 0;
+	hasElements.clear();
+	afterKey = false;
+	return ret;
+}
+
+void JSONWriter::BeginElement()
+{
+	//Values after a key go in the same line. Values at the root have nothing before them
+	if (afterKey)
+	{
+		afterKey = false;
+		return;
+	}
+	if (hasElements.empty())
+		return;
+
+	if (hasElements.back())
+		Append(",\n", 2);
+	else
+		Append('\n');
+	hasElements.back() = true;
+	AppendIndent((uint)hasElements.size());
+}
+
+void JSONWriter::EndContainer(char close)
+{
+	bool hadElements = hasElements.back();
+	hasElements.pop_back();
+
+	//Empty containers are written in a single line
+	if (hadElements)
+	{
+		Append('\n');
+		AppendIndent((uint)hasElements.size());
+	}
+	Append(close);
+}
+
+void JSONWriter::Grow(uint64 minCapacity)
+{
+	uint64 newCapacity = capacity > 0 ? capacity * 2 : minCapacity;
+	while (newCapacity < minCapacity)
+		newCapacity *= 2;
+
+	char* newData = new char[newCapacity];
+	if (size > 0)
+		memcpy(newData, data, size);
+	RELEASE_ARRAY(data);
+
+	data = newData;
+	capacity = newCapacity;
+}
+
+void JSONWriter::Append(const char* text, uint64 length)
+{
+	Reserve(length);
+	memcpy(data + size, text, length);
+	size += length;
+}
+
+void JSONWriter::AppendIndent(uint level)
+{
+	Reserve(level * 4);
+	memset(data + size, ' ', level * 4);
+	size += level * 4;
+}
+
+void JSONWriter::AppendString(const char* value, uint64 length)
+{
+	//Control characters take six: \u00XX
+	Reserve(length * 6 + 2);
+	char* out = data + size;
+	*out++ = '"';
+
+	for (uint64 i = 0; i < length; ++i)
+	{
+		char c = value[i];
+		char sequence = 0;
+		switch (c)
+		{
+			case '"':  sequence = '"'; break;
+			case '\\': sequence = '\\'; break;
+			case '/':  sequence = '/'; break;	//As parson, to keep json embeddable in html
+			case '\b': sequence = 'b'; break;
+			case '\f': sequence = 'f'; break;
+			case '\n': sequence = 'n'; break;
+			case '\r': sequence = 'r'; break;
+			case '\t': sequence = 't'; break;
+		}
+
+		if (sequence != 0)
+		{
+			*out++ = '\\';
+			*out++ = sequence;
+		}
+		else if ((unsigned char)c < 0x20)
+		{
+			static const char hexDigits[] = "0123456789abcdef";
+			memcpy(out, "\\u00", 4);
+			out[4] = hexDigits[(unsigned char)c >> 4];
+			out[5] = hexDigits[c & 0xF];
+			out += 6;
+		}
+		else
+		{
+			*out++ = c;
+		}
+	}
+
+	*out++ = '"';
+	size = out - data;
+}
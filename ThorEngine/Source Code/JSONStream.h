@@ -0,0 +1,147 @@
+#ifndef __JSON_STREAM_H__
+#define __JSON_STREAM_H__
+
+#include "Globals.h"
+
+#include <string>
+#include <vector>
+#include <string.h>
+
+//Streaming json, for large files: no document tree is built, content is read or written in a single pass
+//Config keeps the parson document for small files that are edited as a whole
+
+//Pull parser over a json buffer. Each call to Next reads one token
+//Keys and strings are views into the buffer: they are only decoded when asked for
+class JSONReader
+{
+public:
+	enum class Token
+	{
+		OBJECT_BEGIN,
+		OBJECT_END,
+		ARRAY_BEGIN,
+		ARRAY_END,
+		KEY,
+		STRING,
+		NUMBER,
+		BOOL,
+		NULL_VALUE,
+		END,		//The root value has been read
+		ERROR,		//Syntax error: every later call returns it too
+	};
+
+	//The buffer has to stay valid while reading. It does not need a null terminator
+	JSONReader(const char* buffer, uint64 size);
+
+	Token Next();
+
+	//Skips the rest of the value started by the current token: the whole object or array after OBJECT_BEGIN or
+	//ARRAY_BEGIN, or the value following a KEY. Returns false on errors
+	bool SkipValue();
+
+	//Object and array loops: 'NextKey' returns false at the end of the current object, 'NextElement' at the end of
+	//the current array. Both return false on errors
+	bool NextKey();
+	bool NextElement();
+
+	//Value after the current KEY. Values of another type are skipped and 'defaultValue' is returned
+	double ReadNumber(double defaultValue = 0);
+	uint64 ReadUInt64(uint64 defaultValue = 0);
+	bool ReadBool(bool defaultValue = true);
+	void ReadString(std::string& string, const char* defaultValue = "");
+	//Fills 'values' with the numbers of the array after the current KEY. Missing numbers keep their value
+	uint ReadNumbers(float* values, uint count);
+
+	inline Token GetToken() const { return token; }
+	inline bool HasError() const { return token == Token::ERROR; }
+	//Byte where reading stopped, to report errors
+	inline uint64 GetOffset() const { return cursor - buffer; }
+
+	//Compares the current KEY or STRING without decoding it
+	template <uint N>
+	inline bool Is(const char (&string)[N]) const { return length == N - 1 && escaped == false && memcmp(view, string, N - 1) == 0; }
+
+	//Current KEY or STRING as found in the buffer, escape sequences included
+	inline const char* GetView() const { return view; }
+	inline uint GetLength() const { return length; }
+	inline bool IsEscaped() const { return escaped; }
+
+	//Current KEY or STRING with its escape sequences decoded
+	void GetString(std::string& string) const;
+	double GetNumber() const;
+	//Integers are read exactly, beyond the precision of a double
+	uint64 GetUInt64() const;
+	inline bool GetBool() const { return boolean; }
+
+private:
+	Token ReadValue();
+	bool ReadStringView();
+	bool ReadLiteral(const char* literal, uint size);
+	void SkipWhitespace();
+	Token Fail();
+
+private:
+	const char* buffer = nullptr;
+	const char* cursor = nullptr;
+	const char* end = nullptr;
+
+	Token token = Token::END;
+	std::vector<char> containers;	//'{' or '[' for each open container
+	bool afterValue = false;		//A value of the current container has been read: a ',' or its end follows
+	bool afterKey = false;			//A KEY has been read: its value follows
+
+	const char* view = nullptr;
+	uint length = 0;
+	bool escaped = false;
+	bool boolean = false;
+};
+
+//Writes json into a growing buffer, in the same pretty format as parson
+//Numbers are written with the shortest text that reads back the same value
+class JSONWriter
+{
+public:
+	JSONWriter(uint64 capacity = 4096);
+	~JSONWriter();
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+
+	//Members of an object: a key followed by its value
+	void Key(const char* name);
+
+	void Number(double value);
+	void UInt64(uint64 value);
+	void Bool(bool value);
+	void String(const char* value);
+	void String(const char* value, uint length);
+	void Null();
+
+	//Adds the null terminator and hands the buffer over. Returns its size, terminator included, as Config::Serialize
+	//Warning: buffer memory needs to be released after the function call
+	uint64 Finish(char** buffer);
+
+private:
+	//Separator and indentation before a value or a key
+	void BeginElement();
+	void EndContainer(char close);
+
+	inline void Reserve(uint64 bytes) { if (size + bytes > capacity) Grow(size + bytes); }
+	void Grow(uint64 minCapacity);
+	inline void Append(char c) { Reserve(1); data[size++] = c; }
+	void Append(const char* text, uint64 length);
+	void AppendIndent(uint level);
+	void AppendString(const char* value, uint64 length);
+
+private:
+	char* data = nullptr;
+	uint64 size = 0;
+	uint64 capacity = 0;
+
+	std::vector<bool> hasElements;	//For each open container
+	bool afterKey = false;
+};
+
+#endif //__JSON_STREAM_H__
@@ -0,0 +1,159 @@
+#include "LibraryPack.h"
+
+#include <string.h>
+
+namespace
+{
+	const char packMagic[8] = { 'T', 'H', 'O', 'R', 'P', 'A', 'C', 'K' };
+	const uint packVersion = 1;
+
+	struct Header
+	{
+		char magic[8];
+		uint version = 0;
+		uint padding = 0;
+		uint64 entryCount = 0;
+		uint64 slotCount = 0;		//Power of two
+		uint64 indexOffset = 0;
+	};
+}
+
+bool LibraryPack::Open(const char* path)
+{
+	Close();
+	if (file.Open(path) == false)
+		return false;
+
+	Header header;
+	bool valid = file.GetSize() >= sizeof(Header);
+	if (valid)
+	{
+		memcpy(&header, file.GetData(), sizeof(Header));
+		valid = memcmp(header.magic, packMagic, sizeof(packMagic)) == 0 && header.version == packVersion;
+	}
+
+	//Slot counts are powers of two and the index has to fit in the file
+	valid = valid && header.slotCount > 0 && (header.slotCount & (header.slotCount - 1)) == 0 && header.indexOffset % 8 == 0;
+	valid = valid && header.indexOffset <= file.GetSize() && header.slotCount <= (file.GetSize() - header.indexOffset) / sizeof(Slot);
+	if (valid == false)
+	{
+		LOG("[error] Library pack '%s' is not valid", path);
+		file.Close();
+		return false;
+	}
+
+	this->path = path;
+	slots = (const Slot*)(file.GetData() + header.indexOffset);
+	slotMask = header.slotCount - 1;
+	entryCount = header.entryCount;
+	return true;
+}
+
+void LibraryPack::Close()
+{
+	file.Close();
+	path.clear();
+	slots = nullptr;
+	slotMask = 0;
+	entryCount = 0;
+}
+
+const LibraryPack::Slot* LibraryPack::Find(uint64 ID) const
+{
+	if (slots == nullptr || ID == 0)
+		return nullptr;
+
+	//Linear probing, the table is never more than half full
+	for (uint64 i = HashID(ID) & slotMask; ; i = (i + 1) & slotMask)
+	{
+		if (slots[i].ID == ID)
+		{
+			//Entries are checked once used: a damaged index never points outside the file
+			return slots[i].offset <= file.GetSize() && slots[i].size <= file.GetSize() - slots[i].offset ? &slots[i] : nullptr;
+		}
+		if (slots[i].ID == 0)
+			return nullptr;
+	}
+}
+
+uint64 LibraryPack::HashID(uint64 ID)
+{
+	//Finalizer of MurmurHash3: IDs of the same type can share their high bits
+	ID ^= ID >> 33;
+	ID *= 0xff51afd7ed558ccdull;
+	ID ^= ID >> 33;
+	return ID;
+}
+
+// Writer -----------------------------------------------------------
+bool LibraryPack::Writer::Open(const char* path)
+{
+	stream.open(path, std::ios::binary | std::ios::trunc);
+	if (stream.is_open() == false)
+		return false;
+
+	//Header is written again once the index is known
+	Header header;
+	stream.write((const char*)&header, sizeof(Header));
+	offset = sizeof(Header);
+	entries.clear();
+	return (bool)stream;
+}
+
+bool LibraryPack::Writer::Add(uint64 ID, const char* data, uint64 size, uint alignment)
+{
+	if (ID == 0 || Pad(alignment) == false)
+		return false;
+
+	Slot slot;
+	slot.ID = ID;
+	slot.offset = offset;
+	slot.size = size;
+	entries.push_back(slot);
+
+	stream.write(data, size);
+	offset += size;
+	return (bool)stream;
+}
+
+bool LibraryPack::Writer::Finish()
+{
+	uint64 slotCount = 16;
+	while (slotCount < entries.size() * 2)
+		slotCount *= 2;
+
+	std::vector<Slot> slots(slotCount);
+	for (uint i = 0; i < entries.size(); ++i)
+	{
+		uint64 s = HashID(entries[i].ID) & (slotCount - 1);
+		while (slots[s].ID != 0 && slots[s].ID != entries[i].ID)
+			s = (s + 1) & (slotCount - 1);
+		slots[s] = entries[i];
+	}
+
+	if (Pad(16) == false)
+		return false;
+
+	Header header;
+	memcpy(header.magic, packMagic, sizeof(packMagic));
+	header.version = packVersion;
+	header.entryCount = entries.size();
+	header.slotCount = slotCount;
+	header.indexOffset = offset;
+
+	stream.write((const char*)slots.data(), sizeof(Slot) * slotCount);
+	stream.seekp(0);
+	stream.write((const char*)&header, sizeof(Header));
+	stream.close();
+	return !stream.fail();
+}
+
+bool LibraryPack::Writer::Pad(uint alignment)
+{
+	static const char zeros[pageAlignment] = { 0 };
+	uint64 padding = (alignment - offset % alignment) % alignment;
+	offset += padding;
+	for (; padding > 0 && stream; padding -= padding < pageAlignment ? padding : pageAlignment)
+		stream.write(zeros, padding < pageAlignment ? padding : pageAlignment);
+	return (bool)stream;
+}
@@ -0,0 +1,71 @@
+#ifndef __LIBRARY_PACK_H__
+#define __LIBRARY_PACK_H__
+
+#include "Globals.h"
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+//Library files of many resources stored in a single archive, built by M_Resources::CookLibrary
+//Layout: header, blobs (each one aligned) and an index. The index is an open addressing hash table keyed by resource ID,
+//read in place from the mapped archive: opening a pack does not parse anything and a lookup is a few probes
+class LibraryPack
+{
+public:
+	struct Slot
+	{
+		uint64 ID = 0;		//0 for empty slots, never a resource ID
+		uint64 offset = 0;	//From the start of the archive
+		uint64 size = 0;
+	};
+
+	//Blobs that can be mapped on their own start on a page
+	static const uint pageAlignment = 4096;
+
+	//'path' is a real path, not a PhysFS one
+	bool Open(const char* path);
+	void Close();
+
+	inline bool IsOpen() const { return slots != nullptr; }
+	inline const std::string& GetPath() const { return path; }
+	inline uint64 GetEntryCount() const { return entryCount; }
+
+	//Returns the slot of a resource blob, nullptr if the pack does not have it
+	const Slot* Find(uint64 ID) const;
+	inline const char* GetBlob(const Slot& slot) const { return file.GetData() + slot.offset; }
+
+	class Writer
+	{
+	public:
+		bool Open(const char* path);
+
+		//'alignment' is a power of two
+		bool Add(uint64 ID, const char* data, uint64 size, uint alignment = 16);
+
+		//Writes the index. The pack is not valid until it has finished
+		bool Finish();
+
+	private:
+		bool Pad(uint alignment);
+
+	private:
+		std::ofstream stream;
+		uint64 offset = 0;
+		std::vector<Slot> entries;
+	};
+
+private:
+	static uint64 HashID(uint64 ID);
+
+private:
+	MappedFile file;
+	std::string path;
+
+	const Slot* slots = nullptr;
+	uint64 slotMask = 0;
+	uint64 entryCount = 0;
+};
+
+#endif //__LIBRARY_PACK_H__
@@ -2,7 +2,7 @@
 #define __LIGHT_H__
 
 #include "Color.h"
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 
 struct Light
 {
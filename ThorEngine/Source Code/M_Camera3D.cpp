@@ -1,6 +1,8 @@
 #include "Engine.h"
 #include "M_Camera3D.h"
+#ifndef THOR_HEADLESS
 #include "M_Editor.h"
+#endif
 #include "M_Input.h"
 #include "M_Window.h"
 #include "C_Camera.h"
@@ -63,6 +65,7 @@ bool M_Camera3D::CleanUp()
 // -----------------------------------------------------------------
 update_status M_Camera3D::Update()
 {
+#ifndef THOR_HEADLESS
 	if (Engine->moduleEditor->UsingKeyboard() == false)
 		Move_Keyboard(Time::deltaTime);
 
@@ -74,6 +77,7 @@ update_status M_Camera3D::Update()
 		}
 		//Move_Mouse();
 	}
+#endif
 
 	return UPDATE_CONTINUE;
 }
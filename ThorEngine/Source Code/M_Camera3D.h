@@ -2,7 +2,7 @@
 #define __MODULE_CAMERA_H__
 
 #include "Module.h"
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 
 class C_Camera;
 class Config;
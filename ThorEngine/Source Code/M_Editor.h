@@ -7,7 +7,7 @@
 
 #include <string>
 #include <vector>
-#include "MathGeoLib\src\Algorithm\Random\LCG.h"
+#include "MathGeoLib/src/Algorithm/Random/LCG.h"
 
 class Config;
 class GameObject;
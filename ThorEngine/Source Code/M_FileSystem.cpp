@@ -2,22 +2,72 @@
 #include "Engine.h"
 #include "M_FileSystem.h"
 #include "PathNode.h"
+#include "Config.h"
+#include "MappedFile.h"
+#include "LibraryPack.h"
+#include "IOService.h"
 
 #include "PhysFS/include/physfs.h"
+#include <string.h>
 #include <fstream>
 #include <filesystem>
 
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#endif
+
+#ifndef THOR_HEADLESS
 #include "Assimp/include/cfileio.h"
 #include "Assimp/include/types.h"
 
 #pragma comment( lib, "PhysFS/libx86/physfs.lib" )
+#endif
+
+namespace
+{
+	//Flushes a file (or, outside of Windows, a directory) to the disk
+	bool SyncPath(const std::string& path, bool isDirectory)
+	{
+#ifdef _WIN32
+		//Directory entries are journaled by NTFS, only file content needs flushing
+		if (isDirectory)
+			return true;
+		int fd = _open(path.c_str(), _O_WRONLY | _O_BINARY);
+		if (fd < 0)
+			return false;
+		bool ret = _commit(fd) == 0;
+		_close(fd);
+		return ret;
+#else
+		int fd = open(path.c_str(), isDirectory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+		if (fd < 0)
+			return false;
+		bool ret = (isDirectory ? fsync(fd) : fdatasync(fd)) == 0;
+		close(fd);
+		return ret;
+#endif
+	}
+}
 
 M_FileSystem::M_FileSystem(bool start_enabled) : Module("FileSystem", true)
 {
 	// needs to be created before Init so other modules can use it
+#ifdef THOR_HEADLESS
+	PHYSFS_init(nullptr);
+#else
 	char* base_path = SDL_GetBasePath();
 	PHYSFS_init(nullptr);
 	SDL_free(base_path);
+#endif
 
 	//Setting the working directory as the writing directory
 	if (PHYSFS_setWriteDir(".") == 0)
@@ -26,11 +76,19 @@ M_FileSystem::M_FileSystem(bool start_enabled) : Module("FileSystem", true)
 	AddPath("."); //Adding ProjectFolder (working directory)
 	AddPath("Assets");
 	CreateLibraryDirectories();
+
+	//Two threads: a write or a read waiting on the disk does not hold back the other requests
+	io = new IOService(2, [this](IORequest& request) { return ResolveRead(request); },
+		[this](const IORequest& request) { return WriteReplacing(request.file, request.buffer, request.size); });
 }
 
 // Destructor
 M_FileSystem::~M_FileSystem()
 {
+	//Queued requests are finished before the I/O threads exit. The modules waiting for them are gone: callbacks are dropped
+	RELEASE(io);
+	RELEASE(scanner);
+	UnmountLibraryPack();
 	PHYSFS_deinit();
 }
 
@@ -40,6 +98,7 @@ bool M_FileSystem::Init(Config& config)
 	LOG("Loading File System");
 	bool ret = true;
 
+#ifndef THOR_HEADLESS
 	// Ask SDL for a write dir
 	char* write_path = SDL_GetPrefPath(Engine->GetOrganizationName(), Engine->GetTitleName());
 
@@ -48,14 +107,32 @@ bool M_FileSystem::Init(Config& config)
 	//	LOG("File System error while creating write dir: %s\n", PHYSFS_getLastError());
 
 	SDL_free(write_path);
+#endif
+
+	if (Exists(LIBRARY_PACK_FILE))
+		MountLibraryPack(LIBRARY_PACK_FILE);
 
+	syncWrites = config.GetBool("Sync Writes", syncWrites);
 	return ret;
 }
 
+void M_FileSystem::SaveConfig(Config& config) const
+{
+	config.SetBool("Sync Writes", syncWrites);
+}
+
+update_status M_FileSystem::PreUpdate()
+{
+	io->RunCompletions();
+	SyncDirectories();
+	return UPDATE_CONTINUE;
+}
+
 // Called before quitting
 bool M_FileSystem::CleanUp()
 {
 	//LOG("Freeing File System subsystem");
+	FinishWrites();
 
 	return true;
 }
@@ -72,6 +149,7 @@ void M_FileSystem::CreateLibraryDirectories()
 	CreateDir(PARTICLES_PATH);
 	CreateDir(SHADERS_PATH);
 	CreateDir(SCENES_PATH);
+	CreateDir(TEMP_PATH);
 }
 
 // Add a new zip file or folder
@@ -84,7 +162,19 @@ bool M_FileSystem::AddPath(const char* path_or_zip)
 		LOG("File System error while adding a path or zip: %s\n", PHYSFS_getLastError());
 	}
 	else
+	{
+		//The snapshot of the previous search path is dropped
+		std::error_code error;
+		if (std::filesystem::is_directory(path_or_zip, error))
+			searchPaths.push_back(path_or_zip);
+		else
+			archiveMounted = true;
+
+		RELEASE(scanner);
+		if (archiveMounted == false)
+			scanner = new DirectoryScanner(searchPaths);
 		ret = true;
+	}
 
 	return ret;
 }
@@ -92,6 +182,13 @@ bool M_FileSystem::AddPath(const char* path_or_zip)
 // Check if a file exists
 bool M_FileSystem::Exists(const char* file) const
 {
+	WaitPendingWrites(file);
+	{
+		std::lock_guard<std::mutex> lock(packMutex);
+		uint64 size = 0, offset = 0;
+		if (FindPackedFile(file, size, offset) != nullptr)
+			return true;
+	}
 	return PHYSFS_exists(file) != 0;
 }
 
@@ -100,6 +197,7 @@ bool M_FileSystem::CreateDir(const char* dir)
 	if (IsDirectory(dir) == false)
 	{
 		PHYSFS_mkdir(dir);
+		InvalidateScan(dir);
 		return true;
 	}
 	return false;
@@ -119,19 +217,17 @@ const char * M_FileSystem::GetWriteDir() const
 
 void M_FileSystem::DiscoverFiles(const char* directory, std::vector<std::string> & file_list, std::vector<std::string> & dir_list) const
 {
-	char **rc = PHYSFS_enumerateFiles(directory);
-	char **i;
+	if (scanner != nullptr)
+		scanner->Scan(directory, false);
 
-	for (i = rc; *i != nullptr; i++)
+	std::shared_ptr<const std::vector<DirectoryScanner::Entry>> entries = ListDirectory(DirectoryScanner::Normalize(directory));
+	for (uint i = 0; entries != nullptr && i < entries->size(); ++i)
 	{
-		std::string str = std::string(directory) + std::string("/") + std::string(*i);
-		if (IsDirectory(str.c_str()))
-			dir_list.push_back(*i);
+		if ((*entries)[i].isDirectory)
+			dir_list.push_back((*entries)[i].name);
 		else
-			file_list.push_back(*i);
+			file_list.push_back((*entries)[i].name);
 	}
-
-	PHYSFS_freeList(rc);
 }
 
 void M_FileSystem::GetAllFilesWithExtension(const char* directory, const char* extension, std::vector<std::string>& file_list) const
@@ -160,40 +256,108 @@ PathNode M_FileSystem::GetAllFiles(const char* directory, std::vector<std::strin
 		if (root.localPath == "")
 			root.localPath = directory;
 
-		std::vector<std::string> file_list, dir_list;
-		DiscoverFiles(directory, file_list, dir_list);	
-		
-		//Adding all child directories
-		for (uint i = 0; i < dir_list.size(); i++)
-		{
-			std::string str = directory;
-			str.append("/").append(dir_list[i]);
-			root.children.push_back(GetAllFiles(str.c_str(), filter_ext, ignore_ext));
-		}
-		//Adding all child files
-		for (uint i = 0; i < file_list.size(); i++)
+		//The whole tree is brought up to date at once, subtrees in parallel
+		if (scanner != nullptr && IsDirectory(directory))
+			scanner->Scan(directory);
+
+		AddPathNodes(root, filter_ext, ignore_ext);
+		root.isFile = HasExtension(root.path.c_str());
+		root.isLeaf = root.children.empty() == true;
+		root.modTime = PHYSFS_getLastModTime(directory);
+	}
+	return root;
+}
+
+void M_FileSystem::InvalidateScan(const char* path) const
+{
+	if (scanner != nullptr)
+		scanner->Invalidate(path);
+}
+
+void M_FileSystem::ClearScan() const
+{
+	if (scanner != nullptr)
+		scanner->Clear();
+}
+
+std::shared_ptr<const std::vector<DirectoryScanner::Entry>> M_FileSystem::ListDirectory(const std::string& directory) const
+{
+	if (scanner != nullptr)
+		return scanner->GetEntries(directory.c_str());
+
+	char** rc = PHYSFS_enumerateFiles(directory.c_str());
+	std::shared_ptr<std::vector<DirectoryScanner::Entry>> entries = std::make_shared<std::vector<DirectoryScanner::Entry>>();
+	for (char** i = rc; *i != nullptr; i++)
+	{
+		std::string path = directory + "/" + *i;
+		DirectoryScanner::Entry entry;
+		entry.name = *i;
+		entry.isDirectory = IsDirectory(path.c_str());
+		entry.modTime = PHYSFS_getLastModTime(path.c_str());
+		entries->push_back(entry);
+	}
+	PHYSFS_freeList(rc);
+	return entries;
+}
+
+void M_FileSystem::AddPathNodes(PathNode& node, std::vector<std::string>* filter_ext, std::vector<std::string>* ignore_ext) const
+{
+	std::shared_ptr<const std::vector<DirectoryScanner::Entry>> entries = ListDirectory(node.path);
+	if (entries == nullptr)
+		return;
+
+	//Child directories first, then child files. Nodes are built in place: subtrees are never copied
+	node.children.reserve(entries->size());
+	for (uint pass = 0; pass < 2; ++pass)
+	{
+		bool directories = pass == 0;
+		for (uint i = 0; i < entries->size(); ++i)
 		{
+			const DirectoryScanner::Entry& entry = (*entries)[i];
+			if (entry.isDirectory != directories)
+				continue;
+
 			//Filtering extensions
-			bool filter = true, discard = false;
-			if (filter_ext != nullptr)
-			{
-				filter = HasExtension(file_list[i].c_str(), *filter_ext);
-			}
-			if (ignore_ext != nullptr)
+			if (directories == false)
 			{
-				discard = HasExtension(file_list[i].c_str(), *ignore_ext);
-			}
-			if (filter == true && discard == false)
-			{
-				std::string str = directory;
-				str.append("/").append(file_list[i]);
-				root.children.push_back(GetAllFiles(str.c_str(), filter_ext, ignore_ext));
+				if (filter_ext != nullptr && MatchesExtension(entry.name, *filter_ext) == false)
+					continue;
+				if (ignore_ext != nullptr && MatchesExtension(entry.name, *ignore_ext) == true)
+					continue;
 			}
+
+			node.children.emplace_back();
+			PathNode& child = node.children.back();
+			child.path.reserve(node.path.size() + 1 + entry.name.size());
+			child.path.append(node.path).append("/").append(entry.name);
+
+			//Same as SplitFilePath: the name without its extension, the whole path decides whether it is a file
+			size_t dot = entry.name.find_last_of('.');
+			child.localPath = entry.name.substr(0, dot);
+			size_t pathDot = child.path.find_last_of('.');
+			child.isFile = pathDot != std::string::npos && pathDot + 1 < child.path.size();
+			child.modTime = entry.modTime;
+
+			if (entry.isDirectory)
+				AddPathNodes(child, filter_ext, ignore_ext);
+			child.isLeaf = child.children.empty();
 		}
-		root.isFile = HasExtension(root.path.c_str());
-		root.isLeaf = root.children.empty() == true;
 	}
-	return root;
+}
+
+bool M_FileSystem::MatchesExtension(const std::string& name, const std::vector<std::string>& extensions)
+{
+	//Same as HasExtension: files without extension match any list
+	size_t dot = name.find_last_of('.');
+	if (dot == std::string::npos || dot + 1 == name.size())
+		return true;
+
+	for (uint i = 0; i < extensions.size(); i++)
+	{
+		if (name.compare(dot + 1, std::string::npos, extensions[i]) == 0)
+			return true;
+	}
+	return false;
 }
 
 void M_FileSystem::GetRealDir(const char* path, std::string& output) const
@@ -300,6 +464,20 @@ unsigned int M_FileSystem::Load(const char * path, const char * file, char ** bu
 uint M_FileSystem::Load(const char* file, char** buffer) const
 {
 	uint ret = 0;
+	WaitPendingWrites(file);
+
+	{
+		std::lock_guard<std::mutex> lock(packMutex);
+		uint64 size = 0, offset = 0;
+		const char* packed = FindPackedFile(file, size, offset);
+		if (packed != nullptr)
+		{
+			*buffer = new char[size + 1];
+			memcpy(*buffer, packed, size);
+			(*buffer)[size] = '\0';
+			return (uint)size;
+		}
+	}
 
 	PHYSFS_file* fs_file = PHYSFS_openRead(file);
 
@@ -314,7 +492,7 @@ uint M_FileSystem::Load(const char* file, char** buffer) const
 			if (readed != size)
 			{
 				LOG("File System error while reading from file %s: %s\n", file, PHYSFS_getLastError());
-				RELEASE_ARRAY(buffer);
+				RELEASE_ARRAY(*buffer);
 			}
 			else
 			{
@@ -333,6 +511,41 @@ uint M_FileSystem::Load(const char* file, char** buffer) const
 	return ret;
 }
 
+MappedFile* M_FileSystem::Map(const char* file) const
+{
+	WaitPendingWrites(file);
+
+	{
+		//Packed blobs are mapped from the pack, mappable ones start on a page
+		std::lock_guard<std::mutex> lock(packMutex);
+		uint64 size = 0, offset = 0;
+		if (FindPackedFile(file, size, offset) != nullptr)
+		{
+			MappedFile* mappedFile = new MappedFile();
+			if (mappedFile->Open(libraryPack->GetPath().c_str(), offset, size) == false)
+			{
+				LOG("[Warning] Could not map file %s from the library pack, it will be read instead", file);
+				RELEASE(mappedFile);
+			}
+			return mappedFile;
+		}
+	}
+
+	//Only files found in a search path directory can be mapped, archive contents are compressed
+	const char* realDir = PHYSFS_getRealDir(file);
+	std::error_code error;
+	if (realDir == nullptr || std::filesystem::is_directory(realDir, error) == false)
+		return nullptr;
+
+	MappedFile* mappedFile = new MappedFile();
+	if (mappedFile->Open((std::filesystem::path(realDir) / file).string().c_str()) == false)
+	{
+		LOG("[Warning] Could not map file %s, it will be read instead", file);
+		RELEASE(mappedFile);
+	}
+	return mappedFile;
+}
+
 bool M_FileSystem::DuplicateFile(const char* file, const char* dstFolder, std::string& relativePath)
 {
 	std::string fileStr, extensionStr;
@@ -347,44 +560,161 @@ bool M_FileSystem::DuplicateFile(const char* file, const char* dstFolder, std::s
 
 bool M_FileSystem::DuplicateFile(const char* srcFile, const char* dstFile)
 {
-	//TODO: Compare performance to calling Load(srcFile) and then Save(dstFile)
-	std::ifstream src;
-	src.open(srcFile, std::ios::binary);
-	bool srcOpen = src.is_open();
-	std::ofstream  dst(dstFile, std::ios::binary);
-	bool dstOpen = dst.is_open();
+	WaitPendingWrites(dstFile);
+	AddLooseLibraryFile(dstFile);
 
-	dst << src.rdbuf();
+	std::filesystem::path root(PHYSFS_getWriteDir());
+	std::filesystem::path tempFile = root / TEMP_PATH / std::to_string(tempFiles++);
+	std::filesystem::path dstPath = root / dstFile;
 
-	src.close();
-	dst.close();
+	uint64 size = 0;
+	if (CopyFileContent(srcFile, tempFile.string().c_str(), &size) == false)
+	{
+		LOG("[error] File %s could not be duplicated to %s", srcFile, dstFile);
+		std::error_code error;
+		std::filesystem::remove(tempFile, error);
+		return false;
+	}
 
-	if (srcOpen && dstOpen)
+	if (ReplaceWith(tempFile, dstPath) == false)
 	{
-		LOG("[success] File Duplicated Correctly");
-		return true;
+		//Library/Temp may be on another device than the destination: the copy is made next to it instead
+		tempFile = dstPath.string() + ".tmp" + std::to_string(tempFiles++);
+		if (CopyFileContent(srcFile, tempFile.string().c_str(), &size) == false || ReplaceWith(tempFile, dstPath) == false)
+		{
+			LOG("[error] File %s could not be duplicated to %s", srcFile, dstFile);
+			std::error_code error;
+			std::filesystem::remove(tempFile, error);
+			return false;
+		}
 	}
-	else
+
+	filesCopied.fetch_add(1, std::memory_order_relaxed);
+	bytesCopied.fetch_add(size, std::memory_order_relaxed);
+	InvalidateScan(dstFile);
+	return true;
+}
+
+bool M_FileSystem::CopyFileContent(const char* srcFile, const char* dstFile, uint64* copiedBytes)
+{
+#ifdef _WIN32
+	//Copied by the system, with block cloning on file systems that support it
+	if (CopyFileA(srcFile, dstFile, FALSE) == 0)
+		return false;
+	if (copiedBytes != nullptr)
+	{
+		std::error_code error;
+		*copiedBytes = (uint64)std::filesystem::file_size(dstFile, error);
+	}
+	return true;
+#else
+	int src = open(srcFile, O_RDONLY);
+	if (src < 0)
+		return false;
+
+	struct stat srcStat;
+	if (fstat(src, &srcStat) != 0 || S_ISREG(srcStat.st_mode) == false)
 	{
-		LOG("[error] File could not be duplicated");
+		close(src);
 		return false;
 	}
+
+	int dst = open(dstFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (dst < 0)
+	{
+		close(src);
+		return false;
+	}
+
+	uint64 size = (uint64)srcStat.st_size;
+	uint64 copied = 0;
+	bool failed = false;
+
+#ifdef __linux__
+	//Copied inside the kernel, or shared extents on file systems that support reflinks
+	bool useCopyRange = true;
+	while (copied < size)
+	{
+		ssize_t result = useCopyRange ? copy_file_range(src, nullptr, dst, nullptr, (size_t)(size - copied), 0) : -1;
+		if (result < 0 && useCopyRange && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP))
+		{
+			//Older kernels or copies between devices: the file offsets are where the last copy stopped
+			useCopyRange = false;
+			continue;
+		}
+		if (result < 0 && useCopyRange == false)
+			result = sendfile(dst, src, nullptr, (size_t)(size - copied));
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0)
+		{
+			failed = result < 0 && errno != EINVAL && errno != ENOSYS;
+			break;
+		}
+		copied += (uint64)result;
+	}
+#endif
+
+	//Plain reads and writes for the rest, where the system calls above are not available
+	if (failed == false && copied < size)
+	{
+		char* buffer = new char[1 << 20];
+		while (copied < size)
+		{
+			ssize_t result = read(src, buffer, 1 << 20);
+			if (result < 0 && errno == EINTR)
+				continue;
+			if (result <= 0)
+				break;
+
+			ssize_t written = 0;
+			while (written < result)
+			{
+				ssize_t chunk = write(dst, buffer + written, (size_t)(result - written));
+				if (chunk < 0 && errno == EINTR)
+					continue;
+				if (chunk <= 0)
+					break;
+				written += chunk;
+			}
+			if (written < result)
+				break;
+			copied += (uint64)result;
+		}
+		RELEASE_ARRAY(buffer);
+	}
+
+	close(src);
+	bool ret = close(dst) == 0 && failed == false && copied == size;
+	if (copiedBytes != nullptr)
+		*copiedBytes = copied;
+	return ret;
+#endif
 }
 
+#ifndef THOR_HEADLESS
 int close_sdl_rwops(SDL_RWops *rw)
 {
 	RELEASE_ARRAY(rw->hidden.mem.base);
 	SDL_FreeRW(rw);
 	return 0;
 }
+#endif
 
 // Save a whole buffer to disk
 uint M_FileSystem::Save(const char* file, const void* buffer, unsigned int size, bool append) const
 {
 	unsigned int ret = 0;
 
-	bool overwrite = PHYSFS_exists(file) != 0;
-	PHYSFS_file* fs_file = (append) ? PHYSFS_openAppend(file) : PHYSFS_openWrite(file);
+	//A background write finishing later would replace this content
+	WaitPendingWrites(file);
+	AddLooseLibraryFile(file);
+
+	//Rewriting the file in place would change (or cut) the content of any view mapping it
+	if (append == false)
+		return WriteReplacing(file, (const char*)buffer, size) ? size : 0;
+
+	PHYSFS_file* fs_file = PHYSFS_openAppend(file);
 
 	if (fs_file != nullptr)
 	{
@@ -395,18 +725,14 @@ uint M_FileSystem::Save(const char* file, const void* buffer, unsigned int size,
 		}
 		else
 		{
-			if (append == true)
-				LOG("Added %u data to [%s%s]", size, GetWriteDir(), file);
-			else if (overwrite == true)
-				LOG("File [%s%s] overwritten with %u bytes", GetWriteDir(), file, size);
-			else
-				LOG("New file created [%s%s] of %u bytes", GetWriteDir(), file, size);
-
+			filesWritten.fetch_add(1, std::memory_order_relaxed);
+			bytesWritten.fetch_add(written, std::memory_order_relaxed);
 			ret = written;
 		}
 
 		if (PHYSFS_close(fs_file) == 0)
 			LOG("[error] File System error while closing file %s: %s", file, PHYSFS_getLastError());
+		InvalidateScan(file);
 	}
 	else
 		LOG("[error] File System error while opening file %s: %s", file, PHYSFS_getLastError());
@@ -414,39 +740,369 @@ uint M_FileSystem::Save(const char* file, const void* buffer, unsigned int size,
 	return ret;
 }
 
-bool M_FileSystem::Remove(const char * file)
+void M_FileSystem::SaveAsync(const char* file, char* buffer, uint size, std::function<void(bool)> onWritten)
 {
-	bool ret = false;
+	AddLooseLibraryFile(file);
+
+	//Writes are done in order: a file saved twice ends with the last content
+	IORequest* request = new IORequest();
+	request->type = IORequest::Type::WRITE;
+	request->file = file;
+	request->buffer = buffer;
+	request->size = size;
+	if (onWritten)
+		request->onComplete = [onWritten](IORequest& written) { onWritten(written.succeeded); };
+	io->Submit(request);
+}
+
+void M_FileSystem::FinishWrites()
+{
+	io->Wait();
+	SyncDirectories();
+}
+
+M_FileSystem::WriteStats M_FileSystem::GetWriteStats() const
+{
+	WriteStats stats;
+	stats.filesWritten = filesWritten.load(std::memory_order_relaxed);
+	stats.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+	stats.filesCopied = filesCopied.load(std::memory_order_relaxed);
+	stats.bytesCopied = bytesCopied.load(std::memory_order_relaxed);
+	stats.filesRemoved = filesRemoved.load(std::memory_order_relaxed);
+	stats.syncs = syncs.load(std::memory_order_relaxed);
+	return stats;
+}
 
-	if (file != nullptr)
+bool M_FileSystem::ResolveRead(IORequest& request) const
+{
 	{
-		//If it is a directory, we need to recursively remove all the files inside
-		if (IsDirectory(file))
+		std::lock_guard<std::mutex> lock(packMutex);
+		uint64 size = 0, offset = 0;
+		const char* packed = FindPackedFile(request.file.c_str(), size, offset);
+		if (packed != nullptr)
 		{
-			std::vector<std::string> containedFiles, containedDirs;
-			PathNode rootDirectory = GetAllFiles(file);
-			
-			for (uint i = 0; i < rootDirectory.children.size(); ++i)
-				Remove(rootDirectory.children[i].path.c_str());
+			request.buffer = io->AcquireBuffer((uint)size + 1, request.capacity);
+			memcpy(request.buffer, packed, size);
+			request.buffer[size] = '\0';
+			request.size = (uint)size;
+			request.succeeded = true;
+			return true;
 		}
-		
-		if (PHYSFS_delete(file) != 0)
+	}
+
+	const char* realDir = PHYSFS_getRealDir(request.file.c_str());
+	if (realDir == nullptr)
+		return true;
+
+	//Files inside archives are read through PhysFS
+	std::error_code error;
+	if (std::filesystem::is_directory(realDir, error) == false)
+	{
+		request.size = Load(request.file.c_str(), &request.buffer);
+		request.succeeded = request.size > 0;
+		return true;
+	}
+
+	request.realPath = (std::filesystem::path(realDir) / request.file).string();
+	return false;
+}
+
+bool M_FileSystem::WriteReplacing(const std::string& file, const char* buffer, uint size) const
+{
+	std::filesystem::path root(PHYSFS_getWriteDir());
+	std::filesystem::path tempFile = root / TEMP_PATH / std::to_string(tempFiles++);
+	std::filesystem::path dstFile = root / file;
+
+	{
+		std::ofstream stream(tempFile, std::ios::binary | std::ios::trunc);
+		if (stream.is_open() == false)
 		{
-			LOG("File deleted: [%s]", file);
-			ret = true;
+			//New files are written through Library/Temp too: it may not exist yet in a fresh project
+			std::error_code error;
+			std::filesystem::create_directories(tempFile.parent_path(), error);
+			stream.open(tempFile, std::ios::binary | std::ios::trunc);
 		}
-		else
-			LOG("File System error while trying to delete [%s]: %s", file, PHYSFS_getLastError());
+		if (stream.is_open() == false || !stream.write(buffer, size))
+		{
+			LOG("[error] File System error while writing to file %s", file.c_str());
+			return false;
+		}
+	}
+
+	if (ReplaceWith(tempFile, dstFile) == false)
+	{
+		LOG("[error] File System error while replacing file %s", file.c_str());
+		return false;
+	}
+
+	filesWritten.fetch_add(1, std::memory_order_relaxed);
+	bytesWritten.fetch_add(size, std::memory_order_relaxed);
+	InvalidateScan(file.c_str());
+	return true;
+}
+
+bool M_FileSystem::ReplaceWith(const std::filesystem::path& tempFile, const std::filesystem::path& dstFile) const
+{
+	std::error_code error;
+	if (syncWrites)
+	{
+		//The content has to reach the disk before the rename does: otherwise a crash could leave an empty file
+		if (SyncPath(tempFile.string(), false) == false)
+			LOG("[Warning] Could not flush %s to the disk", dstFile.string().c_str());
+		syncs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::filesystem::rename(tempFile, dstFile, error);
+	if (error)
+	{
+		std::filesystem::remove(tempFile, error);
+		return false;
+	}
+
+	if (syncWrites)
+	{
+		std::lock_guard<std::mutex> lock(syncMutex);
+		unsyncedDirectories.insert(dstFile.parent_path().string());
+	}
+	return true;
+}
+
+void M_FileSystem::SyncDirectories() const
+{
+	std::unordered_set<std::string> directories;
+	{
+		std::lock_guard<std::mutex> lock(syncMutex);
+		if (unsyncedDirectories.empty())
+			return;
+		directories.swap(unsyncedDirectories);
+	}
+
+	for (std::unordered_set<std::string>::const_iterator it = directories.begin(); it != directories.end(); ++it)
+	{
+		if (SyncPath(it->empty() ? "." : *it, true) == false)
+			LOG("[Warning] Could not flush directory %s to the disk", it->c_str());
+		syncs.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void M_FileSystem::WaitPendingWrites(const char* file) const
+{
+	io->WaitWrites(file);
+}
+
+bool M_FileSystem::Remove(const char * file)
+{
+	if (file == nullptr)
+		return false;
+
+	//If it is a directory, we need to recursively remove all the files inside. The tree is only walked once
+	if (IsDirectory(file))
+	{
+		PathNode rootDirectory = GetAllFiles(file);
+		RemoveContent(rootDirectory);
+	}
+	return RemoveEntry(file);
+}
+
+void M_FileSystem::RemoveContent(const PathNode& node)
+{
+	for (uint i = 0; i < node.children.size(); ++i)
+	{
+		RemoveContent(node.children[i]);
+		RemoveEntry(node.children[i].path.c_str());
+	}
+}
+
+bool M_FileSystem::RemoveEntry(const char* file)
+{
+	bool ret = false;
+	WaitPendingWrites(file);
+
+	//A removed library file is not read from the pack either
+	AddLooseLibraryFile(file);
+	if (libraryPack != nullptr)
+	{
+		//Both paths are relative to the write dir, not to the working directory
+		std::filesystem::path root(PHYSFS_getWriteDir());
+		std::error_code error;
+		if (std::filesystem::equivalent(root / file, root / LIBRARY_PACK_FILE, error))
+			UnmountLibraryPack();
 	}
 
+	if (PHYSFS_delete(file) != 0)
+	{
+		filesRemoved.fetch_add(1, std::memory_order_relaxed);
+		ret = true;
+	}
+	else
+		LOG("File System error while trying to delete [%s]: %s", file, PHYSFS_getLastError());
+
+	InvalidateScan(file);
 	return ret;
 }
 
 uint64 M_FileSystem::GetLastModTime(const char* filename)
 {
+	WaitPendingWrites(filename);
+	return PHYSFS_getLastModTime(filename);
+}
+
+uint64 M_FileSystem::GetScannedModTime(const char* filename)
+{
+	WaitPendingWrites(filename);
+	uint64 ret = 0;
+	if (scanner != nullptr && scanner->GetModTime(filename, ret))
+		return ret;
 	return PHYSFS_getLastModTime(filename);
 }
 
+bool M_FileSystem::MountLibraryPack(const char* file)
+{
+	UnmountLibraryPack();
+
+	LibraryPack* pack = new LibraryPack();
+	if (pack->Open((std::filesystem::path(PHYSFS_getWriteDir()) / file).string().c_str()) == false)
+	{
+		RELEASE(pack);
+		return false;
+	}
+
+	//Type folders only hold library files named by ID
+	static const char* folders[] = { FOLDERS_PATH, MESHES_PATH, TEXTURES_PATH, MATERIALS_PATH, MODELS_PATH, ANIMATIONS_PATH,
+		PARTICLES_PATH, SHADERS_PATH, SCENES_PATH };
+
+	std::unordered_set<std::string> looseFiles;
+	for (uint i = 0; i < sizeof(folders) / sizeof(folders[0]); ++i)
+	{
+		char** list = PHYSFS_enumerateFiles(folders[i]);
+		for (char** it = list; *it != nullptr; ++it)
+			looseFiles.insert(std::string(folders[i]) + *it);
+		PHYSFS_freeList(list);
+	}
+
+	LOG("Mounted library pack %s: %llu files, %u loose files", file, pack->GetEntryCount(), (uint)looseFiles.size());
+
+	std::lock_guard<std::mutex> lock(packMutex);
+	libraryPack = pack;
+	looseLibraryFiles.swap(looseFiles);
+	return true;
+}
+
+void M_FileSystem::UnmountLibraryPack()
+{
+	std::lock_guard<std::mutex> lock(packMutex);
+	RELEASE(libraryPack);
+	looseLibraryFiles.clear();
+}
+
+bool M_FileSystem::CookLibraryPack(const std::vector<PackedFile>& files, bool removeLooseFiles)
+{
+	FinishWrites();
+
+	std::filesystem::path root(PHYSFS_getWriteDir());
+	std::filesystem::path tempFile = root / TEMP_PATH / std::to_string(tempFiles++);
+
+	LibraryPack::Writer writer;
+	bool ret = writer.Open(tempFile.string().c_str());
+	for (uint i = 0; i < files.size() && ret; ++i)
+	{
+		uint64 ID = GetLibraryFileID(files[i].file.c_str());
+		char* buffer = nullptr;
+		uint size = ID != 0 ? Load(files[i].file.c_str(), &buffer) : 0;
+		if (size == 0)
+		{
+			LOG("[Warning] Library file %s not packed: it could not be read", files[i].file.c_str());
+			continue;
+		}
+
+		ret = writer.Add(ID, buffer, size, files[i].alignment);
+		RELEASE_ARRAY(buffer);
+	}
+
+	std::error_code error;
+	if (ret == false || writer.Finish() == false)
+	{
+		LOG("[error] File System error while writing library pack %s", tempFile.string().c_str());
+		std::filesystem::remove(tempFile, error);
+		return false;
+	}
+
+	//Resources still mapping the previous pack keep its content
+	UnmountLibraryPack();
+	std::filesystem::rename(tempFile, root / LIBRARY_PACK_FILE, error);
+	if (error)
+	{
+		LOG("[error] File System error while replacing library pack: %s", error.message().c_str());
+		std::filesystem::remove(tempFile, error);
+		return false;
+	}
+
+	if (removeLooseFiles)
+	{
+		for (uint i = 0; i < files.size(); ++i)
+			std::filesystem::remove(root / files[i].file, error);
+	}
+
+	return MountLibraryPack(LIBRARY_PACK_FILE);
+}
+
+void M_FileSystem::AddLooseLibraryFile(const char* file) const
+{
+	std::lock_guard<std::mutex> lock(packMutex);
+	if (libraryPack != nullptr && GetLibraryFileID(file) != 0)
+		looseLibraryFiles.insert(file);
+}
+
+const char* M_FileSystem::FindPackedFile(const char* file, uint64& size, uint64& offset) const
+{
+	if (libraryPack == nullptr)
+		return nullptr;
+
+	uint64 ID = GetLibraryFileID(file);
+	if (ID == 0 || looseLibraryFiles.find(file) != looseLibraryFiles.end())
+		return nullptr;
+
+	const LibraryPack::Slot* slot = libraryPack->Find(ID);
+	if (slot == nullptr)
+		return nullptr;
+
+	size = slot->size;
+	offset = slot->offset;
+	return libraryPack->GetBlob(*slot);
+}
+
+uint64 M_FileSystem::GetLibraryFileID(const char* file)
+{
+	if (file == nullptr || strncmp(file, LIBRARY_PATH, strlen(LIBRARY_PATH)) != 0)
+		return 0;
+
+	const char* name = strrchr(file, '/') + 1;
+	if (*name == '\0')
+		return 0;
+
+	uint64 ID = 0;
+	for (const char* c = name; *c != '\0'; ++c)
+	{
+		if (*c < '0' || *c > '9')
+			return 0;
+		ID = ID * 10 + (*c - '0');
+	}
+	return ID;
+}
+
+std::string M_FileSystem::GetUserDataDir() const
+{
+	std::string directory;
+#ifndef THOR_HEADLESS
+	if (char* prefPath = SDL_GetPrefPath(Engine->GetOrganizationName(), Engine->GetTitleName()))
+	{
+		directory = prefPath;
+		SDL_free(prefPath);
+	}
+#endif
+	return directory;
+}
+
 std::string M_FileSystem::GetUniqueName(const char* path, const char* name) const
 {
 	//TODO: modify to distinguix files and dirs?
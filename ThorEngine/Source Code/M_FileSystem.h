@@ -3,6 +3,15 @@
 
 #include "Module.h"
 #include <vector>
+#include <string>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <filesystem>
+
+#include "DirectoryScanner.h"
 
 struct SDL_RWops;
 int close_sdl_rwops(SDL_RWops *rw);
@@ -11,6 +20,10 @@ struct aiFileIO;
 
 //struct BASS_FILEPROCS;
 class Config;
+class MappedFile;
+class LibraryPack;
+class IOService;
+struct IORequest;
 struct PathNode;
 
 class M_FileSystem : public Module
@@ -24,6 +37,10 @@ public:
 
 	// Called before render is available
 	bool Init(Config& config) override;
+	void SaveConfig(Config& config) const override;
+
+	//Runs the main thread callbacks of the finished background requests
+	update_status PreUpdate() override;
 
 	// Called before quitting
 	bool CleanUp() override;
@@ -38,7 +55,14 @@ public:
 	const char* GetWriteDir() const;
 	void DiscoverFiles(const char* directory, std::vector<std::string>& file_list, std::vector<std::string>& dir_list) const;
 	void GetAllFilesWithExtension(const char* directory, const char* extension, std::vector<std::string>& file_list) const;
+
+	//Directory listings come from a cached snapshot: scanning again only reads the directories modified since
+	//Files written or removed through the file system update it. Changes made outside of it need InvalidateScan, unless
+	//they add, remove or rename entries
 	PathNode GetAllFiles(const char* directory, std::vector<std::string>* filter_ext = nullptr, std::vector<std::string>* ignore_ext = nullptr) const;
+	void InvalidateScan(const char* path) const;
+	//Drops the snapshot: the next scan lists every directory again
+	void ClearScan() const;
 	void GetRealDir(const char* path, std::string& output) const;
 	std::string GetPathRelativeToAssets(const char* originalPath) const;
 
@@ -53,14 +77,133 @@ public:
 	unsigned int Load(const char* path, const char* file, char** buffer) const;
 	unsigned int Load(const char* file, char** buffer) const;
 
+	//Maps the file read-only instead of reading it into a buffer. The caller owns the returned view
+	//Returns nullptr if the file is missing, empty or not a plain file on disk (inside an archive): use Load instead
+	MappedFile* Map(const char* file) const;
+
+	//The copy is made in Library/Temp and renamed over 'dstFile', like Save
 	bool DuplicateFile(const char* file, const char* dstFolder, std::string& relativePath);
 	bool DuplicateFile(const char* srcFile, const char* dstFile);
 
+	//Copies a file on disk without passing its content through the process where the platform allows it
+	//(copy_file_range or sendfile on Linux, CopyFile on Windows). 'dstFile' is created or truncated in place
+	static bool CopyFileContent(const char* srcFile, const char* dstFile, uint64* copiedBytes = nullptr);
+
+	//Files are written in Library/Temp and renamed over 'file' unless appending: a crash never leaves them half
+	//written and views mapping the previous content stay valid
 	unsigned int Save(const char* file, const void* buffer, unsigned int size, bool append = false) const;
+
+	//Writes the file in the I/O threads, which take ownership of 'buffer' (allocated with new[])
+	//The content is written in Library/Temp and renamed over 'file': it is never found half written
+	//Loading, checking or removing the file waits until its pending writes have finished
+	//'onWritten' runs in the main thread once the file is in place, with the result of the write
+	void SaveAsync(const char* file, char* buffer, uint size, std::function<void(bool)> onWritten = nullptr);
+
+	//Background reads and writes. Reads resolve files like Load: packed library files and loose overrides included
+	inline IOService* GetIO() const { return io; }
+
+	//Blocks until every background request, writes included, has finished and runs their main thread callbacks
+	void FinishWrites();
 	bool Remove(const char* file);
 
+	//With 'Sync Writes' the content of every file is flushed to the disk before it is renamed in place. The renames
+	//are flushed once per frame for all the directories written meanwhile, and by FinishWrites
+	inline bool IsSyncingWrites() const { return syncWrites; }
+	inline void SetSyncWrites(bool sync) { syncWrites = sync; }
+
+	struct WriteStats
+	{
+		uint64 filesWritten = 0;
+		uint64 bytesWritten = 0;
+		uint64 filesCopied = 0;
+		uint64 bytesCopied = 0;
+		uint64 filesRemoved = 0;
+		uint64 syncs = 0;		//Files and directories flushed to the disk
+	};
+	//Totals since the engine started. Writes are counted instead of logged one by one
+	WriteStats GetWriteStats() const;
+
 	uint64 GetLastModTime(const char* filename);
+	//Same as GetLastModTime, taken from the last scan of its directory when it is still valid
+	uint64 GetScannedModTime(const char* filename);
+
+	//Library files found in the mounted LIBRARY_PACK_FILE are read from it, unless a loose copy exists in Library: files
+	//written after the pack was built override it. Load, Map and Exists resolve both transparently
+	//Removed library files stay hidden until the pack is mounted again. Mounting and cooking replace the pack: no file can
+	//be loading meanwhile
+	bool MountLibraryPack(const char* file);
+	void UnmountLibraryPack();
+	inline bool HasLibraryPack() const { return libraryPack != nullptr; }
+
+	struct PackedFile
+	{
+		std::string file;
+		uint alignment = 16;	//Files mapped on their own start on a page (LibraryPack::pageAlignment)
+	};
+
+	//Builds LIBRARY_PACK_FILE from the library files (packed or loose) and mounts it, replacing the previous pack
+	//Packed loose files are deleted if 'removeLooseFiles'. Returns false if the pack could not be written
+	bool CookLibraryPack(const std::vector<PackedFile>& files, bool removeLooseFiles);
+
+	//Library files written without the file system (import cache copies) are reported so they override the pack
+	void AddLooseLibraryFile(const char* file) const;
+
+	//Per user directory for data shared between projects. Empty if the platform has none
+	std::string GetUserDataDir() const;
 	std::string GetUniqueName(const char* path, const char* name) const;
+
+private:
+	//Listing of a directory, from the scanner or from PhysFS when an archive is mounted
+	std::shared_ptr<const std::vector<DirectoryScanner::Entry>> ListDirectory(const std::string& directory) const;
+	void AddPathNodes(PathNode& node, std::vector<std::string>* filter_ext, std::vector<std::string>* ignore_ext) const;
+	static bool MatchesExtension(const std::string& name, const std::vector<std::string>& extensions);
+
+	//Removes the files and directories under 'node', deepest first
+	void RemoveContent(const PathNode& node);
+	bool RemoveEntry(const char* file);
+
+	bool WriteReplacing(const std::string& file, const char* buffer, uint size) const;
+	//Renames a temporary file over 'dstFile', flushing it first when syncing writes
+	bool ReplaceWith(const std::filesystem::path& tempFile, const std::filesystem::path& dstFile) const;
+	//Flushes the directories of the files renamed since the last call
+	void SyncDirectories() const;
+
+	//Read resolver of the I/O service, runs in the I/O threads
+	bool ResolveRead(IORequest& request) const;
+
+	//Blocks while 'file' has background writes pending
+	void WaitPendingWrites(const char* file) const;
+
+	//Packed copy of a library file, nullptr if there is no pack, the pack does not have it or a loose copy overrides it
+	//Called with 'packMutex' locked
+	const char* FindPackedFile(const char* file, uint64& size, uint64& offset) const;
+
+	//Resource ID of a library file named after it, 0 for any other file
+	static uint64 GetLibraryFileID(const char* file);
+
+private:
+	IOService* io = nullptr;
+
+	std::vector<std::string> searchPaths;	//Mounted directories, in search order
+	bool archiveMounted = false;			//Archives are not scanned, their listings come from PhysFS
+	DirectoryScanner* scanner = nullptr;
+
+	mutable std::atomic<uint> tempFiles{ 0 };			//Names the files written in Library/Temp
+
+	bool syncWrites = false;
+	mutable std::mutex syncMutex;
+	mutable std::unordered_set<std::string> unsyncedDirectories;
+
+	mutable std::atomic<uint64> filesWritten{ 0 };
+	mutable std::atomic<uint64> bytesWritten{ 0 };
+	mutable std::atomic<uint64> filesCopied{ 0 };
+	mutable std::atomic<uint64> bytesCopied{ 0 };
+	mutable std::atomic<uint64> filesRemoved{ 0 };
+	mutable std::atomic<uint64> syncs{ 0 };
+
+	mutable std::mutex packMutex;
+	LibraryPack* libraryPack = nullptr;
+	mutable std::unordered_set<std::string> looseLibraryFiles;	//Library files read from disk while a pack is mounted, deleted ones included
 };
 
 #endif // __MODULEFILESYSTEM_H__
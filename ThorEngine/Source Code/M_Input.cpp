@@ -2,19 +2,23 @@
 #include "Engine.h"
 #include "M_Input.h"
 #include "M_Renderer3D.h"
-#include "M_Editor.h"
 #include "M_Window.h"
 #include "M_Resources.h"
+
+#include "SDL/include/SDL_mouse.h"
+
+#ifndef THOR_HEADLESS
+#include "M_Editor.h"
 #include "W_Explorer.h"
 #include "WF_SceneEditor.h"
 
 #include "WindowFrame.h" //TODO: Remove as the code gets cleaner. Acess in PreUpdate -> DROPFILE
 
-#include "SDL/include/SDL_mouse.h"
 #include "Assimp/include/cfileio.h"
 #include "Assimp/include/types.h"
 #include "ImGui/imgui.h"
 #include "ImGui/imgui_internal.h"
+#endif
 
 #define MAX_KEYS 300
 
@@ -34,6 +38,10 @@ M_Input::~M_Input()
 // Called before render is available
 bool M_Input::Init(Config& config)
 {
+#ifdef THOR_HEADLESS
+	//No window to receive events from: all keys and buttons stay idle
+	return true;
+#else
 	LOG("Init SDL input event system");
 	bool ret = true;
 	SDL_Init(0);
@@ -45,11 +53,16 @@ bool M_Input::Init(Config& config)
 	}
 
 	return ret;
+#endif
 }
 
 // Called every draw update
 update_status M_Input::PreUpdate()
 {
+#ifdef THOR_HEADLESS
+	mouse_motion_x = mouse_motion_y = mouse_z = 0;
+	return UPDATE_CONTINUE;
+#else
 	static SDL_Event event;
 
 	mouse_motion_x = mouse_motion_y = 0;
@@ -197,25 +210,32 @@ update_status M_Input::PreUpdate()
 	infiniteHorizontal = false;
 
 	return UPDATE_CONTINUE;
+#endif
 }
 
 // Called before quitting
 bool M_Input::CleanUp()
 {
+#ifndef THOR_HEADLESS
 	LOG("Quitting SDL input event subsystem");
 	SDL_QuitSubSystem(SDL_INIT_EVENTS);
+#endif
 	return true;
 }
 
 void M_Input::SetMouseX(int x)
 {
+#ifndef THOR_HEADLESS
 	SDL_WarpMouseInWindow(Engine->window->window, x, mouse_y);
+#endif
 	mouse_x = x;
 }
 
 void M_Input::SetMouseY(int y)
 {
+#ifndef THOR_HEADLESS
 	SDL_WarpMouseInWindow(Engine->window->window, mouse_x, y);
+#endif
 	mouse_y = y;
 }
 
@@ -226,6 +246,7 @@ void M_Input::InfiniteHorizontal()
 
 void M_Input::ResetImGuiDrag()
 {
+#ifndef THOR_HEADLESS
 	//First update mouse position, otherwise in next frame mousePrev will
 	//not be the updated version
 	ImGui::GetIO().MousePos.x = mouse_x;
@@ -238,4 +259,5 @@ void M_Input::ResetImGuiDrag()
 	ImGui::GetCurrentContext()->ActiveIdIsJustActivated = true;
 
 	///It looks so simple when it's done :'(
+#endif
 }
@@ -10,7 +10,9 @@
 #include "M_Resources.h"
 #include "I_Materials.h"
 #include "M_Input.h"
+#ifndef THOR_HEADLESS
 #include "M_Editor.h"
+#endif
 
 #include "C_Camera.h"
 #include "C_Material.h"
@@ -21,7 +23,7 @@
 #include "R_Texture.h"
 #include "R_Shader.h"
 
-
+#ifndef THOR_HEADLESS
 #pragma comment (lib, "glu32.lib")    /* link OpenGL Utility lib     */
 #pragma comment (lib, "opengl32.lib") /* link Microsoft OpenGL lib   */
 #pragma comment (lib, "Glew/libx86/glew32.lib") /* link Microsoft OpenGL lib   */
@@ -29,12 +31,13 @@
 
 //TMP TESTING  TODO: what is this?
 
-#include "Devil\include\ilu.h"
-#include "Devil\include\ilut.h"
+#include "Devil/include/ilu.h"
+#include "Devil/include/ilut.h"
 
 #pragma comment( lib, "Devil/libx86/DevIL.lib" )
 #pragma comment( lib, "Devil/libx86/ILU.lib" )
 #pragma comment( lib, "Devil/libx86/ILUT.lib" )
+#endif
 
 
 
@@ -52,6 +55,10 @@ bool M_Renderer3D::Init(Config& config)
 	LOG("Creating 3D Renderer context");
 	bool ret = true;
 	
+#ifdef THOR_HEADLESS
+	//Null rendering backend: there is no context to create, all GL calls are no-ops
+	context = nullptr;
+#else
 	//Create context
 	context = SDL_GL_CreateContext(Engine->window->window);
 	if(context == nullptr)
@@ -67,12 +74,15 @@ bool M_Renderer3D::Init(Config& config)
 		LOG("Error initializing glew library! %s", SDL_GetError());
 		ret = false;
 	}
+#endif
 
 	if(ret == true)
 	{
+#ifndef THOR_HEADLESS
 		//Use Vsync
 		if(VSYNC && SDL_GL_SetSwapInterval(1) < 0)
 			LOG("Warning: Unable to set VSync! SDL Error: %s", SDL_GetError());
+#endif
 
 		//Initialize Projection Matrix
 		glMatrixMode(GL_PROJECTION);
@@ -88,8 +98,10 @@ bool M_Renderer3D::Init(Config& config)
 
 
 
+#ifdef _WIN32
 		int monitor_screen_width = GetSystemMetrics(SM_CXSCREEN);
 		int monitor_screen_height = GetSystemMetrics(SM_CYSCREEN);
+#endif
 		//Initialize Modelview Matrix
 		glMatrixMode(GL_MODELVIEW);
 		glLoadIdentity();
@@ -157,8 +169,16 @@ bool M_Renderer3D::Init(Config& config)
 
 bool M_Renderer3D::Start()
 {
-	hDefaultTexture.Set(Engine->moduleResources->FindResourceBase("Engine/Assets/Defaults/Default Texture.png")->ID);
-	hDefaultShader.Set(Engine->moduleResources->FindResourceBase("Engine/Assets/Shaders/Default Shader_PlainLight.shader")->ID);
+	//Projects without the engine default assets (e.g. generated ones) render with no default texture or shader
+	if (const ResourceBase* base = Engine->moduleResources->FindResourceBase("Engine/Assets/Defaults/Default Texture.png"))
+		hDefaultTexture.Set(base->ID);
+	else
+		LOG("[Warning] Default texture not found in Engine/Assets");
+
+	if (const ResourceBase* base = Engine->moduleResources->FindResourceBase("Engine/Assets/Shaders/Default Shader_PlainLight.shader"))
+		hDefaultShader.Set(base->ID);
+	else
+		LOG("[Warning] Default shader not found in Engine/Assets");
 
 	return true;
 }
@@ -190,15 +210,20 @@ update_status M_Renderer3D::PreUpdate()
 update_status M_Renderer3D::PostUpdate()
 {
 	DrawAllScene();
+#ifndef THOR_HEADLESS
 	Engine->moduleEditor->Draw();
 
 	SDL_GL_SwapWindow(Engine->window->window);
+#endif
 
 	return UPDATE_CONTINUE;
 }
 
 uint M_Renderer3D::SaveImage(const char* source_file)
 {
+#ifdef THOR_HEADLESS
+	return 0;
+#else
 	SDL_Surface* surface = SDL_GetWindowSurface(Engine->window->window);
 	//Enable surface pixel read-write
 	SDL_LockSurface(surface);
@@ -224,6 +249,7 @@ uint M_Renderer3D::SaveImage(const char* source_file)
 	//ilDeleteImages(1, &img);
 	
 	return 0;
+#endif
 
 }
 
@@ -258,7 +284,9 @@ bool M_Renderer3D::CleanUp()
 {
 	LOG("Destroying 3D Renderer");
 
+#ifndef THOR_HEADLESS
 	SDL_GL_DeleteContext(context);
+#endif
 
 	return true;
 }
@@ -384,6 +412,9 @@ void M_Renderer3D::DrawAllScene()
 		drawGrid = !drawGrid;
 	}
 
+	drawnMeshes = meshes.size();
+	drawnParticles = particles.size();
+
 	DrawAllMeshes();
 	DrawAllParticles();
 	DrawAllBox();
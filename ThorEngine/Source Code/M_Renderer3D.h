@@ -8,7 +8,7 @@
 #include "ResourceHandle.h"
 
 //TODO: this should be removed or changed by float4x4
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 #include <map>
 
 #define MAX_LIGHTS 8
@@ -140,6 +140,10 @@ public:
 
 	bool depthEnabled = true;
 
+	//Render list sizes of the last drawn frame
+	uint drawnMeshes = 0;
+	uint drawnParticles = 0;
+
 private:
 	ResourceHandle<R_Texture> hDefaultTexture;
 	ResourceHandle<R_Material> hDefaultMaterial;
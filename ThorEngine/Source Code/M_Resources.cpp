@@ -13,29 +13,122 @@
 
 #include "Resource.h"
 #include "ResourceHandle.h"
+#include "MemoryTracker.h"
 #include "R_Model.h"
 
 #include "M_FileSystem.h"
 #include "PathNode.h"
+#include "MappedFile.h"
+#include "LibraryPack.h"
+#include "ThreadPool.h"
+#include "PerfTimer.h"
+#include "Hash.h"
+#include "Compression.h"
+#include "IOService.h"
 
 #include "Config.h"
 
 #include "Assimp/include/scene.h"
 
-M_Resources::M_Resources(bool start_enabled) : Module("Resources", start_enabled)
+#include <algorithm>
+#include <limits.h>
+
+namespace MetaKeys
+{
+	//Attributes of .meta files, read for every asset the asset database does not have
+	const ConfigKey type("Type");
+	const ConfigKey ID("ID");
+	const ConfigKey name("Name");
+	const ConfigKey libraryFile("Library file");
+	const ConfigKey hash("Hash");
+	const ConfigKey containedResources("Contained Resources");
+	const ConfigKey dependencies("Dependencies");
+	const ConfigKey date("Date");
+	const ConfigKey importerVersion("Importer Version");
+	const ConfigKey importSettings("Import Settings");
+
+	//Contained resources have their own order: separate keys keep both slots
+	const ConfigKey containedType("Type");
+	const ConfigKey containedID("ID");
+	const ConfigKey containedName("Name");
+	const ConfigKey containedLibraryFile("Library file");
+}
+
+struct M_Resources::AsyncLoad
+{
+	uint64 ID = 0;
+	ResourceType type = ResourceType::UNKNOWN;
+	std::string libraryFile;	//Copied: the library can change while the file is read
+
+	Resource* resource = nullptr;
+	char* buffer = nullptr;
+	uint size = 0;
+	uint capacity = 0;			//Buffers read by the I/O service come from its pool
+	bool parsed = false;
+
+	const IORequest* request = nullptr;	//Only compared: deleted by the I/O service once read
+
+	bool read = false;			//Set by the loading thread, guarded by 'uploadMutex'
+	bool discarded = false;		//Unloaded or deleted before being published
+};
+
+struct M_Resources::ImportJob
 {
+	uint64 ID = 0;
+	ResourceType type = ResourceType::UNKNOWN;
+	std::string assetsFile;		//Copied: the library can change while the file is imported
+	std::string libraryFile;
+
+	//Registered assets whose file may have changed. Their resource is only replaced if the import is needed
+	bool registered = false;
+	bool importerChanged = false;
+	uint64 registeredHash = 0;
+	std::vector<uint64> containedIDs;
+
+	uint64 hash = 0;
+	bool upToDate = false;		//Same content and importer setup, the library file is still valid
+	bool cached = false;		//Library files copied from the import cache
+	std::vector<ResourceBase> cachedContained;
+
+	char* buffer = nullptr;		//Asset file content, only kept for the importers run in the main thread
+	uint size = 0;
+	const aiScene* scene = nullptr;
+	bool saved = false;			//Library file already written by the importing thread
+	std::vector<uint64> dependencies;	//Read by the importing thread for scenes, which are too slow to parse in the main thread
+};
 
+M_Resources::M_Resources(bool start_enabled) : Module("Resources", start_enabled)
+{
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+		compressLibraryFiles[i] = IsCompressedByDefault((ResourceType)i);
 }
 
 M_Resources::~M_Resources()
 {
-
+	RELEASE(assetsWatcher);
+	RELEASE(loadingThreads);
 }
 
 bool M_Resources::Init(Config& config)
 {
 	//ClearMetaData();
 	Importer::Textures::Init();
+	cache.Load(config.GetNode("Cache"));
+	importThreads = (uint)config.GetNumber("Import Threads", importThreads);
+	watchAssets = config.GetBool("Watch Assets", watchAssets);
+	prefetchDependencies = config.GetBool("Prefetch Dependencies", prefetchDependencies);
+	mapLibraryFiles = config.GetBool("Map Library Files", mapLibraryFiles);
+	textSceneAssets = config.GetBool("Text Scene Assets", textSceneAssets);
+
+	Config compressNode = config.GetNode("Compress Library Files");
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+		compressLibraryFiles[i] = compressNode.GetBool(MemoryTracker::GetTagName(MemoryTracker::GetResourceTag((ResourceType)i)), compressLibraryFiles[i]);
+
+	std::string cacheDir = Engine->fileSystem->GetUserDataDir();
+	if (!cacheDir.empty())
+		cacheDir.append("ImportCache");
+	importCache.SetDirectory(config.GetString("Import Cache", cacheDir.c_str()).c_str());
+	loadingThreads = new ThreadPool(std::min(std::thread::hardware_concurrency(), 4u));
 
 	return true;
 }
@@ -44,6 +137,14 @@ bool M_Resources::Start()
 {
 	LoadAllAssets();
 	updateAssets_timer.Start();
+
+	//Changes made during the scan are lost: the watcher only reports the ones made after it starts
+	if (watchAssets)
+	{
+		assetsWatcher = new FileWatcher();
+		if (assetsWatcher->Start("Assets") == false)
+			RELEASE(assetsWatcher);
+	}
 	saveChangedResources_timer.Stop();
 
 	return true;
@@ -51,17 +152,20 @@ bool M_Resources::Start()
 
 update_status M_Resources::Update()
 {
+	ProcessDeferredReleases();
+	ProcessUploadQueue(uploadBudgetMs);
+	ReleasePrefetchRequests();
+
+	//Evictions wait until the end of the frame: resources released and requested again in the same frame are reused
+	TrimCache();
+
 	//Little dirty trick to offset both updates
 	if (saveChangedResources_timer.IsRunning() == false && updateAssets_timer.ReadSec() > 2.5)
 	{
 		saveChangedResources_timer.Start();
 	}
 
-	if (updateAssets_timer.ReadSec() > 5)
-	{
-		//LoadAllAssets(); //TODO: Add to update in several frames
-		updateAssets_timer.Start();
-	}
+	ProcessAssetEvents(assetRefreshBudgetMs);
 
 	if (saveChangedResources_timer.ReadSec() > 5)
 	{
@@ -74,7 +178,32 @@ update_status M_Resources::Update()
 
 bool M_Resources::CleanUp()
 {
+	RELEASE(assetsWatcher);
+	assetEvents.clear();
+
+	//Pending loads are read before the threads stop, none of them gets published
+	Engine->fileSystem->FinishWrites();
+	RELEASE(loadingThreads);
+	for (uint i = 0; i < uploadQueue.size(); ++i)
+	{
+		if (uploadQueue[i]->size > 0 && uploadQueue[i]->parsed == false)
+			MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, uploadQueue[i]->size);
+		ReleaseAsyncBuffer(uploadQueue[i]);
+		RELEASE(uploadQueue[i]->resource);
+		RELEASE(uploadQueue[i]);
+	}
+	uploadQueue.clear();
+	asyncLoads.clear();
+	asyncRequests.clear();
+	prefetchRequests.clear();
+	deferredReleases.clear();
+
+	ClearCache();
 	SaveChangedResources();
+	Engine->fileSystem->FinishWrites();
+	SaveAssetDatabase();
+	registry.Clear();
+	FreeRetiredResources(true);
 	for (std::map<unsigned long long, Resource*>::iterator it = resources.begin(); it != resources.end(); )
 	{
 		it->second->FreeMemory();
@@ -85,76 +214,166 @@ bool M_Resources::CleanUp()
 	return true;
 }
 
+void M_Resources::SaveConfig(Config& config) const
+{
+	Config cacheNode = config.SetNode("Cache");
+	cache.Save(cacheNode);
+	config.SetNumber("Import Threads", importThreads);
+	config.SetString("Import Cache", importCache.GetDirectory().c_str());
+	config.SetBool("Watch Assets", watchAssets);
+	config.SetBool("Prefetch Dependencies", prefetchDependencies);
+	config.SetBool("Map Library Files", mapLibraryFiles);
+	config.SetBool("Text Scene Assets", textSceneAssets);
+
+	Config compressNode = config.SetNode("Compress Library Files");
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+		compressNode.SetBool(MemoryTracker::GetTagName(MemoryTracker::GetResourceTag((ResourceType)i)), compressLibraryFiles[i]);
+}
+
 void M_Resources::LoadAllAssets()
 {
 	std::vector<std::string> ignore_ext;
 	ignore_ext.push_back("meta");
 
+	//Every asset is registered first, new and modified files are imported once all of them are known
+	std::vector<ImportJob*> imports;
+
+	char* buffer = nullptr;
+	uint size = Engine->fileSystem->Load(ASSET_DATABASE_FILE, &buffer);
+	if (size > 0 && assetDatabase.Load(buffer, size) == false)
+		LOG("[Warning] Asset database is not valid, every .meta file will be read");
+	RELEASE_ARRAY(buffer);
+
 	uint64 folderID = 0;
 	PathNode engineAssets = Engine->fileSystem->GetAllFiles("Engine/Assets", nullptr, &ignore_ext);
-	LoadAssetBase(engineAssets, folderID);
+	LoadAssetBase(engineAssets, folderID, imports);
 	hEngineAssetsFolder.Set(folderID);
 
 	PathNode assets = Engine->fileSystem->GetAllFiles("Assets", nullptr, &ignore_ext);
-	LoadAssetBase(assets, folderID);
+	LoadAssetBase(assets, folderID, imports);
 	hAssetsFolder.Set(folderID);
+
+	RunImportJobs(imports);
+
+	assetDatabase.RemoveUnvisited();
+	SaveAssetDatabase();
 }
 
-bool M_Resources::LoadAssetBase(PathNode node, uint64& assetID) //TODO: Add modification date check!
+bool M_Resources::LoadMetaRecord(const char* assetsFile, AssetDatabase::Record& record)
 {
-	bool importedAsNew = false;
+	std::string metaFile = std::string(assetsFile) + ".meta";
 
-	//Load resource base from .meta file if it exists
-	std::string metaFile = node.path + ".meta";
-	if (Engine->fileSystem->Exists(metaFile.c_str()))
+	char* buffer = nullptr;
+	if (Engine->fileSystem->Load(metaFile.c_str(), &buffer) == 0)
+		return false;
+
+	Config metaData(buffer);
+
+	ResourceBase& base = record.base;
+	base = ResourceBase((ResourceType)(int)(metaData.GetNumber(MetaKeys::type)), assetsFile, metaData.GetString(MetaKeys::name).c_str(), metaData.GetNumber(MetaKeys::ID));
+	base.libraryFile = metaData.GetString(MetaKeys::libraryFile).c_str();
+	base.contentHash = Hash::FromString(metaData.GetString(MetaKeys::hash).c_str());
+	base.LoadDependencies(metaData);
+
+	//Add all contained resources saved in the meta file
+	Config_Array containedResources = metaData.GetArray(MetaKeys::containedResources);
+	for (uint i = 0; i < containedResources.GetSize(); ++i)
 	{
-		char* buffer = nullptr;
-		Engine->fileSystem->Load(metaFile.c_str(), &buffer);
-		Config metaData(buffer);
+		Config contained = containedResources.GetNode(i);
 
-		std::map<uint64, ResourceBase>::iterator it = resourceLibrary.find(metaData.GetNumber("ID"));
-		if (it != resourceLibrary.end()) //The resource is already loaded. Check modification date in case it needs re-importing
-		{
-			assetID = it->first;
+		//Adding the resource ID as a child
+		base.containedResources.push_back(contained.GetNumber(MetaKeys::containedID));
 
-			uint64 fileMod = Engine->fileSystem->GetLastModTime(node.path.c_str());
-			uint64 configDate = metaData.GetNumber("Date");
-			if (fileMod != configDate)
-				ImportFileFromAssets(node.path.c_str());
-		}
-		else //Load resource base from the .meta content
+		if (base.type != ResourceType::FOLDER) //Folders' contained resources will be loaded as normal files
 		{
-			ResourceBase base((ResourceType)(int)(metaData.GetNumber("Type")), node.path.c_str(), metaData.GetString("Name").c_str(), metaData.GetNumber("ID"));
-			base.libraryFile = metaData.GetString("Library file").c_str();
+			ResourceBase containedBase((ResourceType)(int)(contained.GetNumber(MetaKeys::containedType)), assetsFile, contained.GetString(MetaKeys::containedName).c_str(), contained.GetNumber(MetaKeys::containedID));
+			containedBase.libraryFile = contained.GetString(MetaKeys::containedLibraryFile).c_str();
+			containedBase.LoadDependencies(contained);
+			record.contained.push_back(containedBase);
+		}
+	}
 
-			//TODO: This should NOT be done for folders
-			//Add all contained resources saved in the meta file
-			Config_Array containedResources = metaData.GetArray("Contained Resources");
-			for (uint i = 0; i < containedResources.GetSize(); ++i)
-			{
-				Config contained = containedResources.GetNode(i);
+	//Models saved before dependencies were recorded: their nodes only reference the model's own resources
+	if (base.type == ResourceType::MODEL && base.dependencies.empty() && metaData.HasAttribute(MetaKeys::dependencies) == false)
+		SetDependencies(base, base.containedResources);
 
-				//Adding the resource ID as a child
-				base.containedResources.push_back(contained.GetNumber("ID"));
+	//.meta files saved before importer versions were recorded are taken as current
+	record.assetDate = metaData.GetNumber(MetaKeys::date);
+	record.importerVersion = (uint)metaData.GetNumber(MetaKeys::importerVersion, GetImporterVersion(base.type));
+	record.importSettings = Hash::FromString(metaData.GetString(MetaKeys::importSettings, Hash::ToString(GetImportSettingsHash(base.type)).c_str()).c_str());
 
-				if (base.type != ResourceType::FOLDER) //Folders' contained resources will be loaded as normal files
-				{
-					//Adding new library entry for the resource
-					ResourceBase containedBase((ResourceType)(int)(contained.GetNumber("Type")), base.assetsFile.c_str(), contained.GetString("Name").c_str(), contained.GetNumber("ID"));
-					containedBase.libraryFile = contained.GetString("Library file").c_str();
-					resourceLibrary[containedBase.ID] = containedBase;
-				}
+	RELEASE_ARRAY(buffer);
+	return true;
+}
 
+void M_Resources::SaveAssetDatabase()
+{
+	if (assetDatabase.IsDirty() == false)
+		return;
 
-			}
-			resourceLibrary[base.ID] = base;
-			assetID = base.ID;
-		}
+	char* buffer = nullptr;
+	uint size = assetDatabase.Save(&buffer);
+	if (size > 0)
+	{
+		Engine->fileSystem->Save(ASSET_DATABASE_FILE, buffer, size);
 		RELEASE_ARRAY(buffer);
 	}
-	else //Import resource as new
+	assetDatabase.ClearDirty();
+}
+
+bool M_Resources::LoadAssetBase(const PathNode& node, uint64& assetID, std::vector<ImportJob*>& imports)
+{
+	bool importedAsNew = false;
+
+	//Load resource base from the asset database, or from the .meta file if it changed since it was recorded
+	std::string metaFile = node.path + ".meta";
+	uint64 metaDate = Engine->fileSystem->GetScannedModTime(metaFile.c_str());
+	std::string databaseKey = NormalizePath(node.path.c_str());
+
+	const AssetDatabase::Record* record = nullptr;
+	if (metaDate != (uint64)-1)
+	{
+		record = assetDatabase.Find(databaseKey, metaDate);
+
+		AssetDatabase::Record metaRecord;
+		if (record == nullptr && LoadMetaRecord(node.path.c_str(), metaRecord))
+		{
+			metaRecord.metaDate = metaDate;
+			record = &assetDatabase.Set(databaseKey, metaRecord);
+		}
+	}
+
+	if (record != nullptr)
+	{
+		std::map<uint64, ResourceBase>::iterator it = resourceLibrary.find(record->base.ID);
+		if (it == resourceLibrary.end())
+		{
+			//Folders' contained resources will be loaded as normal files
+			for (uint i = 0; i < record->contained.size(); ++i)
+				AddResourceBase(record->contained[i]);
+			AddResourceBase(record->base);
+		}
+		assetID = record->base.ID;
+
+		//A different modification date only triggers a content check: the file is imported again if its hash changed
+		//Folders are not imported again, their content is updated below
+		if (node.isFile)
+		{
+			const ResourceBase& base = resourceLibrary[assetID];
+			bool importerChanged = record->importerVersion != GetImporterVersion(base.type) || record->importSettings != GetImportSettingsHash(base.type);
+			if (importerChanged || node.modTime != record->assetDate)
+				imports.push_back(CreateReimportJob(base, importerChanged));
+		}
+	}
+	else //Import resource as new. Folders are imported right away: their content is added below
 	{
-		assetID = ImportFileFromAssets(node.path.c_str());
+		if (node.isFile)
+		{
+			imports.push_back(CreateImportJob(node.path.c_str()));
+			assetID = imports.back()->ID;
+		}
+		else
+			assetID = ImportFileFromAssets(node.path.c_str());
 		importedAsNew = true;
 	}
 
@@ -165,7 +384,7 @@ bool M_Resources::LoadAssetBase(PathNode node, uint64& assetID) //TODO: Add modi
 		for (uint i = 0; i < node.children.size(); i++)
 		{
 			uint64 childID = 0;
-			if (LoadAssetBase(node.children[i], childID))
+			if (LoadAssetBase(node.children[i], childID, imports))
 			{
 				newChildren.push_back(childID);
 			}
@@ -193,40 +412,341 @@ void M_Resources::ImportFileFromExplorer(const char* path, const char* dstDir)
 
 uint64 M_Resources::ImportFileFromAssets(const char* path)
 {
-	ResourceType type = GetTypeFromFileExtension(path);
-	Resource* resource = CreateNewResource(path, type);
-	uint64 resourceID = resource->GetID();
+	ImportJob* job = CreateImportJob(path);
+	uint64 resourceID = job->ID;
 
-	char* buffer = nullptr;
-	uint64 fileSize = 0;
-	if (type != ResourceType::FOLDER)
-		fileSize = Engine->fileSystem->Load(path, &buffer);
-	
-	if (resource->isExternal) //TODO: Shaders should not be external, keeping it by now
+	PrepareImport(job);
+	FinishImport(job);
+
+	return resourceID;
+}
+
+M_Resources::ImportJob* M_Resources::CreateImportJob(const char* path)
+{
+	ImportJob* job = new ImportJob();
+	job->type = GetTypeFromFileExtension(path);
+
+	Resource* resource = CreateNewResource(path, job->type);
+	job->ID = resource->GetID();
+	job->assetsFile = resource->GetAssetsFile();
+	job->libraryFile = resource->GetLibraryFile();
+
+	return job;
+}
+
+M_Resources::ImportJob* M_Resources::CreateReimportJob(const ResourceBase& base, bool importerChanged)
+{
+	ImportJob* job = new ImportJob();
+	job->ID = base.ID;
+	job->type = base.type;
+	job->assetsFile = base.assetsFile;
+	job->libraryFile = base.libraryFile;
+
+	job->registered = true;
+	job->importerChanged = importerChanged;
+	job->registeredHash = base.contentHash;
+	job->containedIDs = base.containedResources;
+
+	return job;
+}
+
+void M_Resources::PrepareImport(ImportJob* job)
+{
+	if (job->type == ResourceType::FOLDER)
+		return;
+
+	job->size = Engine->fileSystem->Load(job->assetsFile.c_str(), &job->buffer);
+	MemoryTracker::OnAllocate(MemoryTracker::Tag::IMPORTER, job->size);
+	job->hash = Hash::Compute(job->buffer, job->size);
+
+	//.meta files saved before content hashes were recorded take the current one if their library file exists
+	bool sameContent = job->registeredHash == 0 || job->hash == job->registeredHash;
+	if (job->registered && !job->importerChanged && sameContent && Engine->fileSystem->Exists(job->libraryFile.c_str()))
+	{
+		job->upToDate = true;
+	}
+	else if (IsImportCached(job->type) && importCache.Fetch(GetImportKey(job->hash, job->type), job->ID, job->containedIDs, job->cachedContained))
+	{
+		job->cached = true;
+
+		//The import cache copies the library files itself
+		Engine->fileSystem->AddLooseLibraryFile(job->libraryFile.c_str());
+		for (uint i = 0; i < job->cachedContained.size(); ++i)
+			Engine->fileSystem->AddLooseLibraryFile(job->cachedContained[i].libraryFile.c_str());
+	}
+	else
 	{
-		switch (type)
+		switch (job->type)
 		{
-			case (ResourceType::TEXTURE):				Importer::Textures::Import(buffer, fileSize, (R_Texture*)resource); break;
-			case (ResourceType::MODEL):					ImportModel(buffer, fileSize, resource); break;
-			case (ResourceType::SHADER):				Importer::Shaders::Import(buffer, (R_Shader*)resource); break;
+			case (ResourceType::TEXTURE):
+			{
+				char* libraryBuffer = nullptr;
+				uint64 librarySize = Importer::Textures::Convert(job->buffer, job->size, &libraryBuffer);
+				if (librarySize > 0)
+				{
+					job->saved = SaveLibraryFile(job->libraryFile.c_str(), job->type, libraryBuffer, (uint)librarySize);
+					RELEASE_ARRAY(libraryBuffer);
+				}
+				break;
+			}
+			case (ResourceType::MODEL):		job->scene = Importer::Models::ProcessAssimpScene(job->buffer, job->size); break;
+			case (ResourceType::SHADER):	break; //Compiled from the file content in the main thread
+			case (ResourceType::SCENE):
+			{
+				//json scene assets are converted: the library always holds the binary format
+				if (Importer::Scenes::IsBinary(job->buffer, job->size))
+				{
+					job->saved = SaveLibraryFile(job->libraryFile.c_str(), job->type, job->buffer, job->size);
+					Importer::Scenes::GetDependencies(job->buffer, job->size, job->dependencies);
+				}
+				else
+				{
+					char* libraryBuffer = nullptr;
+					uint64 librarySize = Importer::Scenes::ConvertJSON(job->buffer, job->size, &libraryBuffer);
+					job->saved = SaveLibraryFile(job->libraryFile.c_str(), job->type, libraryBuffer, (uint)librarySize);
+					Importer::Scenes::GetDependencies(libraryBuffer, (uint)librarySize, job->dependencies);
+					RELEASE_ARRAY(libraryBuffer);
+				}
+				break;
+			}
+			default: //We skip import process as we only need to duplicate the file into library
+			{
+				job->saved = SaveLibraryFile(job->libraryFile.c_str(), job->type, job->buffer, job->size);
+				break;
+			}
 		}
-		SaveResource(resource);
 	}
-	else //We skip import process as we only need to duplicate the file into library
+
+	bool parsedInMainThread = job->type == ResourceType::SHADER || (job->saved && HasDependencies(job->type) && job->type != ResourceType::SCENE);
+	if (!parsedInMainThread || job->upToDate || job->cached)
+	{
+		RELEASE_ARRAY(job->buffer);
+		MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, job->size);
+	}
+}
+
+void M_Resources::FinishImport(ImportJob* job)
+{
+	if (job->upToDate) //Only the .meta date is outdated
+	{
+		ResourceBase& base = resourceLibrary[job->ID];
+		base.contentHash = job->hash;
+		SaveMetaInfo(base);
+		RELEASE(job);
+		return;
+	}
+
+	//Registered resources are replaced now that the import is needed. Their library file is overwritten
+	Resource* resource = job->registered ? CreateNewResource(job->assetsFile.c_str(), job->type) : resources[job->ID];
+	resource->baseData->contentHash = job->hash;
+
+	bool imported = false;
+	if (job->cached)
 	{
-		Engine->fileSystem->Save(resource->GetLibraryFile(), buffer, fileSize);
+		for (uint i = 0; i < job->cachedContained.size(); ++i)
+		{
+			job->cachedContained[i].assetsFile = job->assetsFile;
+			resource->AddContainedResource(AddResourceBase(job->cachedContained[i]).ID);
+		}
+
+		//Model nodes only reference the model's own meshes and materials
+		if (job->type == ResourceType::MODEL)
+			SetDependencies(*resource->baseData, resource->baseData->containedResources);
 		SaveMetaInfo(*resource->baseData);
-	}		
-	RELEASE_ARRAY(buffer);
-	UnloadResource(resource->GetID());
+	}
+	else
+	{
+		switch (job->type)
+		{
+			case (ResourceType::TEXTURE):
+			{
+				//Converted and saved by PrepareImport, the library file was written if the conversion succeeded
+				if (job->saved)
+					SaveMetaInfo(*resource->baseData);
+				imported = job->saved;
+				break;
+			}
+			case (ResourceType::MODEL):
+			{
+				if (job->scene != nullptr)
+				{
+					ImportModel(job->scene, resource);
+					Importer::Models::ReleaseAssimpScene(job->scene);
+					imported = true;
+				}
+				SaveResource(resource);
+				break;
+			}
+			case (ResourceType::SHADER): //TODO: Shaders should not be external, keeping it by now
+			{
+				Importer::Shaders::Import(job->buffer, (R_Shader*)resource);
+				SaveResource(resource);
+				break;
+			}
+			case (ResourceType::FOLDER):	SaveResource(resource); break;
+			default:
+			{
+				if (job->type == ResourceType::SCENE)
+				{
+					SetDependencies(*resource->baseData, job->dependencies);
+				}
+				else if (job->buffer != nullptr)
+				{
+					ParseResource(job->buffer, job->size, resource);
+					UpdateDependencies(resource);
+				}
+				SaveMetaInfo(*resource->baseData);
+				break;
+			}
+		}
+	}
 
-	return resourceID;
+	//New library output is shared with other projects
+	if (imported && IsImportCached(job->type) && importCache.IsEnabled())
+	{
+		std::vector<const ResourceBase*> contained;
+		for (uint i = 0; i < resource->baseData->containedResources.size(); ++i)
+		{
+			if (const ResourceBase* containedBase = GetResourceBase(resource->baseData->containedResources[i]))
+				contained.push_back(containedBase);
+		}
+		importCache.Store(GetImportKey(job->hash, job->type), *resource->baseData, contained);
+	}
+
+	if (job->buffer != nullptr)
+	{
+		RELEASE_ARRAY(job->buffer);
+		MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, job->size);
+	}
+	UnloadResource(job->ID);
+	RELEASE(job);
+}
+
+void M_Resources::RunImportJobs(std::vector<ImportJob*>& jobs)
+{
+	importProgress = ImportProgress();
+	importProgress.total = jobs.size();
+	if (jobs.empty())
+		return;
+
+	PerfTimer timer;
+	std::stable_sort(jobs.begin(), jobs.end(), [](const ImportJob* a, const ImportJob* b) { return GetImportPhase(a->type) < GetImportPhase(b->type); });
+
+	ThreadPool* threads = (importThreads != 1 && jobs.size() > 1) ? new ThreadPool(importThreads) : nullptr;
+	uint threadCount = threads ? threads->GetThreadCount() : 1;
+	uint logStep = std::max(1u, importProgress.total / 10);
+
+	uint first = 0;
+	while (first < jobs.size())
+	{
+		//Every job in a phase is finished before the next phase starts
+		int phase = GetImportPhase(jobs[first]->type);
+		uint last = first;
+		while (last < jobs.size() && GetImportPhase(jobs[last]->type) == phase)
+			++last;
+
+		if (threads != nullptr)
+		{
+			for (uint i = first; i < last; ++i)
+			{
+				ImportJob* job = jobs[i];
+				threads->Submit([this, job]
+				{
+					PrepareImport(job);
+					{
+						std::lock_guard<std::mutex> lock(importMutex);
+						importQueue.push_back(job);
+					}
+					importReady.notify_one();
+				});
+			}
+		}
+
+		for (uint i = first; i < last; ++i)
+		{
+			ImportJob* job = jobs[i];
+			if (threads != nullptr) //Finished in completion order
+			{
+				std::unique_lock<std::mutex> lock(importMutex);
+				importReady.wait(lock, [this] { return !importQueue.empty(); });
+				job = importQueue.front();
+				importQueue.pop_front();
+			}
+			else
+			{
+				PrepareImport(job);
+			}
+
+			importProgress.current = job->assetsFile;
+			importProgress.unchanged += job->upToDate ? 1 : 0;
+			importProgress.cached += job->cached ? 1 : 0;
+			FinishImport(job);
+
+			importProgress.done++;
+			importProgress.elapsedMs = timer.ReadMs();
+			if (importProgress.done % logStep == 0 || importProgress.done == importProgress.total)
+				LOG("Importing assets: %u/%u", importProgress.done, importProgress.total);
+		}
+		first = last;
+	}
+
+	RELEASE(threads);
+	jobs.clear();
+	LOG("Imported %u assets in %.1f ms using %u threads: %u unchanged, %u from the import cache", importProgress.total, importProgress.elapsedMs, threadCount, importProgress.unchanged, importProgress.cached);
+}
+
+int M_Resources::GetImportPhase(ResourceType type)
+{
+	//Model materials import the textures they reference if they are not registered yet
+	return type == ResourceType::MODEL ? 1 : 0;
+}
+
+uint M_Resources::GetImporterVersion(ResourceType type)
+{
+	//Bump the version of an importer whenever its library output changes: every asset of the type is imported again
+	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
+	switch (type)
+	{
+		case ResourceType::MODEL:		return 1;
+		case ResourceType::TEXTURE:		return 1;
+		case ResourceType::SHADER:		return 1;
+		case ResourceType::SCENE:		return 3; //3: Binary library files
+		default:						return 2; //2: Dependencies recorded in the .meta
+	}
+}
+
+uint64 M_Resources::GetImportSettingsHash(ResourceType type)
+{
+	//Settings applied by the importers. Keep in sync with Importer::Models::ProcessAssimpScene and Importer::Textures::Save
+	switch (type)
+	{
+		case ResourceType::MODEL:		return Hash::Compute(std::string("aiProcessPreset_TargetRealtime_MaxQuality"));
+		case ResourceType::TEXTURE:		return Hash::Compute(std::string("DDS DXT5"));
+		default:						return 0;
+	}
+}
+
+uint64 M_Resources::GetImportKey(uint64 contentHash, ResourceType type)
+{
+	uint64 key = Hash::Combine(contentHash, (uint64)type);
+	key = Hash::Combine(key, GetImporterVersion(type));
+	return Hash::Combine(key, GetImportSettingsHash(type));
+}
+
+bool M_Resources::IsImportCached(ResourceType type)
+{
+	//Other assets are copied to library as they are: the cache would only add another copy
+	return type == ResourceType::MODEL || type == ResourceType::TEXTURE;
+}
+
+bool M_Resources::HasDependencies(ResourceType type)
+{
+	return type == ResourceType::SCENE || type == ResourceType::MATERIAL || type == ResourceType::ANIMATOR_CONTROLLER || type == ResourceType::PARTICLESYSTEM;
 }
 
-void M_Resources::ImportModel(const char* buffer, uint size, Resource* model)
+void M_Resources::ImportModel(const aiScene* scene, Resource* model)
 {
 	R_Model* rModel = (R_Model*)model;
-	const aiScene* scene = Importer::Models::ProcessAssimpScene(buffer, size);
 	Importer::Models::Import(scene, rModel);
 	std::vector<uint64> meshes, materials, animations;
 
@@ -245,7 +765,9 @@ void M_Resources::ImportModel(const char* buffer, uint size, Resource* model)
 	for (uint i = 0; i < scene->mNumMaterials; ++i)
 	{
 		aiString matName;
+#ifndef THOR_HEADLESS
 		scene->mMaterials[i]->Get(AI_MATKEY_NAME, matName);
+#endif
 		materials.push_back(ImportResourceFromModel(model->GetAssetsFile(), scene->mMaterials[i], matName.C_Str(), ResourceType::MATERIAL));
 		model->AddContainedResource(materials.back());
 	}
@@ -306,11 +828,14 @@ Resource* M_Resources::CreateNewResource(const char* assetsPath, ResourceType ty
 		if (type == ResourceType::TEXTURE) base.name.append(".").append(extension);
 	}
 
-	uint oldInstances = 0;
+	//An existing resource keeps its ID. Its library file is kept: the new content overwrites it
 	if (const ResourceBase* oldBase = FindResourceBase(base.assetsFile.c_str(), base.name.c_str(), base.type))
 	{
 		base.ID = oldBase->ID;
-		oldInstances = DeleteResource(oldBase->ID, false);
+		if (RetireResource(base.ID))
+			LOG("[Warning] Asset '%s' was reimported while in use, its users keep the previous version", oldBase->assetsFile.c_str());
+		UnloadResource(base.ID);
+		RemoveResourceBase(base.ID);
 	}
 
 	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
@@ -328,10 +853,10 @@ Resource* M_Resources::CreateNewResource(const char* assetsPath, ResourceType ty
 		case ResourceType::SCENE:				base.libraryFile = SCENES_PATH;	break;
 	}
 	base.libraryFile.append(std::to_string(base.ID));
-	resourceLibrary[base.ID] = base;
 
-	Resource* newResource = CreateResourceFromBase(resourceLibrary[base.ID]);
-	newResource->instances = oldInstances;
+	Resource* newResource = CreateResourceFromBase(AddResourceBase(base));
+	resources[base.ID] = newResource;
+	registry.Add(newResource);
 
 	return 	newResource;
 }
@@ -356,7 +881,7 @@ Resource* M_Resources::CreateResourceFromBase(ResourceBase& base)
 	}
 
 	resource->baseData = &base;
-	return resources[base.ID] = resource;
+	return resource;
 }
 
 uint64 M_Resources::CreateNewCopyResource(const char* srcFile, const char* dstDir)
@@ -382,45 +907,52 @@ uint64 M_Resources::CreateNewCopyResource(const char* srcFile, const char* dstDi
 
 Resource* M_Resources::RequestResource(uint64 ID)
 {
+	if (Engine->IsMainThread() == false)
+		return registry.Acquire(ID);
+
 	Resource* resource = nullptr;
 
 	//First find if the wanted resource is loaded
 	std::map<uint64, Resource*>::iterator resourcesIt = resources.find(ID);
 	if (resourcesIt != resources.end())
 	{
+		if (cache.Remove(resourcesIt->second))
+			cache.RecordHit(resourcesIt->second->GetType());
 		resourcesIt->second->instances++;
 		return resourcesIt->second;
 	}
 
+	//A resource being loaded asynchronously is finished now instead of being loaded twice
+	std::map<uint64, AsyncLoad*>::iterator asyncIt = asyncLoads.find(ID);
+	if (asyncIt != asyncLoads.end())
+	{
+		AsyncLoad* load = asyncIt->second;
+		WaitAsyncLoad(load);
+		resource = FinishAsyncLoad(load);
+		if (resource != nullptr)
+			resource->instances++;
+		return resource;
+	}
+
 	//If the resource is not loaded, search in the library and load it
 	std::map<uint64, ResourceBase>::iterator libraryIt = resourceLibrary.find(ID);
 	if (libraryIt != resourceLibrary.end())
 	{
+		//Dependencies are read in parallel while the resource is loaded, instead of one by one as they are first used
+		if (prefetchDependencies && (libraryIt->second.type == ResourceType::SCENE || libraryIt->second.type == ResourceType::MODEL))
+			PrefetchDependencies(ID);
+
 		resource = CreateResourceFromBase(libraryIt->second);
-		char* buffer = nullptr;
-		uint size = Engine->fileSystem->Load(resource->GetLibraryFile(), &buffer);
-		if (size == 0)
+		if (LoadResourceData(resource) == false)
 		{
 			//TODO: A resource does not have a valid library file, needs re-import
+			LOG("[Warning] Could not load resource '%s': missing library file", resource->GetName());
+			failedLoads.insert(ID);
 			RELEASE(resource);
 			return nullptr;
 		}
 
-		switch (resource->GetType())
-		{
-			case (ResourceType::FOLDER):				{ Importer::Folders::Load(buffer, (R_Folder*)resource); break; }
-			case (ResourceType::MESH):					{ Importer::Meshes::Load(buffer, (R_Mesh*)resource); break; }
-			case (ResourceType::TEXTURE):				{ Importer::Textures::Load(buffer, size, (R_Texture*)resource); break; }
-			case (ResourceType::MATERIAL):				{ Importer::Materials::Load(buffer, size, (R_Material*)resource); break; }
-			case (ResourceType::MODEL):					{ Importer::Models::Load(buffer, (R_Model*)resource); break; }
-			case (ResourceType::ANIMATION):				{ Importer::Animations::Load(buffer, (R_Animation*)resource); break; }
-			case (ResourceType::ANIMATOR_CONTROLLER):	{ Importer::Animators::Load(buffer, (R_AnimatorController*)resource); break; }
-			case (ResourceType::PARTICLESYSTEM):		{ Importer::Particles::Load(buffer, size, (R_ParticleSystem*)resource); break; }
-			case (ResourceType::SHADER):				{ Importer::Shaders::Load(buffer, size, (R_Shader*)resource); break; }
-			case (ResourceType::SCENE):					{ Importer::Scenes::Load(buffer, (R_Scene*)resource); break; }
-		}
-		RELEASE_ARRAY(buffer);
-		resource->LoadOnMemory();
+		PublishResource(resource);
 		resource->instances++;
 	}
 
@@ -429,83 +961,624 @@ Resource* M_Resources::RequestResource(uint64 ID)
 
 void M_Resources::ReleaseResource(Resource* resource)
 {
-	resource->instances--;
-	if (resource->instances <= 0)
+	//Outside the main thread the resource can be unloaded as soon as the instance is released: it is not touched after that
+	uint64 ID = resource->GetID();
+	if (--resource->instances > 0)
+		return;
+
+	if (Engine->IsMainThread() == false)
 	{
-		UnloadResource(resource->GetID());
+		std::lock_guard<std::mutex> lock(deferredMutex);
+		deferredReleases.push_back({ ID, false });
+		return;
 	}
-}
 
-const ResourceBase* M_Resources::FindResourceBase(const char* path, const char* name, ResourceType type) const
-{
-	//TODO: Search process should start at Root Folder and iterate down the path
-	//		It will make it much faster than comparing all strings
-	std::map<uint64, ResourceBase>::const_iterator it;
-	for (it = resourceLibrary.begin(); it != resourceLibrary.end(); ++it)
+	if (asyncRequests.find(ID) == asyncRequests.end())
 	{
-		if (it->second.Compare(path, name, type))
-			return &it->second;
+		OnResourceUnused(resource);
 	}
-	return nullptr;
 }
 
-const ResourceBase* M_Resources::GetResourceBase(uint64 ID) const
+ResourceLoadState M_Resources::RequestResourceAsync(uint64 ID)
 {
-	std::map<uint64, ResourceBase>::const_iterator it = resourceLibrary.find(ID);
-	if (it != resourceLibrary.end())
-	{
-		return &it->second;
-	}
-	return nullptr;
+	if (Engine->IsMainThread() == false)
+		return ResourceLoadState::FAILED;
+
+	ResourceLoadState ret = StartAsyncLoad(ID, IOPriority::NORMAL);
+	SubmitQueuedReads();
+	return ret;
 }
 
-bool M_Resources::GetAllMetaFromType(ResourceType type, std::vector<const ResourceBase*>& metas) const
+ResourceLoadState M_Resources::StartAsyncLoad(uint64 ID, IOPriority priority)
 {
-	std::map<uint64, ResourceBase>::const_iterator it;
-	for (it = resourceLibrary.begin(); it != resourceLibrary.end(); ++it)
+	ResourceLoadState state = GetLoadState(ID);
+	if (state == ResourceLoadState::READY || state == ResourceLoadState::LOADING)
 	{
-		if ((*it).second.type == type)
-			metas.push_back(&(*it).second);
+		//The request keeps the resource loaded, it is no longer cached
+		if (state == ResourceLoadState::READY && cache.Remove(resources[ID]))
+			cache.RecordHit(resources[ID]->GetType());
+
+		asyncRequests[ID]++;
+		return state;
 	}
-	return metas.size() > 0;
-}
 
-void M_Resources::SaveResource(Resource* resource, bool saveMeta)
-{
-	char* buffer = nullptr;
-	uint size = 0;
+	std::map<uint64, ResourceBase>::iterator libraryIt = resourceLibrary.find(ID);
+	if (state == ResourceLoadState::FAILED || libraryIt == resourceLibrary.end())
+		return ResourceLoadState::FAILED;
 
-	switch (resource->GetType())
+	AsyncLoad* load = new AsyncLoad();
+	load->ID = ID;
+	load->type = libraryIt->second.type;
+	load->libraryFile = libraryIt->second.libraryFile;
+	load->resource = CreateResourceFromBase(libraryIt->second);
+
+	asyncLoads[ID] = load;
+	asyncRequests[ID]++;
+
+	//Mapped files are read when their pages are touched: nothing to queue
+	if (mapLibraryFiles && CanMapLibraryFile(load->type))
 	{
-		case(ResourceType::FOLDER): { size = Importer::Folders::Save((R_Folder*)resource, &buffer); break; }
-		case(ResourceType::MESH): { size = Importer::Meshes::Save((R_Mesh*)resource, &buffer); break; }
-		case(ResourceType::TEXTURE): { size = Importer::Textures::Save((R_Texture*)resource, &buffer); break; }
-		case(ResourceType::MATERIAL): { size = Importer::Materials::Save((R_Material*)resource, &buffer); break; }
-		case(ResourceType::ANIMATION): { size = Importer::Animations::Save((R_Animation*)resource, &buffer); break;	}
-		case(ResourceType::ANIMATOR_CONTROLLER): { size = Importer::Animators::Save((R_AnimatorController*)resource, &buffer);	break; }
-		case(ResourceType::MODEL): { size = Importer::Models::Save((R_Model*)resource, &buffer); break; }
-		case(ResourceType::PARTICLESYSTEM): { size = Importer::Particles::Save((R_ParticleSystem*)resource, &buffer); break; }
-		case(ResourceType::SHADER): { size = Importer::Shaders::Save((R_Shader*)resource, &buffer); break; }
-		case(ResourceType::SCENE): { size = Importer::Scenes::Save((R_Scene*)resource, &buffer); break; }
+		loadingThreads->Submit([this, load]() { ReadAsyncLoad(load); });
 	}
-
-	if (size > 0)
+	else
 	{
-		Engine->fileSystem->Save(resource->GetLibraryFile(), buffer, size);
+		IORequest* request = new IORequest();
+		request->priority = priority;
+		request->file = load->libraryFile;
+		request->completeOnMainThread = false;
+		request->onComplete = [this, load](IORequest& read)
+		{
+			load->buffer = read.buffer;
+			load->size = read.size;
+			load->capacity = read.capacity;
+			read.buffer = nullptr;
+			loadingThreads->Submit([this, load]() { ParseAsyncLoad(load); });
+		};
+		load->request = request;
+		queuedReads.push_back(request);
+	}
 
-		if (!resource->isExternal)
-			Engine->fileSystem->Save(resource->GetAssetsFile(), buffer, size); 
-		if (saveMeta) //Model internal resources should not override meta content
-			SaveMetaInfo(*resource->baseData);
+	if (prefetchDependencies && (load->type == ResourceType::SCENE || load->type == ResourceType::MODEL))
+		PrefetchDependencies(ID);
 
-		RELEASE_ARRAY(buffer);
-	}
+	return ResourceLoadState::LOADING;
 }
 
-uint64 M_Resources::SaveResourceAs(Resource* resource, const char* directory, const char* fileName)
+void M_Resources::ReleaseAsyncRequest(uint64 ID)
 {
-	//TODO:   SaveResourceAs would override any existing resource with that name, and not remove its library content.
-
+	if (Engine->IsMainThread() == false)
+	{
+		std::lock_guard<std::mutex> lock(deferredMutex);
+		deferredReleases.push_back({ ID, true });
+		return;
+	}
+
+	std::map<uint64, uint>::iterator it = asyncRequests.find(ID);
+	if (it == asyncRequests.end())
+		return;
+
+	if (--it->second > 0)
+		return;
+	asyncRequests.erase(it);
+
+	//Loads still in progress are dropped when they reach the upload queue
+	std::map<uint64, Resource*>::iterator resourcesIt = resources.find(ID);
+	if (resourcesIt != resources.end() && resourcesIt->second->instances <= 0)
+		OnResourceUnused(resourcesIt->second);
+}
+
+ResourceLoadState M_Resources::GetLoadState(uint64 ID) const
+{
+	if (Engine->IsMainThread() == false)
+		return registry.Contains(ID) ? ResourceLoadState::READY : ResourceLoadState::UNLOADED;
+
+	if (resources.find(ID) != resources.end())
+		return ResourceLoadState::READY;
+	if (asyncLoads.find(ID) != asyncLoads.end())
+		return ResourceLoadState::LOADING;
+	if (failedLoads.find(ID) != failedLoads.end())
+		return ResourceLoadState::FAILED;
+	return ResourceLoadState::UNLOADED;
+}
+
+void M_Resources::PrefetchDependencies(uint64 ID)
+{
+	std::vector<uint64> closure;
+	GetDependencies(ID, closure);
+
+	for (uint i = 0; i < closure.size(); ++i)
+	{
+		//Loaded resources only need to be taken out of the cache when they are used
+		if (GetLoadState(closure[i]) != ResourceLoadState::UNLOADED)
+			continue;
+
+		if (StartAsyncLoad(closure[i], IOPriority::PREFETCH) == ResourceLoadState::LOADING)
+			prefetchRequests.push_back(closure[i]);
+	}
+	SubmitQueuedReads();
+}
+
+void M_Resources::SubmitQueuedReads()
+{
+	//The whole closure of a scene goes in a single batch
+	Engine->fileSystem->GetIO()->Submit(queuedReads);
+	queuedReads.clear();
+}
+
+void M_Resources::ReleasePrefetchRequests()
+{
+	for (uint i = 0; i < prefetchRequests.size(); )
+	{
+		if (GetLoadState(prefetchRequests[i]) == ResourceLoadState::LOADING)
+		{
+			++i;
+			continue;
+		}
+		ReleaseAsyncRequest(prefetchRequests[i]);
+		prefetchRequests[i] = prefetchRequests.back();
+		prefetchRequests.pop_back();
+	}
+}
+
+void M_Resources::FinishAsyncLoads()
+{
+	//Finished reads queue their parsing in the loading threads
+	Engine->fileSystem->FinishWrites();
+	loadingThreads->Wait();
+	ProcessUploadQueue(-1.0);
+}
+
+bool M_Resources::CookLibrary(bool removeLooseFiles)
+{
+	//Loads read from the pack being replaced
+	FinishAsyncLoads();
+
+	std::vector<M_FileSystem::PackedFile> files;
+	for (std::map<uint64, ResourceBase>::const_iterator it = resourceLibrary.begin(); it != resourceLibrary.end(); ++it)
+	{
+		if (it->second.libraryFile.empty() || Engine->fileSystem->Exists(it->second.libraryFile.c_str()) == false)
+			continue;
+
+		M_FileSystem::PackedFile file;
+		file.file = it->second.libraryFile;
+		file.alignment = CanMapLibraryFile(it->second.type) ? LibraryPack::pageAlignment : 16;
+		files.push_back(file);
+	}
+
+	PerfTimer timer;
+	bool ret = Engine->fileSystem->CookLibraryPack(files, removeLooseFiles);
+	if (ret)
+		LOG("Cooked %u library files in %.1f ms", (uint)files.size(), timer.ReadMs());
+	return ret;
+}
+
+bool M_Resources::LoadResourceData(Resource* resource)
+{
+	if (mapLibraryFiles && CanMapLibraryFile(resource->GetType()) && LoadMappedData(resource->GetLibraryFile(), resource) > 0)
+		return true;
+
+	char* buffer = nullptr;
+	uint size = LoadLibraryFile(resource->GetLibraryFile(), &buffer);
+	if (size == 0)
+		return false;
+
+	MemoryTracker::OnAllocate(MemoryTracker::Tag::IMPORTER, size);
+	ParseResource(buffer, size, resource);
+	RELEASE_ARRAY(buffer);
+	MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, size);
+
+	return true;
+}
+
+void M_Resources::ParseResource(const char* buffer, uint size, Resource* resource)
+{
+	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
+	switch (resource->GetType())
+	{
+		case (ResourceType::FOLDER):				{ Importer::Folders::Load(buffer, (R_Folder*)resource); break; }
+		case (ResourceType::MESH):					{ Importer::Meshes::Load(buffer, (R_Mesh*)resource); break; }
+		case (ResourceType::TEXTURE):				{ Importer::Textures::Load(buffer, size, (R_Texture*)resource); break; }
+		case (ResourceType::MATERIAL):				{ Importer::Materials::Load(buffer, size, (R_Material*)resource); break; }
+		case (ResourceType::MODEL):					{ Importer::Models::Load(buffer, size, (R_Model*)resource); break; }
+		case (ResourceType::ANIMATION):				{ Importer::Animations::Load(buffer, (R_Animation*)resource); break; }
+		case (ResourceType::ANIMATOR_CONTROLLER):	{ Importer::Animators::Load(buffer, (R_AnimatorController*)resource); break; }
+		case (ResourceType::PARTICLESYSTEM):		{ Importer::Particles::Load(buffer, size, (R_ParticleSystem*)resource); break; }
+		case (ResourceType::SHADER):				{ Importer::Shaders::Load(buffer, size, (R_Shader*)resource); break; }
+		case (ResourceType::SCENE):					{ Importer::Scenes::Load(buffer, size, (R_Scene*)resource); break; }
+		default:
+		{
+			LOG("[error] Resource type %i of '%s' can not be parsed", (int)resource->GetType(), resource->GetName());
+			return;
+		}
+	}
+}
+
+uint M_Resources::LoadMappedData(const char* libraryFile, Resource* resource) const
+{
+	MappedFile* file = Engine->fileSystem->Map(libraryFile);
+	if (file == nullptr)
+		return 0;
+
+	uint size = (uint)file->GetSize();
+	if (Compression::IsBlob(file->GetData(), size))
+	{
+		//Decoded straight from the mapping, the file is never copied
+		char* buffer = nullptr;
+		size = DecompressLibraryFile(libraryFile, file->GetData(), file->GetSize(), &buffer);
+		RELEASE(file);
+		if (size > 0)
+		{
+			MemoryTracker::OnAllocate(MemoryTracker::Tag::IMPORTER, size);
+			ParseResource(buffer, size, resource);
+			RELEASE_ARRAY(buffer);
+			MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, size);
+		}
+	}
+	else if (resource->GetType() == ResourceType::MESH)
+	{
+		//The mesh keeps the mapping
+		Importer::Meshes::Load(file, (R_Mesh*)resource);
+	}
+	else
+	{
+		//Animation keys are stored in maps, they are built from the mapped file without reading it into a buffer first
+		ParseResource(file->GetData(), size, resource);
+		RELEASE(file);
+	}
+	return size;
+}
+
+bool M_Resources::CanMapLibraryFile(ResourceType type)
+{
+	return type == ResourceType::MESH || type == ResourceType::ANIMATION;
+}
+
+uint M_Resources::LoadLibraryFile(const char* file, char** buffer) const
+{
+	uint size = Engine->fileSystem->Load(file, buffer);
+	if (size == 0 || Compression::IsBlob(*buffer, size) == false)
+		return size;
+
+	char* compressed = *buffer;
+	size = DecompressLibraryFile(file, compressed, size, buffer);
+	RELEASE_ARRAY(compressed);
+	return size;
+}
+
+bool M_Resources::SaveLibraryFile(const char* file, ResourceType type, const char* buffer, uint size) const
+{
+	char* compressed = nullptr;
+	uint compressedSize = 0;
+	if ((int)type >= 0 && type < ResourceType::UNKNOWN && compressLibraryFiles[(int)type])
+		compressedSize = (uint)Compression::CompressBlob(buffer, size, &compressed);
+
+	//Data that does not get smaller is saved as it is
+	bool ret = compressedSize > 0 ? Engine->fileSystem->Save(file, compressed, compressedSize) > 0 : Engine->fileSystem->Save(file, buffer, size) > 0;
+	RELEASE_ARRAY(compressed);
+	return ret;
+}
+
+uint M_Resources::DecompressLibraryFile(const char* file, const char* data, uint64 size, char** buffer)
+{
+	*buffer = nullptr;
+	uint64 rawSize = Compression::GetBlobRawSize(data, size);
+	if (rawSize == 0 || rawSize >= UINT_MAX)
+	{
+		LOG("[error] Library file '%s' is damaged", file);
+		return 0;
+	}
+
+	//Null terminated like M_FileSystem::Load buffers: some library files are parsed as text
+	*buffer = new char[rawSize + 1];
+	(*buffer)[rawSize] = '\0';
+	if (Compression::DecompressBlob(data, size, *buffer) == false)
+	{
+		LOG("[error] Library file '%s' is damaged", file);
+		RELEASE_ARRAY(*buffer);
+		return 0;
+	}
+	return (uint)rawSize;
+}
+
+bool M_Resources::IsCompressedByDefault(ResourceType type)
+{
+	//Animations repeat a lot, scenes and models are text. Meshes are left raw so they can be mapped
+	//and textures are already block compressed
+	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
+	return type == ResourceType::ANIMATION || type == ResourceType::SCENE || type == ResourceType::MODEL;
+}
+
+void M_Resources::PublishResource(Resource* resource)
+{
+	cache.RecordMiss(resource->GetType());
+	resource->LoadOnMemory();
+	resource->UpdateMemoryUsage();
+	resources[resource->GetID()] = resource;
+	registry.Add(resource);
+}
+
+void M_Resources::ReadAsyncLoad(AsyncLoad* load)
+{
+	if (mapLibraryFiles && CanMapLibraryFile(load->type))
+	{
+		load->size = LoadMappedData(load->libraryFile.c_str(), load->resource);
+		load->parsed = load->size > 0;
+	}
+
+	if (load->parsed == false)
+		load->size = LoadLibraryFile(load->libraryFile.c_str(), &load->buffer);
+
+	ParseAsyncLoad(load);
+}
+
+void M_Resources::ParseAsyncLoad(AsyncLoad* load)
+{
+	if (load->size > 0 && load->parsed == false && Compression::IsBlob(load->buffer, load->size))
+	{
+		char* compressed = load->buffer;
+		uint capacity = load->capacity;
+		load->size = DecompressLibraryFile(load->libraryFile.c_str(), compressed, load->size, &load->buffer);
+		load->capacity = 0;
+		Engine->fileSystem->GetIO()->ReleaseBuffer(compressed, capacity);
+	}
+
+	if (load->size > 0 && load->parsed == false)
+	{
+		MemoryTracker::OnAllocate(MemoryTracker::Tag::IMPORTER, load->size);
+		if (CanParseOnLoadingThread(load->type))
+		{
+			ParseResource(load->buffer, load->size, load->resource);
+			ReleaseAsyncBuffer(load);
+			MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, load->size);
+			load->parsed = true;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(uploadMutex);
+		load->read = true;
+		uploadQueue.push_back(load);
+	}
+	uploadReady.notify_all();
+}
+
+bool M_Resources::CanParseOnLoadingThread(ResourceType type)
+{
+	//Textures and shaders create GL objects while parsing. Models, scenes, particle systems
+	//and animator controllers create GameObjects or request other resources
+	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
+	return type == ResourceType::FOLDER || type == ResourceType::MESH || type == ResourceType::MATERIAL || type == ResourceType::ANIMATION;
+}
+
+void M_Resources::ProcessUploadQueue(double budgetMs)
+{
+	PerfTimer timer;
+	while (true)
+	{
+		AsyncLoad* load = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(uploadMutex);
+			if (uploadQueue.empty())
+				break;
+			load = uploadQueue.front();
+			uploadQueue.pop_front();
+		}
+
+		//Every request was released while the file was being read
+		if (load->discarded == false && asyncRequests.find(load->ID) == asyncRequests.end())
+			UnloadResource(load->ID);
+
+		FinishAsyncLoad(load);
+
+		if (budgetMs >= 0.0 && timer.ReadMs() > budgetMs)
+			break;
+	}
+}
+
+void M_Resources::WaitAsyncLoad(AsyncLoad* load)
+{
+	//A prefetched file needed now is read before the rest of the prefetch
+	if (load->request != nullptr)
+		Engine->fileSystem->GetIO()->Promote(load->request, IOPriority::HIGH);
+
+	std::unique_lock<std::mutex> lock(uploadMutex);
+	uploadReady.wait(lock, [load] { return load->read; });
+	uploadQueue.erase(std::find(uploadQueue.begin(), uploadQueue.end(), load));
+}
+
+Resource* M_Resources::FinishAsyncLoad(AsyncLoad* load)
+{
+	Resource* resource = nullptr;
+	if (load->discarded == false)
+	{
+		asyncLoads.erase(load->ID);
+
+		if (load->size == 0)
+		{
+			LOG("[Warning] Could not load resource '%s': missing library file", load->resource->GetName());
+			failedLoads.insert(load->ID);
+		}
+		else
+		{
+			if (load->parsed == false)
+			{
+				ParseResource(load->buffer, load->size, load->resource);
+				ReleaseAsyncBuffer(load);
+				MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, load->size);
+			}
+
+			resource = load->resource;
+			load->resource = nullptr;
+			PublishResource(resource);
+		}
+	}
+	else if (load->size > 0 && load->parsed == false)
+	{
+		MemoryTracker::OnFree(MemoryTracker::Tag::IMPORTER, load->size);
+	}
+
+	ReleaseAsyncBuffer(load);
+	RELEASE(load->resource);
+	RELEASE(load);
+	return resource;
+}
+
+void M_Resources::ReleaseAsyncBuffer(AsyncLoad* load)
+{
+	Engine->fileSystem->GetIO()->ReleaseBuffer(load->buffer, load->capacity);
+	load->buffer = nullptr;
+	load->capacity = 0;
+}
+
+const ResourceBase* M_Resources::FindResourceBase(const char* path, const char* name, ResourceType type) const
+{
+	std::unordered_map<std::string, std::vector<ResourceBase*>>::const_iterator it = pathIndex.find(NormalizePath(path));
+	if (it == pathIndex.end())
+		return nullptr;
+
+	//Only an asset and its contained resources share a path, in ID order as the library
+	for (uint i = 0; i < it->second.size(); ++i)
+	{
+		if (it->second[i]->Matches(name, type))
+			return it->second[i];
+	}
+	return nullptr;
+}
+
+const ResourceBase* M_Resources::GetResourceBase(uint64 ID) const
+{
+	std::map<uint64, ResourceBase>::const_iterator it = resourceLibrary.find(ID);
+	if (it != resourceLibrary.end())
+	{
+		return &it->second;
+	}
+	return nullptr;
+}
+
+void M_Resources::GetDependencies(uint64 ID, std::vector<uint64>& dependencies, bool recursive) const
+{
+	std::set<uint64> visited;
+	visited.insert(ID);
+
+	//Breadth first: closer dependencies come first
+	std::vector<uint64> pending(1, ID);
+	for (uint p = 0; p < pending.size(); ++p)
+	{
+		std::map<uint64, ResourceBase>::const_iterator it = resourceLibrary.find(pending[p]);
+		if (it == resourceLibrary.end())
+			continue;
+
+		for (uint i = 0; i < it->second.dependencies.size(); ++i)
+		{
+			uint64 dependency = it->second.dependencies[i];
+			if (visited.insert(dependency).second == false)
+				continue;
+
+			dependencies.push_back(dependency);
+			if (recursive)
+				pending.push_back(dependency);
+		}
+	}
+}
+
+void M_Resources::GetDependents(uint64 ID, std::vector<uint64>& dependents) const
+{
+	for (std::map<uint64, ResourceBase>::const_iterator it = resourceLibrary.begin(); it != resourceLibrary.end(); ++it)
+	{
+		if (std::binary_search(it->second.dependencies.begin(), it->second.dependencies.end(), ID))
+			dependents.push_back(it->first);
+	}
+}
+
+bool M_Resources::GetAllMetaFromType(ResourceType type, std::vector<const ResourceBase*>& metas) const
+{
+	if ((int)type < 0 || type > ResourceType::UNKNOWN)
+		return false;
+
+	const std::map<uint64, ResourceBase*>& bases = typeIndex[(int)type];
+	for (std::map<uint64, ResourceBase*>::const_iterator it = bases.begin(); it != bases.end(); ++it)
+		metas.push_back(it->second);
+
+	return metas.size() > 0;
+}
+
+void M_Resources::SaveResource(Resource* resource, bool saveMeta)
+{
+	char* buffer = nullptr;
+	uint size = SerializeResource(resource, &buffer);
+
+	if (size > 0)
+	{
+		resource->needs_save = false;
+		UpdateDependencies(resource);
+		SaveLibraryFile(resource->GetLibraryFile(), resource->GetType(), buffer, size);
+
+		if (!resource->isExternal)
+		{
+			char* textBuffer = nullptr;
+			uint textSize = SerializeTextAsset(resource, &textBuffer);
+			const char* assetBuffer = textSize > 0 ? textBuffer : buffer;
+			uint assetSize = textSize > 0 ? textSize : size;
+
+			Engine->fileSystem->Save(resource->GetAssetsFile(), assetBuffer, assetSize);
+			resource->baseData->contentHash = Hash::Compute(assetBuffer, assetSize);
+			RELEASE_ARRAY(textBuffer);
+		}
+		if (saveMeta) //Model internal resources should not override meta content
+			SaveMetaInfo(*resource->baseData);
+
+		RELEASE_ARRAY(buffer);
+	}
+}
+
+void M_Resources::UpdateDependencies(Resource* resource)
+{
+	std::vector<uint64> dependencies;
+	resource->GetDependencies(dependencies);
+	SetDependencies(*resource->baseData, dependencies);
+}
+
+void M_Resources::SetDependencies(ResourceBase& base, std::vector<uint64> dependencies)
+{
+	std::sort(dependencies.begin(), dependencies.end());
+	dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+	dependencies.erase(std::remove_if(dependencies.begin(), dependencies.end(), [&base](uint64 ID) { return ID == 0 || ID == base.ID; }), dependencies.end());
+	base.dependencies.swap(dependencies);
+}
+
+uint M_Resources::SerializeResource(Resource* resource, char** buffer)
+{
+	switch (resource->GetType())
+	{
+		case(ResourceType::FOLDER): return Importer::Folders::Save((R_Folder*)resource, buffer);
+		case(ResourceType::MESH): return Importer::Meshes::Save((R_Mesh*)resource, buffer);
+		case(ResourceType::TEXTURE): return Importer::Textures::Save((R_Texture*)resource, buffer);
+		case(ResourceType::MATERIAL): return Importer::Materials::Save((R_Material*)resource, buffer);
+		case(ResourceType::ANIMATION): return Importer::Animations::Save((R_Animation*)resource, buffer);
+		case(ResourceType::ANIMATOR_CONTROLLER): return Importer::Animators::Save((R_AnimatorController*)resource, buffer);
+		case(ResourceType::MODEL): return Importer::Models::Save((R_Model*)resource, buffer);
+		case(ResourceType::PARTICLESYSTEM): return Importer::Particles::Save((R_ParticleSystem*)resource, buffer);
+		case(ResourceType::SHADER): return Importer::Shaders::Save((R_Shader*)resource, buffer);
+		case(ResourceType::SCENE): return Importer::Scenes::Save((R_Scene*)resource, buffer);
+		default:
+		{
+			LOG("[error] Resource type %i of '%s' can not be saved", (int)resource->GetType(), resource->GetName());
+			return 0;
+		}
+	}
+}
+
+uint M_Resources::SerializeTextAsset(Resource* resource, char** buffer) const
+{
+	if (resource->GetType() == ResourceType::SCENE && textSceneAssets)
+		return (uint)Importer::Scenes::SaveJSON((R_Scene*)resource, buffer);
+	return 0;
+}
+
+uint64 M_Resources::SaveResourceAs(Resource* resource, const char* directory, const char* fileName)
+{
+	//TODO:   SaveResourceAs would override any existing resource with that name, and not remove its library content.
+
 	//Creating a new empty resource just to add it into the database
 	std::string path = directory + std::string("/").append(name); //TODO: Append extension...?
 	Resource* newResource = CreateNewResource(path.c_str(), resource->GetType(), fileName);
@@ -530,18 +1603,38 @@ uint64 M_Resources::SaveResourceAs(Resource* resource, const char* directory, co
 //Save .meta file in assets
 void M_Resources::SaveMetaInfo(const ResourceBase& base)
 {
+	AssetDatabase::Record record;
+	record.base = base;
+
 	Config config;
 	base.Serialize(config);
 
 	//Getting file modification date
-	uint64 modDate = Engine->fileSystem->GetLastModTime(base.assetsFile.c_str());
-	config.SetNumber("Date", modDate);
+	record.assetDate = Engine->fileSystem->GetLastModTime(base.assetsFile.c_str());
+	config.SetNumber("Date", record.assetDate);
+
+	//Import key: the asset is only imported again if any of them changes
+	record.importerVersion = GetImporterVersion(base.type);
+	record.importSettings = GetImportSettingsHash(base.type);
+	if (base.contentHash != 0)
+	{
+		config.SetString("Hash", Hash::ToString(base.contentHash).c_str());
+		config.SetNumber("Importer Version", record.importerVersion);
+		config.SetString("Import Settings", Hash::ToString(record.importSettings).c_str());
+	}
 
 	Config_Array children = config.SetArray("Contained Resources");
 	for (uint i = 0; i < base.containedResources.size(); ++i)
 	{
-		ResourceBase& baseChild = resourceLibrary[base.containedResources[i]];
-		baseChild.Serialize(children.AddNode());
+		std::map<uint64, ResourceBase>::const_iterator childIt = resourceLibrary.find(base.containedResources[i]);
+		if (childIt == resourceLibrary.end())
+			continue;
+
+		Config childNode = children.AddNode();
+		childIt->second.Serialize(childNode);
+
+		if (base.type != ResourceType::FOLDER)
+			record.contained.push_back(childIt->second);
 	}
 
 	char* buffer = nullptr;
@@ -551,19 +1644,243 @@ void M_Resources::SaveMetaInfo(const ResourceBase& base)
 		std::string path = base.assetsFile + ".meta";
 		Engine->fileSystem->Save(path.c_str(), buffer, size);
 		RELEASE_ARRAY(buffer);
+
+		record.metaDate = Engine->fileSystem->GetLastModTime(path.c_str());
+		assetDatabase.Set(NormalizePath(base.assetsFile.c_str()), record);
 	}
 }
 
 void M_Resources::SaveChangedResources()
 {
-	for (std::map<uint64, Resource*>::iterator it = resources.begin(); it != resources.end(); it++)
+	SaveAssetDatabase();
+
+	//Resources unloaded since they were modified lost their changes with their memory
+	for (std::set<uint64>::iterator it = dirtyResources.begin(); it != dirtyResources.end(); ++it)
+	{
+		std::map<uint64, Resource*>::iterator loaded = resources.find(*it);
+		if (loaded != resources.end() && loaded->second->needs_save == true)
+		{
+			SaveResourceInBackground(loaded->second);
+			loaded->second->needs_save = false;
+		}
+	}
+	dirtyResources.clear();
+}
+
+void M_Resources::SaveResourceInBackground(Resource* resource)
+{
+	char* buffer = nullptr;
+	uint size = SerializeResource(resource, &buffer);
+	if (size == 0)
+		return;
+	UpdateDependencies(resource);
+
+	if (!resource->isExternal)
+	{
+		char* assetBuffer = nullptr;
+		uint assetSize = SerializeTextAsset(resource, &assetBuffer);
+		if (assetSize == 0)
+		{
+			assetSize = size;
+			assetBuffer = new char[size];
+			memcpy(assetBuffer, buffer, size);
+		}
+		resource->baseData->contentHash = Hash::Compute(assetBuffer, assetSize);
+
+		//The .meta is written once the asset is in place: it records the new modification date
+		uint64 ID = resource->GetID();
+		Engine->fileSystem->SaveAsync(resource->GetAssetsFile(), assetBuffer, assetSize, [this, ID](bool written)
+		{
+			std::map<uint64, ResourceBase>::iterator it = resourceLibrary.find(ID);
+			if (written && it != resourceLibrary.end())
+				SaveMetaInfo(it->second);
+		});
+	}
+
+	//Compressed here: the writer thread only writes bytes
+	char* compressed = nullptr;
+	uint compressedSize = 0;
+	if (compressLibraryFiles[(int)resource->GetType()])
+		compressedSize = (uint)Compression::CompressBlob(buffer, size, &compressed);
+
+	if (compressedSize > 0)
+	{
+		RELEASE_ARRAY(buffer);
+		Engine->fileSystem->SaveAsync(resource->GetLibraryFile(), compressed, compressedSize);
+	}
+	else
+		Engine->fileSystem->SaveAsync(resource->GetLibraryFile(), buffer, size);
+}
+
+void M_Resources::ProcessAssetEvents(double budgetMs)
+{
+	if (assetsWatcher == nullptr)
+		return;
+
+	std::vector<FileWatcher::Event> events;
+	assetsWatcher->CollectEvents(events);
+	assetEvents.insert(assetEvents.end(), events.begin(), events.end());
+	if (assetEvents.empty())
+		return;
+
+	//Changes left once the budget is spent are applied in the next frames, in the same order
+	PerfTimer timer;
+	do
+	{
+		FileWatcher::Event event = assetEvents.front();
+		assetEvents.pop_front();
+		ProcessAssetEvent(event);
+	} while (!assetEvents.empty() && timer.ReadMs() < budgetMs);
+
+	//Resources saved by the refresh update their .meta files: the database is kept in sync with them
+	SaveAssetDatabase();
+}
+
+void M_Resources::ProcessAssetEvent(const FileWatcher::Event& event)
+{
+	//Modified files do not change their directory: the scanned listing would keep the old date
+	Engine->fileSystem->InvalidateScan(event.path.c_str());
+	if (event.type == FileWatcher::EventType::RENAMED)
+		Engine->fileSystem->InvalidateScan(event.oldPath.c_str());
+
+	//.meta changes reload their asset. Removed ones are written again when their asset is saved
+	std::string extension;
+	Engine->fileSystem->SplitFilePath(event.path.c_str(), nullptr, nullptr, &extension);
+	if (extension == "meta")
+	{
+		if (event.type != FileWatcher::EventType::DELETED)
+			RefreshAsset(event.path.substr(0, event.path.size() - 5).c_str(), false);
+		return;
+	}
+
+	switch (event.type)
+	{
+		case FileWatcher::EventType::CREATED:	RefreshAsset(event.path.c_str(), true); break;
+		case FileWatcher::EventType::MODIFIED:	RefreshAsset(event.path.c_str(), event.isDirectory); break;
+		case FileWatcher::EventType::DELETED:	ForgetAsset(event.path.c_str()); break;
+		case FileWatcher::EventType::RENAMED:
+		{
+			Engine->fileSystem->SplitFilePath(event.oldPath.c_str(), nullptr, nullptr, &extension);
+			if (extension != "meta")
+				ForgetAsset(event.oldPath.c_str());
+			RefreshAsset(event.path.c_str(), true);
+			break;
+		}
+	}
+}
+
+void M_Resources::RefreshAsset(const char* path, bool scanContent)
+{
+	//Deleted again before the change was applied
+	if (Engine->fileSystem->Exists(path) == false)
+		return;
+
+	//Assets are added to their folder: a folder that is not registered yet is refreshed with all its content instead
+	std::string parentPath;
+	Engine->fileSystem->SplitFilePath(path, &parentPath);
+	while (!parentPath.empty() && (parentPath.back() == '/' || parentPath.back() == '\\'))
+		parentPath.pop_back();
+
+	const ResourceBase* parent = parentPath.empty() ? nullptr : FindResourceBase(parentPath.c_str(), nullptr, ResourceType::FOLDER);
+	if (parent == nullptr && !parentPath.empty() && Engine->fileSystem->IsDirectory(parentPath.c_str()))
+	{
+		RefreshAsset(parentPath.c_str(), true);
+		return;
+	}
+	uint64 parentID = parent ? parent->ID : 0;
+
+	PathNode node;
+	if (scanContent)
+	{
+		std::vector<std::string> ignore_ext;
+		ignore_ext.push_back("meta");
+		node = Engine->fileSystem->GetAllFiles(path, nullptr, &ignore_ext);
+	}
+	else
+	{
+		node.path = path;
+		Engine->fileSystem->SplitFilePath(path, nullptr, &node.localPath);
+		node.isFile = Engine->fileSystem->HasExtension(path);
+		node.modTime = Engine->fileSystem->GetLastModTime(path);
+	}
+
+	uint64 assetID = 0;
+	std::vector<ImportJob*> imports;
+	bool importedAsNew = LoadAssetBase(node, assetID, imports);
+	RunImportJobs(imports);
+
+	if (importedAsNew && parentID != 0)
+	{
+		ResourceHandle<Resource> hFolder(parentID);
+		if (Resource* folder = hFolder.Get())
+		{
+			folder->AddContainedResource(assetID);
+			SaveResource(folder);
+		}
+	}
+}
+
+void M_Resources::ForgetAsset(const char* path)
+{
+	std::string key = NormalizePath(path);
+	std::string prefix = key + "/";
+
+	//The asset, its contained resources and, for folders, everything inside them
+	std::vector<std::string> keys;
+	for (std::unordered_map<std::string, std::vector<ResourceBase*>>::const_iterator it = pathIndex.begin(); it != pathIndex.end(); ++it)
+	{
+		if (it->first == key || it->first.compare(0, prefix.size(), prefix) == 0)
+			keys.push_back(it->first);
+	}
+	if (keys.empty())
+		return;
+
+	std::set<uint64> removedIDs;
+	for (uint i = 0; i < keys.size(); ++i)
 	{
-		if (it->second->needs_save == true)
+		assetDatabase.Remove(keys[i]);
+
+		//Copied: removing a base modifies the index entry
+		std::vector<ResourceBase*> bases = pathIndex[keys[i]];
+		for (uint b = 0; b < bases.size(); ++b)
 		{
-			SaveResource(it->second);
-			it->second->needs_save = false;
+			uint64 ID = bases[b]->ID;
+			std::map<uint64, Resource*>::iterator loaded = resources.find(ID);
+			if (loaded != resources.end() && loaded->second->instances > 0)
+			{
+				LOG("[Warning] Asset '%s' was removed while in use, it stays loaded", bases[b]->assetsFile.c_str());
+				continue;
+			}
+			UnloadResource(ID);
+			RemoveResourceBase(ID);
+			removedIDs.insert(ID);
 		}
 	}
+
+	//Remove the asset from its folder, if the folder itself is still there
+	std::string parentPath;
+	Engine->fileSystem->SplitFilePath(key.c_str(), &parentPath);
+	while (!parentPath.empty() && parentPath.back() == '/')
+		parentPath.pop_back();
+
+	const ResourceBase* parent = parentPath.empty() ? nullptr : FindResourceBase(parentPath.c_str(), nullptr, ResourceType::FOLDER);
+	if (parent != nullptr)
+	{
+		ResourceHandle<Resource> hFolder(parent->ID);
+		if (Resource* folder = hFolder.Get())
+		{
+			std::vector<uint64>& contained = folder->baseData->containedResources;
+			uint64 previousSize = contained.size();
+			contained.erase(std::remove_if(contained.begin(), contained.end(), [&removedIDs](uint64 ID) { return removedIDs.count(ID) > 0; }), contained.end());
+			if (contained.size() != previousSize)
+				SaveResource(folder);
+		}
+	}
+}
+
+void M_Resources::OnResourceModified(Resource* resource)
+{
+	dirtyResources.insert(resource->GetID());
 }
 
 uint M_Resources::DeleteResource(uint64 ID, bool deleteAsset)
@@ -577,11 +1894,12 @@ uint M_Resources::DeleteResource(uint64 ID, bool deleteAsset)
 	{
 		if (deleteAsset)
 		{
+			assetDatabase.Remove(NormalizePath(libraryIt->second.assetsFile.c_str()));
 			Engine->fileSystem->Remove(libraryIt->second.assetsFile.c_str());
-			Engine->fileSystem->Remove(libraryIt->second.assetsFile.append(".meta").c_str());
+			Engine->fileSystem->Remove((libraryIt->second.assetsFile + ".meta").c_str());
 		}
 		Engine->fileSystem->Remove(libraryIt->second.libraryFile.c_str());
-		resourceLibrary.erase(libraryIt);
+		RemoveResourceBase(ID);
 	}
 
 	return instances;
@@ -591,10 +1909,19 @@ uint M_Resources::UnloadResource(uint64 ID)
 {
 	uint64 instances = 0;
 
+	//A load in progress is dropped once it reaches the upload queue
+	std::map<uint64, AsyncLoad*>::iterator asyncIt = asyncLoads.find(ID);
+	if (asyncIt != asyncLoads.end())
+	{
+		asyncIt->second->discarded = true;
+		asyncLoads.erase(asyncIt);
+	}
+
 	std::map<uint64, Resource*>::iterator it = resources.find(ID);
 	if (it != resources.end())
 	{
-		//TODO: at this moment no resource is freeing any memory
+		registry.Remove(ID);
+		cache.Remove(it->second);
 		it->second->FreeMemory();
 		instances = it->second->instances;
 		RELEASE(it->second);
@@ -603,6 +1930,198 @@ uint M_Resources::UnloadResource(uint64 ID)
 	return instances;
 }
 
+bool M_Resources::RetireResource(uint64 ID)
+{
+	std::map<uint64, Resource*>::iterator it = resources.find(ID);
+	if (it == resources.end())
+		return false;
+
+	//Out of the registry first: no other thread can take an instance once it has none
+	Resource* resource = it->second;
+	registry.Remove(ID);
+	if (resource->instances <= 0)
+		return false;
+
+	cache.Remove(resource);
+	resource->baseData = new ResourceBase(*resource->baseData);
+	retiredResources.push_back(resource);
+	resources.erase(it);
+	return true;
+}
+
+void M_Resources::FreeRetiredResources(bool all)
+{
+	for (uint i = 0; i < retiredResources.size(); )
+	{
+		Resource* resource = retiredResources[i];
+		if (all == false && resource->instances > 0)
+		{
+			++i;
+			continue;
+		}
+
+		ResourceBase* base = resource->baseData;
+		resource->FreeMemory();
+		RELEASE(resource);
+		RELEASE(base);
+		retiredResources[i] = retiredResources.back();
+		retiredResources.pop_back();
+	}
+}
+
+void M_Resources::OnResourceUnused(Resource* resource)
+{
+	//Resources created outside the module are owned by whoever created them: they are never cached nor unloaded here
+	//Retired resources are deleted once they are released
+	std::map<uint64, Resource*>::iterator it = resources.find(resource->GetID());
+	if (it == resources.end() || it->second != resource)
+	{
+		FreeRetiredResources();
+		return;
+	}
+
+	if (cache.Add(resource) == false)
+		UnloadUnusedResource(resource->GetID());
+}
+
+bool M_Resources::UnloadUnusedResource(uint64 ID)
+{
+	//Once out of the registry no other thread can take an instance. If one was taken, its release brings the resource back here
+	if (registry.RemoveIfUnused(ID) == false)
+		return false;
+
+	UnloadResource(ID);
+	return true;
+}
+
+void M_Resources::ProcessDeferredReleases()
+{
+	std::vector<DeferredRelease> released;
+	{
+		std::lock_guard<std::mutex> lock(deferredMutex);
+		released.swap(deferredReleases);
+	}
+
+	for (uint i = 0; i < released.size(); ++i)
+	{
+		if (released[i].asyncRequest)
+		{
+			ReleaseAsyncRequest(released[i].ID);
+			continue;
+		}
+
+		//The resource may have been taken again, or unloaded by a reimport, since it was released
+		std::map<uint64, Resource*>::iterator it = resources.find(released[i].ID);
+		if (it != resources.end() && it->second->instances <= 0 && asyncRequests.find(released[i].ID) == asyncRequests.end())
+			OnResourceUnused(it->second);
+	}
+
+	//Releases of retired resources come with the ID of the resource that replaced them
+	if (released.empty() == false && retiredResources.empty() == false)
+		FreeRetiredResources();
+}
+
+void M_Resources::TrimCache()
+{
+	std::vector<uint64> evicted;
+	cache.CollectEvictions(evicted);
+
+	for (uint i = 0; i < evicted.size(); ++i)
+		UnloadUnusedResource(evicted[i]);
+}
+
+void M_Resources::ClearCache()
+{
+	std::vector<uint64> evicted;
+	cache.CollectEvictions(evicted, true);
+
+	for (uint i = 0; i < evicted.size(); ++i)
+		UnloadUnusedResource(evicted[i]);
+}
+
+ResourceBase& M_Resources::AddResourceBase(const ResourceBase& base)
+{
+	failedLoads.erase(base.ID);
+
+	std::map<uint64, ResourceBase>::iterator it = resourceLibrary.find(base.ID);
+	if (it != resourceLibrary.end())
+	{
+		UnindexResourceBase(&it->second);
+		it->second = base;
+	}
+	else
+	{
+		it = resourceLibrary.insert(std::pair<uint64, ResourceBase>(base.ID, base)).first;
+	}
+
+	IndexResourceBase(&it->second);
+	return it->second;
+}
+
+void M_Resources::RemoveResourceBase(uint64 ID)
+{
+	std::map<uint64, ResourceBase>::iterator it = resourceLibrary.find(ID);
+	if (it != resourceLibrary.end())
+	{
+		UnindexResourceBase(&it->second);
+		resourceLibrary.erase(it);
+	}
+}
+
+void M_Resources::IndexResourceBase(ResourceBase* base)
+{
+	//Path entries are sorted by ID so lookups return the same resource a library iteration would
+	std::vector<ResourceBase*>& entries = pathIndex[NormalizePath(base->assetsFile.c_str())];
+	std::vector<ResourceBase*>::iterator position = entries.begin();
+	while (position != entries.end() && (*position)->ID < base->ID)
+		++position;
+	entries.insert(position, base);
+
+	if ((int)base->type >= 0 && base->type <= ResourceType::UNKNOWN)
+		typeIndex[(int)base->type][base->ID] = base;
+}
+
+void M_Resources::UnindexResourceBase(ResourceBase* base)
+{
+	std::unordered_map<std::string, std::vector<ResourceBase*>>::iterator it = pathIndex.find(NormalizePath(base->assetsFile.c_str()));
+	if (it != pathIndex.end())
+	{
+		for (uint i = 0; i < it->second.size(); ++i)
+		{
+			if (it->second[i] == base)
+			{
+				it->second.erase(it->second.begin() + i);
+				break;
+			}
+		}
+		if (it->second.empty())
+			pathIndex.erase(it);
+	}
+
+	if ((int)base->type >= 0 && base->type <= ResourceType::UNKNOWN)
+		typeIndex[(int)base->type].erase(base->ID);
+}
+
+std::string M_Resources::NormalizePath(const char* path)
+{
+	std::string normalized;
+	normalized.reserve(strlen(path));
+
+	if (path[0] == '.' && (path[1] == '/' || path[1] == '\\'))
+		path += 2;
+	while (path[0] == '/' || path[0] == '\\')
+		path++;
+
+	for (const char* c = path; *c != '\0'; ++c)
+	{
+		char character = *c == '\\' ? '/' : *c;
+		if (character == '/' && !normalized.empty() && normalized.back() == '/')
+			continue;
+		normalized.push_back(character);
+	}
+	return normalized;
+}
+
 void M_Resources::ClearMetaData()
 {
 	//Getting all .meta in assets
@@ -624,7 +2143,7 @@ void M_Resources::ClearMetaData()
 	Engine->fileSystem->CreateLibraryDirectories();
 }
 
-void M_Resources::RemoveMetaFromFolder(PathNode node)
+void M_Resources::RemoveMetaFromFolder(const PathNode& node)
 {
 	if (node.isFile == true)
 	{
@@ -4,15 +4,29 @@
 #include "Module.h"
 #include "Resource.h"
 #include "ResourceHandle.h"
+#include "ResourceCache.h"
+#include "ResourceRegistry.h"
+#include "ImportCache.h"
+#include "AssetDatabase.h"
+#include "FileWatcher.h"
 
 #include "Timer.h"
-#include "MathGeoLib\src\Algorithm\Random\LCG.h"
+#include "MathGeoLib/src/Algorithm/Random/LCG.h"
 
 #include <map>
+#include <set>
 #include <vector>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 
 class R_Folder;
+class ThreadPool;
+struct IORequest;
+enum class IOPriority;
 struct PathNode;
+struct aiScene;
 
 class M_Resources : public Module
 {
@@ -25,16 +39,66 @@ public:
 	update_status Update() override;
 	bool CleanUp() override;
 
+	void SaveConfig(Config& config) const override;
+
 	//Import a file from outside the project folder
 	//The file will be duplicated into the current active folder in the asset explorer
 	void ImportFileFromExplorer(const char* path, const char* dstDir);
 
 	//Import a file existing in assets and create its resources
 	uint64 ImportFileFromAssets(const char* path);
+
+	//Assets imported by the last LoadAllAssets, updated as each of them is finished
+	struct ImportProgress
+	{
+		uint total = 0;
+		uint done = 0;
+		std::string current;	//Last asset finished
+		double elapsedMs = 0.0;
+
+		uint unchanged = 0;		//Modified date changed, same content
+		uint cached = 0;		//Library output taken from the import cache
+	};
+	inline const ImportProgress& GetImportProgress() const { return importProgress; }
 	
+	//Ownership across threads:
+	// - Only the main thread loads, replaces and unloads resources
+	// - Any thread can take an instance of a loaded resource with RequestResource and release it. Outside the main thread
+	//   requests never load: they return nullptr if the resource is not loaded
+	// - A resource released for the last time outside the main thread is cached or unloaded by the main thread in the next Update
+	// - Evictions never unload a resource that has instances, even one taken while the eviction runs
+	// - Reimports and deletions unload a resource regardless of its instances: other threads must not keep resources across frames
+
+	//Loads the resource synchronously. A resource being loaded asynchronously is finished right away
 	Resource* RequestResource(uint64 ID);
 	void ReleaseResource(Resource* resource);
 
+	//Starts loading the resource in the background, if it is not loaded yet. Returns the resulting state
+	//The library file is read (and parsed, for types that allow it) by the loading threads. GPU upload
+	//happens in Update, limited by 'uploadBudgetMs' per frame. While the request is held, the resource
+	//stays loaded even without instances: RequestResource takes an instance, then release the request
+	//Asynchronous requests can only be made by the main thread. Outside of it, GetLoadState only reports READY or UNLOADED
+	ResourceLoadState RequestResourceAsync(uint64 ID);
+	void ReleaseAsyncRequest(uint64 ID);
+	ResourceLoadState GetLoadState(uint64 ID) const;
+
+	//Blocks until every asynchronous load has been read and uploaded
+	void FinishAsyncLoads();
+
+	//Packs the library files of every registered resource in LIBRARY_PACK_FILE and mounts it (M_FileSystem::CookLibraryPack)
+	//Meshes and animations start on a page, so they are mapped straight from the pack
+	//Their loose copies are deleted if 'removeLooseFiles': files written afterwards override the pack until the next cook
+	bool CookLibrary(bool removeLooseFiles = true);
+
+	//Reads a library file into a new buffer, decompressing it if it was saved compressed
+	//Returns the size of the content, 0 if the file could not be read. Can be called from any thread
+	uint LoadLibraryFile(const char* file, char** buffer) const;
+
+	//Resources without instances are kept in the cache until their type goes over its memory budget
+	inline ResourceCache& GetCache() { return cache; }
+	//Unloads every cached resource
+	void ClearCache();
+
 	//Used for internal resources (external referring to fbx, textures,...)
 	uint64 CreateNewCopyResource(const char* srcFile, const char* dstDir);
 
@@ -46,23 +110,66 @@ public:
 	//Returns the newly created resource's ID
 	uint64 SaveResourceAs(Resource* resource, const char* directory, const char* fileName);
 
+	//Called by Resource::SetDirty. Modified resources are saved every few seconds, only the dirty ones are visited
+	void OnResourceModified(Resource* resource);
+
+	//Serializes the dirty resources in the main thread, the files are written by the file system writer thread
+	void SaveChangedResources();
+
 	const ResourceBase* FindResourceBase(const char* path, const char* name = nullptr, ResourceType type = ResourceType::UNKNOWN) const;
 	const ResourceBase* GetResourceBase(uint64 ID) const;
 
 	bool GetAllMetaFromType(ResourceType type, std::vector<const ResourceBase*>& metas) const;
 
+	//Dependency graph, recorded when resources are saved. 'recursive' returns the full closure, each resource once
+	void GetDependencies(uint64 ID, std::vector<uint64>& dependencies, bool recursive = true) const;
+	//Resources that reference 'ID' directly
+	void GetDependents(uint64 ID, std::vector<uint64>& dependents) const;
+
+	//Starts loading the dependency closure of a resource in the loading threads
+	//The requests are released once their loads finish: resources not used by then stay in the cache
+	void PrefetchDependencies(uint64 ID);
+
 private:
 	//Iterates all files inside Assets and Engine/Assets.
 	//Loads any resource that is not registered inside resourcesLibrary
 	//Imports any new resource
 	void LoadAllAssets();
 
+	//Asset imports. Only reading, decoding and library writes of the asset file run in the importing threads:
+	//the resource is registered when the job is created, importers and .meta writes run in the main thread
+	struct ImportJob;
+
 	//Loads the base data from the resource in 'node.path' and all its children
+	//Files to import are registered and added to 'imports', to be imported later by RunImportJobs
 	//Returns wether the resource was imported as new or not
-	bool LoadAssetBase(PathNode node, uint64& assetID);
+	bool LoadAssetBase(const PathNode& node, uint64& assetID, std::vector<ImportJob*>& imports);
+
+	//Parses the .meta file of an asset into an asset database record. Returns false if it could not be read
+	bool LoadMetaRecord(const char* assetsFile, AssetDatabase::Record& record);
+	void SaveAssetDatabase();
+
+	ImportJob* CreateImportJob(const char* path);
+	//Checks the content of a registered asset, it is imported again only if its import key changed
+	ImportJob* CreateReimportJob(const ResourceBase& base, bool importerChanged);
+	void PrepareImport(ImportJob* job);
+	void FinishImport(ImportJob* job);
+
+	//Prepares the jobs in parallel and finishes them as they become ready
+	//Models are imported after every other asset: their materials reference the textures
+	void RunImportJobs(std::vector<ImportJob*>& jobs);
+	static int GetImportPhase(ResourceType type);
+
+	//Import key: content hash, importer version and import settings. Saved in .meta files
+	static uint GetImporterVersion(ResourceType type);
+	static uint64 GetImportSettingsHash(ResourceType type);
+	static uint64 GetImportKey(uint64 contentHash, ResourceType type);
+	static bool IsImportCached(ResourceType type);
+	//Copied assets that reference other resources. Their content is parsed on import to record the dependencies
+	static bool HasDependencies(ResourceType type);
 
 	//Import a 3D scene file
-	void ImportModel(const char* buffer, uint size, Resource* prefab);
+	void ImportModel(const aiScene* scene, Resource* prefab);
 
 	//Import a resource existing in a prefab (3D scene) file
 	uint64 ImportResourceFromModel(const char* file, const void* data, const char* name, ResourceType type);
@@ -76,10 +183,72 @@ private:
 	//Creates a resource from the base data in the library
 	Resource* CreateResourceFromBase(ResourceBase& base);
 
-	//.meta file generation
+	//Fills a resource created from its base data with the library file content
+	//Returns false if the library file could not be read
+	bool LoadResourceData(Resource* resource);
+	static void ParseResource(const char* buffer, uint size, Resource* resource);
+
+	//Fills the resource from a mapping of its library file. Returns the mapped size, 0 if the file could not be mapped
+	//Can be called from the loading threads
+	uint LoadMappedData(const char* libraryFile, Resource* resource) const;
+	static bool CanMapLibraryFile(ResourceType type);
+
+	//Writes a library file, compressed if its type has 'compressLibraryFiles' set. Can be called from the importing threads
+	bool SaveLibraryFile(const char* file, ResourceType type, const char* buffer, uint size) const;
+	//Decodes a compressed library file into a new null terminated buffer. Returns the decoded size, 0 if the data is damaged
+	static uint DecompressLibraryFile(const char* file, const char* data, uint64 size, char** buffer);
+	static bool IsCompressedByDefault(ResourceType type);
+
+	//Uploads a loaded resource to the GPU and makes it available in 'resources'
+	void PublishResource(Resource* resource);
+
+	//Asynchronous loads. Reading runs in the I/O threads (mapped files in the loading threads), parsing in the
+	//loading threads when the type allows it and everything else in the main thread
+	struct AsyncLoad;
+	//Reads are queued until SubmitQueuedReads, so the files requested together are read as a batch
+	ResourceLoadState StartAsyncLoad(uint64 ID, IOPriority priority);
+	void SubmitQueuedReads();
+	void ReadAsyncLoad(AsyncLoad* load);
+	void ParseAsyncLoad(AsyncLoad* load);
+	void ReleaseAsyncBuffer(AsyncLoad* load);
+	static bool CanParseOnLoadingThread(ResourceType type);
+
+	//Uploads the loads already read until 'budgetMs' is exceeded. A negative budget uploads all of them
+	void ProcessUploadQueue(double budgetMs);
+
+	//Waits until the load has been read and takes it out of the upload queue
+	void WaitAsyncLoad(AsyncLoad* load);
+
+	//Parses and publishes a load taken out of the upload queue. Returns the published resource
+	Resource* FinishAsyncLoad(AsyncLoad* load);
+
+	//.meta file generation. The asset database is updated with the same content
 	void SaveMetaInfo(const ResourceBase& base);
 
-	void SaveChangedResources();
+	void SaveResourceInBackground(Resource* resource);
+
+	//Library file content of a resource, as saved by its importer
+	static uint SerializeResource(Resource* resource, char** buffer);
+	//Asset content when it differs from the library file (json scenes with 'textSceneAssets'), 0 otherwise
+	uint SerializeTextAsset(Resource* resource, char** buffer) const;
+
+	//Records the resources referenced by a resource in its base data
+	void UpdateDependencies(Resource* resource);
+	static void SetDependencies(ResourceBase& base, std::vector<uint64> dependencies);
+
+	//Releases the prefetch requests whose loads have finished
+	void ReleasePrefetchRequests();
+
+	//Applies the changes reported by the assets watcher until 'budgetMs' is exceeded
+	void ProcessAssetEvents(double budgetMs);
+	void ProcessAssetEvent(const FileWatcher::Event& event);
+
+	//Registers the new assets in 'path' and imports the modified ones. 'scanContent' also refreshes every asset inside a folder
+	void RefreshAsset(const char* path, bool scanContent);
+
+	//Unregisters the asset at 'path' and every asset inside it, once their files are gone
+	//Library files are kept: a renamed asset keeps its .meta, and its import, under the new path
+	void ForgetAsset(const char* path);
 
 	//Completely deletes a resource
 	//'deleteAsset' flag to delete the original asset file
@@ -90,26 +259,141 @@ private:
 	//Returns the instances held by the resource
 	uint UnloadResource(uint64 ID);
 
+	//Takes a loaded resource that is still in use out of the module, instead of unloading it: the handles holding it
+	//keep the previous content. Returns false if the resource is not loaded or has no instances
+	bool RetireResource(uint64 ID);
+	//Deletes the retired resources whose last instance has been released, or all of them
+	void FreeRetiredResources(bool all = false);
+
+	//Called once a resource has no instances nor requests. It is cached or unloaded
+	void OnResourceUnused(Resource* resource);
+	//Unloads a resource unless another thread took an instance of it. Returns false if it is still in use
+	bool UnloadUnusedResource(uint64 ID);
+
+	//Applies the releases made outside the main thread
+	void ProcessDeferredReleases();
+
+	//Unloads the cached resources of every type over its budget
+	void TrimCache();
+
 	//Remove all .meta files in assets
 	void ClearMetaData();
 
 	//Remove all .meta files in a folder
-	void RemoveMetaFromFolder(PathNode node);
+	void RemoveMetaFromFolder(const PathNode& node);
 
 	ResourceType GetTypeFromFileExtension(const char* path) const;
 	inline uint64 GetNewID() { return random.Int(); }
 
+	//Resource library changes. They keep the lookup indices in sync: 'resourceLibrary' must not be modified directly
+	//Adding an existing ID replaces its data, the ResourceBase keeps its address
+	ResourceBase& AddResourceBase(const ResourceBase& base);
+	void RemoveResourceBase(uint64 ID);
+
+	void IndexResourceBase(ResourceBase* base);
+	void UnindexResourceBase(ResourceBase* base);
+
+	//Path index key: same separators and no leading "./" or "/", so equivalent paths share their entry
+	static std::string NormalizePath(const char* path);
+
 public:
 	//Resources loaded in memory
 	//TODO: Move to private, accessing in W_Resources to display memory
 	std::map<uint64, Resource*> resources;
 
+	//Time (ms) per frame that can be spent uploading asynchronous loads. At least one is uploaded every frame
+	double uploadBudgetMs = 4.0;
+
+	//Scenes and models prefetch their dependencies when they are requested. Saved as "Prefetch Dependencies"
+	bool prefetchDependencies = true;
+
+	//Meshes and animations are read from a mapping of their library file instead of a loaded copy. Mapped meshes keep
+	//pointing into the file while they are loaded. Saved as "Map Library Files"
+	//Off by default on Windows, where a mapped file cannot be replaced: reimporting a loaded mesh would fail
+#ifdef _WIN32
+	bool mapLibraryFiles = false;
+#else
+	bool mapLibraryFiles = true;
+#endif
+
+	//Scene assets are saved as json instead of the binary format, to read or diff them. Their library files are always
+	//binary: json scenes are converted when imported. Saved as "Text Scene Assets"
+	bool textSceneAssets = false;
+
+	//Library files saved compressed, by resource type. Files are decompressed on load whatever the setting: changing it
+	//only affects the files saved afterwards. Compressed meshes and animations are not mapped, they are decoded from the mapping
+	//Saved under "Compress Library Files"
+	bool compressLibraryFiles[(int)ResourceType::UNKNOWN];
+
+	//Threads preparing asset imports. 0 uses every core, 1 imports everything in the main thread
+	uint importThreads = 0;
+
+	//Model and texture imports shared between projects. Saved as "Import Cache" in the settings, empty disables it
+	ImportCache importCache;
+
+	//Changes made to the Assets folder while the engine runs are applied without a full scan. Saved as "Watch Assets"
+	bool watchAssets = true;
+	//Time (ms) per frame that can be spent applying asset changes. At least one is applied every frame
+	double assetRefreshBudgetMs = 2.0;
+
 	ResourceHandle<Resource> hAssetsFolder;
 	ResourceHandle<Resource> hEngineAssetsFolder;
 private:
 
 	//All resources imported
 	std::map<uint64, ResourceBase> resourceLibrary;
+
+	//Library indices, both in ID order. Contained resources share the path of their asset
+	std::unordered_map<std::string, std::vector<ResourceBase*>> pathIndex;
+	std::map<uint64, ResourceBase*> typeIndex[(int)ResourceType::UNKNOWN + 1];
+
+	//Binary copy of every .meta file, saved in Library at the end of LoadAllAssets and with the changed resources
+	AssetDatabase assetDatabase;
+
+	//Asynchronous loads, by resource ID. Their resources are not in 'resources' until published
+	std::map<uint64, AsyncLoad*> asyncLoads;
+	//Asynchronous requests held, by resource ID
+	std::map<uint64, uint> asyncRequests;
+	//Resources whose library file could not be read
+	std::set<uint64> failedLoads;
+	//Loaded resources modified since they were last saved
+	std::set<uint64> dirtyResources;
+	//Asynchronous requests made by PrefetchDependencies
+	std::vector<uint64> prefetchRequests;
+	//Reads of the loads started, not submitted to the I/O service yet
+	std::vector<IORequest*> queuedReads;
+
+	ResourceCache cache;
+
+	//Every loaded resource, shared with other threads. 'resources' is only used by the main thread
+	ResourceRegistry registry;
+
+	//Last instances and asynchronous requests released outside the main thread
+	struct DeferredRelease
+	{
+		uint64 ID = 0;
+		bool asyncRequest = false;
+	};
+	std::mutex deferredMutex;
+	std::vector<DeferredRelease> deferredReleases;
+
+	//Resources replaced by a reimport while in use. Each one owns a copy of its previous base data
+	std::vector<Resource*> retiredResources;
+
+	ThreadPool* loadingThreads = nullptr;
+	//Guards the loads finished by the loading threads, in completion order
+	std::mutex uploadMutex;
+	std::condition_variable uploadReady;
+	std::deque<AsyncLoad*> uploadQueue;
+
+	ImportProgress importProgress;
+	//Guards the import jobs prepared by the importing threads, in completion order
+	std::mutex importMutex;
+	std::condition_variable importReady;
+	std::deque<ImportJob*> importQueue;
+
+	FileWatcher* assetsWatcher = nullptr;
+	std::deque<FileWatcher::Event> assetEvents;
 	
 	Timer updateAssets_timer;
 	Timer saveChangedResources_timer;
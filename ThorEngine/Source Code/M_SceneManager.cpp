@@ -6,11 +6,11 @@
 #include "Config.h"
 #include "Quadtree.h"
 #include "Time.h"
+#include "PerfTimer.h"
 
 #include "M_Camera3D.h"
 #include "M_Input.h"
 #include "I_Scenes.h"
-#include "M_Editor.h"
 #include "M_Renderer3D.h"
 #include "M_FileSystem.h"
 #include "M_Resources.h"
@@ -25,8 +25,12 @@
 #include "C_Transform.h"
 #include "C_Camera.h"
 
+#ifndef THOR_HEADLESS
+#include "M_Editor.h"
+
 #include <windows.h>
 #include <shobjidl.h> 
+#endif
 
 M_SceneManager::M_SceneManager(bool start_enabled) : Module("Scene", start_enabled)
 {
@@ -57,6 +61,7 @@ bool M_SceneManager::Start()
 bool M_SceneManager::CleanUp()
 {
 	LOG("Unloading scene");
+	hCurrentScene.Free();
 
 	return true;
 }
@@ -74,6 +79,7 @@ const GameObject* M_SceneManager::GetRoot() const
 // Update
 update_status M_SceneManager::Update()
 {
+#ifndef THOR_HEADLESS
 #pragma region WindowTest
 	if (Engine->input->GetKey(SDL_SCANCODE_K) == KEY_DOWN)
 	{
@@ -95,10 +101,18 @@ update_status M_SceneManager::Update()
 		}
 	}
 #pragma endregion
+#endif
+	//Nothing to update until a scene has been loaded
+	if (hCurrentScene.GetID() == 0)
+		return UPDATE_CONTINUE;
+
+	PerfTimer timer;
  	UpdateAllGameObjects(GetRoot(), Time::deltaTime);
+	updateMs = timer.ReadMs();
 
 	if (Engine->renderer3D->culling_camera)
 	{
+		timer.Start();
 		std::vector<const GameObject*> candidates;
 
 		quadtree->CollectCandidates(candidates, Engine->renderer3D->culling_camera->frustum);
@@ -106,17 +120,23 @@ update_status M_SceneManager::Update()
 		std::vector<const GameObject*> gameObjects;
 		TestGameObjectsCulling(candidates, gameObjects);
 		TestGameObjectsCulling(nonStatic, gameObjects);
+		cullingMs = timer.ReadMs();
 
+		timer.Start();
 		for (uint i = 0; i < gameObjects.size(); i++)
 		{
 			if (gameObjects[i]->name != "root");
 			((GameObject*)gameObjects[i])->Draw(true, false, drawBounds, drawBoundsSelected);
 		}
 		gameObjects.clear();
+		drawListMs = timer.ReadMs();
 	}
 	else
 	{
+		timer.Start();
 		DrawAllGameObjects(GetRoot());
+		cullingMs = 0.0;
+		drawListMs = timer.ReadMs();
 	}
 
 	if (drawQuadtree)
@@ -379,7 +399,9 @@ void M_SceneManager::OnClickSelection(const LineSegment& segment)
 			}
 		}
 	}
+#ifndef THOR_HEADLESS
 	Engine->moduleEditor->SelectSingle((GameObject*)toSelect);
+#endif
 }
 
 GameObject* M_SceneManager::CreateCamera()
@@ -85,6 +85,11 @@ public:
 	bool reset = false;
 	Quadtree* quadtree = nullptr;
 
+	//Time spent in the last Update, in ms
+	double updateMs = 0.0;		//GameObjects update: transforms, animation, particles
+	double cullingMs = 0.0;		//Quadtree and frustum tests, 0 without a culling camera
+	double drawListMs = 0.0;	//GameObjects sent to the renderer
+
 	ResourceHandle<R_Scene> hCurrentScene; //The main scene loaded into the editor/game
 	std::vector<ResourceHandle<R_Scene>> activeScenes; //All scenes currently loaded. Editor previews are stored here
 	
@@ -1,17 +1,20 @@
 #include "Globals.h"
 #include "Engine.h"
 #include "M_Window.h"
-#include "SDL\include\SDL_video.h"
+#include "SDL/include/SDL_video.h"
 #include "M_FileSystem.h"
 
 #include "SDL/include/SDL.h"
 #include "OpenGL.h"
-#include "Devil\include\ilu.h"
-#include "Devil\include\ilut.h"
+
+#ifndef THOR_HEADLESS
+#include "Devil/include/ilu.h"
+#include "Devil/include/ilut.h"
 
 #pragma comment( lib, "Devil/libx86/DevIL.lib" )
 #pragma comment( lib, "Devil/libx86/ILU.lib" )
 #pragma comment( lib, "Devil/libx86/ILUT.lib" )
+#endif
 
 M_Window::M_Window(bool start_enabled) : Module("Window", start_enabled)
 {
@@ -29,7 +32,11 @@ M_Window::~M_Window()
 // Called before render is available
 bool M_Window::Init(Config& config)
 {
-
+#ifdef THOR_HEADLESS
+	//No-window mode: only the virtual window size is kept for cameras and render targets
+	LOG("Headless build: running without window");
+	return true;
+#else
 	LOG("Init SDL window & surface");
 	bool ret = true;
 
@@ -93,11 +100,15 @@ bool M_Window::Init(Config& config)
 	}
 
 	return ret;
+#endif
 }
 
 // Called before quitting
 bool M_Window::CleanUp()
 {
+#ifdef THOR_HEADLESS
+	return true;
+#else
 	LOG("Destroying SDL window and quitting all SDL systems");
 
 	SDL_GL_DeleteContext(context);
@@ -111,9 +122,14 @@ bool M_Window::CleanUp()
 	//Quit SDL subsystems
 	SDL_Quit();
 	return true;
+#endif
 }
 
 void M_Window::SetTitle(const char* new_title)
 {
+#ifdef THOR_HEADLESS
+	(void)new_title;
+#else
 	SDL_SetWindowTitle(window, new_title);
+#endif
 }
\ No newline at end of file
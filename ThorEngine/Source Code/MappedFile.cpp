@@ -0,0 +1,130 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* path)
+{
+	return Open(path, 0, 0);
+}
+
+bool MappedFile::Open(const char* path, uint64 offset, uint64 size)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(fileHandle, &fileSize) == 0)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+	uint64 totalSize = (uint64)fileSize.QuadPart;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	uint64 totalSize = (uint64)fileStat.st_size;
+#endif
+
+	//Size 0 maps the whole file
+	if (size == 0 && offset == 0)
+		size = totalSize;
+
+	bool valid = size > 0 && offset <= totalSize && size <= totalSize - offset;
+	if (valid)
+	{
+		//Views start at a multiple of the allocation granularity
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		uint64 granularity = info.dwAllocationGranularity;
+#else
+		uint64 granularity = (uint64)sysconf(_SC_PAGESIZE);
+#endif
+		uint64 viewOffset = offset - offset % granularity;
+		uint64 mapSize = size + (offset - viewOffset);
+
+#ifdef _WIN32
+		HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* mapped = nullptr;
+		if (mappingHandle != nullptr)
+		{
+			mapped = MapViewOfFile(mappingHandle, FILE_MAP_READ, (DWORD)(viewOffset >> 32), (DWORD)(viewOffset & 0xFFFFFFFF), (SIZE_T)mapSize);
+			if (mapped == nullptr)
+				CloseHandle(mappingHandle);
+		}
+
+		if (mapped != nullptr)
+		{
+			file = fileHandle;
+			mapping = mappingHandle;
+			view = (const char*)mapped;
+		}
+#else
+		void* mapped = mmap(nullptr, (size_t)mapSize, PROT_READ, MAP_PRIVATE, fd, (off_t)viewOffset);
+		if (mapped != MAP_FAILED)
+			view = (const char*)mapped;
+#endif
+
+		if (view != nullptr)
+		{
+			viewSize = mapSize;
+			data = view + (offset - viewOffset);
+			this->size = size;
+		}
+	}
+
+#ifdef _WIN32
+	if (view == nullptr)
+		CloseHandle(fileHandle);
+#else
+	//The mapping keeps its own reference to the file
+	close(fd);
+#endif
+
+	return view != nullptr;
+}
+
+void MappedFile::Close()
+{
+	if (view == nullptr)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+	CloseHandle(mapping);
+	CloseHandle(file);
+	mapping = nullptr;
+	file = nullptr;
+#else
+	munmap((void*)view, (size_t)viewSize);
+#endif
+
+	view = nullptr;
+	viewSize = 0;
+	data = nullptr;
+	size = 0;
+}
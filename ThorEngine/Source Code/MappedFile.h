@@ -0,0 +1,48 @@
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include "Globals.h"
+
+//Read-only view of a whole file mapped in memory. Pages are read from disk when first touched and, being
+//backed by the file, the system can drop them under memory pressure instead of swapping them out
+//The view stays valid until the object is destroyed, even if the file is replaced or deleted meanwhile
+//(on Windows the file cannot be replaced while it is mapped). Writing in place over the file is not supported
+class MappedFile
+{
+public:
+	MappedFile() {}
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//'path' is a real path, not a PhysFS one. Empty files cannot be mapped
+	bool Open(const char* path);
+
+	//Maps 'size' bytes starting at 'offset'. The range does not need to be aligned: the view starts on the page (allocation
+	//granularity on Windows) containing 'offset' and only the requested range is exposed
+	bool Open(const char* path, uint64 offset, uint64 size);
+	void Close();
+
+	inline const char* GetData() const { return data; }
+	inline uint64 GetSize() const { return size; }
+	inline bool IsOpen() const { return data != nullptr; }
+
+	//Whether 'pointer' points inside the view
+	inline bool Contains(const void* pointer) const { return pointer >= data && pointer < data + size; }
+
+private:
+	const char* data = nullptr;
+	uint64 size = 0;
+
+	//Whole mapped view, starts up to a page before 'data'
+	const char* view = nullptr;
+	uint64 viewSize = 0;
+
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
+
+#endif //__MAPPED_FILE_H__
@@ -0,0 +1,151 @@
+#include "MemoryTracker.h"
+
+#include "Engine.h"
+#include "M_FileSystem.h"
+#include "Config.h"
+
+#include <atomic>
+
+namespace MemoryTracker
+{
+	namespace Private
+	{
+		struct TagCounters
+		{
+			std::atomic<uint64> liveBytes{ 0 };
+			std::atomic<uint64> peakBytes{ 0 };
+			std::atomic<uint64> liveCount{ 0 };
+			std::atomic<uint64> allocations{ 0 };
+			std::atomic<uint64> gpuBytes{ 0 };
+			std::atomic<uint64> gpuPeakBytes{ 0 };
+		};
+
+		//Function local so tagged allocations done during static initialization are safe
+		TagCounters* GetCounters()
+		{
+			static TagCounters counters[(int)Tag::COUNT];
+			return counters;
+		}
+
+		void UpdatePeak(std::atomic<uint64>& peak, uint64 value)
+		{
+			uint64 previous = peak.load(std::memory_order_relaxed);
+			while (value > previous && !peak.compare_exchange_weak(previous, value, std::memory_order_relaxed));
+		}
+	}
+}
+
+const char* MemoryTracker::GetTagName(Tag tag)
+{
+	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
+	static const char* names[(int)Tag::COUNT] =
+	{
+		"GameObjects", "Components", "Particles", "Editor", "Importer",
+		"Folders", "Meshes", "Textures", "Materials", "Animations", "Animator Controllers",
+		"Models", "Particle Systems", "Shaders", "Scenes", "Unknown Resources"
+	};
+	return (int)tag >= 0 && tag < Tag::COUNT ? names[(int)tag] : "Invalid";
+}
+
+void MemoryTracker::OnAllocate(Tag tag, uint64 bytes)
+{
+	Private::TagCounters& counters = Private::GetCounters()[(int)tag];
+	uint64 live = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	Private::UpdatePeak(counters.peakBytes, live);
+	counters.liveCount.fetch_add(1, std::memory_order_relaxed);
+	counters.allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::OnFree(Tag tag, uint64 bytes)
+{
+	Private::TagCounters& counters = Private::GetCounters()[(int)tag];
+	counters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+	counters.liveCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::OnGPUAllocate(Tag tag, uint64 bytes)
+{
+	Private::TagCounters& counters = Private::GetCounters()[(int)tag];
+	uint64 live = counters.gpuBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	Private::UpdatePeak(counters.gpuPeakBytes, live);
+}
+
+void MemoryTracker::OnGPUFree(Tag tag, uint64 bytes)
+{
+	Private::GetCounters()[(int)tag].gpuBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryTracker::Stats MemoryTracker::GetStats(Tag tag)
+{
+	const Private::TagCounters& counters = Private::GetCounters()[(int)tag];
+
+	Stats stats;
+	stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	stats.liveCount = counters.liveCount.load(std::memory_order_relaxed);
+	stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+	stats.gpuBytes = counters.gpuBytes.load(std::memory_order_relaxed);
+	stats.gpuPeakBytes = counters.gpuPeakBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+MemoryTracker::Stats MemoryTracker::GetTotalStats()
+{
+	Stats total;
+	for (int i = 0; i < (int)Tag::COUNT; ++i)
+	{
+		Stats stats = GetStats((Tag)i);
+		total.liveBytes += stats.liveBytes;
+		total.peakBytes += stats.peakBytes;
+		total.liveCount += stats.liveCount;
+		total.allocations += stats.allocations;
+		total.gpuBytes += stats.gpuBytes;
+		total.gpuPeakBytes += stats.gpuPeakBytes;
+	}
+	return total;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+	for (int i = 0; i < (int)Tag::COUNT; ++i)
+	{
+		Private::TagCounters& counters = Private::GetCounters()[i];
+		counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		counters.gpuPeakBytes.store(counters.gpuBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+void MemoryTracker::Save(Config& config)
+{
+	Config_Array tags = config.SetArray("Tags");
+	for (int i = 0; i <= (int)Tag::COUNT; ++i)
+	{
+		Stats stats = i < (int)Tag::COUNT ? GetStats((Tag)i) : GetTotalStats();
+
+		Config node = tags.AddNode();
+		node.SetString("Tag", i < (int)Tag::COUNT ? GetTagName((Tag)i) : "Total");
+		node.SetNumber("Live Bytes", (double)stats.liveBytes);
+		node.SetNumber("Peak Bytes", (double)stats.peakBytes);
+		node.SetNumber("Live Count", (double)stats.liveCount);
+		node.SetNumber("Allocations", (double)stats.allocations);
+		node.SetNumber("GPU Bytes", (double)stats.gpuBytes);
+		node.SetNumber("GPU Peak Bytes", (double)stats.gpuPeakBytes);
+	}
+}
+
+bool MemoryTracker::SaveReport(const char* file)
+{
+	Config config;
+	Save(config);
+
+	char* buffer = nullptr;
+	uint size = config.Serialize(&buffer);
+
+	//Serialized size includes the null terminator
+	bool ret = Engine->fileSystem->Save(file, buffer, size - 1) == size - 1;
+	RELEASE_ARRAY(buffer);
+
+	if (ret == false)
+		LOG("[error] Could not write memory report to '%s'", file);
+	return ret;
+}
@@ -0,0 +1,91 @@
+#ifndef __MEMORY_TRACKER_H__
+#define __MEMORY_TRACKER_H__
+
+#include "Globals.h"
+#include "ResourceBase.h"
+
+#include <new>
+
+class Config;
+
+//Memory accounting grouped by engine subsystem and by resource type
+//Classes declared with MEMORY_TAG report every allocation of their instances. Resources report
+//an estimate of the CPU and GPU memory they hold once loaded (see Resource::UpdateMemoryUsage)
+namespace MemoryTracker
+{
+	enum class Tag
+	{
+		GAMEOBJECTS,
+		COMPONENTS,
+		PARTICLES,
+		EDITOR,
+		IMPORTER,		//Scratch buffers used while importing and loading resources
+		RESOURCES,		//First resource tag, followed by one tag per ResourceType
+		COUNT = RESOURCES + (int)ResourceType::UNKNOWN + 1
+	};
+
+	struct Stats
+	{
+		uint64 liveBytes = 0;
+		uint64 peakBytes = 0;
+		uint64 liveCount = 0;		//Allocations not freed yet
+		uint64 allocations = 0;		//Allocations since the engine started
+		uint64 gpuBytes = 0;
+		uint64 gpuPeakBytes = 0;
+	};
+
+	inline Tag GetResourceTag(ResourceType type) { return (Tag)((int)Tag::RESOURCES + (int)type); }
+	const char* GetTagName(Tag tag);
+
+	void OnAllocate(Tag tag, uint64 bytes);
+	void OnFree(Tag tag, uint64 bytes);
+	void OnGPUAllocate(Tag tag, uint64 bytes);
+	void OnGPUFree(Tag tag, uint64 bytes);
+
+	Stats GetStats(Tag tag);
+	Stats GetTotalStats();
+
+	//Peaks restart from the live values, to measure the peak of a single operation
+	void ResetPeaks();
+
+	//Writes the stats of every tag as a "Tags" array. Totals are not peak accurate: every tag peaks at a different time
+	void Save(Config& config);
+	bool SaveReport(const char* file);
+
+	//STL allocator reporting to a tag, for containers owned by a tracked subsystem
+	template<typename T, Tag tag>
+	struct Allocator
+	{
+		typedef T value_type;
+		template<typename U> struct rebind { typedef Allocator<U, tag> other; };
+
+		Allocator() {}
+		template<typename U> Allocator(const Allocator<U, tag>&) {}
+
+		T* allocate(size_t count)
+		{
+			OnAllocate(tag, count * sizeof(T));
+			return (T*)::operator new(count * sizeof(T));
+		}
+
+		void deallocate(T* ptr, size_t count)
+		{
+			OnFree(tag, count * sizeof(T));
+			::operator delete(ptr);
+		}
+
+		bool operator==(const Allocator&) const { return true; }
+		bool operator!=(const Allocator&) const { return false; }
+	};
+}
+
+//Class level allocation operators reporting every instance (derived classes included) to a tag
+//Sized delete gets the dynamic size as long as the class has a virtual destructor
+#define MEMORY_TAG(tag)\
+public:\
+	static void* operator new(size_t size) { MemoryTracker::OnAllocate(tag, size); return ::operator new(size); }\
+	static void* operator new[](size_t size) { MemoryTracker::OnAllocate(tag, size); return ::operator new[](size); }\
+	static void operator delete(void* ptr, size_t size) { MemoryTracker::OnFree(tag, size); ::operator delete(ptr); }\
+	static void operator delete[](void* ptr, size_t size) { MemoryTracker::OnFree(tag, size); ::operator delete[](ptr); }
+
+#endif //__MEMORY_TRACKER_H__
@@ -0,0 +1,207 @@
+#ifndef __NULL_GL_H__
+#define __NULL_GL_H__
+
+//Null rendering backend used by headless builds (THOR_HEADLESS)
+//Declares the subset of the OpenGL API the engine calls as no-op functions,
+//so scene, resources and renderer code can run without a window or GL context.
+//Object creation functions hand out unique names so resources keep a valid state.
+
+#include <string.h>
+#include <stdint.h>
+
+typedef unsigned int	GLenum;
+typedef unsigned char	GLboolean;
+typedef unsigned int	GLbitfield;
+typedef int				GLint;
+typedef int				GLsizei;
+typedef unsigned int	GLuint;
+typedef float			GLfloat;
+typedef float			GLclampf;
+typedef double			GLclampd;
+typedef char			GLchar;
+typedef unsigned char	GLubyte;
+typedef long			GLsizeiptr;
+typedef void			GLvoid;
+
+#define GL_FALSE						0
+#define GL_TRUE							1
+#define GL_NO_ERROR						0
+
+#define GL_LINES						0x0001
+#define GL_TRIANGLES					0x0004
+#define GL_CCW							0x0901
+#define GL_LINE_SMOOTH					0x0B20
+#define GL_CULL_FACE					0x0B44
+#define GL_LIGHTING						0x0B50
+#define GL_LIGHT_MODEL_AMBIENT			0x0B53
+#define GL_COLOR_MATERIAL				0x0B57
+#define GL_DEPTH_TEST					0x0B71
+#define GL_BLEND						0x0BE2
+#define GL_PERSPECTIVE_CORRECTION_HINT	0x0C50
+#define GL_LINE_SMOOTH_HINT				0x0C52
+#define GL_TEXTURE_2D					0x0DE1
+#define GL_NICEST						0x1102
+#define GL_AMBIENT						0x1200
+#define GL_DIFFUSE						0x1201
+#define GL_POSITION						0x1203
+#define GL_UNSIGNED_BYTE				0x1401
+#define GL_UNSIGNED_INT					0x1405
+#define GL_FLOAT						0x1406
+#define GL_MODELVIEW					0x1700
+#define GL_PROJECTION					0x1701
+#define GL_DEPTH_COMPONENT				0x1902
+#define GL_RGB							0x1907
+#define GL_RGBA							0x1908
+#define GL_SMOOTH						0x1D01
+#define GL_LINEAR						0x2601
+#define GL_TEXTURE_MAG_FILTER			0x2800
+#define GL_TEXTURE_MIN_FILTER			0x2801
+#define GL_LIGHT0						0x4000
+#define GL_FRONT_AND_BACK				0x0408
+#define GL_SRC_ALPHA					0x0302
+#define GL_ONE_MINUS_SRC_ALPHA			0x0303
+#define GL_FUNC_ADD						0x8006
+#define GL_PROGRAM_BINARY_LENGTH		0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS	0x87FE
+#define GL_ARRAY_BUFFER					0x8892
+#define GL_ELEMENT_ARRAY_BUFFER			0x8893
+#define GL_STREAM_DRAW					0x88E0
+#define GL_STATIC_DRAW					0x88E4
+#define GL_FRAGMENT_SHADER				0x8B30
+#define GL_VERTEX_SHADER				0x8B31
+#define GL_COMPILE_STATUS				0x8B81
+#define GL_LINK_STATUS					0x8B82
+#define GL_FRAMEBUFFER_COMPLETE			0x8CD5
+#define GL_COLOR_ATTACHMENT0			0x8CE0
+#define GL_DEPTH_ATTACHMENT				0x8D00
+#define GL_FRAMEBUFFER					0x8D40
+#define GL_RENDERBUFFER					0x8D41
+
+#define GL_COLOR_BUFFER_BIT				0x00004000
+#define GL_DEPTH_BUFFER_BIT				0x00000100
+
+namespace NullGL
+{
+	//Work submitted to the null context, so headless runs can report what a frame would have drawn
+	//Counters only grow, reset them between frames if needed
+	struct Capture
+	{
+		uint64_t drawCalls = 0;
+		uint64_t drawnIndices = 0;
+		uint64_t immediateBatches = 0;	//glBegin / glEnd pairs
+		uint64_t uploadedBytes = 0;		//glBufferData
+		uint64_t generatedNames = 0;	//glGen* object names
+		uint64_t deletedNames = 0;		//glDelete* object names, 0 is ignored as in GL
+	};
+
+	inline Capture& GetCapture()
+	{
+		static Capture capture;
+		return capture;
+	}
+
+	//Returns a new unique object name, as glGen* functions would
+	inline GLuint NextName()
+	{
+		static GLuint lastName = 0;
+		return ++lastName;
+	}
+
+	inline void GenNames(GLsizei n, GLuint* names)
+	{
+		for (GLsizei i = 0; i < n; ++i)
+			names[i] = NextName();
+		GetCapture().generatedNames += n;
+	}
+
+	inline void DeleteNames(GLsizei n, const GLuint* names)
+	{
+		for (GLsizei i = 0; i < n; ++i)
+			GetCapture().deletedNames += names[i] != 0;
+	}
+}
+
+//Context state ------------------------------
+inline GLenum glGetError() { return GL_NO_ERROR; }
+inline const GLubyte* gluErrorString(GLenum) { return (const GLubyte*)""; }
+inline void glEnable(GLenum) {}
+inline void glDisable(GLenum) {}
+inline void glHint(GLenum, GLenum) {}
+inline void glGetIntegerv(GLenum, GLint* data) { *data = 0; }
+inline void glViewport(GLint, GLint, GLsizei, GLsizei) {}
+inline void glClear(GLbitfield) {}
+inline void glClearColor(GLclampf, GLclampf, GLclampf, GLclampf) {}
+inline void glClearDepth(GLclampd) {}
+inline void glBlendEquation(GLenum) {}
+inline void glBlendFunc(GLenum, GLenum) {}
+inline void glFrontFace(GLenum) {}
+inline void glShadeModel(GLenum) {}
+inline void glLineWidth(GLfloat) {}
+inline void glReadPixels(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, GLvoid*) {}
+
+//Fixed pipeline -----------------------------
+inline void glMatrixMode(GLenum) {}
+inline void glLoadIdentity() {}
+inline void glLoadMatrixf(const GLfloat*) {}
+inline void glMultMatrixf(const GLfloat*) {}
+inline void glPushMatrix() {}
+inline void glPopMatrix() {}
+inline void glBegin(GLenum) { NullGL::GetCapture().immediateBatches++; }
+inline void glEnd() {}
+inline void glVertex3f(GLfloat, GLfloat, GLfloat) {}
+inline void glVertex3fv(const GLfloat*) {}
+inline void glTexCoord2f(GLfloat, GLfloat) {}
+inline void glColor3f(GLfloat, GLfloat, GLfloat) {}
+inline void glColor4f(GLfloat, GLfloat, GLfloat, GLfloat) {}
+inline void glLightfv(GLenum, GLenum, const GLfloat*) {}
+inline void glLightModelfv(GLenum, const GLfloat*) {}
+inline void glMaterialfv(GLenum, GLenum, const GLfloat*) {}
+
+//Buffers and vertex arrays ------------------
+inline void glGenBuffers(GLsizei n, GLuint* buffers) { NullGL::GenNames(n, buffers); }
+inline void glDeleteBuffers(GLsizei n, const GLuint* buffers) { NullGL::DeleteNames(n, buffers); }
+inline void glBindBuffer(GLenum, GLuint) {}
+inline void glBufferData(GLenum, GLsizeiptr size, const GLvoid*, GLenum) { NullGL::GetCapture().uploadedBytes += size; }
+inline void glGenVertexArrays(GLsizei n, GLuint* arrays) { NullGL::GenNames(n, arrays); }
+inline void glDeleteVertexArrays(GLsizei n, const GLuint* arrays) { NullGL::DeleteNames(n, arrays); }
+inline void glBindVertexArray(GLuint) {}
+inline void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const GLvoid*) {}
+inline void glEnableVertexAttribArray(GLuint) {}
+inline void glDrawElements(GLenum, GLsizei count, GLenum, const GLvoid*) { NullGL::GetCapture().drawCalls++; NullGL::GetCapture().drawnIndices += count; }
+
+//Textures and frame buffers -----------------
+inline void glGenTextures(GLsizei n, GLuint* textures) { NullGL::GenNames(n, textures); }
+inline void glDeleteTextures(GLsizei n, const GLuint* textures) { NullGL::DeleteNames(n, textures); }
+inline void glBindTexture(GLenum, GLuint) {}
+inline void glTexParameteri(GLenum, GLenum, GLint) {}
+inline void glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) {}
+inline void glGenFramebuffers(GLsizei n, GLuint* framebuffers) { NullGL::GenNames(n, framebuffers); }
+inline void glBindFramebuffer(GLenum, GLuint) {}
+inline void glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) {}
+inline void glFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) {}
+inline GLenum glCheckFramebufferStatus(GLenum) { return GL_FRAMEBUFFER_COMPLETE; }
+inline void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers) { NullGL::GenNames(n, renderbuffers); }
+inline void glBindRenderbuffer(GLenum, GLuint) {}
+inline void glRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) {}
+
+//Shaders ------------------------------------
+inline GLuint glCreateShader(GLenum) { return NullGL::NextName(); }
+inline void glDeleteShader(GLuint) {}
+inline void glShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) {}
+inline void glCompileShader(GLuint) {}
+inline void glGetShaderiv(GLuint, GLenum, GLint* params) { *params = GL_TRUE; }
+inline void glGetShaderInfoLog(GLuint, GLsizei, GLsizei* length, GLchar* infoLog) { if (length) *length = 0; if (infoLog) infoLog[0] = '\0'; }
+inline GLuint glCreateProgram() { return NullGL::NextName(); }
+inline void glDeleteProgram(GLuint) {}
+inline void glAttachShader(GLuint, GLuint) {}
+inline void glLinkProgram(GLuint) {}
+inline void glUseProgram(GLuint) {}
+inline void glGetProgramiv(GLuint, GLenum pname, GLint* params) { *params = (pname == GL_LINK_STATUS) ? GL_TRUE : 0; }
+inline void glGetProgramInfoLog(GLuint, GLsizei, GLsizei* length, GLchar* infoLog) { if (length) *length = 0; if (infoLog) infoLog[0] = '\0'; }
+inline void glGetProgramBinary(GLuint, GLsizei, GLsizei* length, GLenum*, GLvoid*) { if (length) *length = 0; }
+inline void glProgramBinary(GLuint, GLenum, const GLvoid*, GLsizei) {}
+inline GLint glGetUniformLocation(GLuint, const GLchar*) { return -1; }
+inline void glUniform4fv(GLint, GLsizei, const GLfloat*) {}
+inline void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+
+#endif //__NULL_GL_H__
@@ -1,11 +1,15 @@
 #ifndef __OPENGL_H__
 #define __OPENGL_H__
 
+#ifdef THOR_HEADLESS
+#include "NullGL.h"
+#else
 #define WIN32_MEAN_AND_LEAN
 #include <Windows.h>
 #include "Glew/include/glew.h" // extension lib
 #include "SDL/include/SDL_opengl.h"
 #include <gl/GL.h>
 #include <gl/GLU.h>
+#endif
 
-#endif
\ No newline at end of file
+#endif
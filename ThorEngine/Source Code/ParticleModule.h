@@ -29,6 +29,7 @@ struct ParticleModule
 	} type;
 
 	ParticleModule(Type type) : type(type) {};
+	virtual ~ParticleModule() {};
 
 	virtual void Spawn(EmitterInstance* emitter, Particle* particle) = 0;
 	virtual void Update(float dt, EmitterInstance* emitter) = 0;
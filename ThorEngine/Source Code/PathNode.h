@@ -1,6 +1,8 @@
 #ifndef __PATHNODE_H__
 #define __PATHNODE_H__
 
+#include "Globals.h"
+
 #include <string>
 #include <vector>
 
@@ -16,6 +18,7 @@ struct PathNode
 
 	bool isLeaf = true;
 	bool isFile = true;
+	uint64 modTime = 0;		//As GetLastModTime, read when the tree was scanned
 
 	bool IsLastFolder() const
 	{
@@ -25,7 +28,7 @@ struct PathNode
 		return true;
 	}
 
-	bool operator ==(const PathNode node) const
+	bool operator ==(const PathNode& node) const
 	{
 		return path == node.path;
 	}
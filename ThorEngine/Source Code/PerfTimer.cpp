@@ -4,7 +4,33 @@
 // ----------------------------------------------------
 
 #include "PerfTimer.h"
-#include "SDL\include\SDL_timer.h"
+
+#ifdef THOR_HEADLESS
+#include <chrono>
+
+//Headless builds do not link SDL. Nanosecond ticks from the steady clock
+static uint64 GetPerformanceCounter()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64 GetPerformanceFrequency()
+{
+	return 1000000000ull;
+}
+#else
+#include "SDL/include/SDL_timer.h"
+
+static uint64 GetPerformanceCounter()
+{
+	return SDL_GetPerformanceCounter();
+}
+
+static uint64 GetPerformanceFrequency()
+{
+	return SDL_GetPerformanceFrequency();
+}
+#endif
 
 uint64 PerfTimer::frequency = 0;
 
@@ -12,7 +38,7 @@ uint64 PerfTimer::frequency = 0;
 PerfTimer::PerfTimer()
 {
 	if (frequency == 0)
-		frequency = SDL_GetPerformanceFrequency();
+		frequency = GetPerformanceFrequency();
 
 	Start();
 }
@@ -20,19 +46,19 @@ PerfTimer::PerfTimer()
 // ---------------------------------------------
 void PerfTimer::Start()
 {
-	started_at = SDL_GetPerformanceCounter();
+	started_at = GetPerformanceCounter();
 }
 
 // ---------------------------------------------
 double PerfTimer::ReadMs() const
 {
-	return 1000.0 * (double(SDL_GetPerformanceCounter() - started_at) / double(frequency));
+	return 1000.0 * (double(GetPerformanceCounter() - started_at) / double(frequency));
 }
 
 // ---------------------------------------------
 uint64 PerfTimer::ReadTicks() const
 {
-	return SDL_GetPerformanceCounter() - started_at;
+	return GetPerformanceCounter() - started_at;
 }
 
 
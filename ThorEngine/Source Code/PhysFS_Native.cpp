@@ -0,0 +1,313 @@
+// ----------------------------------------------------
+// PhysFS_Native.cpp
+// Native implementation of the PhysFS calls used by M_FileSystem
+// Only compiled in headless builds, where the PhysFS binaries are not available
+// ----------------------------------------------------
+
+#ifdef THOR_HEADLESS
+
+#include "PhysFS/include/physfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	//Files are opened from the I/O and import threads while the main thread mounts directories
+	std::shared_mutex pathMutex;
+	std::vector<std::string> searchPath;
+	std::string writeDir;
+	//Per thread, as in PhysFS: failed lookups happen on several threads at once
+	thread_local std::string lastError;
+
+	std::vector<std::string> GetSearchPath()
+	{
+		std::shared_lock<std::shared_mutex> lock(pathMutex);
+		return searchPath;
+	}
+
+	std::string GetWriteDir()
+	{
+		std::shared_lock<std::shared_mutex> lock(pathMutex);
+		return writeDir;
+	}
+
+	//Converts a PhysFS platform-independent path into a real path relative to 'root'
+	std::string RealPath(const std::string& root, const char* file)
+	{
+		std::string ret = root;
+		if (file != nullptr && file[0] != '\0')
+		{
+			if (ret.empty() == false && ret.back() != '/')
+				ret.append("/");
+			ret.append(file[0] == '/' ? file + 1 : file);
+		}
+		return ret;
+	}
+
+	//Fills 'dir' with the search path element containing 'file'. Returns false if not found
+	bool FindRealDir(const char* file, std::string& dir)
+	{
+		std::error_code error;
+		std::shared_lock<std::shared_mutex> lock(pathMutex);
+		for (size_t i = 0; i < searchPath.size(); ++i)
+		{
+			if (fs::exists(RealPath(searchPath[i], file), error))
+			{
+				dir = searchPath[i];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	char** CreateList(const std::vector<std::string>& strings)
+	{
+		char** list = (char**)malloc(sizeof(char*) * (strings.size() + 1));
+		for (size_t i = 0; i < strings.size(); ++i)
+		{
+			list[i] = (char*)malloc(strings[i].size() + 1);
+			memcpy(list[i], strings[i].c_str(), strings[i].size() + 1);
+		}
+		list[strings.size()] = nullptr;
+		return list;
+	}
+
+	PHYSFS_File* OpenFile(const std::string& path, const char* mode)
+	{
+		FILE* file = fopen(path.c_str(), mode);
+		if (file == nullptr)
+		{
+			lastError = std::string("could not open ") + path;
+			return nullptr;
+		}
+		PHYSFS_File* handle = new PHYSFS_File;
+		handle->opaque = file;
+		return handle;
+	}
+}
+
+int PHYSFS_init(const char* /*argv0*/)
+{
+	return 1;
+}
+
+int PHYSFS_deinit(void)
+{
+	std::unique_lock<std::shared_mutex> lock(pathMutex);
+	searchPath.clear();
+	writeDir.clear();
+	return 1;
+}
+
+void PHYSFS_freeList(void* listVar)
+{
+	if (listVar != nullptr)
+	{
+		for (char** i = (char**)listVar; *i != nullptr; ++i)
+			free(*i);
+		free(listVar);
+	}
+}
+
+const char* PHYSFS_getLastError(void)
+{
+	return lastError.c_str();
+}
+
+const char* PHYSFS_getBaseDir(void)
+{
+	static std::string baseDir;
+	baseDir = fs::current_path().generic_string() + "/";
+	return baseDir.c_str();
+}
+
+const char* PHYSFS_getWriteDir(void)
+{
+	return writeDir.empty() ? nullptr : writeDir.c_str();
+}
+
+int PHYSFS_setWriteDir(const char* newDir)
+{
+	std::unique_lock<std::shared_mutex> lock(pathMutex);
+	writeDir = newDir ? newDir : "";
+	return 1;
+}
+
+char** PHYSFS_getSearchPath(void)
+{
+	//PhysFS returns a list the caller must free. M_FileSystem only reads the first entry,
+	//so we keep a persistent list to avoid leaking on every call. One per thread: it is valid until the next call
+	thread_local std::vector<char*> list;
+	thread_local std::vector<std::string> listStrings;
+
+	listStrings = GetSearchPath();
+	list.clear();
+	for (size_t i = 0; i < listStrings.size(); ++i)
+		list.push_back((char*)listStrings[i].c_str());
+	list.push_back(nullptr);
+
+	return list.data();
+}
+
+int PHYSFS_mount(const char* newDir, const char* /*mountPoint*/, int appendToPath)
+{
+	std::error_code error;
+	if (newDir == nullptr || fs::is_directory(newDir, error) == false)
+	{
+		lastError = std::string("not a directory: ") + (newDir ? newDir : "");
+		return 0;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(pathMutex);
+	if (std::find(searchPath.begin(), searchPath.end(), newDir) == searchPath.end())
+	{
+		if (appendToPath)
+			searchPath.push_back(newDir);
+		else
+			searchPath.insert(searchPath.begin(), newDir);
+	}
+	return 1;
+}
+
+int PHYSFS_mkdir(const char* dirName)
+{
+	std::error_code error;
+	fs::create_directories(RealPath(GetWriteDir(), dirName), error);
+	if (error)
+	{
+		lastError = error.message();
+		return 0;
+	}
+	return 1;
+}
+
+int PHYSFS_delete(const char* filename)
+{
+	std::error_code error;
+	if (fs::remove(RealPath(GetWriteDir(), filename), error) == false)
+	{
+		lastError = error ? error.message() : std::string("file not found");
+		return 0;
+	}
+	return 1;
+}
+
+const char* PHYSFS_getRealDir(const char* filename)
+{
+	//Valid until the next call from the same thread
+	thread_local std::string dir;
+	return FindRealDir(filename, dir) ? dir.c_str() : nullptr;
+}
+
+char** PHYSFS_enumerateFiles(const char* dir)
+{
+	std::vector<std::string> entries;
+	std::vector<std::string> paths = GetSearchPath();
+	std::error_code error;
+
+	for (size_t i = 0; i < paths.size(); ++i)
+	{
+		fs::directory_iterator it(RealPath(paths[i], dir), error);
+		if (error)
+		{
+			error.clear();
+			continue;
+		}
+		for (; it != fs::directory_iterator(); it.increment(error))
+			entries.push_back(it->path().filename().generic_string());
+	}
+
+	//Same as PhysFS: sorted and without duplicates from different search paths
+	std::sort(entries.begin(), entries.end());
+	entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+	return CreateList(entries);
+}
+
+int PHYSFS_exists(const char* fname)
+{
+	std::string dir;
+	return FindRealDir(fname, dir);
+}
+
+int PHYSFS_isDirectory(const char* fname)
+{
+	std::error_code error;
+	std::string dir;
+	return FindRealDir(fname, dir) && fs::is_directory(RealPath(dir, fname), error);
+}
+
+PHYSFS_sint64 PHYSFS_getLastModTime(const char* filename)
+{
+	std::string dir;
+	if (FindRealDir(filename, dir) == false)
+		return -1;
+
+	struct stat fileStat;
+	if (stat(RealPath(dir, filename).c_str(), &fileStat) != 0)
+		return -1;
+
+	return (PHYSFS_sint64)fileStat.st_mtime;
+}
+
+PHYSFS_File* PHYSFS_openWrite(const char* filename)
+{
+	return OpenFile(RealPath(GetWriteDir(), filename), "wb");
+}
+
+PHYSFS_File* PHYSFS_openAppend(const char* filename)
+{
+	return OpenFile(RealPath(GetWriteDir(), filename), "ab");
+}
+
+PHYSFS_File* PHYSFS_openRead(const char* filename)
+{
+	std::string dir;
+	if (FindRealDir(filename, dir) == false)
+	{
+		lastError = std::string("file not found: ") + (filename ? filename : "");
+		return nullptr;
+	}
+	return OpenFile(RealPath(dir, filename), "rb");
+}
+
+int PHYSFS_close(PHYSFS_File* handle)
+{
+	int ret = fclose((FILE*)handle->opaque) == 0;
+	delete handle;
+	return ret;
+}
+
+PHYSFS_sint64 PHYSFS_read(PHYSFS_File* handle, void* buffer, PHYSFS_uint32 objSize, PHYSFS_uint32 objCount)
+{
+	return (PHYSFS_sint64)fread(buffer, objSize, objCount, (FILE*)handle->opaque);
+}
+
+PHYSFS_sint64 PHYSFS_write(PHYSFS_File* handle, const void* buffer, PHYSFS_uint32 objSize, PHYSFS_uint32 objCount)
+{
+	return (PHYSFS_sint64)fwrite(buffer, objSize, objCount, (FILE*)handle->opaque);
+}
+
+PHYSFS_sint64 PHYSFS_fileLength(PHYSFS_File* handle)
+{
+	FILE* file = (FILE*)handle->opaque;
+	long current = ftell(file);
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, current, SEEK_SET);
+	return (PHYSFS_sint64)length;
+}
+
+#endif //THOR_HEADLESS
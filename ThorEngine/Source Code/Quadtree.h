@@ -1,7 +1,7 @@
 #ifndef __QUADTREE_H__
 #define __QUADTREE_H__
 
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 #include "Globals.h"
 #include <map>
 
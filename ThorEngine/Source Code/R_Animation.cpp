@@ -63,4 +63,20 @@ R_Animation::R_Animation() : Resource(ResourceType::ANIMATION)
 R_Animation::~R_Animation()
 {
 
-}
\ No newline at end of file
+}
+
+uint64 R_Animation::GetCPUMemory() const
+{
+	//Map nodes hold the pair plus the tree links
+	const uint64 nodeLinks = 4 * sizeof(void*);
+
+	uint64 bytes = sizeof(R_Animation);
+	for (std::map<std::string, Channel>::const_iterator it = channels.begin(); it != channels.end(); ++it)
+	{
+		const Channel& channel = it->second;
+		bytes += sizeof(*it) + nodeLinks + it->first.capacity() + channel.name.capacity();
+		bytes += (sizeof(std::pair<const double, float3>) + nodeLinks) * (channel.positionKeys.size() + channel.scaleKeys.size());
+		bytes += (sizeof(std::pair<const double, Quat>) + nodeLinks) * channel.rotationKeys.size();
+	}
+	return bytes;
+}
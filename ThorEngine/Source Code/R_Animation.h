@@ -2,7 +2,7 @@
 #define __R_ANIMATION_H__
 
 #include "Resource.h"
-#include "MathGeoLib\src\MathGeoLib.h"
+#include "MathGeoLib/src/MathGeoLib.h"
 
 #include <map>
 
@@ -34,6 +34,8 @@ public:
 	R_Animation();
 	~R_Animation();
 
+	uint64 GetCPUMemory() const override;
+
 	float duration;
 	float ticksPerSecond;
 	bool loopable = true;
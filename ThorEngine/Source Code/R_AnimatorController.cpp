@@ -18,4 +18,13 @@ void R_AnimatorController::AddAnimation()
 void R_AnimatorController::AddAnimation(uint64 animationID)
 {
 	animations.push_back(animationID);
-}
\ No newline at end of file
+}
+
+void R_AnimatorController::GetDependencies(std::vector<uint64>& dependencies) const
+{
+	for (uint i = 0; i < animations.size(); ++i)
+	{
+		if (animations[i] != 0)
+			dependencies.push_back(animations[i]);
+	}
+}
@@ -16,6 +16,8 @@ public:
 	void AddAnimation();
 	void AddAnimation(uint64 animationID);
 
+	void GetDependencies(std::vector<uint64>& dependencies) const override;
+
 public:
 	std::vector<uint64> animations;
 };
@@ -14,3 +14,9 @@ R_Material::~R_Material()
 {
 
 }
+
+void R_Material::GetDependencies(std::vector<uint64>& dependencies) const
+{
+	if (hShader.GetID() != 0) dependencies.push_back(hShader.GetID());
+	if (hTexture.GetID() != 0) dependencies.push_back(hTexture.GetID());
+}
@@ -17,6 +17,8 @@ public:
 	R_Material();
 	~R_Material();
 
+	void GetDependencies(std::vector<uint64>& dependencies) const override;
+
 public:
 	ResourceHandle<R_Shader> hShader;
 	ResourceHandle<R_Texture> hTexture;
@@ -1,5 +1,6 @@
 #include "R_Mesh.h"
 #include "OpenGL.h"
+#include "MappedFile.h"
 
 R_Mesh::R_Mesh() : Resource(ResourceType::MESH)
 {
@@ -13,7 +14,16 @@ R_Mesh::R_Mesh() : Resource(ResourceType::MESH)
 
 R_Mesh::~R_Mesh()
 {
-
+	if (mappedFile == nullptr)
+	{
+		RELEASE_ARRAY(indices);
+		RELEASE_ARRAY(vertices);
+		RELEASE_ARRAY(normals);
+		RELEASE_ARRAY(tex_coords);
+		RELEASE_ARRAY(boneIDs);
+		RELEASE_ARRAY(boneWeights);
+	}
+	RELEASE(mappedFile);
 }
 
 void R_Mesh::CreateAABB()
@@ -45,8 +55,8 @@ void R_Mesh::LoadOnMemory()
 	//Create the array buffer for tex coords and enable attrib pointer
 	if (buffersSize[b_tex_coords] > 0)
 	{
-		glGenBuffers(1, &buffers[b_normals]);
-		glBindBuffer(GL_ARRAY_BUFFER, buffers[b_normals]);
+		glGenBuffers(1, &buffers[b_tex_coords]);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[b_tex_coords]);
 		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * buffersSize[b_tex_coords] * 2, tex_coords, GL_STATIC_DRAW);
 
 		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
@@ -121,5 +131,45 @@ void R_Mesh::LoadSkinnedBuffers(bool init)
 
 void R_Mesh::FreeMemory()
 {
-	//glDeleteBuffers(max_buffer_type, buffers);
-}
\ No newline at end of file
+	//Buffers never created keep name 0, ignored by glDelete*
+	glDeleteBuffers(max_buffer_type, buffers);
+	glDeleteVertexArrays(1, &VAO);
+
+	for (uint i = 0; i < max_buffer_type; i++)
+		buffers[i] = 0;
+	VAO = 0;
+}
+
+uint64 R_Mesh::GetCPUMemory() const
+{
+	//Mapped arrays are backed by the library file, the system reclaims their pages when needed
+	uint64 bytes = sizeof(R_Mesh);
+	if (mappedFile == nullptr)
+	{
+		if (indices) bytes += sizeof(uint) * buffersSize[b_indices];
+		if (vertices) bytes += sizeof(float) * buffersSize[b_vertices] * 3;
+		if (normals) bytes += sizeof(float) * buffersSize[b_normals] * 3;
+		if (tex_coords) bytes += sizeof(float) * buffersSize[b_tex_coords] * 2;
+		if (boneIDs) bytes += sizeof(int) * buffersSize[b_bone_IDs];
+		if (boneWeights) bytes += sizeof(float) * buffersSize[b_bone_weights];
+	}
+
+	//Map nodes hold the pair plus the tree links
+	for (std::map<std::string, uint>::const_iterator it = boneMapping.begin(); it != boneMapping.end(); ++it)
+		bytes += sizeof(*it) + 4 * sizeof(void*) + it->first.capacity();
+
+	bytes += sizeof(float4x4) * (boneTransforms.capacity() + boneOffsets.capacity());
+	return bytes;
+}
+
+uint64 R_Mesh::GetGPUMemory() const
+{
+	//Same buffers LoadOnMemory and LoadSkinnedBuffers upload
+	if (VAO == 0)
+		return 0;
+
+	uint64 bytes = sizeof(uint) * buffersSize[b_indices] + sizeof(float) * buffersSize[b_vertices] * 3;
+	bytes += sizeof(float) * buffersSize[b_normals] * 3;
+	bytes += sizeof(float) * buffersSize[b_tex_coords] * 2;
+	return bytes;
+}
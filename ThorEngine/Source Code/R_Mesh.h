@@ -9,6 +9,8 @@
 #include "MathGeoLib/src/Geometry/AABB.h"
 #include "MathGeoLib/src/Math/float4x4.h"
 
+class MappedFile;
+
 struct Bone
 {
 	uint numWeights = 0;
@@ -42,12 +44,18 @@ public:
 
 	void FreeMemory();
 
+	uint64 GetCPUMemory() const override;
+	uint64 GetGPUMemory() const override;
+
 public:
 
 	uint VAO = 0;
 	uint buffers[max_buffer_type];
 	uint buffersSize[max_buffer_type];
 
+	//Loaded from a mapped library file, the arrays below point into 'mappedFile' and are read-only
+	MappedFile* mappedFile = nullptr;
+
 	uint*	indices = nullptr;
 	float*	vertices = nullptr;
 	float*	normals = nullptr;
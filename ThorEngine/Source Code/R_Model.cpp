@@ -1,5 +1,7 @@
 #include "R_Model.h"
 
+#include "GameObject.h"
+
 R_Model::R_Model() : Resource(ResourceType::MODEL)
 {
 	isExternal = true;
@@ -8,4 +10,18 @@ R_Model::R_Model() : Resource(ResourceType::MODEL)
 R_Model::~R_Model()
 {
 
-}
\ No newline at end of file
+}
+
+void R_Model::GetDependencies(std::vector<uint64>& dependencies) const
+{
+	for (uint i = 0; i < nodes.size(); ++i)
+	{
+		if (nodes[i].meshID > 0) dependencies.push_back(nodes[i].meshID);
+		if (nodes[i].materialID > 0) dependencies.push_back(nodes[i].materialID);
+	}
+	for (uint i = 0; i < animationIDs.size(); ++i)
+		dependencies.push_back(animationIDs[i]);
+
+	if (root != nullptr)
+		root->CollectResources(dependencies);
+}
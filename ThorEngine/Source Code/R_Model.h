@@ -34,6 +34,9 @@ public:
 	R_Model();
 	~R_Model();
 
+	//Node resources when imported, component resources once loaded: only one of both is filled
+	void GetDependencies(std::vector<uint64>& dependencies) const override;
+
 	GameObject* root = nullptr; //By now, just to compile. Should be erased with new structure
 
 	uint64 thumbnailID = 0;
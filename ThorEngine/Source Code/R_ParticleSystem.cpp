@@ -39,7 +39,8 @@ void R_ParticleSystem::SaveAsset(Config& config) const
 
 	for (uint i = 0; i < emitters.size(); ++i)
 	{
-		emitters[i].SaveAsset(emittersArray.AddNode());
+		Config emitterNode = emittersArray.AddNode();
+		emitters[i].SaveAsset(emitterNode);
 	}
 }
 
@@ -59,4 +60,13 @@ void R_ParticleSystem::Load(Config& config)
 		emitters[i].Load(emitterNode);
 	}
 
-}
\ No newline at end of file
+}
+
+void R_ParticleSystem::GetDependencies(std::vector<uint64>& dependencies) const
+{
+	for (uint i = 0; i < emitters.size(); ++i)
+	{
+		if (emitters[i].hMaterial.GetID() != 0)
+			dependencies.push_back(emitters[i].hMaterial.GetID());
+	}
+}
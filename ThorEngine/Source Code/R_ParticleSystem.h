@@ -19,6 +19,8 @@ public:
 	void SaveResource(char* buffer);
 	void Load(Config& config);
 
+	void GetDependencies(std::vector<uint64>& dependencies) const override;
+
 public:
 	std::vector<Emitter> emitters;
 };
@@ -18,3 +18,9 @@ void R_Scene::Update(float dt)
 {
 
 }
+
+void R_Scene::GetDependencies(std::vector<uint64>& dependencies) const
+{
+	if (root != nullptr)
+		root->CollectResources(dependencies);
+}
@@ -14,6 +14,8 @@ public:
 
 	void Update(float dt);
 
+	void GetDependencies(std::vector<uint64>& dependencies) const override;
+
 public:
 	GameObject* root = nullptr;
 
@@ -2,7 +2,7 @@
 
 #include "Globals.h"
 
-#include "Glew/include/glew.h"
+#include "OpenGL.h"
 
 R_Shader::R_Shader() : Resource(ResourceType::SHADER)
 {
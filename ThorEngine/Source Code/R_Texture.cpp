@@ -18,5 +18,24 @@ void R_Texture::LoadOnMemory()
 
 void R_Texture::FreeMemory()
 {
-	//glDeleteBuffers(1, &buffer);
+	glDeleteTextures(1, &buffer);
+	buffer = 0;
+}
+
+uint64 R_Texture::GetCPUMemory() const
+{
+	//Image data is released once uploaded to the GPU
+	return sizeof(R_Texture);
+}
+
+uint64 R_Texture::GetGPUMemory() const
+{
+	//RGBA8 with a full mipmap chain
+	uint64 bytes = 0;
+	for (uint w = width, h = height; w > 0 && h > 0; w = w > 1 ? w / 2 : 1, h = h > 1 ? h / 2 : 1)
+	{
+		bytes += (uint64)w * h * 4;
+		if (w == 1 && h == 1) break;
+	}
+	return bytes;
 }
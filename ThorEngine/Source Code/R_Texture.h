@@ -12,7 +12,12 @@ public:
 	void LoadOnMemory();
 	void FreeMemory();
 
+	uint64 GetCPUMemory() const override;
+	uint64 GetGPUMemory() const override;
+
 public:
 	uint buffer = 0;
+	uint width = 0;
+	uint height = 0;
 };
 #endif //__R_TEXTURE_H__
@@ -1,13 +1,21 @@
 #include "Resource.h"
+#include "MemoryTracker.h"
 
-Resource::Resource(ResourceType type) : TreeNode(RESOURCE)
+#include "Engine.h"
+#include "M_Resources.h"
+
+Resource::Resource(ResourceType type) : TreeNode(RESOURCE), memoryType(type)
 {
 
 }
 
 Resource::~Resource()
 {
-	
+	if (memoryTracked)
+	{
+		MemoryTracker::OnFree(MemoryTracker::GetResourceTag(memoryType), trackedCPUMemory);
+		MemoryTracker::OnGPUFree(MemoryTracker::GetResourceTag(memoryType), trackedGPUMemory);
+	}
 }
 
 TreeNode* Resource::GetParentNode() const
@@ -28,4 +36,30 @@ bool Resource::HasResource(uint64 ID) const
 			return true;
 	}
 	return false;
-}
\ No newline at end of file
+}
+
+void Resource::UpdateMemoryUsage()
+{
+	MemoryTracker::Tag tag = MemoryTracker::GetResourceTag(memoryType);
+	if (memoryTracked)
+	{
+		MemoryTracker::OnFree(tag, trackedCPUMemory);
+		MemoryTracker::OnGPUFree(tag, trackedGPUMemory);
+	}
+
+	trackedCPUMemory = GetCPUMemory();
+	trackedGPUMemory = GetGPUMemory();
+	memoryTracked = true;
+
+	MemoryTracker::OnAllocate(tag, trackedCPUMemory);
+	MemoryTracker::OnGPUAllocate(tag, trackedGPUMemory);
+}
+
+void Resource::SetDirty()
+{
+	if (needs_save == false)
+	{
+		needs_save = true;
+		Engine->moduleResources->OnResourceModified(this);
+	}
+}
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <atomic>
 
 #include "TreeNode.h"
 #include "ResourceBase.h"
@@ -16,7 +17,7 @@ class Resource : public TreeNode
 public:
 
 	Resource(ResourceType type);
-	~Resource();
+	virtual ~Resource();
 
 	TreeNode* GetParentNode() const;
 
@@ -34,11 +35,25 @@ public:
 
 	virtual inline void AddContainedResource(uint64 ID) { baseData->containedResources.push_back(ID); };
 
+	//Resources referenced by ID, needed whenever this one is used. Recorded in the base data when it is saved
+	virtual void GetDependencies(std::vector<uint64>& /*dependencies*/) const {}
+
 	virtual void LoadOnMemory() {};
 	virtual void FreeMemory() {};
 
+	//Estimated memory held by the loaded resource, in bytes
+	virtual uint64 GetCPUMemory() const { return sizeof(Resource); }
+	virtual uint64 GetGPUMemory() const { return 0; }
+
+	//Reports the current memory estimate to the MemoryTracker, replacing the previous one
+	void UpdateMemoryUsage();
+
+	//Flags the resource as modified: it is saved with the next changed resources, in the background
+	void SetDirty();
+
 public:
-	uint instances = 0;
+	//Taken and released from any thread, see M_Resources for the ownership rules
+	std::atomic<int> instances{ 0 };
 	bool needs_save = false;
 	bool isExternal = false;
 
@@ -47,6 +62,12 @@ public: //TODO: Can be set to private? Importers need to modify its content
 
 	//TODO: UID that should point to containing folder
 	Resource* parent;
+
+private:
+	ResourceType memoryType;
+	bool memoryTracked = false;
+	uint64 trackedCPUMemory = 0;
+	uint64 trackedGPUMemory = 0;
 };  
 
 #endif // !__RESOURCE_H__
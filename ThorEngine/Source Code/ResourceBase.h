@@ -22,6 +22,14 @@ enum class ResourceType
 	UNKNOWN,
 };
 
+enum class ResourceLoadState
+{
+	UNLOADED,
+	LOADING,	//Requested asynchronously, waiting for the loading threads or the upload queue
+	READY,		//Loaded in memory
+	FAILED,		//The library file could not be read. Cleared when the resource is imported again
+};
+
 struct ResourceBase
 {
 	uint64 ID = 0;
@@ -33,12 +41,19 @@ struct ResourceBase
 
 	std::vector<uint64> containedResources;
 
+	//Hash of the assets file content when it was last imported. 0 if unknown (folders, contained resources)
+	uint64 contentHash = 0;
+
+	//Resources this one references, in ID order. Loaded along with it
+	std::vector<uint64> dependencies;
+
 	ResourceBase() {}; //Looks like we need default constructor for maps
 	ResourceBase(ResourceType type, const char* file, const char* name, uint64 id) : type(type), assetsFile(file), name(name ? name : ""), ID(id) {};
 
-	bool Compare(const char* file, const char* name, ResourceType type) const
+	//Null name and UNKNOWN type match any resource. The assets path is matched by M_Resources' path index
+	bool Matches(const char* name, ResourceType type) const
 	{
-		return (this->assetsFile == file && (name ? this->name == name : true) && (type != ResourceType::UNKNOWN ? type == this->type : true));
+		return ((name ? this->name == name : true) && (type != ResourceType::UNKNOWN ? type == this->type : true));
 	}
 
 	void Serialize(Config& config) const
@@ -47,6 +62,26 @@ struct ResourceBase
 		config.SetString("Name", name.c_str());
 		config.SetNumber("Type", static_cast<int>(type));
 		config.SetString("Library file", libraryFile.c_str());
+
+		if (!dependencies.empty())
+		{
+			Config_Array dependencyArray = config.SetArray("Dependencies");
+			for (uint i = 0; i < dependencies.size(); ++i)
+				dependencyArray.AddNumber(dependencies[i]);
+		}
+	}
+
+	void LoadDependencies(const Config& config)
+	{
+		static const ConfigKey dependenciesKey("Dependencies");
+
+		dependencies.clear();
+		if (config.HasAttribute(dependenciesKey) == false)
+			return;
+
+		Config_Array dependencyArray = config.GetArray(dependenciesKey);
+		for (uint i = 0; i < dependencyArray.GetSize(); ++i)
+			dependencies.push_back(dependencyArray.GetNumber(i));
 	}
 };
 
@@ -0,0 +1,166 @@
+#include "ResourceCache.h"
+
+#include "Resource.h"
+#include "MemoryTracker.h"
+#include "Config.h"
+
+#include <algorithm>
+#include <iterator>
+
+#define MB (1024ull * 1024ull)
+
+ResourceCache::ResourceCache()
+{
+	static_assert(static_cast<int>(ResourceType::UNKNOWN) == 10, "Code Needs Update");
+	budgets[(int)ResourceType::MESH] = { 256 * MB, 256 * MB };
+	budgets[(int)ResourceType::TEXTURE] = { 32 * MB, 512 * MB };
+	budgets[(int)ResourceType::MATERIAL] = { 8 * MB, 0 };
+	budgets[(int)ResourceType::ANIMATION] = { 128 * MB, 0 };
+	budgets[(int)ResourceType::ANIMATOR_CONTROLLER] = { 8 * MB, 0 };
+	budgets[(int)ResourceType::MODEL] = { 32 * MB, 0 };
+	budgets[(int)ResourceType::PARTICLESYSTEM] = { 8 * MB, 0 };
+	budgets[(int)ResourceType::SHADER] = { 8 * MB, 0 };
+}
+
+void ResourceCache::Load(const Config& config)
+{
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+	{
+		if (IsCacheable((ResourceType)i) == false) continue;
+
+		Config node = config.GetNode(MemoryTracker::GetTagName(MemoryTracker::GetResourceTag((ResourceType)i)));
+		budgets[i].cpuBytes = (uint64)(node.GetNumber("CPU MB", (double)(budgets[i].cpuBytes / MB)) * MB);
+		budgets[i].gpuBytes = (uint64)(node.GetNumber("GPU MB", (double)(budgets[i].gpuBytes / MB)) * MB);
+	}
+}
+
+void ResourceCache::Save(Config& config) const
+{
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+	{
+		if (IsCacheable((ResourceType)i) == false) continue;
+
+		Config node = config.SetNode(MemoryTracker::GetTagName(MemoryTracker::GetResourceTag((ResourceType)i)));
+		node.SetNumber("CPU MB", (double)budgets[i].cpuBytes / MB);
+		node.SetNumber("GPU MB", (double)budgets[i].gpuBytes / MB);
+	}
+}
+
+bool ResourceCache::IsCacheable(ResourceType type)
+{
+	return type != ResourceType::SCENE && type != ResourceType::FOLDER && type != ResourceType::UNKNOWN;
+}
+
+void ResourceCache::SetBudget(ResourceType type, Budget budget)
+{
+	if (IsCacheable(type))
+		budgets[(int)type] = budget;
+}
+
+bool ResourceCache::Add(Resource* resource)
+{
+	ResourceType type = resource->GetType();
+	if (IsCacheable(type) == false || budgets[(int)type].cpuBytes == 0)
+		return false;
+
+	//Handles can take an instance without a request: the resource may still be listed
+	Remove(resource);
+
+	lru.push_front(resource);
+
+	Entry& entry = entries[resource->GetID()];
+	entry.node = lru.begin();
+	entry.cpuBytes = resource->GetCPUMemory();
+	entry.gpuBytes = resource->GetGPUMemory();
+
+	Stats& typeStats = stats[(int)type];
+	typeStats.cachedCount++;
+	typeStats.cachedCPUBytes += entry.cpuBytes;
+	typeStats.cachedGPUBytes += entry.gpuBytes;
+
+	return true;
+}
+
+bool ResourceCache::Remove(Resource* resource)
+{
+	std::unordered_map<uint64, Entry>::iterator it = entries.find(resource->GetID());
+	if (it == entries.end())
+		return false;
+
+	Erase(it);
+	return true;
+}
+
+void ResourceCache::CollectEvictions(std::vector<uint64>& evicted, bool all)
+{
+	//Memory held by every loaded resource of each type, cached or not
+	uint64 cpuUsage[(int)ResourceType::UNKNOWN + 1];
+	uint64 gpuUsage[(int)ResourceType::UNKNOWN + 1];
+	for (int i = 0; i <= (int)ResourceType::UNKNOWN; ++i)
+	{
+		MemoryTracker::Stats typeMemory = MemoryTracker::GetStats(MemoryTracker::GetResourceTag((ResourceType)i));
+		cpuUsage[i] = typeMemory.liveBytes;
+		gpuUsage[i] = typeMemory.gpuBytes;
+	}
+
+	//'node' stays valid while the resource before it is erased
+	std::list<Resource*>::iterator node = lru.end();
+	while (node != lru.begin())
+	{
+		Resource* resource = *std::prev(node);
+		std::unordered_map<uint64, Entry>::iterator it = entries.find(resource->GetID());
+
+		//Instances taken directly, without requesting the resource
+		if (resource->instances > 0)
+		{
+			Erase(it);
+			continue;
+		}
+
+		int type = (int)resource->GetType();
+		if (all || cpuUsage[type] > budgets[type].cpuBytes || gpuUsage[type] > budgets[type].gpuBytes)
+		{
+			cpuUsage[type] -= std::min(cpuUsage[type], it->second.cpuBytes);
+			gpuUsage[type] -= std::min(gpuUsage[type], it->second.gpuBytes);
+
+			stats[type].evictions++;
+			stats[type].evictedCPUBytes += it->second.cpuBytes;
+			stats[type].evictedGPUBytes += it->second.gpuBytes;
+			evicted.push_back(resource->GetID());
+
+			Erase(it);
+		}
+		else
+		{
+			--node;
+		}
+	}
+}
+
+ResourceCache::Stats ResourceCache::GetTotalStats() const
+{
+	Stats total;
+	for (int i = 0; i <= (int)ResourceType::UNKNOWN; ++i)
+	{
+		total.hits += stats[i].hits;
+		total.misses += stats[i].misses;
+		total.evictions += stats[i].evictions;
+		total.evictedCPUBytes += stats[i].evictedCPUBytes;
+		total.evictedGPUBytes += stats[i].evictedGPUBytes;
+		total.cachedCount += stats[i].cachedCount;
+		total.cachedCPUBytes += stats[i].cachedCPUBytes;
+		total.cachedGPUBytes += stats[i].cachedGPUBytes;
+	}
+	return total;
+}
+
+void ResourceCache::Erase(std::unordered_map<uint64, Entry>::iterator it)
+{
+	Stats& typeStats = stats[(int)(*it->second.node)->GetType()];
+	typeStats.cachedCount--;
+	typeStats.cachedCPUBytes -= it->second.cpuBytes;
+	typeStats.cachedGPUBytes -= it->second.gpuBytes;
+
+	lru.erase(it->second.node);
+	entries.erase(it);
+}
@@ -0,0 +1,88 @@
+#ifndef __RESOURCE_CACHE_H__
+#define __RESOURCE_CACHE_H__
+
+#include "Globals.h"
+#include "ResourceBase.h"
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+class Resource;
+class Config;
+
+//Keeps resources loaded after their last instance is released, so they can be reused if requested again
+//Every resource type has a CPU and GPU memory budget over all its loaded resources (used or not)
+//While a type is over budget, its least recently released resources are evicted
+class ResourceCache
+{
+public:
+	struct Budget
+	{
+		uint64 cpuBytes = 0;	//0 disables the cache for the type
+		uint64 gpuBytes = 0;
+	};
+
+	struct Stats
+	{
+		uint64 hits = 0;		//Requests served by a cached resource
+		uint64 misses = 0;		//Requests that loaded the resource from the library
+		uint64 evictions = 0;
+		uint64 evictedCPUBytes = 0;
+		uint64 evictedGPUBytes = 0;
+
+		uint cachedCount = 0;
+		uint64 cachedCPUBytes = 0;
+		uint64 cachedGPUBytes = 0;
+
+		inline double GetHitRate() const { return hits + misses > 0 ? (double)hits / (hits + misses) : 0.0; }
+	};
+
+	ResourceCache();
+
+	//Budgets are saved in MB, by resource type name
+	void Load(const Config& config);
+	void Save(Config& config) const;
+
+	//Scenes own the GameObjects loaded from them and folders are always in use: they are never cached
+	static bool IsCacheable(ResourceType type);
+
+	void SetBudget(ResourceType type, Budget budget);
+	inline const Budget& GetBudget(ResourceType type) const { return budgets[(int)type]; }
+
+	//Adds a resource without instances. Returns false if its type is not cached: it should be unloaded now
+	bool Add(Resource* resource);
+
+	//Takes a resource out of the cache. Returns false if it was not cached
+	bool Remove(Resource* resource);
+
+	inline void RecordHit(ResourceType type) { stats[(int)type].hits++; }
+	inline void RecordMiss(ResourceType type) { stats[(int)type].misses++; }
+
+	//Takes out of the cache the resources to unload so every type fits its budget, oldest first
+	//'all' takes every cached resource
+	void CollectEvictions(std::vector<uint64>& evicted, bool all = false);
+
+	inline const Stats& GetStats(ResourceType type) const { return stats[(int)type]; }
+	Stats GetTotalStats() const;
+
+private:
+	struct Entry
+	{
+		std::list<Resource*>::iterator node;
+		uint64 cpuBytes = 0;
+		uint64 gpuBytes = 0;
+	};
+
+	void Erase(std::unordered_map<uint64, Entry>::iterator it);
+
+private:
+	//Most recently released first
+	std::list<Resource*> lru;
+	std::unordered_map<uint64, Entry> entries;
+
+	Budget budgets[(int)ResourceType::UNKNOWN + 1];
+	Stats stats[(int)ResourceType::UNKNOWN + 1];
+};
+
+#endif //__RESOURCE_CACHE_H__
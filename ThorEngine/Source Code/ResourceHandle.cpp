@@ -26,19 +26,82 @@ template class ResourceHandle<R_ParticleSystem>;
 template class ResourceHandle<R_AnimatorController>;
 
 template <typename T>
-T* ResourceHandle<T>::RequestResource() const
+ResourceHandle<T>::ResourceHandle(const ResourceHandle& other) : ID(other.ID)
 {
-	return dynamic_cast<T*>(Engine->moduleResources->RequestResource(ID));
+	if (T* loaded = other.resource.load())
+		Set(loaded);
 }
 
 template <typename T>
-void ResourceHandle<T>::Free()
+ResourceHandle<T>& ResourceHandle<T>::operator=(const ResourceHandle& other)
 {
-	if (resource != nullptr)
+	if (this != &other)
+	{
+		if (T* loaded = other.resource.load())
+			Set(loaded);
+		else
+			Set(other.ID);
+	}
+	return *this;
+}
+
+template <typename T>
+T* ResourceHandle<T>::Resolve() const
+{
+	T* requested = RequestResource();
+	if (requested == nullptr)
+		return nullptr;
+
+	T* expected = nullptr;
+	if (resource.compare_exchange_strong(expected, requested, std::memory_order_acq_rel) == false)
 	{
-		Engine->moduleResources->ReleaseResource(resource);
-		resource = nullptr;
+		Engine->moduleResources->ReleaseResource(requested);
+		return expected;
 	}
+	return requested;
 }
 
+template <typename T>
+T* ResourceHandle<T>::RequestResource() const
+{
+	T* ret = dynamic_cast<T*>(Engine->moduleResources->RequestResource(ID));
+	CancelAsync();
+	return ret;
+}
+
+template <typename T>
+void ResourceHandle<T>::LoadAsync() const
+{
+	if (resource.load() == nullptr && asyncRequested.load() == false && ID != 0 && Engine->IsMainThread())
+		asyncRequested = Engine->moduleResources->RequestResourceAsync(ID) != ResourceLoadState::FAILED;
+}
 
+template <typename T>
+T* ResourceHandle<T>::TryGet()
+{
+	T* loaded = resource.load(std::memory_order_acquire);
+	if (loaded == nullptr && GetState() == ResourceLoadState::READY)
+		loaded = Resolve();
+	return loaded;
+}
+
+template <typename T>
+ResourceLoadState ResourceHandle<T>::GetState() const
+{
+	return resource.load() ? ResourceLoadState::READY : Engine->moduleResources->GetLoadState(ID);
+}
+
+template <typename T>
+void ResourceHandle<T>::CancelAsync() const
+{
+	if (asyncRequested.exchange(false))
+		Engine->moduleResources->ReleaseAsyncRequest(ID);
+}
+
+template <typename T>
+void ResourceHandle<T>::Free()
+{
+	CancelAsync();
+	if (T* loaded = resource.exchange(nullptr))
+		Engine->moduleResources->ReleaseResource(loaded);
+}
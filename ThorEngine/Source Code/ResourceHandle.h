@@ -3,8 +3,13 @@
 
 #include "Resource.h"
 
-typedef unsigned __int64 uint64;
+#include <atomic>
 
+typedef unsigned long long uint64;
+
+//Holds one instance of a resource, taken the first time it is used
+//Get() and Free() can be called from any thread. Outside the main thread Get() never loads: it returns nullptr
+//if the resource is not loaded yet
 template <typename T = Resource>
 class ResourceHandle
 {
@@ -17,6 +22,10 @@ public:
 		ID = resource->GetID();
 	}
 
+	//A copy takes its own instance, both handles can be freed independently
+	ResourceHandle(const ResourceHandle& other);
+	ResourceHandle& operator=(const ResourceHandle& other);
+
 	~ResourceHandle()
 	{
 		Free();
@@ -24,42 +33,60 @@ public:
 
 	void Set(uint64 ID)
 	{
-		if (resource && resource->GetID() != ID)
+		T* loaded = resource.load();
+		if (loaded && loaded->GetID() != ID)
 			Free();
 
-		if (!resource)
+		if (!resource.load() && this->ID != ID)
+		{
+			CancelAsync();
 			this->ID = ID;
+		}
 	}
 
 	void Set(T* resource)
 	{
-		if (this->resource && this->resource != resource)
+		T* loaded = this->resource.load();
+		if (loaded && loaded != resource)
 			Free();
 
-		if (!this->resource)
+		if (!this->resource.load())
 		{
-			this->resource = resource;
 			resource->instances++;
+			this->resource.store(resource);
 			this->ID = resource->GetID();
 		}
 	}
 
 	//Loads the resource if it has not been loaded previously. Compiler throws errors when trying 'inline'
-	inline T* Get() { return resource ? resource : (resource = RequestResource()); }
-	inline const T* Get() const { return resource ? resource : (resource = RequestResource()); }
+	inline T* Get() { T* loaded = resource.load(std::memory_order_acquire); return loaded ? loaded : Resolve(); }
+	inline const T* Get() const { T* loaded = resource.load(std::memory_order_acquire); return loaded ? loaded : Resolve(); }
+
+	//Starts loading the resource in the background. Get() is still valid, it waits for the load to finish
+	//Only the main thread starts loads
+	void LoadAsync() const;
+
+	//Returns the resource once the background load has finished, nullptr while it is loading or if it failed
+	T* TryGet();
+
+	ResourceLoadState GetState() const;
 
 	//Releases the use of the resource in module resources
 	void Free();
 
 	inline uint64 GetID() const { return ID; }
-	inline bool IsLoaded() const { return resource != nullptr; };
+	inline bool IsLoaded() const { return resource.load() != nullptr; };
 
 private:
+	//Requests the resource and keeps it. If another thread resolved the handle first, its instance is kept instead
+	T* Resolve() const;
 	T* RequestResource() const;
+	void CancelAsync() const;
 
 private:
 	uint64 ID = 0;
-	mutable T* resource = nullptr;
+	mutable std::atomic<T*> resource{ nullptr };
+	mutable std::atomic<bool> asyncRequested{ false };
 };
 
 #endif //__RESOURCE_HANDLE_H__
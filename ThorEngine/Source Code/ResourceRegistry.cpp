@@ -0,0 +1,61 @@
+#include "ResourceRegistry.h"
+
+#include "Resource.h"
+
+void ResourceRegistry::Add(Resource* resource)
+{
+	Shard& shard = GetShard(resource->GetID());
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	shard.resources[resource->GetID()] = resource;
+}
+
+Resource* ResourceRegistry::Acquire(uint64 ID)
+{
+	Shard& shard = GetShard(ID);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	std::unordered_map<uint64, Resource*>::iterator it = shard.resources.find(ID);
+	if (it == shard.resources.end())
+		return nullptr;
+
+	it->second->instances++;
+	return it->second;
+}
+
+bool ResourceRegistry::Contains(uint64 ID) const
+{
+	const Shard& shard = GetShard(ID);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	return shard.resources.find(ID) != shard.resources.end();
+}
+
+void ResourceRegistry::Remove(uint64 ID)
+{
+	Shard& shard = GetShard(ID);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	shard.resources.erase(ID);
+}
+
+bool ResourceRegistry::RemoveIfUnused(uint64 ID)
+{
+	Shard& shard = GetShard(ID);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+
+	std::unordered_map<uint64, Resource*>::iterator it = shard.resources.find(ID);
+	if (it != shard.resources.end())
+	{
+		if (it->second->instances > 0)
+			return false;
+		shard.resources.erase(it);
+	}
+	return true;
+}
+
+void ResourceRegistry::Clear()
+{
+	for (uint i = 0; i < shardCount; ++i)
+	{
+		std::lock_guard<std::mutex> lock(shards[i].mutex);
+		shards[i].resources.clear();
+	}
+}
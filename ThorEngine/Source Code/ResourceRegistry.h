@@ -0,0 +1,49 @@
+#ifndef __RESOURCE_REGISTRY_H__
+#define __RESOURCE_REGISTRY_H__
+
+#include "Globals.h"
+
+#include <mutex>
+#include <unordered_map>
+
+class Resource;
+
+//Loaded resources by ID, readable from any thread
+//IDs are spread over independent shards, each with its own lock, so threads resolving different resources rarely wait on each other
+//Taking an instance and removing an unused resource both happen under the shard lock: a resource acquired by a thread is never
+//unloaded by an eviction running at the same time
+class ResourceRegistry
+{
+public:
+	//Publishes a loaded resource, replacing the one registered with the same ID
+	void Add(Resource* resource);
+
+	//Takes an instance of a loaded resource. Returns nullptr if it is not loaded
+	Resource* Acquire(uint64 ID);
+
+	bool Contains(uint64 ID) const;
+
+	//Unregisters a resource whatever its instances are
+	void Remove(uint64 ID);
+
+	//Unregisters a resource only if nobody holds an instance. Returns false if it is in use
+	bool RemoveIfUnused(uint64 ID);
+
+	void Clear();
+
+private:
+	struct Shard
+	{
+		mutable std::mutex mutex;
+		std::unordered_map<uint64, Resource*> resources;
+	};
+
+	inline Shard& GetShard(uint64 ID) { return shards[(ID ^ (ID >> 32)) % shardCount]; }
+	inline const Shard& GetShard(uint64 ID) const { return shards[(ID ^ (ID >> 32)) % shardCount]; }
+
+private:
+	static const uint shardCount = 16;
+	Shard shards[shardCount];
+};
+
+#endif //__RESOURCE_REGISTRY_H__
@@ -0,0 +1,340 @@
+#include "SceneGenerator.h"
+
+#include "Engine.h"
+#include "M_Resources.h"
+#include "M_FileSystem.h"
+#include "Config.h"
+
+#include "GameObject.h"
+#include "C_Mesh.h"
+#include "C_Material.h"
+#include "C_Animator.h"
+#include "C_ParticleSystem.h"
+
+#include "R_Scene.h"
+#include "R_Model.h"
+#include "I_Scenes.h"
+#include "ResourceBase.h"
+
+#include "PerfTimer.h"
+#include "MathGeoLib/src/Algorithm/Random/LCG.h"
+
+#define SCENE_GENERATOR_VERSION 1
+
+namespace SceneGenerator
+{
+	namespace Private
+	{
+		//Picks up to 'count' resources of the given type, in ID order so the choice is stable
+		void CollectResources(ResourceType type, uint count, std::vector<uint64>& IDs)
+		{
+			std::vector<const ResourceBase*> bases;
+			Engine->moduleResources->GetAllMetaFromType(type, bases);
+
+			for (uint i = 0; i < bases.size() && IDs.size() < count; ++i)
+				IDs.push_back(bases[i]->ID);
+		}
+
+		//Models that contain at least one animation
+		void CollectAnimatedModels(uint count, std::vector<uint64>& IDs)
+		{
+			std::vector<const ResourceBase*> models;
+			Engine->moduleResources->GetAllMetaFromType(ResourceType::MODEL, models);
+
+			for (uint i = 0; i < models.size() && IDs.size() < count; ++i)
+			{
+				for (uint c = 0; c < models[i]->containedResources.size(); ++c)
+				{
+					const ResourceBase* contained = Engine->moduleResources->GetResourceBase(models[i]->containedResources[c]);
+					if (contained != nullptr && contained->type == ResourceType::ANIMATION)
+					{
+						IDs.push_back(models[i]->ID);
+						break;
+					}
+				}
+			}
+		}
+
+		//Random numbers are always drawn in the same order, even if there are no resources to assign,
+		//so the hierarchy and transforms only depend on the settings
+		uint64 PickResource(const std::vector<uint64>& IDs, LCG& random)
+		{
+			//Raw LCG output: Int(a, b) goes through a float and only returns multiples of 256 on such a range
+			uint index = random.Int();
+			return IDs.empty() ? 0 : IDs[index % IDs.size()];
+		}
+
+		float3 RandomTopLevelPosition(const Settings& settings, LCG& random)
+		{
+			return float3(random.Float(-settings.extent, settings.extent), random.Float(0.0f, 10.0f), random.Float(-settings.extent, settings.extent));
+		}
+
+		GameObject* CreateObject(const Settings& settings, Stats& stats, LCG& random, GameObject* parent, uint index, uint depth)
+		{
+			float3 position = depth == 1 ? RandomTopLevelPosition(settings, random) : float3(random.Float(-2.0f, 2.0f), random.Float(-2.0f, 2.0f), random.Float(-2.0f, 2.0f));
+			Quat rotation = Quat::RotateAxisAngle(float3::unitY, random.Float(0.0f, 2.0f * pi));
+
+			std::string name = std::string("GameObject_") + std::to_string(index);
+			GameObject* gameObject = new GameObject(parent, name.c_str(), position, rotation);
+
+			gameObject->isStatic = random.Float() < settings.staticRatio;
+			if (gameObject->isStatic)
+				++stats.staticObjects;
+
+			if (uint64 meshID = PickResource(stats.meshes, random))
+				((C_Mesh*)gameObject->CreateComponent(Component::Type::Mesh))->SetResource(meshID);
+
+			if (uint64 materialID = PickResource(stats.materials, random))
+				((C_Material*)gameObject->CreateComponent(Component::Type::Material))->SetResource(materialID);
+
+			++stats.gameObjects;
+			stats.depth = depth > stats.depth ? depth : stats.depth;
+			return gameObject;
+		}
+
+		//Instantiates the model node hierarchy from its library file, without keeping the model loaded
+		GameObject* InstantiateModel(uint64 modelID)
+		{
+			const ResourceBase* base = Engine->moduleResources->GetResourceBase(modelID);
+			if (base == nullptr)
+				return nullptr;
+
+			char* buffer = nullptr;
+			uint size = Engine->moduleResources->LoadLibraryFile(base->libraryFile.c_str(), &buffer);
+			if (size == 0)
+				return nullptr;
+
+			R_Model model;
+			Importer::Models::Load(buffer, size, &model);
+			RELEASE_ARRAY(buffer);
+
+			return model.root;
+		}
+
+		void CreateCharacters(const Settings& settings, Stats& stats, LCG& random, GameObject* root)
+		{
+			if (settings.characterCount > 0 && stats.models.empty())
+				LOG("[Warning] Scene generator: no animated models found in the project, characters are skipped");
+
+			for (uint i = 0; i < settings.characterCount && !stats.models.empty(); ++i)
+			{
+				float3 position = RandomTopLevelPosition(settings, random);
+				uint64 modelID = PickResource(stats.models, random);
+				uint64 animatorID = PickResource(stats.animators, random);
+
+				GameObject* model = InstantiateModel(modelID);
+				if (model == nullptr)
+				{
+					LOG("[Warning] Scene generator: model [%llu] could not be instantiated", modelID);
+					continue;
+				}
+
+				std::string name = std::string("Character_") + std::to_string(i);
+				GameObject* character = new GameObject(root, name.c_str(), position);
+				model->SetParent(character, nullptr, false);
+
+				C_Animator* animator = (C_Animator*)character->CreateComponent(Component::Type::Animator);
+				if (animatorID != 0)
+					animator->SetResource(animatorID);
+				animator->playing = true;
+
+				std::vector<GameObject*> nodes;
+				character->CollectChilds(nodes);
+				stats.gameObjects += nodes.size();
+				++stats.characters;
+			}
+		}
+
+		void CreateEmitters(const Settings& settings, Stats& stats, LCG& random, GameObject* root)
+		{
+			if (settings.emitterCount > 0 && stats.particleSystems.empty())
+				LOG("[Warning] Scene generator: no particle systems found in the project, emitters are skipped");
+
+			for (uint i = 0; i < settings.emitterCount && !stats.particleSystems.empty(); ++i)
+			{
+				std::string name = std::string("Emitter_") + std::to_string(i);
+				GameObject* gameObject = new GameObject(root, name.c_str(), RandomTopLevelPosition(settings, random));
+
+				C_ParticleSystem* particleSystem = (C_ParticleSystem*)gameObject->CreateComponent(Component::Type::ParticleSystem);
+				particleSystem->SetResource(PickResource(stats.particleSystems, random));
+
+				++stats.gameObjects;
+				++stats.emitters;
+			}
+		}
+
+		//FNV-1a, used to check that two generations produced the same content
+		uint64 HashBuffer(const char* buffer, uint size)
+		{
+			uint64 hash = 14695981039346656037ull;
+			for (uint i = 0; i < size; ++i)
+			{
+				hash ^= (unsigned char)buffer[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		void SaveIDs(Config& config, const char* name, const std::vector<uint64>& IDs)
+		{
+			Config_Array array = config.SetArray(name);
+			for (uint i = 0; i < IDs.size(); ++i)
+				array.AddNumber((double)IDs[i]);
+		}
+
+		bool SaveManifest(const char* path, const Settings& settings, const Stats& stats, const char* sceneFile, uint64 sceneID, uint64 hash)
+		{
+			Config config;
+			config.SetNumber("Generator Version", SCENE_GENERATOR_VERSION);
+			config.SetString("Scene", sceneFile);
+			config.SetNumber("Scene ID", (double)sceneID);
+
+			char hashString[17];
+			snprintf(hashString, 17, "%016llx", hash);
+			config.SetString("Content Hash", hashString);
+
+			Config settingsNode = config.SetNode("Settings");
+			settings.Save(settingsNode);
+
+			config.SetNumber("GameObjects", stats.gameObjects);
+			config.SetNumber("Static GameObjects", stats.staticObjects);
+			config.SetNumber("Depth", stats.depth);
+			config.SetNumber("Characters", stats.characters);
+			config.SetNumber("Emitters", stats.emitters);
+
+			Config resources = config.SetNode("Resources");
+			SaveIDs(resources, "Meshes", stats.meshes);
+			SaveIDs(resources, "Materials", stats.materials);
+			SaveIDs(resources, "Models", stats.models);
+			SaveIDs(resources, "Animators", stats.animators);
+			SaveIDs(resources, "Particle Systems", stats.particleSystems);
+
+			char* buffer = nullptr;
+			uint size = config.Serialize(&buffer);
+			uint written = Engine->fileSystem->Save(path, buffer, size - 1);
+			RELEASE_ARRAY(buffer);
+
+			return written > 0;
+		}
+	}
+}
+
+void SceneGenerator::Settings::Save(Config& config) const
+{
+	config.SetString("Name", name.c_str());
+	config.SetNumber("Seed", seed);
+	config.SetNumber("Object Count", objectCount);
+	config.SetNumber("Max Depth", maxDepth);
+	config.SetNumber("Fan Out", fanOut);
+	config.SetNumber("Static Ratio", staticRatio);
+	config.SetNumber("Extent", extent);
+	config.SetNumber("Mesh Count", meshCount);
+	config.SetNumber("Material Count", materialCount);
+	config.SetNumber("Character Count", characterCount);
+	config.SetNumber("Emitter Count", emitterCount);
+}
+
+void SceneGenerator::Settings::Load(const Config& config)
+{
+	name = config.GetString("Name", name.c_str());
+	seed = config.GetNumber("Seed", seed);
+	objectCount = config.GetNumber("Object Count", objectCount);
+	maxDepth = config.GetNumber("Max Depth", maxDepth);
+	fanOut = config.GetNumber("Fan Out", fanOut);
+	staticRatio = config.GetNumber("Static Ratio", staticRatio);
+	extent = config.GetNumber("Extent", extent);
+	meshCount = config.GetNumber("Mesh Count", meshCount);
+	materialCount = config.GetNumber("Material Count", materialCount);
+	characterCount = config.GetNumber("Character Count", characterCount);
+	emitterCount = config.GetNumber("Emitter Count", emitterCount);
+}
+
+void SceneGenerator::Generate(const Settings& settings, R_Scene* scene, Stats& stats)
+{
+	LCG random(settings.seed);
+	stats = Stats();
+
+	Private::CollectResources(ResourceType::MESH, settings.meshCount, stats.meshes);
+	Private::CollectResources(ResourceType::MATERIAL, settings.materialCount, stats.materials);
+	Private::CollectAnimatedModels(settings.characterCount, stats.models);
+	Private::CollectResources(ResourceType::ANIMATOR_CONTROLLER, settings.characterCount, stats.animators);
+	Private::CollectResources(ResourceType::PARTICLESYSTEM, settings.emitterCount, stats.particleSystems);
+
+	uint maxDepth = settings.maxDepth > 0 ? settings.maxDepth : 1;
+	uint fanOut = settings.fanOut > 0 ? settings.fanOut : 1;
+
+	//Top level GameObjects are filled breadth first up to 'maxDepth' levels, then a new one is started
+	uint created = 0;
+	std::vector<GameObject*> level;
+	std::vector<GameObject*> nextLevel;
+	while (created < settings.objectCount)
+	{
+		level.clear();
+		level.push_back(Private::CreateObject(settings, stats, random, scene->root, created++, 1));
+
+		for (uint depth = 2; depth <= maxDepth && created < settings.objectCount; ++depth)
+		{
+			nextLevel.clear();
+			for (uint p = 0; p < level.size() && created < settings.objectCount; ++p)
+			{
+				for (uint c = 0; c < fanOut && created < settings.objectCount; ++c)
+					nextLevel.push_back(Private::CreateObject(settings, stats, random, level[p], created++, depth));
+			}
+			level.swap(nextLevel);
+		}
+	}
+
+	Private::CreateCharacters(settings, stats, random, scene->root);
+	Private::CreateEmitters(settings, stats, random, scene->root);
+
+	//UIDs are only used to link parents when loading the scene. Sequential IDs keep the file reproducible
+	std::vector<GameObject*> gameObjects;
+	scene->root->CollectChilds(gameObjects);
+	for (uint i = 0; i < gameObjects.size(); ++i)
+		gameObjects[i]->uid = i;
+
+	scene->root->OnUpdateTransform();
+}
+
+uint64 SceneGenerator::GenerateAsset(const Settings& settings, const char* assetsPath, const char* manifestPath)
+{
+	PerfTimer timer;
+	LOG("Generating scene '%s': %u GameObjects, seed %u", assetsPath, settings.objectCount, settings.seed);
+
+	R_Scene scene;
+	Stats stats;
+	Generate(settings, &scene, stats);
+
+	char* buffer = nullptr;
+	uint size = Engine->moduleResources->textSceneAssets ? Importer::Scenes::SaveJSON(&scene, &buffer) : Importer::Scenes::Save(&scene, &buffer);
+	RELEASE(scene.root);
+
+	std::string directory;
+	Engine->fileSystem->SplitFilePath(assetsPath, &directory);
+	if (!directory.empty())
+		Engine->fileSystem->CreateDir(directory.c_str());
+
+	uint64 sceneID = 0;
+	if (size > 0 && Engine->fileSystem->Save(assetsPath, buffer, size) > 0)
+	{
+		sceneID = Engine->moduleResources->ImportFileFromAssets(assetsPath);
+
+		if (manifestPath != nullptr)
+			Private::SaveManifest(manifestPath, settings, stats, assetsPath, sceneID, Private::HashBuffer(buffer, size));
+
+		LOG("Scene generated in %.1f ms: %u GameObjects (%u static), %u characters, %u emitters", timer.ReadMs(),
+			stats.gameObjects, stats.staticObjects, stats.characters, stats.emitters);
+	}
+	else
+	{
+		LOG("[error] Scene generator: could not save '%s'", assetsPath);
+	}
+
+	RELEASE_ARRAY(buffer);
+	return sceneID;
+}
+
+std::string SceneGenerator::GetManifestPath(const char* sceneName)
+{
+	return std::string(LIBRARY_PATH) + sceneName + ".manifest";
+}
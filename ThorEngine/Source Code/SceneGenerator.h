@@ -0,0 +1,65 @@
+#ifndef __SCENE_GENERATOR_H__
+#define __SCENE_GENERATOR_H__
+
+#include "Globals.h"
+
+#include <string>
+#include <vector>
+
+class Config;
+class R_Scene;
+
+//Procedural stress scenes for scaling tests and profiling sessions
+//The same settings (seed included) and the same project resources always generate the same scene,
+//the manifest records both so a run can be reproduced and compared on identical content
+namespace SceneGenerator
+{
+	struct Settings
+	{
+		std::string name = "StressScene";
+		uint seed = 1;
+
+		uint objectCount = 10000;		//Mesh GameObjects, characters and emitters not included
+		uint maxDepth = 4;				//Hierarchy levels below the scene root
+		uint fanOut = 8;				//Maximum children per GameObject
+		float staticRatio = 0.8f;		//Fraction of the GameObjects flagged as static
+		float extent = 75.0f;			//Half size of the area the GameObjects are spread over
+
+		uint meshCount = 16;			//Distinct meshes reused by the GameObjects (0 = no meshes)
+		uint materialCount = 8;			//Distinct materials reused by the GameObjects (0 = no materials)
+		uint characterCount = 0;		//Instances of animated models, with an animator
+		uint emitterCount = 0;			//GameObjects with a particle system
+
+		void Save(Config& config) const;
+		void Load(const Config& config);
+	};
+
+	//What a generation actually produced. Resources are picked from the ones available in the project
+	struct Stats
+	{
+		uint gameObjects = 0;
+		uint staticObjects = 0;
+		uint depth = 0;
+		uint characters = 0;
+		uint emitters = 0;
+
+		std::vector<uint64> meshes;
+		std::vector<uint64> materials;
+		std::vector<uint64> models;
+		std::vector<uint64> animators;
+		std::vector<uint64> particleSystems;
+	};
+
+	//Fills 'scene->root' with the generated hierarchy. Requires the resources module to be started
+	void Generate(const Settings& settings, R_Scene* scene, Stats& stats);
+
+	//Generates the scene, saves it as a scene asset in 'assetsPath' and imports it
+	//The manifest (settings, stats and content hash) is written to 'manifestPath' if not null
+	//Returns the scene resource ID, 0 if the scene could not be saved
+	uint64 GenerateAsset(const Settings& settings, const char* assetsPath, const char* manifestPath);
+
+	//Default manifest location for a generated scene. Kept out of Assets, it is not an importable file
+	std::string GetManifestPath(const char* sceneName);
+}
+
+#endif //__SCENE_GENERATOR_H__
@@ -0,0 +1,69 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint threadCount)
+{
+	if (threadCount == 0)
+	{
+		uint cores = std::thread::hardware_concurrency();
+		threadCount = cores > 1 ? cores - 1 : 1;
+	}
+
+	for (uint i = 0; i < threadCount; ++i)
+		threads.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	//Queued tasks still run before the workers exit
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	taskAvailable.notify_all();
+
+	for (uint i = 0; i < threads.size(); ++i)
+		threads[i].join();
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	taskAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	tasksFinished.wait(lock, [this] { return tasks.empty() && runningTasks == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+			if (tasks.empty())
+				return;
+
+			task = std::move(tasks.front());
+			tasks.pop_front();
+			runningTasks++;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			runningTasks--;
+			if (tasks.empty() && runningTasks == 0)
+				tasksFinished.notify_all();
+		}
+	}
+}
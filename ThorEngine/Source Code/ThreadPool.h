@@ -0,0 +1,43 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include "Globals.h"
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//Fixed set of worker threads running queued tasks in submission order
+//Tasks must not touch engine state owned by the main thread (GL, modules, the editor)
+class ThreadPool
+{
+public:
+	//'threadCount' 0 uses one thread per hardware core except the main one
+	ThreadPool(uint threadCount = 0);
+	~ThreadPool();
+
+	void Submit(std::function<void()> task);
+
+	//Blocks until every submitted task has finished
+	void Wait();
+
+	inline uint GetThreadCount() const { return threads.size(); }
+
+private:
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> tasks;
+
+	std::mutex mutex;
+	std::condition_variable taskAvailable;
+	std::condition_variable tasksFinished;
+	uint runningTasks = 0;
+	bool stopping = false;
+};
+
+#endif //__THREAD_POOL_H__
@@ -7,6 +7,7 @@ float Time::time;
 
 bool Time::running = false;
 bool Time::paused = false;
+bool Time::fixedStep = false;
 
 Timer Time::gameTimer;
 
@@ -21,7 +22,7 @@ void Time::PreUpdate(float dt)
 {
 	deltaTime = running ? dt : 0;
 	if (running)
-		time = gameTimer.ReadSec();
+		time = fixedStep ? time + dt : gameTimer.ReadSec();
 }
 
 void Time::Update()
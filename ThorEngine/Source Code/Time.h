@@ -32,6 +32,7 @@ public:
 	static Timer gameTimer;
 	static bool paused;
 	static bool running;
+	static bool fixedStep; //Game time advances by the frame dt instead of the game timer (deterministic runs)
 	//----------------------
 };
 #endif //__TIME_H__
@@ -5,6 +5,22 @@
 
 #include "Timer.h"
 
+#ifdef THOR_HEADLESS
+#include <chrono>
+
+//Headless builds do not link SDL. Milliseconds since the first call
+static Uint32 GetTicks()
+{
+	static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	return (Uint32)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+#else
+static Uint32 GetTicks()
+{
+	return SDL_GetTicks();
+}
+#endif
+
 // ---------------------------------------------
 Timer::Timer()
 {
@@ -15,14 +31,14 @@ Timer::Timer()
 void Timer::Start()
 {
 	running = true;
-	started_at = SDL_GetTicks();
+	started_at = GetTicks();
 }
 
 // ---------------------------------------------
 void Timer::Stop()
 {
 	running = false;
-	stopped_at = SDL_GetTicks();
+	stopped_at = GetTicks();
 }
 
 void Timer::Resume()
@@ -30,13 +46,13 @@ void Timer::Resume()
 	if (running == false)
 	{
 		running = true;
-		started_at = SDL_GetTicks() - (stopped_at - started_at);
+		started_at = GetTicks() - (stopped_at - started_at);
 	}
 }
 
 float Timer::ReadSec() const
 {
-	return float(SDL_GetTicks() - started_at) / 1000.0f;
+	return float(GetTicks() - started_at) / 1000.0f;
 }
 
 // ---------------------------------------------
@@ -44,7 +60,7 @@ Uint32 Timer::Read()
 {
 	if(running == true)
 	{
-		return SDL_GetTicks() - started_at;
+		return GetTicks() - started_at;
 	}
 	else
 	{
@@ -171,10 +171,43 @@ void WF_SceneEditor::MenuBar_Development()
 			ImGui::MenuItem("GameObjects box (selected)", nullptr, &Engine->sceneManager->drawBoundsSelected);
 			ImGui::EndMenu();
 		}
+		if (ImGui::BeginMenu("Generate Stress Scene"))
+		{
+			MenuBar_SceneGenerator();
+			ImGui::EndMenu();
+		}
 		ImGui::EndMenu();
 	}
 }
 
+void WF_SceneEditor::MenuBar_SceneGenerator()
+{
+	ImGui::InputText("Name", generatorName, 64);
+	ImGui::InputScalar("Seed", ImGuiDataType_U32, &generatorSettings.seed);
+	ImGui::InputScalar("GameObjects", ImGuiDataType_U32, &generatorSettings.objectCount);
+	ImGui::InputScalar("Max Depth", ImGuiDataType_U32, &generatorSettings.maxDepth);
+	ImGui::InputScalar("Fan Out", ImGuiDataType_U32, &generatorSettings.fanOut);
+	ImGui::SliderFloat("Static Ratio", &generatorSettings.staticRatio, 0.0f, 1.0f);
+	ImGui::InputFloat("Extent", &generatorSettings.extent);
+	ImGui::Separator();
+	ImGui::InputScalar("Meshes", ImGuiDataType_U32, &generatorSettings.meshCount);
+	ImGui::InputScalar("Materials", ImGuiDataType_U32, &generatorSettings.materialCount);
+	ImGui::InputScalar("Characters", ImGuiDataType_U32, &generatorSettings.characterCount);
+	ImGui::InputScalar("Emitters", ImGuiDataType_U32, &generatorSettings.emitterCount);
+	ImGui::Separator();
+
+	if (ImGui::Button("Generate and Open"))
+	{
+		generatorSettings.name = generatorName;
+		std::string path = std::string("Assets/Generated/") + generatorName + ".scene";
+		std::string manifest = SceneGenerator::GetManifestPath(generatorName);
+
+		if (uint64 sceneID = SceneGenerator::GenerateAsset(generatorSettings, path.c_str(), manifest.c_str()))
+			Engine->sceneManager->LoadScene(sceneID);
+		ImGui::CloseCurrentPopup();
+	}
+}
+
 void WF_SceneEditor::LoadLayout_Default(ImGuiID mainDockID)
 {
 	// Generate a new window docked into the previous dock space.
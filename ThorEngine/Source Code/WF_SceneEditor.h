@@ -2,6 +2,7 @@
 #define __WF_MAIN_WINDOW_H__
 
 #include "WindowFrame.h"
+#include "SceneGenerator.h"
 
 class M_Editor;
 
@@ -33,8 +34,13 @@ private:
 	void MenuBar_Custom() override;
 	void MenuBar_Development() override;
 
+	void MenuBar_SceneGenerator();
+
 	//Specific window class for the explorer smallest windows
 	ImGuiWindowClass* explorerWindowClass = nullptr;
+
+	SceneGenerator::Settings generatorSettings;
+	char generatorName[64] = "StressScene";
 };
 
 #endif // !__WF_MAIN_WINDOW_H
@@ -64,6 +64,7 @@ void W_Emitters::Draw()
 	if (ImGui::Button("Add Emitter"))
 	{
 		particleSystem->AddDefaultEmitter();
+		particleSystem->SetDirty();
 	}
 
 	ImGui::End();
@@ -2,6 +2,7 @@
 
 #include "WF_ParticleEditor.h"
 #include "ParticleModule.h"
+#include "R_ParticleSystem.h"
 
 #include "ImGui/imgui.h"
 
@@ -19,27 +20,31 @@ void W_ParticleDetails::Draw()
 
 	if (module != nullptr)
 	{
+		bool modified = false;
 		switch (module->type)
 		{
 		case(ParticleModule::Type::EmitterBase):
-			DrawModule((EmitterBase*)module); break;
+			modified = DrawModule((EmitterBase*)module); break;
 		case(ParticleModule::Type::EmitterSpawn):
-			DrawModule((EmitterSpawn*)module); break;
+			modified = DrawModule((EmitterSpawn*)module); break;
 		case(ParticleModule::Type::EmitterArea):
-			DrawModule((EmitterArea*)module); break;
+			modified = DrawModule((EmitterArea*)module); break;
 		case(ParticleModule::Type::ParticlePosition):
-			DrawModule((ParticlePosition*)module); break;
+			modified = DrawModule((ParticlePosition*)module); break;
 		case(ParticleModule::Type::ParticleRotation):
-			DrawModule((ParticleRotation*)module); break;
+			modified = DrawModule((ParticleRotation*)module); break;
 		case(ParticleModule::Type::ParticleSize):
-			DrawModule((ParticleSize*)module); break;
+			modified = DrawModule((ParticleSize*)module); break;
 		case(ParticleModule::Type::ParticleColor):
-			DrawModule((ParticleColor*)module); break;
+			modified = DrawModule((ParticleColor*)module); break;
 		case(ParticleModule::Type::ParticleLifetime):
-			DrawModule((ParticleLifetime*)module); break;
+			modified = DrawModule((ParticleLifetime*)module); break;
 		case(ParticleModule::Type::ParticleVelocity):
-			DrawModule((ParticleVelocity*)module); break;
+			modified = DrawModule((ParticleVelocity*)module); break;
 		}
+
+		if (modified && hostWindow->particleSystem != nullptr)
+			hostWindow->particleSystem->SetDirty();
 	}
 	else
 	{
@@ -50,9 +55,9 @@ void W_ParticleDetails::Draw()
 	ImGui::End();
 }
 
-void W_ParticleDetails::DrawModule(EmitterBase* module)
+bool W_ParticleDetails::DrawModule(EmitterBase* module)
 {
-	ImGui::InputFloat3("Origin: ", module->emitterOrigin.ptr());
+	bool modified = ImGui::InputFloat3("Origin: ", module->emitterOrigin.ptr());
 
 	static char* alignmentOptions[9] = { "None", "Screen", "Camera", "LockYZ", "LockYX", "LockXY", "LockXZ", "LockZX", "LockZY" };
 	int currentOption = (int)module->alignment;
@@ -62,59 +67,88 @@ void W_ParticleDetails::DrawModule(EmitterBase* module)
 		for (uint i = 0; i < 9; ++i)
 		{
 			if (ImGui::Selectable(alignmentOptions[i], i == currentOption))
+			{
 				module->alignment = (EmitterBase::Alignment)i;
+				modified = true;
+			}
 		}
 		ImGui::EndCombo();
 	}
+	return modified;
 }
 
-void W_ParticleDetails::DrawModule(EmitterSpawn* module)
+bool W_ParticleDetails::DrawModule(EmitterSpawn* module)
 {
 	if (ImGui::InputFloat("Spawn Ratio", &module->spawnRatio))
+	{
 		module->spawnRatio = math::Clamp<float>(module->spawnRatio, 0.0f, module->spawnRatio);
+		return true;
+	}
+	return false;
 }
 
-void W_ParticleDetails::DrawModule(EmitterArea* module)
+bool W_ParticleDetails::DrawModule(EmitterArea* module)
 {
 	ImGui::Text("-- Needs Update --");
+	return false;
 }
 
-void W_ParticleDetails::DrawModule(ParticlePosition* module)
+bool W_ParticleDetails::DrawModule(ParticlePosition* module)
 {
-	ImGui::InputFloat3("Position 1", module->initialPosition1.ptr());
-	ImGui::InputFloat3("Position 2", module->initialPosition2.ptr());
+	bool modified = ImGui::InputFloat3("Position 1", module->initialPosition1.ptr());
+	modified |= ImGui::InputFloat3("Position 2", module->initialPosition2.ptr());
+	return modified;
 }
 
-void W_ParticleDetails::DrawModule(ParticleRotation* module)
+bool W_ParticleDetails::DrawModule(ParticleRotation* module)
 {
-	ImGui::InputFloat("Rotation 1", &module->initialRotation1);
-	ImGui::InputFloat("Rotation 2", &module->initialRotation2);
+	bool modified = ImGui::InputFloat("Rotation 1", &module->initialRotation1);
+	modified |= ImGui::InputFloat("Rotation 2", &module->initialRotation2);
+	return modified;
 }
 
-void W_ParticleDetails::DrawModule(ParticleSize* module)
+bool W_ParticleDetails::DrawModule(ParticleSize* module)
 {
+	bool modified = false;
 	if (ImGui::InputFloat("Size 1", &module->initialSize1))
+	{
 		module->initialSize1 = math::Clamp<float>(module->initialSize1, 0.0f, module->initialSize1);
+		modified = true;
+	}
 	if (ImGui::InputFloat("Size 2", &module->initialSize2))
+	{
 		module->initialSize2 = math::Clamp<float>(module->initialSize2, 0.0f, module->initialSize2);
+		modified = true;
+	}
+	return modified;
 }
 
-void W_ParticleDetails::DrawModule(ParticleColor* module)
+bool W_ParticleDetails::DrawModule(ParticleColor* module)
 {
-	ImGui::ColorEdit4("Color 1", module->initialColor1.ptr());
-	ImGui::ColorEdit4("Color 2", module->initialColor2.ptr());
+	bool modified = ImGui::ColorEdit4("Color 1", module->initialColor1.ptr());
+	modified |= ImGui::ColorEdit4("Color 2", module->initialColor2.ptr());
+	return modified;
 }
 
-void W_ParticleDetails::DrawModule(ParticleLifetime* module)
+bool W_ParticleDetails::DrawModule(ParticleLifetime* module)
 {
+	bool modified = false;
 	if (ImGui::InputFloat("Lifetime 1", &module->initialLifetime1))
+	{
 		module->initialLifetime1 = math::Clamp<float>(module->initialLifetime1, 0.0f, module->initialLifetime1);
+		modified = true;
+	}
 	if (ImGui::InputFloat("Lifetime 2", &module->initialLifetime2))
+	{
 		module->initialLifetime2 = math::Clamp<float>(module->initialLifetime2, 0.0f, module->initialLifetime2);
+		modified = true;
+	}
+	return modified;
 }
 
-void W_ParticleDetails::DrawModule(ParticleVelocity* module)
+bool W_ParticleDetails::DrawModule(ParticleVelocity* module)
 {
-	ImGui::InputFloat4("Velocity 1", module->initialVelocity1.ptr());
-	ImGui::InputFloat4("Velocity 2", module->initialVelocity2.ptr());
+	bool modified = ImGui::InputFloat4("Velocity 1", module->initialVelocity1.ptr());
+	modified |= ImGui::InputFloat4("Velocity 2", module->initialVelocity2.ptr());
+	return modified;
 }
\ No newline at end of file
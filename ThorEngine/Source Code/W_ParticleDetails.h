@@ -28,15 +28,16 @@ public:
 	static inline const char* GetName() { return "Details"; };
 
 private:
-	void DrawModule(EmitterBase* module);
-	void DrawModule(EmitterSpawn* module);
-	void DrawModule(EmitterArea* module);
-	void DrawModule(ParticlePosition* module);
-	void DrawModule(ParticleRotation* module);
-	void DrawModule(ParticleSize* module);
-	void DrawModule(ParticleColor* module);
-	void DrawModule(ParticleLifetime* module);
-	void DrawModule(ParticleVelocity* module);
+	//Return true if the module was modified
+	bool DrawModule(EmitterBase* module);
+	bool DrawModule(EmitterSpawn* module);
+	bool DrawModule(EmitterArea* module);
+	bool DrawModule(ParticlePosition* module);
+	bool DrawModule(ParticleRotation* module);
+	bool DrawModule(ParticleSize* module);
+	bool DrawModule(ParticleColor* module);
+	bool DrawModule(ParticleLifetime* module);
+	bool DrawModule(ParticleVelocity* module);
 
 private:
 	WF_ParticleEditor* hostWindow = nullptr;
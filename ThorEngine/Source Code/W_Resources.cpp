@@ -4,6 +4,9 @@
 
 #include "Engine.h"
 #include "M_Resources.h"
+#include "M_FileSystem.h"
+#include "MemoryTracker.h"
+#include "ResourceBase.h"
 
 //Resources
 #include "R_Mesh.h"
@@ -23,6 +26,21 @@ void W_Resources::Draw()
 
 	ImGui::Text("Resources loaded in memory");
 
+	if (ImGui::CollapsingHeader("Memory"))
+	{
+		DisplayMemoryStats();
+	}
+
+	if (ImGui::CollapsingHeader("Cache"))
+	{
+		DisplayCacheStats();
+	}
+
+	if (ImGui::CollapsingHeader("File System"))
+	{
+		DisplayFileSystemStats();
+	}
+
 	if (ImGui::CollapsingHeader("Models"))
 	{
 		for (std::map<uint64, Resource*>::iterator it = Engine->moduleResources->resources.begin(); it != Engine->moduleResources->resources.end(); it++)
@@ -96,11 +114,165 @@ void W_Resources::Draw()
 	ImGui::End();
 }
 
+//Displays a byte count in the most readable unit
+void TextBytes(uint64 bytes)
+{
+	if (bytes >= 1024 * 1024)
+		ImGui::Text("%.2f MB", bytes / (1024.0 * 1024.0));
+	else if (bytes >= 1024)
+		ImGui::Text("%.2f KB", bytes / 1024.0);
+	else
+		ImGui::Text("%llu B", bytes);
+}
+
+void W_Resources::DisplayMemoryStats()
+{
+	ImGui::Columns(5, "Memory");
+	ImGui::Text("Tag");			ImGui::NextColumn();
+	ImGui::Text("Live");		ImGui::NextColumn();
+	ImGui::Text("Peak");		ImGui::NextColumn();
+	ImGui::Text("Allocations");	ImGui::NextColumn();
+	ImGui::Text("GPU");			ImGui::NextColumn();
+	ImGui::Separator();
+
+	for (int i = 0; i <= (int)MemoryTracker::Tag::COUNT; ++i)
+	{
+		bool total = i == (int)MemoryTracker::Tag::COUNT;
+		MemoryTracker::Stats stats = total ? MemoryTracker::GetTotalStats() : MemoryTracker::GetStats((MemoryTracker::Tag)i);
+
+		//Resource types never loaded are left out
+		if (stats.allocations == 0 && stats.gpuPeakBytes == 0)
+			continue;
+
+		if (total) ImGui::Separator();
+		ImGui::Text("%s", total ? "Total" : MemoryTracker::GetTagName((MemoryTracker::Tag)i));	ImGui::NextColumn();
+		TextBytes(stats.liveBytes);															ImGui::NextColumn();
+		TextBytes(stats.peakBytes);															ImGui::NextColumn();
+		ImGui::Text("%llu / %llu", stats.liveCount, stats.allocations);						ImGui::NextColumn();
+		TextBytes(stats.gpuBytes);															ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+
+	if (ImGui::Button("Save Memory Report"))
+	{
+		MemoryTracker::SaveReport("Library/MemoryReport.json");
+	}
+}
+
 void W_Resources::DisplayResourceInfo(Resource* resource)
 {
 	ImGui::BeginTooltip();
 	ImGui::Text("UID: %llu", resource->GetID());
 	ImGui::Text("Source file: %s", resource->GetAssetsFile());
-	ImGui::Text("Instances: %i", resource->instances);
+	ImGui::Text("Instances: %i", resource->instances.load());
+	ImGui::Text("CPU memory: %.2f KB", resource->GetCPUMemory() / 1024.0);
+	ImGui::Text("GPU memory: %.2f KB", resource->GetGPUMemory() / 1024.0);
+
+	//Dependency graph recorded in the asset database
+	std::vector<uint64> dependencies, closure, dependents;
+	Engine->moduleResources->GetDependencies(resource->GetID(), dependencies, false);
+	Engine->moduleResources->GetDependencies(resource->GetID(), closure);
+	Engine->moduleResources->GetDependents(resource->GetID(), dependents);
+
+	ImGui::Separator();
+	ImGui::Text("Dependencies: %i (%i with their own)", (int)dependencies.size(), (int)closure.size());
+	DisplayResourceNames(dependencies);
+	ImGui::Text("Used by: %i", (int)dependents.size());
+	DisplayResourceNames(dependents);
 	ImGui::EndTooltip();
-}
\ No newline at end of file
+}
+
+void W_Resources::DisplayResourceNames(const std::vector<uint64>& IDs)
+{
+	//Long lists are cut, the tooltip would not fit the screen
+	const uint maxNames = 10;
+	for (uint i = 0; i < IDs.size() && i < maxNames; ++i)
+	{
+		const ResourceBase* base = Engine->moduleResources->GetResourceBase(IDs[i]);
+		ImGui::BulletText("%s", base ? base->name.c_str() : "Missing resource");
+	}
+	if (IDs.size() > maxNames)
+		ImGui::BulletText("... %i more", (int)(IDs.size() - maxNames));
+}
+
+void W_Resources::DisplayCacheStats()
+{
+	ResourceCache& cache = Engine->moduleResources->GetCache();
+
+	ImGui::Columns(6, "Cache");
+	ImGui::Text("Type");		ImGui::NextColumn();
+	ImGui::Text("Budget MB");	ImGui::NextColumn();
+	ImGui::Text("Cached");		ImGui::NextColumn();
+	ImGui::Text("Hit Rate");	ImGui::NextColumn();
+	ImGui::Text("Evictions");	ImGui::NextColumn();
+	ImGui::Text("Evicted");		ImGui::NextColumn();
+	ImGui::Separator();
+
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+	{
+		ResourceType type = (ResourceType)i;
+		if (ResourceCache::IsCacheable(type) == false) continue;
+
+		const ResourceCache::Stats& stats = cache.GetStats(type);
+		ResourceCache::Budget budget = cache.GetBudget(type);
+
+		ImGui::PushID(i);
+		ImGui::Text("%s", MemoryTracker::GetTagName(MemoryTracker::GetResourceTag(type)));	ImGui::NextColumn();
+
+		//Budgets edited in MB, both CPU and GPU
+		int budgetMB[2] = { (int)(budget.cpuBytes >> 20), (int)(budget.gpuBytes >> 20) };
+		ImGui::SetNextItemWidth(-1);
+		if (ImGui::DragInt2("##Budget", budgetMB, 1.0f, 0, 4096))
+		{
+			budget.cpuBytes = (uint64)budgetMB[0] << 20;
+			budget.gpuBytes = (uint64)budgetMB[1] << 20;
+			cache.SetBudget(type, budget);
+		}
+		ImGui::NextColumn();
+
+		ImGui::Text("%u", stats.cachedCount);												ImGui::SameLine();
+		TextBytes(stats.cachedCPUBytes + stats.cachedGPUBytes);								ImGui::NextColumn();
+		ImGui::Text("%.1f%% (%llu)", stats.GetHitRate() * 100.0, stats.hits + stats.misses);	ImGui::NextColumn();
+		ImGui::Text("%llu", stats.evictions);												ImGui::NextColumn();
+		TextBytes(stats.evictedCPUBytes + stats.evictedGPUBytes);							ImGui::NextColumn();
+		ImGui::PopID();
+	}
+	ImGui::Columns(1);
+
+	if (ImGui::Button("Clear Cache"))
+	{
+		Engine->moduleResources->ClearCache();
+	}
+}
+
+void W_Resources::DisplayFileSystemStats()
+{
+	M_FileSystem::WriteStats stats = Engine->fileSystem->GetWriteStats();
+
+	ImGui::Columns(3, "File System");
+	ImGui::Text("Operation");	ImGui::NextColumn();
+	ImGui::Text("Files");		ImGui::NextColumn();
+	ImGui::Text("Size");		ImGui::NextColumn();
+	ImGui::Separator();
+
+	ImGui::Text("Written");		ImGui::NextColumn();
+	ImGui::Text("%llu", stats.filesWritten);	ImGui::NextColumn();
+	TextBytes(stats.bytesWritten);				ImGui::NextColumn();
+
+	ImGui::Text("Copied");		ImGui::NextColumn();
+	ImGui::Text("%llu", stats.filesCopied);		ImGui::NextColumn();
+	TextBytes(stats.bytesCopied);				ImGui::NextColumn();
+
+	ImGui::Text("Removed");		ImGui::NextColumn();
+	ImGui::Text("%llu", stats.filesRemoved);	ImGui::NextColumn();
+	ImGui::NextColumn();
+
+	ImGui::Text("Flushed");		ImGui::NextColumn();
+	ImGui::Text("%llu", stats.syncs);			ImGui::NextColumn();
+	ImGui::NextColumn();
+	ImGui::Columns(1);
+
+	bool syncWrites = Engine->fileSystem->IsSyncingWrites();
+	if (ImGui::Checkbox("Sync Writes", &syncWrites))
+		Engine->fileSystem->SetSyncWrites(syncWrites);
+}
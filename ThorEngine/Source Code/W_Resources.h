@@ -3,6 +3,8 @@
 
 #include "Window.h"
 
+#include <vector>
+
 class Resource;
 
 struct ImGuiWindowClass;
@@ -18,7 +20,11 @@ public:
 	static inline const char* GetName() { return "Resources"; };
 
 private:
+	void DisplayMemoryStats();
+	void DisplayCacheStats();
+	void DisplayFileSystemStats();
 	void DisplayResourceInfo(Resource* resource);
+	void DisplayResourceNames(const std::vector<uint64>& IDs);
 
 };
 
@@ -1,6 +1,6 @@
 #include "W_Scene.h"
 
-#include "ImGui\imgui.h"
+#include "ImGui/imgui.h"
 #include "Glew/include/glew.h"
 
 #include "Engine.h"
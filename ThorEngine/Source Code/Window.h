@@ -3,6 +3,7 @@
 
 #include <string>
 #include "Vec2.h"
+#include "MemoryTracker.h"
 
 class Dock;
 typedef unsigned int uint;
@@ -12,6 +13,8 @@ struct ImGuiWindowClass;
 
 class Window
 {
+	MEMORY_TAG(MemoryTracker::Tag::EDITOR)
+
 public:
 	Window(M_Editor* editor, std::string name, ImGuiWindowClass* windowClass, int ID);
 	virtual ~Window();
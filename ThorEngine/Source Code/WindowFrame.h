@@ -14,7 +14,7 @@ struct ImGuiDockNode;
 struct ImGuiWindowClass;
 typedef unsigned int ImGuiID;
 typedef unsigned int uint;
-typedef unsigned __int64 uint64;
+typedef unsigned long long uint64;
 
 class WindowFrame
 {
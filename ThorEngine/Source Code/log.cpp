@@ -1,23 +1,29 @@
-
 #include "Globals.h"
 #include "Engine.h"
 
+#include <stdarg.h>
+
 void log(const char file[], int line, const char* format, ...)
 {
-	static char tmp_string[4096];
-	static char tmp_string2[4096];
-	static va_list  ap;
+	//Local buffers: resources log from the loading threads too. Engine::Log queues their lines for the main thread
+	char tmp_string[4096];
+	va_list  ap;
 
 	// Construct the string from variable arguments
 	va_start(ap, format);
-	vsprintf_s(tmp_string, 4096, format, ap);
+	vsnprintf(tmp_string, 4096, format, ap);
 	va_end(ap);
-	sprintf_s(tmp_string2, 4096, "\n%s(%d) : %s", file, line, tmp_string);
+#ifdef _WIN32
+	char tmp_string2[4096];
+	snprintf(tmp_string2, 4096, "\n%s(%d) : %s", file, line, tmp_string);
 	OutputDebugString(tmp_string2);
+#else
+	(void)file;
+	(void)line;
+#endif
 
 	if (Engine)
 	{
-		sprintf_s(tmp_string2, 4096, "\n%s", tmp_string);
 		Engine->Log(tmp_string);
 	}
-}
\ No newline at end of file
+}
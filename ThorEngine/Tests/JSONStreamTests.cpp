@@ -0,0 +1,71 @@
+//Checks of the streaming json reader and writer, runs on the headless engine core
+
+#include "JSONStream.h"
+#include "parson/parson.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+int failures = 0;
+
+void Check(bool condition, const char* what)
+{
+	if (condition == false)
+	{
+		printf("FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+//Names with every control character are written escaped, and read back the same by parson and by the reader
+void ControlCharacterRoundTrip()
+{
+	std::string name = "Game";
+	for (char c = 1; c < 0x20; ++c)
+		name.push_back(c);
+	name += "Object";
+
+	JSONWriter writer;
+	writer.BeginObject();
+	writer.Key("Name");
+	writer.String(name.c_str(), (uint)name.size());
+	writer.EndObject();
+
+	char* buffer = nullptr;
+	uint64 size = writer.Finish(&buffer);
+
+	bool raw = false;
+	for (uint64 i = 0; i + 1 < size; ++i)
+		raw |= (unsigned char)buffer[i] < 0x20 && buffer[i] != '\n';
+	Check(raw == false, "control characters are escaped");
+
+	JSON_Value* value = json_parse_string(buffer);
+	Check(value != nullptr, "parson parses the written json");
+	if (value != nullptr)
+	{
+		const char* parsed = json_object_get_string(json_value_get_object(value), "Name");
+		Check(parsed != nullptr && name == parsed, "parson reads the same name");
+		json_value_free(value);
+	}
+
+	JSONReader reader(buffer, size);
+	std::string read;
+	Check(reader.Next() == JSONReader::Token::OBJECT_BEGIN && reader.NextKey() && reader.Is("Name"), "reader finds the key");
+	reader.ReadString(read);
+	Check(read == name, "reader reads the same name");
+	Check(reader.Next() == JSONReader::Token::OBJECT_END && reader.Next() == JSONReader::Token::END, "reader reaches the end");
+
+	RELEASE_ARRAY(buffer);
+}
+
+int main()
+{
+	ControlCharacterRoundTrip();
+
+	if (failures > 0)
+		return EXIT_FAILURE;
+
+	printf("All checks passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+//Checks of the resource module, runs on the headless engine core in a scratch project
+
+#include "Engine.h"
+#include "M_Resources.h"
+#include "ResourceHandle.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+TEngine* Engine = nullptr;
+
+int failures = 0;
+
+void Check(bool condition, const char* what)
+{
+	if (condition == false)
+	{
+		printf("FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+bool StartEngine(const std::filesystem::path& project)
+{
+	std::error_code error;
+	std::filesystem::remove_all(project, error);
+	std::filesystem::create_directories(project / "Engine" / "Assets", error);
+	std::filesystem::create_directories(project / "Assets", error);
+	std::ofstream(project / "Engine" / "DefaultSettings.JSON") << "{ \"EditorState\": { } }";
+	std::ofstream(project / "Assets" / "Reimported.scene") << "{ \"GameObjects\": [ ] }";
+
+	std::filesystem::current_path(project, error);
+	if (error)
+		return false;
+
+	Engine = new TEngine();
+	return Engine->Init();
+}
+
+//A reimport of an asset in use keeps the loaded resource alive for the handles holding it
+void ReimportInUse()
+{
+	uint64 ID = Engine->moduleResources->ImportFileFromAssets("Assets/Reimported.scene");
+	Check(ID != 0, "scene asset is imported");
+
+	ResourceHandle<Resource> handle(ID);
+	Resource* loaded = handle.Get();
+	Check(loaded != nullptr, "scene is loaded");
+	if (loaded == nullptr)
+		return;
+
+	Check(Engine->moduleResources->ImportFileFromAssets("Assets/Reimported.scene") == ID, "reimport keeps the ID");
+	Check(handle.Get() == loaded && loaded->GetID() == ID, "handle keeps the previous resource");
+	Check(std::string(loaded->GetAssetsFile()) == "Assets/Reimported.scene", "previous resource keeps its data");
+
+	handle.Free();
+
+	ResourceHandle<Resource> reloaded(ID);
+	Check(reloaded.Get() != nullptr, "reimported scene is loaded");
+}
+
+int main()
+{
+	std::filesystem::path project = std::filesystem::temp_directory_path() / "ThorResourceTests";
+	if (StartEngine(project) == false)
+	{
+		printf("FAILED: engine could not start in %s\n", project.string().c_str());
+		return EXIT_FAILURE;
+	}
+
+	ReimportInUse();
+
+	Engine->CleanUp();
+	RELEASE(Engine);
+
+	if (failures > 0)
+		return EXIT_FAILURE;
+
+	printf("All checks passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+//Packs the library of a project into Library/Library.pack, runs on the headless engine core
+//The engine imports the project first, so the pack always matches the current assets
+
+#include "Engine.h"
+#include "M_Resources.h"
+
+#include <filesystem>
+#include <stdlib.h>
+#include <string.h>
+
+TEngine* Engine = nullptr;
+
+void PrintUsage()
+{
+	printf("Usage: ThorCookLibrary [options]\n");
+	printf("  --project <dir>         Project directory (default: current directory)\n");
+	printf("  --keep-loose            Keep the loose library files once packed (they override the pack)\n");
+}
+
+int main(int argc, char** argv)
+{
+	std::string project = ".";
+	bool keepLoose = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--help") == 0)
+		{
+			PrintUsage();
+			return EXIT_SUCCESS;
+		}
+		else if (strcmp(arg, "--keep-loose") == 0)
+		{
+			keepLoose = true;
+		}
+		else if (strcmp(arg, "--project") == 0 && value != nullptr)
+		{
+			project = value;
+			++i;
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::current_path(project, error);
+	if (error)
+	{
+		printf("[error] Could not open project '%s': %s\n", project.c_str(), error.message().c_str());
+		return EXIT_FAILURE;
+	}
+
+	Engine = new TEngine();
+	int ret = EXIT_FAILURE;
+	if (Engine->Init())
+	{
+		if (Engine->moduleResources->CookLibrary(keepLoose == false))
+			ret = EXIT_SUCCESS;
+		else
+			printf("[error] Could not write the library pack\n");
+	}
+	Engine->CleanUp();
+	RELEASE(Engine);
+
+	return ret;
+}
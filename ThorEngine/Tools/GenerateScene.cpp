@@ -0,0 +1,123 @@
+//Command line front end of SceneGenerator, runs on the headless engine core
+//Generates a stress scene asset inside an existing project and its manifest
+
+#include "Engine.h"
+#include "Config.h"
+#include "SceneGenerator.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+TEngine* Engine = nullptr;
+
+void PrintUsage()
+{
+	printf("Usage: ThorSceneGenerator [options]\n");
+	printf("  --project <dir>         Project directory (default: current directory)\n");
+	printf("  --out <file>            Scene asset, relative to the project (default: Assets/Generated/<name>.scene)\n");
+	printf("  --manifest <file>       Manifest, relative to the project (default: Library/<name>.manifest)\n");
+	printf("  --from-manifest <file>  Load the generation settings from a previous manifest\n");
+	printf("  --name <name>           Scene name (default: StressScene)\n");
+	printf("  --seed <n>              Random seed (default: 1)\n");
+	printf("  --count <n>             GameObjects with mesh (default: 10000)\n");
+	printf("  --depth <n>             Hierarchy levels below the root (default: 4)\n");
+	printf("  --fan-out <n>           Maximum children per GameObject (default: 8)\n");
+	printf("  --static-ratio <f>      Fraction of static GameObjects (default: 0.8)\n");
+	printf("  --extent <f>            Half size of the generated area (default: 75)\n");
+	printf("  --meshes <n>            Distinct meshes reused (default: 16)\n");
+	printf("  --materials <n>         Distinct materials reused (default: 8)\n");
+	printf("  --characters <n>        Animated model instances (default: 0)\n");
+	printf("  --emitters <n>          Particle systems (default: 0)\n");
+}
+
+bool LoadManifestSettings(const char* file, SceneGenerator::Settings& settings)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if (!stream.is_open())
+		return false;
+
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+
+	Config manifest(buffer.str().c_str());
+	if (manifest.NodeExists() == false)
+		return false;
+
+	settings.Load(manifest.GetNode("Settings"));
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	SceneGenerator::Settings settings;
+	std::string project = ".";
+	std::string outFile;
+	std::string manifestFile;
+
+	for (int i = 1; i < argc; i += 2)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--help") == 0 || value == nullptr)
+		{
+			PrintUsage();
+			return strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (strcmp(arg, "--project") == 0)			project = value;
+		else if (strcmp(arg, "--out") == 0)				outFile = value;
+		else if (strcmp(arg, "--manifest") == 0)		manifestFile = value;
+		else if (strcmp(arg, "--name") == 0)			settings.name = value;
+		else if (strcmp(arg, "--seed") == 0)			settings.seed = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--count") == 0)			settings.objectCount = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--depth") == 0)			settings.maxDepth = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--fan-out") == 0)			settings.fanOut = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--static-ratio") == 0)	settings.staticRatio = atof(value);
+		else if (strcmp(arg, "--extent") == 0)			settings.extent = atof(value);
+		else if (strcmp(arg, "--meshes") == 0)			settings.meshCount = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--materials") == 0)		settings.materialCount = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--characters") == 0)		settings.characterCount = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--emitters") == 0)		settings.emitterCount = strtoul(value, nullptr, 10);
+		else if (strcmp(arg, "--from-manifest") == 0)
+		{
+			if (LoadManifestSettings(value, settings) == false)
+			{
+				printf("[error] Could not read manifest '%s'\n", value);
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (outFile.empty())
+		outFile = std::string("Assets/Generated/") + settings.name + ".scene";
+	if (manifestFile.empty())
+		manifestFile = SceneGenerator::GetManifestPath(settings.name.c_str());
+
+	std::error_code error;
+	std::filesystem::current_path(project, error);
+	if (error)
+	{
+		printf("[error] Could not open project '%s': %s\n", project.c_str(), error.message().c_str());
+		return EXIT_FAILURE;
+	}
+
+	Engine = new TEngine();
+	int ret = EXIT_FAILURE;
+	if (Engine->Init())
+	{
+		if (SceneGenerator::GenerateAsset(settings, outFile.c_str(), manifestFile.c_str()) != 0)
+			ret = EXIT_SUCCESS;
+	}
+	Engine->CleanUp();
+	RELEASE(Engine);
+
+	return ret;
+}
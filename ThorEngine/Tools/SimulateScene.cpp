@@ -0,0 +1,424 @@
+//Headless frame runner: loads a scene and simulates N frames at a fixed dt without presenting
+//Runs the whole module update loop (scene update, animation, particles, culling and draw list building)
+//on the null GL backend and reports per-phase timings, allocations and peak memory as JSON
+
+#include "Engine.h"
+#include "Config.h"
+#include "Time.h"
+#include "Module.h"
+#include "NullGL.h"
+#include "MemoryTracker.h"
+
+#include "M_SceneManager.h"
+#include "M_Renderer3D.h"
+#include "M_Camera3D.h"
+#include "M_Resources.h"
+#include "M_FileSystem.h"
+#include "ResourceBase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+TEngine* Engine = nullptr;
+
+//Allocation tracking -------------------------------------------------------------
+//Every allocation done through operator new is counted. Blocks carry a header with their size
+//so the live heap and its peak can be tracked without platform allocator queries
+namespace Allocations
+{
+	//Aligned as any type: the block after it keeps the default new alignment
+	struct alignas(std::max_align_t) Header
+	{
+		size_t size;
+	};
+
+	std::atomic<uint64_t> count(0);
+	std::atomic<uint64_t> bytes(0);
+	std::atomic<uint64_t> live(0);
+	std::atomic<uint64_t> peak(0);
+
+	void* Allocate(size_t size)
+	{
+		Header* header = (Header*)malloc(sizeof(Header) + size);
+		if (header == nullptr)
+			return nullptr;
+
+		header->size = size;
+		count.fetch_add(1, std::memory_order_relaxed);
+		bytes.fetch_add(size, std::memory_order_relaxed);
+
+		uint64_t current = live.fetch_add(size, std::memory_order_relaxed) + size;
+		uint64_t previousPeak = peak.load(std::memory_order_relaxed);
+		while (current > previousPeak && !peak.compare_exchange_weak(previousPeak, current, std::memory_order_relaxed));
+
+		return header + 1;
+	}
+
+	void Free(void* ptr)
+	{
+		if (ptr == nullptr)
+			return;
+
+		//Stepped back as an address, so gcc does not check the header against the bounds of the freed object
+		Header* header = reinterpret_cast<Header*>(reinterpret_cast<uintptr_t>(ptr) - sizeof(Header));
+		live.fetch_sub(header->size, std::memory_order_relaxed);
+		free(header);
+	}
+}
+
+void* operator new(size_t size)
+{
+	void* ptr = Allocations::Allocate(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void* ptr = Allocations::Allocate(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocations::Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocations::Allocate(size); }
+
+void operator delete(void* ptr) noexcept { Allocations::Free(ptr); }
+void operator delete[](void* ptr) noexcept { Allocations::Free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { Allocations::Free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { Allocations::Free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { Allocations::Free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { Allocations::Free(ptr); }
+//---------------------------------------------------------------------------------
+
+//Process peak resident memory, in KB
+uint64_t GetPeakRSS()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize / 1024;
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		return usage.ru_maxrss; //Already in KB on Linux
+	return 0;
+#endif
+}
+
+//Samples of one measured value, one per simulated frame
+struct Series
+{
+	std::string name;
+	std::vector<double> samples;
+
+	Series(const char* name) : name(name) {}
+
+	void Save(Config_Array& array) const
+	{
+		Config node = array.AddNode();
+		std::vector<double> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0.0;
+		for (uint i = 0; i < sorted.size(); ++i)
+			total += sorted[i];
+
+		node.SetString("Name", name.c_str());
+		node.SetNumber("Mean", sorted.empty() ? 0.0 : total / sorted.size());
+		node.SetNumber("P50", Percentile(sorted, 0.50));
+		node.SetNumber("P90", Percentile(sorted, 0.90));
+		node.SetNumber("P99", Percentile(sorted, 0.99));
+		node.SetNumber("Min", sorted.empty() ? 0.0 : sorted.front());
+		node.SetNumber("Max", sorted.empty() ? 0.0 : sorted.back());
+		node.SetNumber("Total", total);
+	}
+
+	//Nearest rank percentile over sorted samples
+	static double Percentile(const std::vector<double>& sorted, double percentile)
+	{
+		if (sorted.empty())
+			return 0.0;
+
+		uint rank = (uint)(percentile * sorted.size() + 0.999999);
+		rank = rank < 1 ? 1 : (rank > sorted.size() ? sorted.size() : rank);
+		return sorted[rank - 1];
+	}
+};
+
+void PrintUsage()
+{
+	printf("Usage: ThorSimulate --scene <file> [options]\n");
+	printf("  --project <dir>   Project directory (default: current directory)\n");
+	printf("  --scene <file>    Scene asset to load, relative to the project\n");
+	printf("  --frames <n>      Measured frames (default: 300)\n");
+	printf("  --warmup <n>      Frames simulated before measuring (default: 10)\n");
+	printf("  --dt <seconds>    Fixed frame time (default: 0.016667)\n");
+	printf("  --no-culling      Send every GameObject to the renderer instead of culling with the editor camera\n");
+	printf("  --out <file>      Save the stats as JSON (default: print them)\n");
+}
+
+bool SaveStats(const char* file, Config& stats)
+{
+	char* buffer = nullptr;
+	uint size = stats.Serialize(&buffer);
+
+	bool ret = false;
+	if (file == nullptr)
+	{
+		printf("%s\n", buffer);
+		ret = true;
+	}
+	else
+	{
+		FILE* output = fopen(file, "wb");
+		if (output != nullptr)
+		{
+			//Serialized size includes the null terminator
+			ret = fwrite(buffer, 1, size - 1, output) == size - 1;
+			fclose(output);
+		}
+		if (ret == false)
+			printf("[error] Could not write simulation stats to '%s'\n", file);
+	}
+
+	RELEASE_ARRAY(buffer);
+	return ret;
+}
+
+int Simulate(const char* scene, uint frames, uint warmup, float dt, bool culling, Config& stats)
+{
+	const ResourceBase* sceneBase = Engine->moduleResources->FindResourceBase(scene);
+	if (sceneBase == nullptr)
+	{
+		printf("[error] Scene '%s' not found in the project\n", scene);
+		return EXIT_FAILURE;
+	}
+
+	PerfTimer loadTimer;
+	uint64_t loadAllocations = Allocations::count.load();
+	Engine->sceneManager->LoadScene(sceneBase->ID);
+	double loadMs = loadTimer.ReadMs();
+	loadAllocations = Allocations::count.load() - loadAllocations;
+
+	Engine->renderer3D->SetCullingCamera(culling ? Engine->camera->GetCamera() : nullptr);
+	Engine->SetFixedDeltaTime(dt);
+	Engine->profileModules = true;
+	Time::Start(0);
+
+	//Engine update steps of every module, followed by the scene manager update breakdown
+	std::vector<Series> phases;
+	const char* stepNames[TEngine::UPDATE_STEP_COUNT] = { "PreUpdate", "Update", "PostUpdate" };
+	for (uint m = 0; m < Engine->GetModuleCount(); ++m)
+		for (uint s = 0; s < TEngine::UPDATE_STEP_COUNT; ++s)
+			phases.push_back(Series((Engine->GetModule(m)->name + "/" + stepNames[s]).c_str()));
+
+	Series frameTime("Frame");
+	Series sceneUpdate("Scene/GameObjects Update");
+	Series sceneCulling("Scene/Culling");
+	Series sceneDrawList("Scene/Draw List");
+
+	Series allocations("Allocations");
+	Series allocatedBytes("Allocated Bytes");
+	Series drawCalls("Draw Calls");
+	Series drawnIndices("Drawn Indices");
+	Series meshes("Render Meshes");
+	Series particles("Render Particles");
+
+	NullGL::Capture& capture = NullGL::GetCapture();
+	uint64_t loadPeak = 0;
+	uint64_t steadyPeak = 0;
+
+	for (uint frame = 0; frame < warmup + frames; ++frame)
+	{
+		//Heap peak is measured separately for the loading and warmup and for the simulated frames
+		if (frame == warmup)
+		{
+			loadPeak = Allocations::peak.load();
+			Allocations::peak = Allocations::live.load();
+		}
+
+		NullGL::Capture captureStart = capture;
+		uint64_t allocationsStart = Allocations::count.load();
+		uint64_t bytesStart = Allocations::bytes.load();
+
+		PerfTimer timer;
+		if (Engine->Update() != UPDATE_CONTINUE)
+		{
+			printf("[error] Engine update stopped at frame %u\n", frame);
+			return EXIT_FAILURE;
+		}
+		double ms = timer.ReadMs();
+
+		if (frame < warmup)
+			continue;
+
+		frameTime.samples.push_back(ms);
+		for (uint m = 0; m < Engine->GetModuleCount(); ++m)
+			for (uint s = 0; s < TEngine::UPDATE_STEP_COUNT; ++s)
+				phases[m * TEngine::UPDATE_STEP_COUNT + s].samples.push_back(Engine->GetModuleTime(m, (TEngine::UpdateStep)s));
+
+		sceneUpdate.samples.push_back(Engine->sceneManager->updateMs);
+		sceneCulling.samples.push_back(Engine->sceneManager->cullingMs);
+		sceneDrawList.samples.push_back(Engine->sceneManager->drawListMs);
+
+		allocations.samples.push_back((double)(Allocations::count.load() - allocationsStart));
+		allocatedBytes.samples.push_back((double)(Allocations::bytes.load() - bytesStart));
+		drawCalls.samples.push_back((double)(capture.drawCalls - captureStart.drawCalls));
+		drawnIndices.samples.push_back((double)(capture.drawnIndices - captureStart.drawnIndices));
+		meshes.samples.push_back(Engine->renderer3D->drawnMeshes);
+		particles.samples.push_back(Engine->renderer3D->drawnParticles);
+	}
+	steadyPeak = Allocations::peak.load();
+
+	Engine->profileModules = false;
+	Engine->SetFixedDeltaTime(0.0f);
+	Time::Stop();
+
+	stats.SetString("Scene", scene);
+	stats.SetNumber("Frames", frames);
+	stats.SetNumber("Warmup Frames", warmup);
+	stats.SetNumber("Dt", dt);
+	stats.SetBool("Culling", culling);
+	stats.SetString("Unit", "ms");
+	stats.SetNumber("Load Ms", loadMs);
+	stats.SetNumber("Load Allocations", (double)loadAllocations);
+
+	Config_Array phasesArray = stats.SetArray("Phases");
+	frameTime.Save(phasesArray);
+	sceneUpdate.Save(phasesArray);
+	sceneCulling.Save(phasesArray);
+	sceneDrawList.Save(phasesArray);
+	for (uint i = 0; i < phases.size(); ++i)
+		phases[i].Save(phasesArray);
+
+	Config_Array countersArray = stats.SetArray("Counters");
+	allocations.Save(countersArray);
+	allocatedBytes.Save(countersArray);
+	drawCalls.Save(countersArray);
+	drawnIndices.Save(countersArray);
+	meshes.Save(countersArray);
+	particles.Save(countersArray);
+
+	Config memory = stats.SetNode("Memory");
+	memory.SetNumber("Live Heap Bytes", (double)Allocations::live.load());
+	memory.SetNumber("Load Peak Heap Bytes", (double)loadPeak);
+	memory.SetNumber("Peak Heap Bytes", (double)steadyPeak);
+	memory.SetNumber("Peak RSS KB", (double)GetPeakRSS());
+	MemoryTracker::Save(memory);
+
+	Config_Array cacheArray = stats.SetArray("Resource Cache");
+	const ResourceCache& cache = Engine->moduleResources->GetCache();
+	for (int i = 0; i < (int)ResourceType::UNKNOWN; ++i)
+	{
+		const ResourceCache::Stats& cacheStats = cache.GetStats((ResourceType)i);
+		if (ResourceCache::IsCacheable((ResourceType)i) == false || cacheStats.hits + cacheStats.misses == 0)
+			continue;
+
+		Config node = cacheArray.AddNode();
+		node.SetString("Type", MemoryTracker::GetTagName(MemoryTracker::GetResourceTag((ResourceType)i)));
+		node.SetNumber("Hits", (double)cacheStats.hits);
+		node.SetNumber("Misses", (double)cacheStats.misses);
+		node.SetNumber("Hit Rate", cacheStats.GetHitRate());
+		node.SetNumber("Evictions", (double)cacheStats.evictions);
+		node.SetNumber("Cached", (double)cacheStats.cachedCount);
+	}
+
+	M_FileSystem::WriteStats writeStats = Engine->fileSystem->GetWriteStats();
+	Config fileSystem = stats.SetNode("File System");
+	fileSystem.SetNumber("Files Written", (double)writeStats.filesWritten);
+	fileSystem.SetNumber("Bytes Written", (double)writeStats.bytesWritten);
+	fileSystem.SetNumber("Files Copied", (double)writeStats.filesCopied);
+	fileSystem.SetNumber("Bytes Copied", (double)writeStats.bytesCopied);
+	fileSystem.SetNumber("Files Removed", (double)writeStats.filesRemoved);
+	fileSystem.SetNumber("Syncs", (double)writeStats.syncs);
+
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+	std::string project = ".";
+	std::string scene;
+	std::string outFile;
+	uint frames = 300;
+	uint warmup = 10;
+	float dt = 1.0f / 60.0f;
+	bool culling = true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (strcmp(arg, "--no-culling") == 0)
+			culling = false;
+		else if (value == nullptr || strcmp(arg, "--help") == 0)
+		{
+			PrintUsage();
+			return strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else
+		{
+			if (strcmp(arg, "--project") == 0)			project = value;
+			else if (strcmp(arg, "--scene") == 0)		scene = value;
+			else if (strcmp(arg, "--frames") == 0)		frames = strtoul(value, nullptr, 10);
+			else if (strcmp(arg, "--warmup") == 0)		warmup = strtoul(value, nullptr, 10);
+			else if (strcmp(arg, "--dt") == 0)			dt = atof(value);
+			else if (strcmp(arg, "--out") == 0)			outFile = value;
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+			++i;
+		}
+	}
+
+	if (scene.empty() || frames == 0 || dt <= 0.0f)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	//Output path is given relative to the launch directory, the project becomes the working directory
+	std::error_code error;
+	if (!outFile.empty() && std::filesystem::path(outFile).is_relative())
+		outFile = std::filesystem::current_path(error).generic_string() + "/" + outFile;
+
+	std::filesystem::current_path(project, error);
+	if (error)
+	{
+		printf("[error] Could not open project '%s': %s\n", project.c_str(), error.message().c_str());
+		return EXIT_FAILURE;
+	}
+
+	Engine = new TEngine();
+	int ret = EXIT_FAILURE;
+	if (Engine->Init())
+	{
+		Config stats;
+		ret = Simulate(scene.c_str(), frames, warmup, dt, culling, stats);
+		if (ret == EXIT_SUCCESS && SaveStats(outFile.empty() ? nullptr : outFile.c_str(), stats) == false)
+			ret = EXIT_FAILURE;
+	}
+	Engine->CleanUp();
+	RELEASE(Engine);
+
+	return ret;
+}